@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "engine/physics/CoulombKernel.hpp"
+#include "engine/physics/ElectricField.hpp"
+
+/**
+ * Coulomb kernel benchmark: all-pairs field evaluation per instruction set
+ * 
+ * Usage: bench_coulomb_kernel [particleCount]
+ * 
+ * The baseline is ElectricField::totalField over std::vector<Particle>. Each
+ * instruction set runs the per-target sum (fieldAtSources) and the pairwise sum
+ * (pairwiseFields, each pair once); pairs/s counts all N² interactions for both.
+ */
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 8000;
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(-1e-6, 1e-6);
+    std::vector<Particle> particles;
+    for (int i = 0; i < count; ++i) {
+        glm::dvec3 p(pos(rng), pos(rng), pos(rng));
+        particles.push_back(i % 2 == 0 ? Particle::createProton(p) : Particle::createElectron(p));
+    }
+    ParticleStore store;
+    store.loadFrom(particles);
+    
+    std::cout << "Coulomb kernel benchmark: " << count << " particles, "
+              << "detected " << CoulombKernel::name(CoulombKernel::detect()) << std::endl;
+    std::cout << std::endl;
+    
+    // Checksum keeps the compiler from discarding results
+    double checksum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& p : particles) {
+        checksum += ElectricField::totalField(p.position, particles).x;
+    }
+    double baseline = secondsSince(start);
+    
+    std::cout << std::setw(18) << "kernel"
+              << std::setw(14) << "time (s)"
+              << std::setw(16) << "pairs/s"
+              << std::setw(10) << "speedup" << std::endl;
+    double pairs = static_cast<double>(count) * count;
+    std::cout << std::setw(18) << "reference"
+              << std::setw(14) << baseline
+              << std::setw(16) << pairs / baseline
+              << std::setw(10) << 1.0 << std::endl;
+    
+    std::vector<glm::dvec3> fields;
+    for (int isa = 0; isa <= static_cast<int>(CoulombKernel::detect()); ++isa) {
+        CoulombKernel::setInstructionSet(static_cast<CoulombKernel::InstructionSet>(isa));
+        for (bool pairwise : {false, true}) {
+            start = std::chrono::steady_clock::now();
+            if (pairwise) {
+                CoulombKernel::pairwiseFields(store, fields);
+            } else {
+                CoulombKernel::fieldAtSources(store, fields);
+            }
+            double time = secondsSince(start);
+            checksum += fields[0].x;
+            
+            std::string name = CoulombKernel::name(CoulombKernel::active());
+            std::cout << std::setw(18) << (pairwise ? name + " pairwise" : name)
+                      << std::setw(14) << time
+                      << std::setw(16) << pairs / time
+                      << std::setw(10) << baseline / time << std::endl;
+        }
+    }
+    
+    std::cout << std::endl << "checksum " << checksum << std::endl;
+    return 0;
+}
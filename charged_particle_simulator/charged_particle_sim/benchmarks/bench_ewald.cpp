@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "engine/physics/EwaldSolver.hpp"
+#include "engine/physics/P3MSolver.hpp"
+
+/**
+ * Ewald benchmark: run time against particle count in a periodic box
+ *
+ * Usage: bench_ewald [maxParticleCount] [accuracy] [threads]
+ *
+ * The particle count doubles from 250 at constant density. Each row lists the
+ * tuned Ewald parameters, the Ewald time and its growth exponent against the
+ * previous row (1.5 expected), and P3M's time and rms error relative to Ewald.
+ */
+
+ParticleStore makeNeutralBox(const PeriodicBox& box, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    ParticleStore store;
+    store.resize(count);
+    for (int i = 0; i < count; ++i) {
+        store.setPosition(i, box.getLow() + box.getSize() * glm::dvec3(unit(rng), unit(rng), unit(rng)));
+        store.q[i] = i % 2 == 0 ? 1.602176634e-19 : -1.602176634e-19;
+        store.m[i] = 1.0;
+    }
+    return store;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int maxCount = argc > 1 ? std::atoi(argv[1]) : 16000;
+    double accuracy = argc > 2 ? std::atof(argv[2]) : EwaldSolver::DEFAULT_ACCURACY;
+    size_t threads = argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 0;
+    ThreadPool pool(threads);
+
+    std::cout << "Ewald benchmark: accuracy " << accuracy << ", " << pool.getThreadCount() << " threads" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::setw(8) << "N"
+              << std::setw(12) << "alpha*L"
+              << std::setw(10) << "r_c/L"
+              << std::setw(8) << "waves"
+              << std::setw(14) << "ewald (s)"
+              << std::setw(10) << "exponent"
+              << std::setw(14) << "p3m (s)"
+              << std::setw(14) << "p3m rms err" << std::endl;
+
+    // 1000 particles per (100 nm)³
+    double previousTime = 0.0;
+    int previousCount = 0;
+    for (int count = 250; count <= maxCount; count *= 2) {
+        const double side = 1e-7 * std::cbrt(count / 1000.0);
+        const PeriodicBox box(glm::dvec3(0.0), glm::dvec3(side));
+        ParticleStore store = makeNeutralBox(box, count, 42);
+
+        EwaldSolver ewald;
+        ewald.setBox(box);
+        ewald.setAccuracy(accuracy);
+        auto start = std::chrono::steady_clock::now();
+        ewald.computeFields(store, &pool);
+        double ewaldTime = secondsSince(start);
+
+        P3MSolver p3m;
+        p3m.setBox(box);
+        p3m.computeFields(store, &pool);  // Influence function, once per mesh
+        start = std::chrono::steady_clock::now();
+        p3m.computeFields(store, &pool);
+        double p3mTime = secondsSince(start);
+
+        double errorSquared = 0.0;
+        double fieldSquared = 0.0;
+        for (int i = 0; i < count; ++i) {
+            glm::dvec3 diff = p3m.getFields()[i] - ewald.getFields()[i];
+            errorSquared += glm::dot(diff, diff);
+            fieldSquared += glm::dot(ewald.getFields()[i], ewald.getFields()[i]);
+        }
+
+        std::cout << std::setw(8) << count
+                  << std::setw(12) << ewald.getSplitting() * side
+                  << std::setw(10) << ewald.getCutoff() / side
+                  << std::setw(8) << ewald.getWaveCount()
+                  << std::setw(14) << ewaldTime;
+        if (previousCount > 0) {
+            std::cout << std::setw(10) << std::log(ewaldTime / previousTime) / std::log(double(count) / previousCount);
+        } else {
+            std::cout << std::setw(10) << "-";
+        }
+        std::cout << std::setw(14) << p3mTime
+                  << std::setw(14) << std::sqrt(errorSquared / fieldSquared) << std::endl;
+
+        previousTime = ewaldTime;
+        previousCount = count;
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "engine/physics/ElectricField.hpp"
+#include "engine/physics/FmmSolver.hpp"
+
+/**
+ * FMM benchmark: accuracy and run time against the direct ElectricField::totalField sum
+ * 
+ * Usage: bench_fmm [particleCount] [maxOrder]
+ * 
+ * The direct sum is evaluated for a strided sample of particles; its full cost
+ * is extrapolated from the sample time.
+ */
+
+std::vector<Particle> makePlasma(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(-1e-6, 1e-6);
+    std::vector<Particle> particles;
+    particles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        glm::dvec3 p(pos(rng), pos(rng), pos(rng));
+        particles.push_back(i % 2 == 0 ? Particle::createProton(p) : Particle::createElectron(p));
+    }
+    return particles;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int maxOrder = argc > 2 ? std::atoi(argv[2]) : 10;
+    
+    std::cout << "FMM benchmark: " << count << " particles" << std::endl;
+    std::vector<Particle> particles = makePlasma(count, 42);
+    
+    // Reference: direct sum for a sample of particles
+    int stride = std::max(1, count / 500);
+    std::vector<glm::dvec3> reference;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i += stride) {
+        reference.push_back(ElectricField::totalField(particles[i].position, particles));
+    }
+    double directTime = secondsSince(start) * stride;
+    std::cout << "Direct sum (extrapolated): " << directTime << " s" << std::endl;
+    std::cout << std::endl;
+    
+    std::cout << std::setw(6) << "order"
+              << std::setw(14) << "time (s)"
+              << std::setw(10) << "speedup"
+              << std::setw(16) << "rms rel err"
+              << std::setw(16) << "max rel err" << std::endl;
+    
+    for (int order = 2; order <= maxOrder; order += 2) {
+        FmmSolver solver;
+        solver.setExpansionOrder(order);
+        
+        start = std::chrono::steady_clock::now();
+        solver.build(particles);
+        solver.computeFields();
+        double fmmTime = secondsSince(start);
+        
+        // Errors relative to the RMS field (robust against near-zero fields)
+        // and the worst per-particle relative error
+        double errorSquared = 0.0;
+        double fieldSquared = 0.0;
+        double maxRelative = 0.0;
+        for (size_t s = 0; s < reference.size(); ++s) {
+            glm::dvec3 diff = solver.getFields()[s * stride] - reference[s];
+            errorSquared += glm::dot(diff, diff);
+            fieldSquared += glm::dot(reference[s], reference[s]);
+            maxRelative = std::max(maxRelative, glm::length(diff) / glm::length(reference[s]));
+        }
+        
+        std::cout << std::setw(6) << order
+                  << std::setw(14) << fmmTime
+                  << std::setw(10) << directTime / fmmTime
+                  << std::setw(16) << std::sqrt(errorSquared / fieldSquared)
+                  << std::setw(16) << maxRelative << std::endl;
+    }
+    
+    return 0;
+}
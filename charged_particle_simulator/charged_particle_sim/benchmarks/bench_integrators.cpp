@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Integrator benchmark: energy drift and cost of every IntegrationMethod
+ *
+ * Usage: bench_integrators [ionCount] [trapPeriods]
+ *
+ * Protons in a harmonic trap (external field E = -κ r, trap frequency ω) repelling
+ * each other: smooth, chaotic dynamics with an exactly conserved energy. Each
+ * method runs for the same simulated time at several step sizes (steps per trap
+ * period) and reports the largest and final relative energy error.
+ */
+
+using Method = ParticleSystem::IntegrationMethod;
+
+const double TRAP_OMEGA = 1e7;  // rad/s
+const double TRAP_KAPPA = PhysicsConstants::m_p * TRAP_OMEGA * TRAP_OMEGA / PhysicsConstants::e;  // V/m²
+
+void buildTrap(ParticleSystem& system, int ions) {
+    // Crystal spacing scale where trap and Coulomb forces balance
+    const double spacing = std::cbrt(PhysicsConstants::k * PhysicsConstants::e * PhysicsConstants::e /
+                                     (PhysicsConstants::m_p * TRAP_OMEGA * TRAP_OMEGA));
+    const double speed = 0.1 * TRAP_OMEGA * spacing;
+
+    // Cubic lattice (no close pairs) with random thermal velocities
+    const int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(ions))));
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (int i = 0; i < ions; ++i) {
+        glm::dvec3 cell(i % side, (i / side) % side, i / (side * side));
+        Particle p = Particle::createProton(spacing * (cell - 0.5 * (side - 1.0)));
+        p.velocity = speed * glm::dvec3(unit(rng), unit(rng), unit(rng));
+        system.addParticle(p);
+    }
+    system.getExternalField().setFunction([](const glm::dvec3& position, double, glm::dvec3& E, glm::dvec3&) {
+        E = -TRAP_KAPPA * position;
+    });
+    system.setCollisionPrevention(false);
+}
+
+double totalEnergy(const ParticleSystem& system) {
+    const auto& particles = system.getParticles();
+    double energy = 0.0;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Particle& p = particles[i];
+        energy += 0.5 * p.mass * glm::dot(p.velocity, p.velocity) +
+                  0.5 * p.charge * TRAP_KAPPA * glm::dot(p.position, p.position);
+        for (size_t j = i + 1; j < particles.size(); ++j) {
+            energy += PhysicsConstants::k * p.charge * particles[j].charge /
+                      glm::length(p.position - particles[j].position);
+        }
+    }
+    return energy;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int ions = argc > 1 ? std::atoi(argv[1]) : 64;
+    int periods = argc > 2 ? std::atoi(argv[2]) : 50;
+    const double period = 2.0 * M_PI / TRAP_OMEGA;
+
+    std::cout << "Integrator benchmark: " << ions << " ions, " << periods << " trap periods" << std::endl;
+    std::cout << std::setw(10) << "method"
+              << std::setw(12) << "steps/per"
+              << std::setw(12) << "evals/step"
+              << std::setw(16) << "max |dE/E|"
+              << std::setw(16) << "final |dE/E|"
+              << std::setw(12) << "time (s)" << std::endl;
+
+    const std::pair<Method, const char*> methods[] = {
+        {Method::EULER, "euler"},
+        {Method::VERLET, "verlet"},
+        {Method::YOSHIDA4, "yoshida4"},
+        {Method::RK4, "rk4"}
+    };
+    for (const auto& [method, name] : methods) {
+        for (int stepsPerPeriod : {100, 200, 400}) {
+            ParticleSystem system;
+            buildTrap(system, ions);
+            system.setIntegrationMethod(method);
+            system.setThreadCount(1);
+
+            const double dt = period / stepsPerPeriod;
+            const int steps = stepsPerPeriod * periods;
+            double e0 = totalEnergy(system);
+            double maxError = 0.0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < steps; ++i) {
+                system.step(dt);
+                if (i % 10 == 9) {
+                    maxError = std::max(maxError, std::abs(totalEnergy(system) / e0 - 1.0));
+                }
+            }
+            double elapsed = secondsSince(start);
+            double finalError = std::abs(totalEnergy(system) / e0 - 1.0);
+
+            std::cout << std::setw(10) << name
+                      << std::setw(12) << stepsPerPeriod
+                      << std::setw(12) << static_cast<double>(system.getForceEvaluationCount()) / steps
+                      << std::setw(16) << std::max(maxError, finalError)
+                      << std::setw(16) << finalError
+                      << std::setw(12) << elapsed << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "engine/physics/CoulombKernel.hpp"
+#include "engine/physics/RetardedFieldSolver.hpp"
+
+/**
+ * Retarded field benchmark: Liénard–Wiechert fields for all particles against
+ * the instantaneous Coulomb direct sum
+ *
+ * Usage: bench_retarded [maxParticleCount] [threads]
+ *
+ * Particles move at up to 1% of c through a box whose light crossing time spans
+ * several recorded steps, so every pair needs a real retarded-time solve.
+ */
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int maxCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    size_t threads = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 0;
+    ThreadPool pool(threads);
+
+    const double dt = 1e-11;
+    const double box = 0.01;  // Light crossing ~3 steps
+    std::cout << "Retarded field benchmark (" << pool.getThreadCount() << " threads)" << std::endl;
+    std::cout << std::setw(10) << "particles"
+              << std::setw(14) << "coulomb (s)"
+              << std::setw(14) << "retarded (s)"
+              << std::setw(10) << "ratio"
+              << std::setw(14) << "iter/pair"
+              << std::setw(16) << "pairs/s" << std::endl;
+
+    for (int count = 1000; count <= maxCount; count *= 2) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> pos(-box, box);
+        std::uniform_real_distribution<double> vel(-3e6, 3e6);
+        std::vector<Particle> particles;
+        for (int i = 0; i < count; ++i) {
+            Particle p = i % 2 == 0 ? Particle::createProton(glm::dvec3(pos(rng), pos(rng), pos(rng)))
+                                    : Particle::createElectron(glm::dvec3(pos(rng), pos(rng), pos(rng)));
+            p.velocity = glm::dvec3(vel(rng), vel(rng), vel(rng));
+            particles.push_back(p);
+        }
+
+        // A few frames of straight-line motion as history
+        RetardedFieldSolver solver;
+        ParticleStore store;
+        for (int f = 0; f < 8; ++f) {
+            store.loadFrom(particles);
+            solver.record(f * dt, store);
+            for (auto& p : particles) {
+                p.position += p.velocity * dt;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<glm::dvec3> coulomb(store.size());
+        pool.parallelFor(0, store.size(), [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                coulomb[i] = CoulombKernel::fieldAt(store.position(i), store);
+            }
+        }, 8);
+        double coulombTime = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        solver.computeFields(store, 7 * dt, pool);
+        double retardedTime = secondsSince(start);
+
+        double pairs = static_cast<double>(count) * (count - 1);
+        std::cout << std::setw(10) << count
+                  << std::setw(14) << coulombTime
+                  << std::setw(14) << retardedTime
+                  << std::setw(10) << retardedTime / coulombTime
+                  << std::setw(14) << solver.getMeanIterations()
+                  << std::setw(16) << pairs / retardedTime << std::endl;
+    }
+
+    return 0;
+}
@@ -41,7 +41,9 @@ void Logger::shutdown() {
     std::lock_guard<std::mutex> lock(s_mutex);
     
     if (s_logFile && s_logFile->is_open()) {
-        info("Logger shutting down");
+        // Written directly: info() would try to take s_mutex again
+        *s_logFile << "[" << levelToString(LogLevel::INFO) << "][" << formatTimestamp()
+                   << "] Logger shutting down" << std::endl;
         s_logFile->close();
     }
     
@@ -0,0 +1,241 @@
+#include "ThreadPool.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+ThreadPool::ThreadPool(size_t threadCount, bool pinThreads)
+    : m_pinned(false)
+    , m_stop(false)
+    , m_body(nullptr)
+    , m_begin(0)
+    , m_end(0)
+    , m_chunkCount(0)
+    , m_grainSize(0)
+    , m_generation(0)
+    , m_pending(0)
+{
+    if (threadCount == 0) {
+        threadCount = hardwareThreads();
+    }
+    
+    m_ranges = std::make_unique<WorkRange[]>(threadCount);
+    
+    // The calling thread runs chunk 0, so only threadCount - 1 workers are spawned
+    m_workers.reserve(threadCount - 1);
+    for (size_t worker = 1; worker < threadCount; ++worker) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+    
+    if (pinThreads) {
+        size_t cores = hardwareThreads();
+        m_pinned = true;
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            m_pinned = pinToCore(m_workers[i], (i + 1) % cores) && m_pinned;
+        }
+        if (!m_pinned) {
+            LOG_WARN("Thread pinning not supported on this platform, threads are unpinned");
+        }
+    }
+    
+    LOG_DEBUG("Thread pool started with " + std::to_string(threadCount) + " threads");
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::hardwareThreads() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, const RangeFunction& body, size_t minChunkSize) {
+    if (end <= begin) {
+        return;
+    }
+    
+    size_t count = end - begin;
+    size_t chunks = std::min(getThreadCount(), count / std::max<size_t>(minChunkSize, 1));
+    if (chunks <= 1) {
+        body(begin, end, 0);
+        return;
+    }
+    
+    startJob(begin, end, body, chunks, 0);
+}
+
+void ThreadPool::parallelForDynamic(size_t begin, size_t end, const RangeFunction& body, size_t grainSize) {
+    if (end <= begin) {
+        return;
+    }
+    
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t count = end - begin;
+    size_t chunks = std::min(getThreadCount(), (count + grainSize - 1) / grainSize);
+    if (chunks <= 1) {
+        for (size_t i = begin; i < end; i += grainSize) {
+            body(i, std::min(i + grainSize, end), 0);
+        }
+        return;
+    }
+    
+    // Seed every thread with its static chunk; stealing rebalances from there
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        m_ranges[chunk].begin = begin + count * chunk / chunks;
+        m_ranges[chunk].end = begin + count * (chunk + 1) / chunks;
+    }
+    
+    startJob(begin, end, body, chunks, grainSize);
+}
+
+void ThreadPool::startJob(size_t begin, size_t end, const RangeFunction& body, size_t chunks, size_t grainSize) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_begin = begin;
+        m_end = end;
+        m_chunkCount = chunks;
+        m_grainSize = grainSize;
+        m_pending = chunks;
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+    
+    // Caller takes part as worker 0
+    runChunk(0);
+    
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_body = nullptr;
+        error = m_error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::runChunk(size_t chunk) {
+    try {
+        if (m_grainSize > 0) {
+            runStealing(chunk);
+        } else {
+            // Contiguous, balanced split that depends only on range and chunk count
+            size_t count = m_end - m_begin;
+            size_t chunkBegin = m_begin + count * chunk / m_chunkCount;
+            size_t chunkEnd = m_begin + count * (chunk + 1) / m_chunkCount;
+            (*m_body)(chunkBegin, chunkEnd, chunk);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_error) {
+            m_error = std::current_exception();
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_pending == 0) {
+        m_done.notify_one();
+    }
+}
+
+void ThreadPool::runStealing(size_t worker) {
+    WorkRange& own = m_ranges[worker];
+    
+    while (true) {
+        // Take the next grain from the front of our own range
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end) {
+                begin = own.begin;
+                end = std::min(own.begin + m_grainSize, own.end);
+                own.begin = end;
+            }
+        }
+        
+        if (begin < end) {
+            (*m_body)(begin, end, worker);
+            continue;
+        }
+        
+        // Out of work: steal the back half of another thread's range.
+        // Only one range lock is held at a time, so thieves cannot deadlock.
+        bool stole = false;
+        for (size_t offset = 1; offset < m_chunkCount && !stole; ++offset) {
+            WorkRange& victim = m_ranges[(worker + offset) % m_chunkCount];
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (victim.begin >= victim.end) {
+                    continue;
+                }
+                size_t remaining = victim.end - victim.begin;
+                size_t take = remaining > m_grainSize ? remaining / 2 : remaining;
+                begin = victim.end - take;
+                end = victim.end;
+                victim.end = begin;
+            }
+            
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+            stole = true;
+        }
+        
+        if (!stole) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    size_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+            
+            // Jobs with fewer chunks than threads leave some workers idle
+            if (worker >= m_chunkCount) {
+                continue;
+            }
+        }
+        runChunk(worker);
+    }
+}
+
+bool ThreadPool::pinToCore(std::thread& thread, size_t core) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    DWORD_PTR mask = static_cast<DWORD_PTR>(1) << (core % (sizeof(DWORD_PTR) * 8));
+    return SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), mask) != 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Thread Pool
+ *
+ * Persistent worker threads for data-parallel loops. Workers are created once and
+ * sleep between jobs, so per-frame parallel loops do not pay thread start-up cost.
+ *
+ * parallelFor() splits an index range into one contiguous chunk per thread (the
+ * calling thread runs chunk 0) and blocks until all chunks are done. The split only
+ * depends on the range and the thread count, and each index is processed exactly
+ * once, so loops whose iterations are independent give identical results for any
+ * thread count.
+ *
+ * parallelForDynamic() is for loops with very uneven iteration cost: each thread
+ * starts on its own contiguous chunk, takes grain-sized pieces from the front, and
+ * when it runs dry steals the back half of another thread's remaining range.
+ *
+ * One job runs at a time: parallelFor must not be called concurrently from several
+ * threads or from inside a loop body.
+ */
+class ThreadPool {
+public:
+    /**
+     * Loop body: processes indices [begin, end) on worker thread `worker`
+     */
+    using RangeFunction = std::function<void(size_t begin, size_t end, size_t worker)>;
+
+    /**
+     * @param threadCount Total threads including the caller (0 = hardware concurrency)
+     * @param pinThreads Pin worker i to logical core i (Linux and Windows only)
+     */
+    explicit ThreadPool(size_t threadCount = 0, bool pinThreads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Run body over [begin, end) split into contiguous chunks
+     *
+     * Ranges smaller than minChunkSize * 2 run inline on the calling thread.
+     * Exceptions thrown by the body are rethrown here after all chunks finish.
+     *
+     * @param begin First index
+     * @param end One past last index
+     * @param body Loop body
+     * @param minChunkSize Smallest range worth handing to another thread
+     */
+    void parallelFor(size_t begin, size_t end, const RangeFunction& body, size_t minChunkSize = 1);
+
+    /**
+     * Run body over [begin, end) with work stealing
+     *
+     * body is called with ranges of at most grainSize indices; which thread runs
+     * which index depends on timing, so iterations must be independent.
+     *
+     * @param begin First index
+     * @param end One past last index
+     * @param body Loop body
+     * @param grainSize Indices handed out per call (and minimum steal size)
+     */
+    void parallelForDynamic(size_t begin, size_t end, const RangeFunction& body, size_t grainSize = 1);
+
+    /**
+     * Total number of threads used by parallelFor (workers + caller)
+     */
+    size_t getThreadCount() const { return m_workers.size() + 1; }
+
+    /**
+     * Check if workers are pinned to cores
+     */
+    bool isPinned() const { return m_pinned; }
+
+    /**
+     * Number of logical cores reported by the OS (at least 1)
+     */
+    static size_t hardwareThreads();
+
+private:
+    // Remaining range of one thread in a work-stealing job
+    struct alignas(64) WorkRange {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<WorkRange[]> m_ranges;
+    bool m_pinned;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stop;
+
+    // Current job (valid while m_pending > 0)
+    const RangeFunction* m_body;
+    size_t m_begin;
+    size_t m_end;
+    size_t m_chunkCount;
+    size_t m_grainSize;      // 0 for static parallelFor jobs
+    size_t m_generation;
+    size_t m_pending;
+    std::exception_ptr m_error;
+
+    void workerLoop(size_t worker);
+    void runChunk(size_t chunk);
+    void startJob(size_t begin, size_t end, const RangeFunction& body, size_t chunks, size_t grainSize);
+
+    /**
+     * Work-stealing loop for one thread; returns when no range has work left
+     */
+    void runStealing(size_t worker);
+
+    /**
+     * Pin a thread to a logical core; returns false if unsupported or refused
+     */
+    static bool pinToCore(std::thread& thread, size_t core);
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Triple Buffer
+ *
+ * Lock-free single-producer, single-consumer exchange of the latest value. The
+ * writer fills the back slot and publishes it; the reader takes the newest
+ * published slot as its front. Neither side ever waits for the other: the writer
+ * always has a free slot to write into, and the reader keeps its front slot
+ * until it asks for a newer one. Values published while the reader is busy are
+ * simply superseded.
+ *
+ * The three slot indices are shared through one atomic byte holding the middle
+ * (last published) slot and a "new data" bit. Publishing swaps back and middle,
+ * acquiring swaps middle and front, so each slot is owned by exactly one side at
+ * a time. Slot contents are reused, so values with heap storage (vectors) stop
+ * allocating once they have reached their working size.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : m_middle(1)
+        , m_back(0)
+        , m_front(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * Writer: slot to fill before publish() (keeps its previous contents)
+     */
+    T& back() { return m_slots[m_back]; }
+
+    /**
+     * Writer: make the back slot the newest value
+     */
+    void publish() {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | NEW_DATA), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    /**
+     * Reader: switch the front slot to the newest published value, if any
+     *
+     * @return true if a value newer than the previous front was taken
+     */
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & NEW_DATA)) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * Reader: current front value (unchanged until the next acquire())
+     */
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t NEW_DATA = 0x4;
+
+    T m_slots[3];
+    std::atomic<uint8_t> m_middle;  // Shared: last published slot | NEW_DATA
+    uint8_t m_back;                 // Writer only
+    uint8_t m_front;                // Reader only
+};
@@ -0,0 +1,543 @@
+#include "Checkpoint.hpp"
+#include "engine/core/Logger.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+namespace {
+    constexpr char MAGIC[8] = {'C', 'P', 'S', 'C', 'H', 'K', 'P', 'T'};
+
+    struct CheckpointHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t payloadSize;
+        uint64_t checksum;
+    };
+    static_assert(sizeof(CheckpointHeader) == 32, "Checkpoint header layout must not change");
+
+    enum ParticleFlags : uint8_t {
+        PARTICLE_DRAGGED = 1 << 0,
+        PARTICLE_FIXED = 1 << 1
+    };
+
+    uint64_t fnv1a(const unsigned char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Appends trivially copyable values to a byte buffer
+    class ByteWriter {
+    public:
+        template<typename T>
+        void put(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Only raw values are serialized");
+            size_t offset = m_bytes.size();
+            m_bytes.resize(offset + sizeof(T));
+            std::memcpy(m_bytes.data() + offset, &value, sizeof(T));
+        }
+
+        void putVector(const glm::dvec3& v) {
+            put(v.x);
+            put(v.y);
+            put(v.z);
+        }
+
+        void reserve(size_t size) { m_bytes.reserve(size); }
+        const std::vector<unsigned char>& bytes() const { return m_bytes; }
+
+    private:
+        std::vector<unsigned char> m_bytes;
+    };
+
+    // Bounds-checked reader; every get() fails once the data runs out
+    class ByteReader {
+    public:
+        ByteReader(const unsigned char* data, size_t size) : m_data(data), m_size(size), m_offset(0) {}
+
+        template<typename T>
+        bool get(T& value) {
+            if (m_size - m_offset < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, m_data + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return true;
+        }
+
+        bool getVector(glm::dvec3& v) {
+            return get(v.x) && get(v.y) && get(v.z);
+        }
+
+        size_t remaining() const { return m_size - m_offset; }
+
+    private:
+        const unsigned char* m_data;
+        size_t m_size;
+        size_t m_offset;
+    };
+
+    constexpr uint64_t MAX_HISTORY_CAPACITY = uint64_t(1) << 32;
+    constexpr size_t HISTORY_POINT_BYTES = 7 * sizeof(double);
+    constexpr size_t PARTICLE_BYTES = 11 * sizeof(double) + 4 * sizeof(float) + sizeof(uint8_t) + 2 * sizeof(uint64_t);
+
+    void putParticles(ByteWriter& out, const std::vector<Particle>& particles) {
+        out.put<uint64_t>(particles.size());
+        for (const Particle& p : particles) {
+            out.putVector(p.position);
+            out.putVector(p.velocity);
+            out.putVector(p.acceleration);
+            out.put(p.charge);
+            out.put(p.mass);
+            out.put(p.visualRadius);
+            out.put(p.color.r);
+            out.put(p.color.g);
+            out.put(p.color.b);
+            uint8_t flags = (p.isBeingDragged ? PARTICLE_DRAGGED : 0) | (p.isFixed ? PARTICLE_FIXED : 0);
+            out.put(flags);
+            out.put<uint64_t>(p.history.capacity());
+            out.put<uint64_t>(p.history.size());
+            for (size_t h = 0; h < p.history.size(); ++h) {
+                out.putVector(p.history.position(h));
+                out.putVector(p.history.velocity(h));
+                out.put(p.history.timestamp(h));
+            }
+        }
+    }
+
+    bool getParticles(ByteReader& in, uint32_t version, std::vector<Particle>& particles) {
+        const size_t particleBytes = PARTICLE_BYTES - (version < 2 ? sizeof(uint64_t) : 0);
+        uint64_t count;
+        if (!in.get(count) || count > in.remaining() / particleBytes) {
+            return false;
+        }
+        particles.assign(static_cast<size_t>(count), Particle());
+        for (Particle& p : particles) {
+            uint8_t flags;
+            uint64_t historyCapacity = Particle::MAX_HISTORY;  // Version 1 had a fixed capacity
+            uint64_t historySize;
+            if (!in.getVector(p.position) || !in.getVector(p.velocity) || !in.getVector(p.acceleration) ||
+                !in.get(p.charge) || !in.get(p.mass) || !in.get(p.visualRadius) ||
+                !in.get(p.color.r) || !in.get(p.color.g) || !in.get(p.color.b) ||
+                !in.get(flags) || (version >= 2 && !in.get(historyCapacity)) || !in.get(historySize) ||
+                historyCapacity == 0 || historyCapacity > MAX_HISTORY_CAPACITY ||
+                historySize > historyCapacity || historySize > in.remaining() / HISTORY_POINT_BYTES) {
+                return false;
+            }
+            p.isBeingDragged = (flags & PARTICLE_DRAGGED) != 0;
+            p.isFixed = (flags & PARTICLE_FIXED) != 0;
+            p.history.setCapacity(static_cast<size_t>(historyCapacity));
+            for (uint64_t h = 0; h < historySize; ++h) {
+                glm::dvec3 position;
+                glm::dvec3 velocity;
+                double timestamp;
+                if (!in.getVector(position) || !in.getVector(velocity) || !in.get(timestamp)) {
+                    return false;
+                }
+                p.history.record(timestamp, position, velocity);
+            }
+        }
+        return true;
+    }
+
+    bool getDoubles(ByteReader& in, std::vector<double>& values, size_t count) {
+        if (count > in.remaining() / sizeof(double)) {
+            return false;
+        }
+        values.resize(count);
+        for (double& v : values) {
+            in.get(v);
+        }
+        return true;
+    }
+
+    // Retarded history is stored oldest frame first, so head is always 0 on load
+    void putRetardedHistory(ByteWriter& out, const RetardedFieldSolver::History& history, size_t frames) {
+        out.put<uint64_t>(frames);
+        out.put<uint64_t>(history.capacity);
+        out.put<uint64_t>(history.particleCount);
+        out.put<uint64_t>(history.frames);
+        const size_t n = history.particleCount;
+        for (size_t f = 0; f < history.frames; ++f) {
+            size_t slot = (history.head + f) % history.capacity;
+            out.put(history.t[slot]);
+            for (const std::vector<double>* array : {&history.x, &history.y, &history.z,
+                                                     &history.vx, &history.vy, &history.vz}) {
+                for (size_t j = 0; j < n; ++j) {
+                    out.put((*array)[slot * n + j]);
+                }
+            }
+        }
+    }
+
+    bool getRetardedHistory(ByteReader& in, RetardedFieldSolver::History& history, size_t& frames) {
+        uint64_t historyFrames, capacity, particleCount, stored;
+        if (!in.get(historyFrames) || !in.get(capacity) || !in.get(particleCount) || !in.get(stored) ||
+            historyFrames > MAX_HISTORY_CAPACITY || capacity > MAX_HISTORY_CAPACITY || stored > capacity ||
+            (capacity > 0 && particleCount > in.remaining() / sizeof(double) / capacity)) {
+            return false;
+        }
+        const size_t n = static_cast<size_t>(particleCount);
+        const size_t values = static_cast<size_t>(capacity) * n;
+        frames = static_cast<size_t>(historyFrames);
+        history = RetardedFieldSolver::History();
+        history.capacity = static_cast<size_t>(capacity);
+        history.particleCount = n;
+        history.frames = static_cast<size_t>(stored);
+        history.t.assign(history.capacity, 0.0);
+        for (std::vector<double>* array : {&history.x, &history.y, &history.z,
+                                           &history.vx, &history.vy, &history.vz}) {
+            array->assign(values, 0.0);
+        }
+        std::vector<double> frame;
+        for (size_t f = 0; f < history.frames; ++f) {
+            if (!in.get(history.t[f])) {
+                return false;
+            }
+            for (std::vector<double>* array : {&history.x, &history.y, &history.z,
+                                               &history.vx, &history.vy, &history.vz}) {
+                if (!getDoubles(in, frame, n)) {
+                    return false;
+                }
+                std::copy(frame.begin(), frame.end(), array->begin() + f * n);
+            }
+        }
+        return true;
+    }
+
+    void putTimeStepState(ByteWriter& out, const ParticleSystem::Snapshot& snapshot) {
+        out.put(static_cast<uint32_t>(snapshot.timeStepMode));
+        out.put(snapshot.timeStepAccuracy);
+        out.put<int32_t>(snapshot.maxTimeStepLevel);
+        out.put<uint8_t>(snapshot.timeStepStateValid ? 1 : 0);
+        out.put<uint64_t>(snapshot.timeStepLevels.size());
+        for (size_t i = 0; i < snapshot.timeStepLevels.size(); ++i) {
+            out.put(snapshot.timeStepLevels[i]);
+            out.putVector(snapshot.previousAccelerations[i]);
+        }
+    }
+
+    bool getTimeStepState(ByteReader& in, ParticleSystem::Snapshot& snapshot) {
+        uint32_t mode;
+        int32_t maxLevel;
+        uint8_t valid;
+        uint64_t count;
+        const size_t entryBytes = sizeof(uint8_t) + 3 * sizeof(double);
+        if (!in.get(mode) || !in.get(snapshot.timeStepAccuracy) || !in.get(maxLevel) ||
+            !in.get(valid) || !in.get(count) ||
+            mode > static_cast<uint32_t>(ParticleSystem::TimeStepMode::BLOCK) ||
+            maxLevel < 0 || maxLevel > ParticleSystem::MAX_TIME_STEP_LEVEL ||
+            !(snapshot.timeStepAccuracy > 0.0) || count > in.remaining() / entryBytes) {
+            return false;
+        }
+        snapshot.timeStepMode = static_cast<ParticleSystem::TimeStepMode>(mode);
+        snapshot.maxTimeStepLevel = maxLevel;
+        snapshot.timeStepStateValid = valid != 0;
+        snapshot.timeStepLevels.resize(static_cast<size_t>(count));
+        snapshot.previousAccelerations.resize(static_cast<size_t>(count));
+        for (size_t i = 0; i < snapshot.timeStepLevels.size(); ++i) {
+            if (!in.get(snapshot.timeStepLevels[i]) || !in.getVector(snapshot.previousAccelerations[i]) ||
+                snapshot.timeStepLevels[i] > maxLevel) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void putPeriodicState(ByteWriter& out, const ParticleSystem::Snapshot& snapshot) {
+        out.put<uint8_t>(snapshot.periodic ? 1 : 0);
+        out.putVector(snapshot.periodicLow);
+        out.putVector(snapshot.periodicHigh);
+        out.put<int32_t>(snapshot.meshSize);
+        out.put(static_cast<uint32_t>(snapshot.chargeAssignment));
+        out.put(snapshot.shortRangeCutoff);
+    }
+
+    bool getPeriodicState(ByteReader& in, ParticleSystem::Snapshot& snapshot) {
+        uint8_t periodic;
+        int32_t meshSize;
+        uint32_t assignment;
+        if (!in.get(periodic) || !in.getVector(snapshot.periodicLow) || !in.getVector(snapshot.periodicHigh) ||
+            !in.get(meshSize) || !in.get(assignment) || !in.get(snapshot.shortRangeCutoff) ||
+            meshSize < 0 || meshSize > P3MSolver::MAX_MESH_SIZE ||
+            assignment > static_cast<uint32_t>(P3MSolver::Assignment::TSC) ||
+            (periodic != 0 && !PeriodicBox(snapshot.periodicLow, snapshot.periodicHigh).isValid())) {
+            return false;
+        }
+        snapshot.periodic = periodic != 0;
+        snapshot.meshSize = meshSize;
+        snapshot.chargeAssignment = static_cast<P3MSolver::Assignment>(assignment);
+        return true;
+    }
+
+    void putEwaldState(ByteWriter& out, const ParticleSystem::Snapshot& snapshot) {
+        out.put(snapshot.ewaldAccuracy);
+    }
+
+    bool getEwaldState(ByteReader& in, ParticleSystem::Snapshot& snapshot) {
+        return in.get(snapshot.ewaldAccuracy) &&
+               snapshot.ewaldAccuracy >= EwaldSolver::MIN_ACCURACY && snapshot.ewaldAccuracy <= EwaldSolver::MAX_ACCURACY;
+    }
+
+    size_t estimateSize(const std::vector<Particle>& particles) {
+        size_t size = sizeof(uint64_t) + particles.size() * PARTICLE_BYTES;
+        for (const Particle& p : particles) {
+            size += p.history.size() * HISTORY_POINT_BYTES;
+        }
+        return size;
+    }
+}
+
+bool Checkpoint::write(const std::string& path, const ParticleSystem::Snapshot& snapshot, std::string& error) {
+    // Serialize to memory first: one large write instead of many small ones
+    ByteWriter payload;
+    const RetardedFieldSolver::History& retarded = snapshot.retardedHistory;
+    payload.reserve(256 + estimateSize(snapshot.particles) + estimateSize(snapshot.initialParticles) +
+                    retarded.frames * (1 + 6 * retarded.particleCount) * sizeof(double) +
+                    snapshot.timeStepLevels.size() * (1 + 3 * sizeof(double)));
+    payload.put(static_cast<uint32_t>(snapshot.integrationMethod));
+    payload.put(static_cast<uint32_t>(snapshot.forceMethod));
+    payload.put<uint8_t>(snapshot.collisionPrevention ? 1 : 0);
+    payload.put(snapshot.minSeparation);
+    payload.put(snapshot.stepCount);
+    payload.put(snapshot.simulationTime);
+    payload.put(snapshot.treeOpeningAngle);
+    payload.put(snapshot.fmmOpeningAngle);
+    payload.put<int32_t>(snapshot.expansionOrder);
+    payload.put<int32_t>(snapshot.forceErrorSampleCount);
+    payload.put<int32_t>(snapshot.forceErrorSampleInterval);
+    payload.put(snapshot.forceErrorTolerance);
+    payload.put(snapshot.forceErrorStats.maxRelativeError);
+    payload.put(snapshot.forceErrorStats.rmsRelativeError);
+    payload.put<uint64_t>(snapshot.forceErrorStats.sampleCount);
+    payload.put<uint64_t>(snapshot.forceErrorStats.stepIndex);
+    putParticles(payload, snapshot.particles);
+    putParticles(payload, snapshot.initialParticles);
+    putRetardedHistory(payload, snapshot.retardedHistory, snapshot.retardedHistoryFrames);
+    payload.put<uint8_t>(snapshot.magneticInteraction ? 1 : 0);
+    payload.putVector(snapshot.externalElectric);
+    payload.putVector(snapshot.externalMagnetic);
+    payload.put<uint8_t>(snapshot.forcesCurrent ? 1 : 0);
+    putTimeStepState(payload, snapshot);
+    putPeriodicState(payload, snapshot);
+    putEwaldState(payload, snapshot);
+
+    const std::vector<unsigned char>& bytes = payload.bytes();
+    CheckpointHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.reserved = 0;
+    header.payloadSize = bytes.size();
+    header.checksum = fnv1a(bytes.data(), bytes.size());
+
+    const std::string tempPath = path + ".tmp";
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        error = tempPath + ": cannot create checkpoint file";
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        error = tempPath + ": checkpoint write failed";
+        return false;
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename(tempPath, path, renameError);
+    if (renameError) {
+        std::remove(tempPath.c_str());
+        error = path + ": cannot replace checkpoint (" + renameError.message() + ")";
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::read(const std::string& path, ParticleSystem::Snapshot& snapshot, std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = path + ": cannot open checkpoint file";
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::fclose(file);
+        error = path + ": not a checkpoint file";
+        return false;
+    }
+    if (header.version < 1 || header.version > VERSION) {
+        std::fclose(file);
+        error = path + ": unsupported checkpoint version " + std::to_string(header.version);
+        return false;
+    }
+
+    std::vector<unsigned char> bytes;
+    bool ok = header.payloadSize < (uint64_t(1) << 40);
+    if (ok) {
+        bytes.resize(static_cast<size_t>(header.payloadSize));
+        ok = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    }
+    std::fclose(file);
+    if (!ok || fnv1a(bytes.data(), bytes.size()) != header.checksum) {
+        error = path + ": checkpoint is truncated or corrupt";
+        return false;
+    }
+
+    ParticleSystem::Snapshot result;
+    ByteReader in(bytes.data(), bytes.size());
+    uint32_t integrationMethod;
+    uint32_t forceMethod;
+    uint8_t collisionPrevention;
+    int32_t expansionOrder;
+    int32_t sampleCount;
+    int32_t sampleInterval;
+    uint64_t statsSampleCount;
+    uint64_t statsStepIndex;
+    uint8_t magneticInteraction = 0;
+    uint8_t forcesCurrent = 0;
+    ok = in.get(integrationMethod) && in.get(forceMethod) && in.get(collisionPrevention) &&
+         in.get(result.minSeparation) && in.get(result.stepCount) && in.get(result.simulationTime) &&
+         in.get(result.treeOpeningAngle) && in.get(result.fmmOpeningAngle) &&
+         in.get(expansionOrder) && in.get(sampleCount) && in.get(sampleInterval) &&
+         in.get(result.forceErrorTolerance) &&
+         in.get(result.forceErrorStats.maxRelativeError) && in.get(result.forceErrorStats.rmsRelativeError) &&
+         in.get(statsSampleCount) && in.get(statsStepIndex) &&
+         getParticles(in, header.version, result.particles) &&
+         getParticles(in, header.version, result.initialParticles) &&
+         (header.version < 3 || getRetardedHistory(in, result.retardedHistory, result.retardedHistoryFrames)) &&
+         (header.version < 4 || (in.get(magneticInteraction) && in.getVector(result.externalElectric) &&
+                                 in.getVector(result.externalMagnetic))) &&
+         (header.version < 5 || in.get(forcesCurrent)) &&
+         (header.version < 6 || getTimeStepState(in, result)) &&
+         (header.version < 7 || getPeriodicState(in, result)) &&
+         (header.version < 8 || getEwaldState(in, result)) &&
+         in.remaining() == 0;
+    if (!ok ||
+        integrationMethod > static_cast<uint32_t>(ParticleSystem::IntegrationMethod::RK4) ||
+        forceMethod > static_cast<uint32_t>(ParticleSystem::ForceMethod::EWALD)) {
+        error = path + ": invalid checkpoint contents";
+        return false;
+    }
+
+    result.integrationMethod = static_cast<ParticleSystem::IntegrationMethod>(integrationMethod);
+    result.forceMethod = static_cast<ParticleSystem::ForceMethod>(forceMethod);
+    result.collisionPrevention = collisionPrevention != 0;
+    result.magneticInteraction = magneticInteraction != 0;
+    result.forcesCurrent = forcesCurrent != 0;
+    result.expansionOrder = expansionOrder;
+    result.forceErrorSampleCount = sampleCount;
+    result.forceErrorSampleInterval = sampleInterval;
+    result.forceErrorStats.sampleCount = static_cast<size_t>(statsSampleCount);
+    result.forceErrorStats.stepIndex = static_cast<size_t>(statsStepIndex);
+    snapshot = std::move(result);
+    return true;
+}
+
+bool Checkpoint::save(const std::string& path, const ParticleSystem& system, std::string& error) {
+    return write(path, system.createSnapshot(), error);
+}
+
+bool Checkpoint::load(const std::string& path, ParticleSystem& system, std::string& error) {
+    ParticleSystem::Snapshot snapshot;
+    if (!read(path, snapshot, error)) {
+        return false;
+    }
+    system.restoreSnapshot(snapshot);
+    return true;
+}
+
+CheckpointWriter::CheckpointWriter()
+    : m_writing(false)
+    , m_stop(false)
+    , m_failed(false)
+    , m_written(0)
+    , m_skipped(0)
+{
+    m_thread = std::thread(&CheckpointWriter::writerLoop, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_pendingCondition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void CheckpointWriter::save(const ParticleSystem& system, const std::string& path) {
+    // The copy is the only work done on the simulation thread
+    auto request = std::make_unique<Request>();
+    request->snapshot = system.createSnapshot();
+    request->path = path;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pending) {
+            ++m_skipped;
+        }
+        m_pending = std::move(request);
+    }
+    m_pendingCondition.notify_one();
+}
+
+bool CheckpointWriter::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return !m_pending && !m_writing; });
+    bool ok = !m_failed;
+    m_failed = false;
+    return ok;
+}
+
+uint64_t CheckpointWriter::getWrittenCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+uint64_t CheckpointWriter::getSkippedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_skipped;
+}
+
+void CheckpointWriter::writerLoop() {
+    while (true) {
+        std::unique_ptr<Request> request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_pendingCondition.wait(lock, [this] { return m_pending || m_stop; });
+            if (!m_pending) {
+                return;  // Stopped with nothing left to write
+            }
+            request = std::move(m_pending);
+            m_writing = true;
+        }
+
+        std::string error;
+        bool ok = Checkpoint::write(request->path, request->snapshot, error);
+        if (!ok) {
+            LOG_ERROR(error);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writing = false;
+            if (ok) {
+                ++m_written;
+            } else {
+                m_failed = true;
+            }
+        }
+        m_idleCondition.notify_all();
+    }
+}
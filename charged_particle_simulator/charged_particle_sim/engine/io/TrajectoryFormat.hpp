@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Binary Trajectory Format (.cpstraj)
+ *
+ * Layout (native little-endian byte order):
+ *
+ *   TrajectoryHeader                      64 bytes
+ *   charges[particleCount]                float64, coulombs
+ *   masses[particleCount]                 float64, kilograms
+ *   (padding to frameDataOffset, 64-byte aligned)
+ *   frames[frameCount]                    fixed stride, see below
+ *   index[frameCount]                     optional TrajectoryIndexEntry table
+ *
+ * Each frame is a TrajectoryFrameHeader followed by interleaved x,y,z positions
+ * (and, if stored, interleaved velocities) for every particle, as float64 or
+ * float32, padded to a multiple of 8 bytes. The fixed stride gives O(1) random
+ * access to any frame from a memory mapping.
+ *
+ * frameCount and indexOffset are written when the file is closed. A file whose
+ * writer did not finish has frameCount 0; readers then recover the frames from
+ * the file size and ignore the index.
+ */
+namespace TrajectoryFormat {
+    constexpr char MAGIC[8] = {'C', 'P', 'S', 'T', 'R', 'A', 'J', '\0'};
+    constexpr uint32_t VERSION = 1;
+
+    // Header flags
+    constexpr uint32_t FLAG_FLOAT32 = 1u << 0;      // Frame data is float32 (else float64)
+    constexpr uint32_t FLAG_VELOCITIES = 1u << 1;   // Frames also store velocities
+    constexpr uint32_t FLAG_INDEX = 1u << 2;        // Per-frame index follows the frames
+
+    constexpr size_t DATA_ALIGNMENT = 64;
+
+    struct TrajectoryHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t particleCount;
+        double dt;                  // Simulation time step (seconds)
+        uint64_t frameCount;        // 0 while the file is being written
+        uint64_t indexOffset;       // Byte offset of the index (0 = none)
+        uint64_t frameDataOffset;   // Byte offset of the first frame
+        uint64_t frameStride;       // Bytes per frame
+    };
+    static_assert(sizeof(TrajectoryHeader) == 64, "Trajectory header must be 64 bytes");
+
+    struct TrajectoryFrameHeader {
+        uint64_t step;              // Simulation step number
+        double time;                // Simulation time (seconds)
+    };
+    static_assert(sizeof(TrajectoryFrameHeader) == 16, "Frame header must be 16 bytes");
+
+    struct TrajectoryIndexEntry {
+        uint64_t step;
+        double time;
+        uint64_t offset;            // Byte offset of the frame in the file
+    };
+    static_assert(sizeof(TrajectoryIndexEntry) == 24, "Index entry must be 24 bytes");
+
+    /**
+     * Bytes per frame for a particle count and storage options
+     */
+    inline uint64_t frameStride(uint64_t particleCount, bool float32, bool velocities) {
+        uint64_t scalar = float32 ? 4 : 8;
+        uint64_t vectors = velocities ? 2 : 1;
+        uint64_t bytes = sizeof(TrajectoryFrameHeader) + particleCount * 3 * scalar * vectors;
+        return (bytes + 7) & ~uint64_t(7);
+    }
+
+    /**
+     * Byte offset of the first frame (after the header and charge/mass tables)
+     */
+    inline uint64_t frameDataOffset(uint64_t particleCount) {
+        uint64_t bytes = sizeof(TrajectoryHeader) + 2 * particleCount * sizeof(double);
+        return (bytes + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    }
+}
@@ -0,0 +1,245 @@
+#include "TrajectoryReader.hpp"
+#include <cstddef>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace TrajectoryFormat;
+
+namespace {
+    // Frame fields are read with memcpy: the mapping gives no alignment guarantee
+    // to the compiler even though the format keeps everything 8-byte aligned
+    template<typename T>
+    T load(const unsigned char* p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+}
+
+TrajectoryReader::TrajectoryReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_header()
+    , m_frameCount(0)
+    , m_index(nullptr)
+#ifdef _WIN32
+    , m_fileHandle(nullptr)
+    , m_mappingHandle(nullptr)
+#endif
+{
+}
+
+TrajectoryReader::~TrajectoryReader() {
+    close();
+}
+
+bool TrajectoryReader::open(const std::string& path, std::string& error) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = path + ": cannot open trajectory file";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        error = path + ": empty or unreadable trajectory file";
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        error = path + ": cannot map trajectory file";
+        return false;
+    }
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": cannot open trajectory file";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        error = path + ": empty or unreadable trajectory file";
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        error = path + ": cannot map trajectory file";
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+
+    // Validate the header before trusting any offsets
+    auto fail = [&](const std::string& message) {
+        close();
+        error = path + ": " + message;
+        return false;
+    };
+    if (m_size < sizeof(TrajectoryHeader)) {
+        return fail("file too small for a trajectory header");
+    }
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    if (std::memcmp(m_header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("not a trajectory file");
+    }
+    if (m_header.version != VERSION) {
+        return fail("unsupported trajectory version " + std::to_string(m_header.version));
+    }
+    const uint64_t count = m_header.particleCount;
+    if (m_header.frameDataOffset != frameDataOffset(count) ||
+        m_header.frameStride != frameStride(count, isFloat32(), hasVelocities()) ||
+        m_header.frameDataOffset > m_size) {
+        return fail("inconsistent trajectory header");
+    }
+
+    uint64_t available = (m_size - m_header.frameDataOffset) / m_header.frameStride;
+    if (m_header.frameCount == 0) {
+        // Unfinished file: every complete frame on disk is usable, the index is not
+        m_frameCount = static_cast<size_t>(available);
+        m_header.flags &= ~FLAG_INDEX;
+    } else {
+        if (m_header.frameCount > available) {
+            return fail("truncated trajectory file");
+        }
+        m_frameCount = static_cast<size_t>(m_header.frameCount);
+    }
+
+    if ((m_header.flags & FLAG_INDEX) != 0) {
+        uint64_t indexEnd = m_header.indexOffset + m_frameCount * sizeof(TrajectoryIndexEntry);
+        if (m_header.indexOffset < m_header.frameDataOffset || indexEnd > m_size || m_header.indexOffset % 8 != 0) {
+            return fail("invalid trajectory index");
+        }
+        m_index = reinterpret_cast<const TrajectoryIndexEntry*>(m_data + m_header.indexOffset);
+    }
+
+    return true;
+}
+
+void TrajectoryReader::close() {
+    if (m_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+        m_mappingHandle = nullptr;
+        m_fileHandle = nullptr;
+#else
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_header = TrajectoryHeader();
+    m_frameCount = 0;
+    m_index = nullptr;
+}
+
+const double* TrajectoryReader::getCharges() const {
+    return reinterpret_cast<const double*>(m_data + sizeof(TrajectoryHeader));
+}
+
+const double* TrajectoryReader::getMasses() const {
+    return getCharges() + m_header.particleCount;
+}
+
+const unsigned char* TrajectoryReader::frameAddress(size_t frame) const {
+    return m_data + m_header.frameDataOffset + frame * m_header.frameStride;
+}
+
+uint64_t TrajectoryReader::getFrameStep(size_t frame) const {
+    return load<uint64_t>(frameAddress(frame) + offsetof(TrajectoryFrameHeader, step));
+}
+
+double TrajectoryReader::getFrameTime(size_t frame) const {
+    return load<double>(frameAddress(frame) + offsetof(TrajectoryFrameHeader, time));
+}
+
+const void* TrajectoryReader::getPositionData(size_t frame) const {
+    return frameAddress(frame) + sizeof(TrajectoryFrameHeader);
+}
+
+const void* TrajectoryReader::getVelocityData(size_t frame) const {
+    if (!hasVelocities()) {
+        return nullptr;
+    }
+    size_t scalar = isFloat32() ? sizeof(float) : sizeof(double);
+    return frameAddress(frame) + sizeof(TrajectoryFrameHeader) + m_header.particleCount * 3 * scalar;
+}
+
+glm::dvec3 TrajectoryReader::readVector(const unsigned char* data, size_t particle) const {
+    if (isFloat32()) {
+        const unsigned char* p = data + particle * 3 * sizeof(float);
+        return glm::dvec3(load<float>(p), load<float>(p + 4), load<float>(p + 8));
+    }
+    const unsigned char* p = data + particle * 3 * sizeof(double);
+    return glm::dvec3(load<double>(p), load<double>(p + 8), load<double>(p + 16));
+}
+
+glm::dvec3 TrajectoryReader::getPosition(size_t frame, size_t particle) const {
+    return readVector(static_cast<const unsigned char*>(getPositionData(frame)), particle);
+}
+
+glm::dvec3 TrajectoryReader::getVelocity(size_t frame, size_t particle) const {
+    const void* data = getVelocityData(frame);
+    if (!data) {
+        return glm::dvec3(0.0);
+    }
+    return readVector(static_cast<const unsigned char*>(data), particle);
+}
+
+size_t TrajectoryReader::findFrameByStep(uint64_t step) const {
+    size_t low = 0;
+    size_t high = m_frameCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        uint64_t midStep = m_index ? m_index[mid].step : getFrameStep(mid);
+        if (midStep < step) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+size_t TrajectoryReader::findFrameByTime(double time) const {
+    size_t low = 0;
+    size_t high = m_frameCount;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        double midTime = m_index ? m_index[mid].time : getFrameTime(mid);
+        if (midTime < time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
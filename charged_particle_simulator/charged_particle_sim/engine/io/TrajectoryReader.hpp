@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+#include "TrajectoryFormat.hpp"
+
+/**
+ * Memory-Mapped Trajectory Reader
+ *
+ * Maps a trajectory file (see TrajectoryFormat.hpp) read-only. Frames are read
+ * straight from the mapping: getPositionData() returns a pointer into the file
+ * with no copy, and any frame is reached in O(1) from the fixed frame stride.
+ * Pages are loaded by the OS on first touch, so opening a large file is cheap.
+ *
+ * Files left unfinished by a crashed writer are readable up to the last complete
+ * frame.
+ */
+class TrajectoryReader {
+public:
+    TrajectoryReader();
+    ~TrajectoryReader();
+
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    /**
+     * Map a trajectory file
+     *
+     * @param path Trajectory file
+     * @param error Set to a description on failure
+     * @return false if the file cannot be mapped or is not a valid trajectory
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * Unmap the file (pointers from getPositionData() etc. become invalid)
+     */
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    size_t getParticleCount() const { return static_cast<size_t>(m_header.particleCount); }
+    size_t getFrameCount() const { return m_frameCount; }
+    double getTimeStep() const { return m_header.dt; }
+    bool isFloat32() const { return (m_header.flags & TrajectoryFormat::FLAG_FLOAT32) != 0; }
+    bool hasVelocities() const { return (m_header.flags & TrajectoryFormat::FLAG_VELOCITIES) != 0; }
+    bool hasIndex() const { return m_index != nullptr; }
+
+    /**
+     * Charge and mass tables (particleCount entries, pointers into the mapping)
+     */
+    const double* getCharges() const;
+    const double* getMasses() const;
+
+    /**
+     * Step number and simulation time of a frame
+     */
+    uint64_t getFrameStep(size_t frame) const;
+    double getFrameTime(size_t frame) const;
+
+    /**
+     * Position / velocity of one particle in a frame (converted to double)
+     */
+    glm::dvec3 getPosition(size_t frame, size_t particle) const;
+    glm::dvec3 getVelocity(size_t frame, size_t particle) const;
+
+    /**
+     * Interleaved x,y,z positions of a frame, zero-copy
+     * (double* or float* depending on isFloat32())
+     */
+    const void* getPositionData(size_t frame) const;
+
+    /**
+     * Interleaved x,y,z velocities of a frame, zero-copy (nullptr if not stored)
+     */
+    const void* getVelocityData(size_t frame) const;
+
+    /**
+     * First frame whose step is >= step (getFrameCount() if none)
+     * Binary search over the index if present, otherwise over the frame headers.
+     */
+    size_t findFrameByStep(uint64_t step) const;
+
+    /**
+     * First frame whose time is >= time (getFrameCount() if none)
+     */
+    size_t findFrameByTime(double time) const;
+
+private:
+    const unsigned char* frameAddress(size_t frame) const;
+    glm::dvec3 readVector(const unsigned char* data, size_t particle) const;
+
+    const unsigned char* m_data;
+    size_t m_size;
+    TrajectoryFormat::TrajectoryHeader m_header;
+    size_t m_frameCount;
+    const TrajectoryFormat::TrajectoryIndexEntry* m_index;
+
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#endif
+};
@@ -0,0 +1,246 @@
+#include "TrajectoryWriter.hpp"
+#include "engine/core/Logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace TrajectoryFormat;
+
+namespace {
+    template<typename Scalar>
+    void packVectors(const std::vector<Particle>& particles, bool velocities, unsigned char* out) {
+        Scalar* data = reinterpret_cast<Scalar*>(out);
+        for (const auto& p : particles) {
+            *data++ = static_cast<Scalar>(p.position.x);
+            *data++ = static_cast<Scalar>(p.position.y);
+            *data++ = static_cast<Scalar>(p.position.z);
+        }
+        if (velocities) {
+            for (const auto& p : particles) {
+                *data++ = static_cast<Scalar>(p.velocity.x);
+                *data++ = static_cast<Scalar>(p.velocity.y);
+                *data++ = static_cast<Scalar>(p.velocity.z);
+            }
+        }
+    }
+}
+
+TrajectoryWriter::TrajectoryWriter()
+    : m_file(nullptr)
+    , m_header()
+    , m_stop(false)
+    , m_failed(false)
+{
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+bool TrajectoryWriter::open(
+    const std::string& path,
+    const std::vector<Particle>& particles,
+    double dt,
+    const Options& options
+) {
+    close();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        LOG_ERROR("Cannot create trajectory file " + path);
+        return false;
+    }
+
+    m_options = options;
+    const uint64_t count = particles.size();
+    const bool float32 = options.precision == Precision::FLOAT32;
+
+    std::memset(&m_header, 0, sizeof(m_header));
+    std::memcpy(m_header.magic, MAGIC, sizeof(MAGIC));
+    m_header.version = VERSION;
+    m_header.flags = (float32 ? FLAG_FLOAT32 : 0u) | (options.velocities ? FLAG_VELOCITIES : 0u);
+    m_header.particleCount = count;
+    m_header.dt = dt;
+    m_header.frameDataOffset = TrajectoryFormat::frameDataOffset(count);
+    m_header.frameStride = TrajectoryFormat::frameStride(count, float32, options.velocities);
+
+    // Header (frame count patched on close), charge/mass tables, padding
+    std::vector<double> table(count);
+    bool ok = std::fwrite(&m_header, sizeof(m_header), 1, m_file) == 1;
+    for (size_t i = 0; i < count; ++i) {
+        table[i] = particles[i].charge;
+    }
+    ok = ok && (count == 0 || std::fwrite(table.data(), sizeof(double), count, m_file) == count);
+    for (size_t i = 0; i < count; ++i) {
+        table[i] = particles[i].mass;
+    }
+    ok = ok && (count == 0 || std::fwrite(table.data(), sizeof(double), count, m_file) == count);
+    size_t padding = m_header.frameDataOffset - sizeof(m_header) - 2 * count * sizeof(double);
+    std::vector<unsigned char> zeros(padding, 0);
+    ok = ok && (padding == 0 || std::fwrite(zeros.data(), 1, padding, m_file) == padding);
+    if (!ok) {
+        LOG_ERROR("Failed to write trajectory header to " + path);
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+
+    // Preallocate the frame buffers: no allocation on the simulation thread
+    size_t bufferCount = std::max<size_t>(1, options.bufferFrames);
+    m_buffers.assign(bufferCount, Buffer());
+    m_free.clear();
+    for (size_t i = 0; i < bufferCount; ++i) {
+        m_buffers[i].data.assign(m_header.frameStride, 0);
+        m_free.push_back(i);
+    }
+    m_ready.clear();
+    m_index.clear();
+    m_stop = false;
+    m_failed = false;
+    m_stats = Stats();
+    m_stats.bytesWritten = m_header.frameDataOffset;
+
+    m_thread = std::thread(&TrajectoryWriter::writerLoop, this);
+
+    LOG_INFO("Writing trajectory " + path + " (" + std::to_string(count) + " particles, " +
+             std::to_string(m_header.frameStride) + " bytes/frame)");
+    return true;
+}
+
+bool TrajectoryWriter::writeFrame(const std::vector<Particle>& particles, uint64_t step, double time) {
+    if (!m_file || particles.size() != m_header.particleCount) {
+        return false;
+    }
+
+    size_t slot;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_failed) {
+            return false;
+        }
+        if (m_free.empty() && m_options.blockWhenFull) {
+            m_freeCondition.wait(lock, [this] { return !m_free.empty() || m_failed; });
+        }
+        if (m_free.empty() || m_failed) {
+            ++m_stats.framesDropped;
+            return false;
+        }
+        slot = m_free.back();
+        m_free.pop_back();
+    }
+
+    // Pack outside the lock; the buffer belongs to this thread until queued
+    packFrame(particles, step, time, m_buffers[slot]);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(slot);
+        ++m_stats.framesQueued;
+    }
+    m_readyCondition.notify_one();
+    return true;
+}
+
+void TrajectoryWriter::packFrame(
+    const std::vector<Particle>& particles,
+    uint64_t step,
+    double time,
+    Buffer& buffer
+) const {
+    buffer.step = step;
+    buffer.time = time;
+
+    TrajectoryFrameHeader frame;
+    frame.step = step;
+    frame.time = time;
+    std::memcpy(buffer.data.data(), &frame, sizeof(frame));
+
+    unsigned char* payload = buffer.data.data() + sizeof(frame);
+    if (m_options.precision == Precision::FLOAT32) {
+        packVectors<float>(particles, m_options.velocities, payload);
+    } else {
+        packVectors<double>(particles, m_options.velocities, payload);
+    }
+}
+
+void TrajectoryWriter::writerLoop() {
+    while (true) {
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_readyCondition.wait(lock, [this] { return !m_ready.empty() || m_stop; });
+            if (m_ready.empty()) {
+                return;  // Stopped and drained
+            }
+            slot = m_ready.front();
+            m_ready.pop_front();
+        }
+
+        const Buffer& buffer = m_buffers[slot];
+        bool ok = std::fwrite(buffer.data.data(), 1, buffer.data.size(), m_file) == buffer.data.size();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (ok) {
+                TrajectoryIndexEntry entry;
+                entry.step = buffer.step;
+                entry.time = buffer.time;
+                entry.offset = m_header.frameDataOffset + m_stats.framesWritten * m_header.frameStride;
+                m_index.push_back(entry);
+                ++m_stats.framesWritten;
+                m_stats.bytesWritten += buffer.data.size();
+            } else if (!m_failed) {
+                m_failed = true;
+                LOG_ERROR("Trajectory write failed after " + std::to_string(m_stats.framesWritten) + " frames");
+            }
+            m_free.push_back(slot);
+        }
+        m_freeCondition.notify_one();
+    }
+}
+
+bool TrajectoryWriter::close() {
+    if (!m_file) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_readyCondition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    bool ok = !m_failed;
+    m_header.frameCount = m_stats.framesWritten;
+
+    if (ok && m_options.frameIndex) {
+        m_header.indexOffset = m_header.frameDataOffset + m_header.frameCount * m_header.frameStride;
+        m_header.flags |= FLAG_INDEX;
+        ok = m_index.empty() ||
+             std::fwrite(m_index.data(), sizeof(TrajectoryIndexEntry), m_index.size(), m_file) == m_index.size();
+        m_stats.bytesWritten += m_index.size() * sizeof(TrajectoryIndexEntry);
+    }
+
+    // Final header makes the file complete
+    if (ok) {
+        ok = std::fseek(m_file, 0, SEEK_SET) == 0 &&
+             std::fwrite(&m_header, sizeof(m_header), 1, m_file) == 1;
+    }
+    ok = (std::fclose(m_file) == 0) && ok;
+    m_file = nullptr;
+
+    if (!ok) {
+        LOG_ERROR("Trajectory file was not finalized");
+    } else if (m_stats.framesDropped > 0) {
+        LOG_WARN("Trajectory writer dropped " + std::to_string(m_stats.framesDropped) +
+                 " frames (disk slower than output rate)");
+    }
+    return ok;
+}
+
+TrajectoryWriter::Stats TrajectoryWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TrajectoryFormat.hpp"
+#include "engine/physics/Particle.hpp"
+
+/**
+ * Streaming Trajectory Writer
+ *
+ * Writes the binary trajectory format (see TrajectoryFormat.hpp) from a background
+ * thread. writeFrame() only packs the particle state into one of a fixed number of
+ * preallocated frame buffers and queues it; the disk write happens on the writer
+ * thread. Memory use is bounded by the buffer count.
+ *
+ * When every buffer is waiting for the disk, writeFrame() drops the frame (and
+ * counts it in Stats::framesDropped) rather than stalling the simulation, unless
+ * Options::blockWhenFull is set.
+ *
+ * writeFrame() must be called from one thread at a time (the simulation thread).
+ */
+class TrajectoryWriter {
+public:
+    enum class Precision {
+        FLOAT64,
+        FLOAT32
+    };
+
+    struct Options {
+        Precision precision = Precision::FLOAT64;
+        bool velocities = true;         // Store velocities next to positions
+        bool frameIndex = true;         // Append a step/time/offset index on close
+        size_t bufferFrames = 32;       // Frames that can wait for the disk
+        bool blockWhenFull = false;     // Wait for a free buffer instead of dropping
+    };
+
+    struct Stats {
+        uint64_t framesQueued = 0;      // Accepted by writeFrame()
+        uint64_t framesWritten = 0;     // Written to disk
+        uint64_t framesDropped = 0;     // Rejected because all buffers were full
+        uint64_t bytesWritten = 0;
+    };
+
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /**
+     * Create a trajectory file and start the writer thread
+     *
+     * Charges and masses are taken from `particles`; every frame must have the
+     * same particle count.
+     *
+     * @param path Output file (overwritten)
+     * @param particles Initial particles (count, charge and mass tables)
+     * @param dt Simulation time step stored in the header
+     * @param options Storage and buffering options
+     * @return false if the file cannot be created
+     */
+    bool open(
+        const std::string& path,
+        const std::vector<Particle>& particles,
+        double dt,
+        const Options& options
+    );
+    bool open(const std::string& path, const std::vector<Particle>& particles, double dt) {
+        return open(path, particles, dt, Options());
+    }
+
+    /**
+     * Queue one frame
+     *
+     * @return false if the frame was dropped (buffers full, wrong particle count,
+     *         writer closed or failed)
+     */
+    bool writeFrame(const std::vector<Particle>& particles, uint64_t step, double time);
+
+    /**
+     * Write all queued frames, the index and the final header, then close the file
+     *
+     * @return false if any write failed
+     */
+    bool close();
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * Frame counters (safe to call from any thread)
+     */
+    Stats getStats() const;
+
+private:
+    struct Buffer {
+        std::vector<unsigned char> data;
+        uint64_t step = 0;
+        double time = 0.0;
+    };
+
+    void writerLoop();
+    void packFrame(const std::vector<Particle>& particles, uint64_t step, double time, Buffer& buffer) const;
+
+    std::FILE* m_file;
+    TrajectoryFormat::TrajectoryHeader m_header;
+    Options m_options;
+
+    // Buffer pool: m_free -> (simulation thread packs) -> m_ready -> (writer thread) -> m_free
+    std::vector<Buffer> m_buffers;
+    std::vector<size_t> m_free;
+    std::deque<size_t> m_ready;
+    bool m_stop;
+    bool m_failed;
+    Stats m_stats;
+    std::vector<TrajectoryFormat::TrajectoryIndexEntry> m_index;  // Writer thread only
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_readyCondition;
+    std::condition_variable m_freeCondition;
+    std::thread m_thread;
+};
@@ -0,0 +1,138 @@
+#include "Fft.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Strided lines are gathered this many at a time: neighbouring lines share
+    // cache lines, so a block uses every value it loads
+    constexpr size_t LINE_BLOCK = 8;
+
+    /**
+     * Transform the lines start + k * stride (k < plan.size()), where
+     * start = outer * outerStride + inner for outer < outerCount, inner < innerCount
+     */
+    void transformLines(
+        Fft::Complex* data, const Fft& plan, size_t stride,
+        size_t outerCount, size_t outerStride, size_t innerCount,
+        bool inverse, ThreadPool* pool
+    ) {
+        const size_t n = plan.size();
+        if (stride == 1) {
+            auto lines = [&](size_t begin, size_t end, size_t) {
+                for (size_t line = begin; line < end; ++line) {
+                    plan.transform(data + line * outerStride, inverse);
+                }
+            };
+            if (pool) {
+                pool->parallelFor(0, outerCount, lines);
+            } else {
+                lines(0, outerCount, 0);
+            }
+            return;
+        }
+
+        const size_t blocksPerOuter = (innerCount + LINE_BLOCK - 1) / LINE_BLOCK;
+        auto blocks = [&](size_t begin, size_t end, size_t) {
+            std::vector<Fft::Complex> scratch(LINE_BLOCK * n);
+            for (size_t task = begin; task < end; ++task) {
+                const size_t outer = task / blocksPerOuter;
+                const size_t inner0 = (task % blocksPerOuter) * LINE_BLOCK;
+                const size_t width = std::min(LINE_BLOCK, innerCount - inner0);
+                Fft::Complex* base = data + outer * outerStride + inner0;
+                for (size_t k = 0; k < n; ++k) {
+                    for (size_t l = 0; l < width; ++l) {
+                        scratch[l * n + k] = base[k * stride + l];
+                    }
+                }
+                for (size_t l = 0; l < width; ++l) {
+                    plan.transform(scratch.data() + l * n, inverse);
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    for (size_t l = 0; l < width; ++l) {
+                        base[k * stride + l] = scratch[l * n + k];
+                    }
+                }
+            }
+        };
+        const size_t tasks = outerCount * blocksPerOuter;
+        if (pool) {
+            pool->parallelFor(0, tasks, blocks);
+        } else {
+            blocks(0, tasks, 0);
+        }
+    }
+}
+
+Fft::Fft(size_t n)
+    : m_size(isPowerOfTwo(n) ? n : nextPowerOfTwo(n))
+{
+    size_t bits = 0;
+    while ((size_t(1) << bits) < m_size) {
+        ++bits;
+    }
+    for (size_t i = 0; i < m_size; ++i) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        if (i < reversed) {
+            m_swaps.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(reversed));
+        }
+    }
+
+    // Each factor from its own angle: no rounding accumulates along the table
+    m_twiddles.resize(m_size / 2);
+    for (size_t k = 0; k < m_twiddles.size(); ++k) {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(m_size);
+        m_twiddles[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+}
+
+size_t Fft::nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+void Fft::transform(Complex* data, bool inverse) const {
+    for (const auto& [a, b] : m_swaps) {
+        std::swap(data[a], data[b]);
+    }
+
+    // Butterflies of length len combine two transforms of len / 2
+    for (size_t len = 2; len <= m_size; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t step = m_size / len;
+        for (size_t start = 0; start < m_size; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                const Complex w = inverse ? std::conj(m_twiddles[k * step]) : m_twiddles[k * step];
+                const Complex even = data[start + k];
+                const Complex b = data[start + k + half];
+                // Written out: std::complex multiplication checks for NaN/inf operands
+                const Complex odd(w.real() * b.real() - w.imag() * b.imag(),
+                                  w.real() * b.imag() + w.imag() * b.real());
+                data[start + k] = even + odd;
+                data[start + k + half] = even - odd;
+            }
+        }
+    }
+}
+
+void Fft::transform3d(Complex* data, const glm::ivec3& counts, bool inverse, ThreadPool* pool) {
+    const size_t nx = static_cast<size_t>(counts.x);
+    const size_t ny = static_cast<size_t>(counts.y);
+    const size_t nz = static_cast<size_t>(counts.z);
+    if (nx * ny * nz == 0) {
+        return;
+    }
+
+    transformLines(data, Fft(nx), 1, ny * nz, nx, 1, inverse, pool);
+    transformLines(data, Fft(ny), nx, nz, nx * ny, nx, inverse, pool);
+    transformLines(data, Fft(nz), nx * ny, ny, nx, nx, inverse, pool);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include "engine/core/ThreadPool.hpp"
+
+/**
+ * Fast Fourier Transform
+ *
+ * Self-contained iterative radix-2 complex FFT for power-of-two lengths, with a
+ * 3D transform for mesh solvers (P3MSolver). A plan holds the bit-reversal
+ * permutation and the twiddle factors e^(-2πik/n) of one length, so repeated
+ * transforms only pay for the butterflies.
+ *
+ * Transforms are unnormalized: forward uses e^(-2πi jk/n), inverse e^(+2πi jk/n),
+ * so inverse(forward(x)) = n x.
+ */
+class Fft {
+public:
+    using Complex = std::complex<double>;
+
+    /**
+     * Plan for transforms of length n (a power of two, at least 1)
+     */
+    explicit Fft(size_t n = 1);
+
+    size_t size() const { return m_size; }
+
+    /**
+     * In-place transform of n contiguous values
+     */
+    void transform(Complex* data, bool inverse) const;
+
+    static bool isPowerOfTwo(size_t n) { return n > 0 && (n & (n - 1)) == 0; }
+
+    /**
+     * Smallest power of two >= n
+     */
+    static size_t nextPowerOfTwo(size_t n);
+
+    /**
+     * In-place 3D transform of an x-fastest array
+     *
+     * Transforms every line along x, then y, then z; lines along y and z are
+     * gathered into contiguous scratch first. Lines are independent, so they are
+     * split across the pool (results do not depend on the thread count).
+     *
+     * @param counts Values per axis (each a power of two)
+     */
+    static void transform3d(Complex* data, const glm::ivec3& counts, bool inverse, ThreadPool* pool = nullptr);
+
+private:
+    size_t m_size;
+    std::vector<std::pair<uint32_t, uint32_t>> m_swaps;  // Bit-reversal permutation
+    std::vector<Complex> m_twiddles;                     // [k]: e^(-2πik/n), k < n/2
+};
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -49,9 +51,130 @@ State rk4Step(
 }
 
 /**
- * Velocity Verlet integrator for particle dynamics
+ * Result of an embedded Runge-Kutta step
+ */
+template<typename State, typename Derivative>
+struct EmbeddedStepResult {
+    State y;            // Higher order solution (used to advance)
+    State error;        // Difference to the embedded lower order solution
+    Derivative fsal;    // f(t + h, y): first stage of the next step
+};
+
+/**
+ * Dormand-Prince 5(4) embedded integrator
+ * 
+ * Advances with the 5th order solution and returns the difference to the
+ * embedded 4th order one as a local error estimate. The last stage is evaluated
+ * at the new state (first-same-as-last), so passing it back as `k1` of the next
+ * step makes an accepted step cost six evaluations of f.
+ * 
+ * @param y Current state vector
+ * @param t Current time
+ * @param h Step size
+ * @param k1 f(t, y), usually the previous step's `fsal`
+ * @param f Derivative function: f(t, y) -> dy/dt (called in stage order, last at t + h)
+ * @return New state, error estimate and derivative at the new state
+ */
+template<typename State, typename Derivative>
+EmbeddedStepResult<State, Derivative> dormandPrinceStep(
+    const State& y,
+    double t,
+    double h,
+    const Derivative& k1,
+    std::function<Derivative(const State&, double)> f
+) {
+    Derivative k2 = f(y + static_cast<State>(h * (1.0 / 5.0) * k1), t + h * (1.0 / 5.0));
+    
+    Derivative k3 = f(y + static_cast<State>(h * ((3.0 / 40.0) * k1 + (9.0 / 40.0) * k2)),
+                      t + h * (3.0 / 10.0));
+    
+    Derivative k4 = f(y + static_cast<State>(h * ((44.0 / 45.0) * k1 - (56.0 / 15.0) * k2 +
+                                                  (32.0 / 9.0) * k3)),
+                      t + h * (4.0 / 5.0));
+    
+    Derivative k5 = f(y + static_cast<State>(h * ((19372.0 / 6561.0) * k1 - (25360.0 / 2187.0) * k2 +
+                                                  (64448.0 / 6561.0) * k3 - (212.0 / 729.0) * k4)),
+                      t + h * (8.0 / 9.0));
+    
+    Derivative k6 = f(y + static_cast<State>(h * ((9017.0 / 3168.0) * k1 - (355.0 / 33.0) * k2 +
+                                                  (46732.0 / 5247.0) * k3 + (49.0 / 176.0) * k4 -
+                                                  (5103.0 / 18656.0) * k5)),
+                      t + h);
+    
+    // 5th order solution
+    EmbeddedStepResult<State, Derivative> result;
+    result.y = y + static_cast<State>(h * ((35.0 / 384.0) * k1 + (500.0 / 1113.0) * k3 +
+                                           (125.0 / 192.0) * k4 - (2187.0 / 6784.0) * k5 +
+                                           (11.0 / 84.0) * k6));
+    
+    // k7 = f(t + h, y_new) doubles as the next step's k1
+    result.fsal = f(result.y, t + h);
+    
+    // y5 - y4 from the difference of the two weight sets
+    result.error = static_cast<State>(h * ((71.0 / 57600.0) * k1 - (71.0 / 16695.0) * k3 +
+                                           (71.0 / 1920.0) * k4 - (17253.0 / 339200.0) * k5 +
+                                           (22.0 / 525.0) * k6 - (1.0 / 40.0) * result.fsal));
+    return result;
+}
+
+/**
+ * Step size factor from a normalized embedded error estimate
  * 
- * More stable than Euler for long-term simulations.
+ * Standard controller h_new = h * safety * err^(-1/(order+1)), clamped to
+ * [minFactor, maxFactor] so a single estimate cannot shrink or grow the step too far.
+ * 
+ * @param errorNorm Error divided by tolerance (accept if <= 1)
+ * @param order Order of the error estimate (4 for Dormand-Prince 5(4))
+ * @param minFactor Smallest allowed factor (rejection limit)
+ * @param maxFactor Largest allowed factor (growth limit)
+ * @return Factor to multiply the step size by
+ */
+inline double embeddedStepFactor(
+    double errorNorm,
+    int order,
+    double minFactor,
+    double maxFactor
+) {
+    const double safety = 0.9;
+    if (errorNorm <= 0.0) {
+        return maxFactor;
+    }
+    double factor = safety * std::pow(errorNorm, -1.0 / (order + 1));
+    return std::min(maxFactor, std::max(minFactor, factor));
+}
+
+/**
+ * Kick-drift-kick velocity Verlet building blocks
+ * 
+ * One step is kick(dt/2), drift(dt), force evaluation, kick(dt/2):
+ * 
+ *   v_half = v + a(x) dt/2
+ *   x_new  = x + v_half dt
+ *   v_new  = v_half + a(x_new) dt/2
+ * 
+ * The forces at x_new are those of the next step's first kick, so a step costs one
+ * force evaluation. Second order, symplectic and time-reversible for position-
+ * dependent forces: energy errors stay bounded instead of drifting.
+ */
+inline glm::dvec3 verletKick(const glm::dvec3& velocity, const glm::dvec3& acceleration, double h) {
+    return velocity + acceleration * h;
+}
+
+inline glm::dvec3 verletDrift(const glm::dvec3& position, const glm::dvec3& velocity, double h) {
+    return position + velocity * h;
+}
+
+/**
+ * Yoshida / Forest-Ruth 4th order symplectic composition
+ * 
+ * Three velocity Verlet substeps of w1 dt, w0 dt, w1 dt with
+ * w1 = 1 / (2 - 2^(1/3)) and w0 = 1 - 2 w1 (three force evaluations per step).
+ */
+constexpr double YOSHIDA4_W1 = 1.3512071919596578;
+constexpr double YOSHIDA4_W0 = -1.7024143839193155;
+
+/**
+ * Semi-implicit Euler integrator (simpler alternative)
  * 
  * @param position Current position
  * @param velocity Current velocity
@@ -59,56 +182,79 @@ State rk4Step(
  * @param dt Time step
  * @return New position and velocity
  */
-struct VerletResult {
+struct EulerResult {
     glm::dvec3 position;
     glm::dvec3 velocity;
 };
 
-inline VerletResult verletStep(
+inline EulerResult eulerStep(
     const glm::dvec3& position,
     const glm::dvec3& velocity,
     const glm::dvec3& acceleration,
     double dt
 ) {
-    VerletResult result;
+    EulerResult result;
     
     // v_new = v + a * dt
     result.velocity = velocity + acceleration * dt;
     
-    // x_new = x + v * dt + 0.5 * a * dt²
-    result.position = position + velocity * dt + 0.5 * acceleration * dt * dt;
+    // x_new = x + v_new * dt
+    result.position = position + result.velocity * dt;
     
     return result;
 }
 
 /**
- * Semi-implicit Euler integrator (simpler alternative)
+ * Boris pusher for charged particles in electric and magnetic fields
+ * 
+ * Half electric kick, exact-magnitude rotation about B, half electric kick, then
+ * drift with the new velocity. The rotation preserves |v|, so gyration stays
+ * stable and energy-conserving in a pure magnetic field for any ω dt < 2, and the
+ * map is volume-preserving. Velocity is staggered half a step from position, like
+ * the semi-implicit Euler step.
  * 
  * @param position Current position
  * @param velocity Current velocity
- * @param acceleration Current acceleration
+ * @param E Electric field at position (V/m)
+ * @param B Magnetic field at position (T)
+ * @param chargeToMass q/m (C/kg)
  * @param dt Time step
+ * @param acceleration Non-electromagnetic acceleration, applied with the electric kicks
  * @return New position and velocity
  */
-struct EulerResult {
+struct BorisResult {
     glm::dvec3 position;
     glm::dvec3 velocity;
 };
 
-inline EulerResult eulerStep(
+inline BorisResult borisStep(
     const glm::dvec3& position,
     const glm::dvec3& velocity,
-    const glm::dvec3& acceleration,
-    double dt
+    const glm::dvec3& E,
+    const glm::dvec3& B,
+    double chargeToMass,
+    double dt,
+    const glm::dvec3& acceleration = glm::dvec3(0.0)
 ) {
-    EulerResult result;
+    const double halfStep = 0.5 * chargeToMass * dt;
+    const glm::dvec3 halfKick = halfStep * E + 0.5 * dt * acceleration;
     
-    // v_new = v + a * dt
-    result.velocity = velocity + acceleration * dt;
+    // v⁻ = v + ((q/m) E + a) dt/2
+    glm::dvec3 vMinus = velocity + halfKick;
+    
+    // Rotation: t = (q/m) B dt/2, s = 2t / (1 + t²)
+    glm::dvec3 t = halfStep * B;
+    glm::dvec3 s = (2.0 / (1.0 + glm::dot(t, t))) * t;
+    glm::dvec3 vPrime = vMinus + glm::cross(vMinus, t);
+    glm::dvec3 vPlus = vMinus + glm::cross(vPrime, s);
+    
+    BorisResult result;
+    
+    // v_new = v⁺ + ((q/m) E + a) dt/2
+    result.velocity = vPlus + halfKick;
     
     // x_new = x + v_new * dt
     result.position = position + result.velocity * dt;
     
     return result;
 }
-
@@ -0,0 +1,168 @@
+#include "MarchingCubes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+    // Cube corner c sits at offset (c & 1, (c >> 1) & 1, (c >> 2) & 1). The six
+    // tetrahedra along the paths 0 -> 7 split every face along the diagonal
+    // through its lowest corner, so adjacent cubes agree on shared faces.
+    constexpr int TETRAHEDRA[6][4] = {
+        {0, 1, 3, 7}, {0, 1, 5, 7}, {0, 2, 3, 7},
+        {0, 2, 6, 7}, {0, 4, 5, 7}, {0, 4, 6, 7}
+    };
+
+    class Extractor {
+    public:
+        Extractor(const MarchingCubes::ScalarGrid& grid, double level, IsosurfaceMesh& mesh)
+            : m_grid(grid)
+            , m_level(level)
+            , m_mesh(mesh)
+            , m_nodeCount(static_cast<uint64_t>(grid.counts.x) * grid.counts.y * grid.counts.z)
+        {
+        }
+
+        void cube(const glm::ivec3& low) {
+            glm::ivec3 corners[8];
+            for (int c = 0; c < 8; ++c) {
+                corners[c] = low + glm::ivec3(c & 1, (c >> 1) & 1, (c >> 2) & 1);
+            }
+            for (const auto& tetrahedron : TETRAHEDRA) {
+                const glm::ivec3 nodes[4] = {
+                    corners[tetrahedron[0]], corners[tetrahedron[1]],
+                    corners[tetrahedron[2]], corners[tetrahedron[3]]
+                };
+                cut(nodes);
+            }
+        }
+
+    private:
+        const MarchingCubes::ScalarGrid& m_grid;
+        double m_level;
+        IsosurfaceMesh& m_mesh;
+        uint64_t m_nodeCount;
+        std::unordered_map<uint64_t, uint32_t> m_edgeVertices;   // Node pair -> welded vertex
+
+        size_t index(const glm::ivec3& n) const {
+            return (static_cast<size_t>(n.z) * m_grid.counts.y + static_cast<size_t>(n.y)) * m_grid.counts.x +
+                   static_cast<size_t>(n.x);
+        }
+
+        double value(const glm::ivec3& n) const { return m_grid.values[index(n)]; }
+
+        glm::dvec3 position(const glm::ivec3& n) const {
+            return m_grid.origin + m_grid.cellSize * glm::dvec3(n);
+        }
+
+        // Central differences, one-sided on the border
+        glm::dvec3 gradient(const glm::ivec3& n) const {
+            glm::dvec3 g;
+            for (int axis = 0; axis < 3; ++axis) {
+                glm::ivec3 below = n;
+                glm::ivec3 above = n;
+                below[axis] = std::max(n[axis] - 1, 0);
+                above[axis] = std::min(n[axis] + 1, m_grid.counts[axis] - 1);
+                g[axis] = (value(above) - value(below)) / ((above[axis] - below[axis]) * m_grid.cellSize);
+            }
+            return g;
+        }
+
+        // Surface crossing on the edge a-b (one end below the level, one not)
+        uint32_t vertex(const glm::ivec3& a, const glm::ivec3& b) {
+            const uint64_t ia = index(a);
+            const uint64_t ib = index(b);
+            const uint64_t key = ia < ib ? ia * m_nodeCount + ib : ib * m_nodeCount + ia;
+            auto found = m_edgeVertices.find(key);
+            if (found != m_edgeVertices.end()) {
+                return found->second;
+            }
+
+            const double va = value(a);
+            const double vb = value(b);
+            const double t = (m_level - va) / (vb - va);
+            glm::dvec3 normal = glm::mix(gradient(a), gradient(b), t);
+            if (!(glm::dot(normal, normal) > 0.0)) {
+                // Flat field: fall back to the edge direction toward higher values
+                normal = (vb > va ? 1.0 : -1.0) * glm::dvec3(b - a);
+            }
+
+            const uint32_t id = static_cast<uint32_t>(m_mesh.vertices.size());
+            m_mesh.vertices.push_back(glm::mix(position(a), position(b), t));
+            m_mesh.normals.push_back(glm::normalize(normal));
+            m_edgeVertices.emplace(key, id);
+            return id;
+        }
+
+        // Add a triangle facing `up` (toward higher values); drops degenerate ones
+        void triangle(uint32_t a, uint32_t b, uint32_t c, const glm::dvec3& up) {
+            const glm::dvec3& pa = m_mesh.vertices[a];
+            glm::dvec3 n = glm::cross(m_mesh.vertices[b] - pa, m_mesh.vertices[c] - pa);
+            if (!(glm::dot(n, n) > 0.0)) {
+                return;
+            }
+            if (glm::dot(n, up) < 0.0) {
+                std::swap(b, c);
+            }
+            m_mesh.indices.insert(m_mesh.indices.end(), {a, b, c});
+        }
+
+        void cut(const glm::ivec3 (&nodes)[4]) {
+            glm::ivec3 below[4];
+            glm::ivec3 above[4];
+            int belowCount = 0;
+            int aboveCount = 0;
+            glm::dvec3 belowSum(0.0);
+            glm::dvec3 aboveSum(0.0);
+            for (const auto& n : nodes) {
+                const double v = value(n);
+                if (!std::isfinite(v)) {
+                    return;
+                }
+                if (v < m_level) {
+                    below[belowCount++] = n;
+                    belowSum += glm::dvec3(n);
+                } else {
+                    above[aboveCount++] = n;
+                    aboveSum += glm::dvec3(n);
+                }
+            }
+            if (belowCount == 0 || aboveCount == 0) {
+                return;
+            }
+            const glm::dvec3 up = aboveSum / static_cast<double>(aboveCount) -
+                                  belowSum / static_cast<double>(belowCount);
+
+            if (belowCount == 1) {
+                triangle(vertex(below[0], above[0]), vertex(below[0], above[1]), vertex(below[0], above[2]), up);
+            } else if (aboveCount == 1) {
+                triangle(vertex(below[0], above[0]), vertex(below[1], above[0]), vertex(below[2], above[0]), up);
+            } else {
+                // Two on each side: the cut is the quad ac, ad, bd, bc
+                const uint32_t ac = vertex(below[0], above[0]);
+                const uint32_t ad = vertex(below[0], above[1]);
+                const uint32_t bd = vertex(below[1], above[1]);
+                const uint32_t bc = vertex(below[1], above[0]);
+                triangle(ac, ad, bd, up);
+                triangle(ac, bd, bc, up);
+            }
+        }
+    };
+}
+
+void MarchingCubes::extract(const ScalarGrid& grid, double level, IsosurfaceMesh& mesh) {
+    mesh.vertices.clear();
+    mesh.normals.clear();
+    mesh.indices.clear();
+    if (!grid.values || glm::any(glm::lessThan(grid.counts, glm::ivec3(2)))) {
+        return;
+    }
+
+    Extractor extractor(grid, level, mesh);
+    for (int z = 0; z + 1 < grid.counts.z; ++z) {
+        for (int y = 0; y + 1 < grid.counts.y; ++y) {
+            for (int x = 0; x + 1 < grid.counts.x; ++x) {
+                extractor.cube(glm::ivec3(x, y, z));
+            }
+        }
+    }
+}
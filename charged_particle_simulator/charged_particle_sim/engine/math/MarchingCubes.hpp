@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Triangle mesh of an isosurface
+ */
+struct IsosurfaceMesh {
+    std::vector<glm::dvec3> vertices;         // Vertex positions (meters)
+    std::vector<glm::dvec3> normals;          // Unit normals, toward increasing values
+    std::vector<uint32_t> indices;            // Three per triangle, wound counter-clockwise seen from the normal side
+
+    size_t triangleCount() const { return indices.size() / 3; }
+    bool empty() const { return indices.empty(); }
+};
+
+/**
+ * Marching Cubes Isosurface Extraction
+ *
+ * Extracts the surface value == level from a scalar field sampled on a uniform
+ * grid (e.g. an equipotential from PotentialGrid). Each cube is split into six
+ * tetrahedra around its main diagonal and the surface is cut linearly from every
+ * tetrahedron, which needs no ambiguity tables and is watertight: neighbouring
+ * cubes split their shared faces the same way. Vertices on shared edges are
+ * welded, and normals come from the central-difference gradient of the field.
+ */
+class MarchingCubes {
+public:
+    /**
+     * Scalar field sampled at origin + cellSize * (x, y, z), stored x-fastest
+     */
+    struct ScalarGrid {
+        const double* values = nullptr;
+        glm::ivec3 counts = glm::ivec3(0);    // Nodes per axis
+        glm::dvec3 origin = glm::dvec3(0.0);
+        double cellSize = 1.0;
+    };
+
+    /**
+     * Extract the isosurface at a level
+     *
+     * @param grid Sampled scalar field
+     * @param level Iso value
+     * @param mesh Output mesh (cleared first)
+     */
+    static void extract(const ScalarGrid& grid, double level, IsosurfaceMesh& mesh);
+
+private:
+    // Prevent instantiation (static class)
+    MarchingCubes() = delete;
+};
@@ -0,0 +1,303 @@
+#include "BarnesHutTree.hpp"
+#include "engine/core/Constants.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+BarnesHutTree::BarnesHutTree()
+    : m_theta(0.5)
+    , m_leafCapacity(8)
+{
+}
+
+void BarnesHutTree::setOpeningAngle(double theta) {
+    m_theta = std::clamp(theta, 0.0, 1.0);
+}
+
+void BarnesHutTree::build(const std::vector<Particle>& particles) {
+    m_positions.clear();
+    m_charges.clear();
+    m_positions.reserve(particles.size());
+    m_charges.reserve(particles.size());
+    for (const auto& p : particles) {
+        m_positions.push_back(p.position);
+        m_charges.push_back(p.charge);
+    }
+    buildFromSources();
+}
+
+void BarnesHutTree::build(const ParticleStore& store) {
+    m_positions.resize(store.size());
+    m_charges.assign(store.q.begin(), store.q.end());
+    for (size_t i = 0; i < store.size(); ++i) {
+        m_positions[i] = store.position(i);
+    }
+    buildFromSources();
+}
+
+void BarnesHutTree::buildFromSources() {
+    m_nodes.clear();
+    if (m_positions.empty()) {
+        return;
+    }
+
+    // Bounding cube of all particles
+    glm::dvec3 minCorner(std::numeric_limits<double>::max());
+    glm::dvec3 maxCorner(std::numeric_limits<double>::lowest());
+    for (const auto& p : m_positions) {
+        minCorner = glm::min(minCorner, p);
+        maxCorner = glm::max(maxCorner, p);
+    }
+
+    glm::dvec3 center = 0.5 * (minCorner + maxCorner);
+    glm::dvec3 extent = maxCorner - minCorner;
+    double halfSize = 0.5 * std::max({extent.x, extent.y, extent.z});
+
+    // Pad slightly so particles on the boundary fall strictly inside
+    halfSize = halfSize * (1.0 + 1e-9) + PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    // Rough upper bound on node count to avoid reallocation during build
+    m_nodes.reserve(2 * m_positions.size() / static_cast<size_t>(m_leafCapacity) + 16);
+
+    buildNode(0, static_cast<int>(m_positions.size()), center, halfSize, 0);
+}
+
+int BarnesHutTree::buildNode(int begin, int end, const glm::dvec3& center, double halfSize, int depth) {
+    int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Node& node = m_nodes[nodeIndex];
+    node.boxCenter = center;
+    node.halfSize = halfSize;
+    node.begin = begin;
+    node.end = end;
+    node.isLeaf = (end - begin) <= m_leafCapacity || depth >= MAX_DEPTH;
+    std::fill(std::begin(node.children), std::end(node.children), -1);
+
+    if (!node.isLeaf) {
+        // Counting sort of the range into octants
+        int counts[8] = {0};
+        std::vector<int> octants(end - begin);
+        for (int i = begin; i < end; ++i) {
+            const glm::dvec3& p = m_positions[i];
+            int octant = (p.x >= center.x ? 1 : 0) |
+                         (p.y >= center.y ? 2 : 0) |
+                         (p.z >= center.z ? 4 : 0);
+            octants[i - begin] = octant;
+            ++counts[octant];
+        }
+
+        int offsets[9] = {0};
+        for (int o = 0; o < 8; ++o) {
+            offsets[o + 1] = offsets[o] + counts[o];
+        }
+
+        std::vector<glm::dvec3> sortedPositions(end - begin);
+        std::vector<double> sortedCharges(end - begin);
+        int cursor[8];
+        std::copy(offsets, offsets + 8, cursor);
+        for (int i = begin; i < end; ++i) {
+            int slot = cursor[octants[i - begin]]++;
+            sortedPositions[slot] = m_positions[i];
+            sortedCharges[slot] = m_charges[i];
+        }
+        std::copy(sortedPositions.begin(), sortedPositions.end(), m_positions.begin() + begin);
+        std::copy(sortedCharges.begin(), sortedCharges.end(), m_charges.begin() + begin);
+
+        // Build children (node reference may be invalidated by emplace_back)
+        double childHalf = 0.5 * halfSize;
+        for (int o = 0; o < 8; ++o) {
+            if (counts[o] == 0) {
+                continue;
+            }
+            glm::dvec3 childCenter = center + childHalf * glm::dvec3(
+                (o & 1) ? 1.0 : -1.0,
+                (o & 2) ? 1.0 : -1.0,
+                (o & 4) ? 1.0 : -1.0
+            );
+            int child = buildNode(begin + offsets[o], begin + offsets[o + 1], childCenter, childHalf, depth + 1);
+            m_nodes[nodeIndex].children[o] = child;
+        }
+    }
+
+    computeMoments(m_nodes[nodeIndex]);
+    return nodeIndex;
+}
+
+void BarnesHutTree::computeMoments(Node& node) {
+    // Expansion centre: |q|-weighted mean (falls back to box centre for neutral particles)
+    double absCharge = 0.0;
+    glm::dvec3 weighted(0.0);
+    for (int i = node.begin; i < node.end; ++i) {
+        double w = std::abs(m_charges[i]);
+        absCharge += w;
+        weighted += w * m_positions[i];
+    }
+    node.expansionCenter = (absCharge > 0.0) ? weighted / absCharge : node.boxCenter;
+
+    node.charge = 0.0;
+    node.dipole = glm::dvec3(0.0);
+    std::fill(std::begin(node.quadrupole), std::end(node.quadrupole), 0.0);
+
+    for (int i = node.begin; i < node.end; ++i) {
+        double q = m_charges[i];
+        glm::dvec3 d = m_positions[i] - node.expansionCenter;
+        double d2 = glm::dot(d, d);
+
+        node.charge += q;
+        node.dipole += q * d;
+        node.quadrupole[0] += q * (3.0 * d.x * d.x - d2);
+        node.quadrupole[1] += q * (3.0 * d.y * d.y - d2);
+        node.quadrupole[2] += q * (3.0 * d.z * d.z - d2);
+        node.quadrupole[3] += q * 3.0 * d.x * d.y;
+        node.quadrupole[4] += q * 3.0 * d.x * d.z;
+        node.quadrupole[5] += q * 3.0 * d.y * d.z;
+    }
+}
+
+glm::dvec3 BarnesHutTree::multipoleField(const Node& node, const glm::dvec3& evalPoint) {
+    glm::dvec3 R = evalPoint - node.expansionCenter;
+    double r2 = glm::dot(R, R);
+    double r = std::sqrt(r2);
+    double invR3 = 1.0 / (r2 * r);
+    double invR5 = invR3 / r2;
+    double invR7 = invR5 / r2;
+
+    const double* Q = node.quadrupole;
+    glm::dvec3 QR(
+        Q[0] * R.x + Q[3] * R.y + Q[4] * R.z,
+        Q[3] * R.x + Q[1] * R.y + Q[5] * R.z,
+        Q[4] * R.x + Q[5] * R.y + Q[2] * R.z
+    );
+    double RQR = glm::dot(R, QR);
+    double pR = glm::dot(node.dipole, R);
+
+    // Monopole: Q R / r³
+    glm::dvec3 E = node.charge * invR3 * R;
+    // Dipole: 3 (p·R) R / r⁵ - p / r³
+    E += 3.0 * pR * invR5 * R - invR3 * node.dipole;
+    // Quadrupole: (5/2) (RᵀQR) R / r⁷ - Q R / r⁵
+    E += 2.5 * RQR * invR7 * R - invR5 * QR;
+
+    return PhysicsConstants::k * E;
+}
+
+double BarnesHutTree::multipolePotential(const Node& node, const glm::dvec3& evalPoint) {
+    glm::dvec3 R = evalPoint - node.expansionCenter;
+    double r2 = glm::dot(R, R);
+    double invR = 1.0 / std::sqrt(r2);
+    double invR3 = invR / r2;
+    double invR5 = invR3 / r2;
+
+    const double* Q = node.quadrupole;
+    double RQR = Q[0] * R.x * R.x + Q[1] * R.y * R.y + Q[2] * R.z * R.z +
+                 2.0 * (Q[3] * R.x * R.y + Q[4] * R.x * R.z + Q[5] * R.y * R.z);
+
+    // Monopole Q / r, dipole (p·R) / r³, quadrupole (1/2) (RᵀQR) / r⁵
+    double phi = node.charge * invR + glm::dot(node.dipole, R) * invR3 + 0.5 * RQR * invR5;
+    return PhysicsConstants::k * phi;
+}
+
+glm::dvec3 BarnesHutTree::fieldAt(const glm::dvec3& evalPoint) const {
+    glm::dvec3 totalE(0.0);
+    if (m_nodes.empty()) {
+        return totalE;
+    }
+
+    const double minDist2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        glm::dvec3 fromBox = glm::abs(evalPoint - node.boxCenter);
+        bool outsideCell = fromBox.x > node.halfSize ||
+                           fromBox.y > node.halfSize ||
+                           fromBox.z > node.halfSize;
+
+        if (outsideCell) {
+            double dist = glm::length(evalPoint - node.expansionCenter);
+            if (2.0 * node.halfSize < m_theta * dist) {
+                // Cell is far enough away: use its multipole expansion
+                totalE += multipoleField(node, evalPoint);
+                continue;
+            }
+        }
+
+        if (node.isLeaf) {
+            // Direct sum over the leaf's particles
+            for (int i = node.begin; i < node.end; ++i) {
+                glm::dvec3 r = evalPoint - m_positions[i];
+                double r2 = glm::dot(r, r);
+                if (r2 < minDist2) {
+                    continue;
+                }
+                double rMag = std::sqrt(r2);
+                totalE += (PhysicsConstants::k * m_charges[i] / (r2 * rMag)) * r;
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child >= 0) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+
+    return totalE;
+}
+
+double BarnesHutTree::potentialAt(const glm::dvec3& evalPoint) const {
+    double totalPhi = 0.0;
+    if (m_nodes.empty()) {
+        return totalPhi;
+    }
+
+    const double minDist2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    // Same acceptance test as fieldAt()
+    while (stackSize > 0) {
+        const Node& node = m_nodes[stack[--stackSize]];
+
+        glm::dvec3 fromBox = glm::abs(evalPoint - node.boxCenter);
+        bool outsideCell = fromBox.x > node.halfSize ||
+                           fromBox.y > node.halfSize ||
+                           fromBox.z > node.halfSize;
+
+        if (outsideCell) {
+            double dist = glm::length(evalPoint - node.expansionCenter);
+            if (2.0 * node.halfSize < m_theta * dist) {
+                totalPhi += multipolePotential(node, evalPoint);
+                continue;
+            }
+        }
+
+        if (node.isLeaf) {
+            for (int i = node.begin; i < node.end; ++i) {
+                glm::dvec3 r = evalPoint - m_positions[i];
+                double r2 = glm::dot(r, r);
+                if (r2 < minDist2) {
+                    continue;
+                }
+                totalPhi += PhysicsConstants::k * m_charges[i] / std::sqrt(r2);
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child >= 0) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+
+    return totalPhi;
+}
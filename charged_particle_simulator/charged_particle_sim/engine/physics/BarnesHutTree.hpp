@@ -0,0 +1,128 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "Particle.hpp"
+#include "ParticleStore.hpp"
+
+/**
+ * Barnes-Hut Octree
+ *
+ * Approximates the Coulomb field of N point charges in O(log N) per evaluation point.
+ * Each cell stores monopole, dipole and quadrupole moments about the |q|-weighted
+ * centre of its charges, so mixed-sign (net neutral) cells are still represented well.
+ *
+ * A cell is accepted as a single source when:
+ *   cellSize / distance < theta
+ * and the evaluation point lies outside the cell. Otherwise it is opened.
+ *
+ * With quadrupole moments the relative error of an accepted cell scales roughly as theta³,
+ * so theta = 0.5 typically gives sub-percent force errors.
+ */
+class BarnesHutTree {
+public:
+    BarnesHutTree();
+
+    /**
+     * Build the tree from particle positions and charges
+     *
+     * @param particles Source particles (copied; the tree does not keep a reference)
+     */
+    void build(const std::vector<Particle>& particles);
+
+    /**
+     * Build the tree from structure-of-arrays particle data
+     */
+    void build(const ParticleStore& store);
+
+    /**
+     * Compute the approximate electric field at a point
+     *
+     * Sources closer than MIN_SAFE_DISTANCE are skipped (self-interaction),
+     * matching ElectricField::totalField. Thread-safe after build().
+     *
+     * @param evalPoint Point where field is evaluated (meters)
+     * @return Electric field vector in N/C
+     */
+    glm::dvec3 fieldAt(const glm::dvec3& evalPoint) const;
+
+    /**
+     * Compute the approximate electrostatic potential at a point (same expansions
+     * and acceptance test as fieldAt()). Thread-safe after build().
+     *
+     * @param evalPoint Point where potential is evaluated (meters)
+     * @return Potential in volts
+     */
+    double potentialAt(const glm::dvec3& evalPoint) const;
+
+    /**
+     * Set opening angle theta (0 = exact direct sum, clamped to [0, 1])
+     */
+    void setOpeningAngle(double theta);
+    double getOpeningAngle() const { return m_theta; }
+
+    /**
+     * Set maximum number of particles stored in a leaf cell
+     */
+    void setLeafCapacity(int capacity) { m_leafCapacity = capacity < 1 ? 1 : capacity; }
+
+    /**
+     * Get number of nodes in the current tree
+     */
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+    /**
+     * Check if tree is empty
+     */
+    bool empty() const { return m_nodes.empty(); }
+
+private:
+    struct Node {
+        glm::dvec3 boxCenter;        // Geometric centre of the cubic cell
+        double halfSize;             // Half edge length of the cell
+        glm::dvec3 expansionCenter;  // |q|-weighted centre (expansion point)
+        double charge;               // Monopole: sum of q
+        glm::dvec3 dipole;           // Sum of q * d
+        double quadrupole[6];        // Traceless quadrupole: xx, yy, zz, xy, xz, yz
+        int children[8];             // Child node indices (-1 if empty)
+        int begin;                   // First particle in m_order
+        int end;                     // One past last particle in m_order
+        bool isLeaf;
+    };
+
+    std::vector<Node> m_nodes;
+
+    // Source data in tree order (contiguous per leaf)
+    std::vector<glm::dvec3> m_positions;
+    std::vector<double> m_charges;
+
+    double m_theta;
+    int m_leafCapacity;
+
+    static constexpr int MAX_DEPTH = 32;
+
+    /**
+     * Build nodes over the sources currently in m_positions / m_charges
+     */
+    void buildFromSources();
+
+    /**
+     * Recursively build a node over m_positions[begin, end)
+     */
+    int buildNode(int begin, int end, const glm::dvec3& center, double halfSize, int depth);
+
+    /**
+     * Compute multipole moments of a node (children must be complete)
+     */
+    void computeMoments(Node& node);
+
+    /**
+     * Field of a node's multipole expansion at a point
+     */
+    static glm::dvec3 multipoleField(const Node& node, const glm::dvec3& evalPoint);
+
+    /**
+     * Potential of a node's multipole expansion at a point
+     */
+    static double multipolePotential(const Node& node, const glm::dvec3& evalPoint);
+};
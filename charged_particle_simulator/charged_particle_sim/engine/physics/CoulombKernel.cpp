@@ -0,0 +1,649 @@
+#include "CoulombKernel.hpp"
+#include "engine/core/Constants.hpp"
+#include "engine/core/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPS_X86_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Per-function target attributes let us compile AVX code without global -mavx flags
+#if defined(CPS_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define CPS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define CPS_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define CPS_TARGET_AVX2
+#define CPS_TARGET_AVX512
+#endif
+
+namespace {
+    constexpr double MIN_DIST2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    std::atomic<CoulombKernel::InstructionSet> s_override{CoulombKernel::InstructionSet::SCALAR};
+    std::atomic<bool> s_overrideSet{false};
+
+    glm::dvec3 fieldScalar(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t begin, size_t count
+    ) {
+        double Ex = 0.0, Ey = 0.0, Ez = 0.0;
+        for (size_t j = begin; j < count; ++j) {
+            double dx = p.x - x[j];
+            double dy = p.y - y[j];
+            double dz = p.z - z[j];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < MIN_DIST2) {
+                continue;
+            }
+            double invR = 1.0 / std::sqrt(r2);
+            double s = q[j] * invR * invR * invR;
+            Ex += s * dx;
+            Ey += s * dy;
+            Ez += s * dz;
+        }
+        return glm::dvec3(Ex, Ey, Ez);
+    }
+
+    double potentialScalar(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t begin, size_t count
+    ) {
+        double phi = 0.0;
+        for (size_t j = begin; j < count; ++j) {
+            double dx = p.x - x[j];
+            double dy = p.y - y[j];
+            double dz = p.z - z[j];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < MIN_DIST2) {
+                continue;
+            }
+            phi += q[j] / std::sqrt(r2);
+        }
+        return phi;
+    }
+
+    // Pair rows of pairwiseFields(): particle i against j in [begin, end), with
+    // i < begin. Fields are without the factor k: the columns accumulate into
+    // ex, ey, ez (ex[0] belongs to begin), the field at i is returned.
+    glm::dvec3 pairRowScalar(
+        size_t i, size_t begin, size_t end,
+        const double* x, const double* y, const double* z, const double* q,
+        double* ex, double* ey, double* ez
+    ) {
+        const double xi = x[i], yi = y[i], zi = z[i], qi = q[i];
+        double Ex = 0.0, Ey = 0.0, Ez = 0.0;
+        for (size_t j = begin; j < end; ++j) {
+            double dx = xi - x[j];
+            double dy = yi - y[j];
+            double dz = zi - z[j];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < MIN_DIST2) {
+                continue;
+            }
+            double invR = 1.0 / std::sqrt(r2);
+            double s = invR * invR * invR;
+            double sj = q[j] * s;
+            double si = qi * s;
+            Ex += sj * dx;
+            Ey += sj * dy;
+            Ez += sj * dz;
+            ex[j - begin] -= si * dx;
+            ey[j - begin] -= si * dy;
+            ez[j - begin] -= si * dz;
+        }
+        return glm::dvec3(Ex, Ey, Ez);
+    }
+
+    using PairRow = glm::dvec3 (*)(size_t, size_t, size_t,
+                                   const double*, const double*, const double*, const double*,
+                                   double*, double*, double*);
+
+#ifdef CPS_X86_SIMD
+    // Lane sums are done through memory: _mm512_reduce_add_pd trips a
+    // -Wuninitialized false positive in GCC 12 headers
+    CPS_TARGET_AVX512
+    double horizontalSum(__m512d v) {
+        alignas(64) double lanes[8];
+        _mm512_store_pd(lanes, v);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+               ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    CPS_TARGET_AVX2
+    double horizontalSum(__m256d v) {
+        __m128d low = _mm256_castpd256_pd128(v);
+        __m128d high = _mm256_extractf128_pd(v, 1);
+        low = _mm_add_pd(low, high);
+        __m128d swapped = _mm_unpackhi_pd(low, low);
+        return _mm_cvtsd_f64(_mm_add_sd(low, swapped));
+    }
+
+    CPS_TARGET_AVX2
+    glm::dvec3 fieldAvx2(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t count
+    ) {
+        const __m256d px = _mm256_set1_pd(p.x);
+        const __m256d py = _mm256_set1_pd(p.y);
+        const __m256d pz = _mm256_set1_pd(p.z);
+        const __m256d minDist2 = _mm256_set1_pd(MIN_DIST2);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+        __m256d Ex = _mm256_setzero_pd();
+        __m256d Ey = _mm256_setzero_pd();
+        __m256d Ez = _mm256_setzero_pd();
+
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            __m256d dx = _mm256_sub_pd(px, _mm256_loadu_pd(x + j));
+            __m256d dy = _mm256_sub_pd(py, _mm256_loadu_pd(y + j));
+            __m256d dz = _mm256_sub_pd(pz, _mm256_loadu_pd(z + j));
+            __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+
+            // Skip sources at the evaluation point
+            __m256d valid = _mm256_cmp_pd(r2, minDist2, _CMP_GE_OQ);
+            __m256d safeR2 = _mm256_blendv_pd(_mm256_set1_pd(1.0), r2, valid);
+
+            // 12-bit single precision estimate, then two Newton steps (~1e-13 relative)
+            __m256d invR = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(safeR2)));
+            __m256d halfR2 = _mm256_mul_pd(half, safeR2);
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+
+            __m256d invR3 = _mm256_mul_pd(invR, _mm256_mul_pd(invR, invR));
+            __m256d s = _mm256_and_pd(_mm256_mul_pd(_mm256_loadu_pd(q + j), invR3), valid);
+
+            Ex = _mm256_fmadd_pd(s, dx, Ex);
+            Ey = _mm256_fmadd_pd(s, dy, Ey);
+            Ez = _mm256_fmadd_pd(s, dz, Ez);
+        }
+
+        glm::dvec3 E(horizontalSum(Ex), horizontalSum(Ey), horizontalSum(Ez));
+        return E + fieldScalar(p, x, y, z, q, j, count);
+    }
+
+    CPS_TARGET_AVX512
+    glm::dvec3 fieldAvx512(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t count
+    ) {
+        const __m512d px = _mm512_set1_pd(p.x);
+        const __m512d py = _mm512_set1_pd(p.y);
+        const __m512d pz = _mm512_set1_pd(p.z);
+        const __m512d minDist2 = _mm512_set1_pd(MIN_DIST2);
+        const __m512d half = _mm512_set1_pd(0.5);
+        const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+        __m512d Ex = _mm512_setzero_pd();
+        __m512d Ey = _mm512_setzero_pd();
+        __m512d Ez = _mm512_setzero_pd();
+
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            __m512d dx = _mm512_sub_pd(px, _mm512_loadu_pd(x + j));
+            __m512d dy = _mm512_sub_pd(py, _mm512_loadu_pd(y + j));
+            __m512d dz = _mm512_sub_pd(pz, _mm512_loadu_pd(z + j));
+            __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+
+            // Skip sources at the evaluation point
+            __mmask8 valid = _mm512_cmp_pd_mask(r2, minDist2, _CMP_GE_OQ);
+
+            // 14-bit estimate, then two Newton steps (full double precision)
+            __m512d invR = _mm512_maskz_rsqrt14_pd(valid, r2);
+            __m512d halfR2 = _mm512_mul_pd(half, r2);
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+
+            __m512d invR3 = _mm512_mul_pd(invR, _mm512_mul_pd(invR, invR));
+            __m512d s = _mm512_mul_pd(_mm512_loadu_pd(q + j), invR3);
+
+            Ex = _mm512_fmadd_pd(s, dx, Ex);
+            Ey = _mm512_fmadd_pd(s, dy, Ey);
+            Ez = _mm512_fmadd_pd(s, dz, Ez);
+        }
+
+        glm::dvec3 E(horizontalSum(Ex), horizontalSum(Ey), horizontalSum(Ez));
+        return E + fieldScalar(p, x, y, z, q, j, count);
+    }
+
+    CPS_TARGET_AVX2
+    double potentialAvx2(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t count
+    ) {
+        const __m256d px = _mm256_set1_pd(p.x);
+        const __m256d py = _mm256_set1_pd(p.y);
+        const __m256d pz = _mm256_set1_pd(p.z);
+        const __m256d minDist2 = _mm256_set1_pd(MIN_DIST2);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+        __m256d phi = _mm256_setzero_pd();
+
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            __m256d dx = _mm256_sub_pd(px, _mm256_loadu_pd(x + j));
+            __m256d dy = _mm256_sub_pd(py, _mm256_loadu_pd(y + j));
+            __m256d dz = _mm256_sub_pd(pz, _mm256_loadu_pd(z + j));
+            __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+
+            __m256d valid = _mm256_cmp_pd(r2, minDist2, _CMP_GE_OQ);
+            __m256d safeR2 = _mm256_blendv_pd(_mm256_set1_pd(1.0), r2, valid);
+
+            __m256d invR = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(safeR2)));
+            __m256d halfR2 = _mm256_mul_pd(half, safeR2);
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+
+            phi = _mm256_fmadd_pd(_mm256_loadu_pd(q + j), _mm256_and_pd(invR, valid), phi);
+        }
+
+        return horizontalSum(phi) + potentialScalar(p, x, y, z, q, j, count);
+    }
+
+    CPS_TARGET_AVX512
+    double potentialAvx512(
+        const glm::dvec3& p,
+        const double* x, const double* y, const double* z, const double* q,
+        size_t count
+    ) {
+        const __m512d px = _mm512_set1_pd(p.x);
+        const __m512d py = _mm512_set1_pd(p.y);
+        const __m512d pz = _mm512_set1_pd(p.z);
+        const __m512d minDist2 = _mm512_set1_pd(MIN_DIST2);
+        const __m512d half = _mm512_set1_pd(0.5);
+        const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+        __m512d phi = _mm512_setzero_pd();
+
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            __m512d dx = _mm512_sub_pd(px, _mm512_loadu_pd(x + j));
+            __m512d dy = _mm512_sub_pd(py, _mm512_loadu_pd(y + j));
+            __m512d dz = _mm512_sub_pd(pz, _mm512_loadu_pd(z + j));
+            __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+
+            __mmask8 valid = _mm512_cmp_pd_mask(r2, minDist2, _CMP_GE_OQ);
+
+            __m512d invR = _mm512_maskz_rsqrt14_pd(valid, r2);
+            __m512d halfR2 = _mm512_mul_pd(half, r2);
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+
+            phi = _mm512_fmadd_pd(_mm512_loadu_pd(q + j), invR, phi);
+        }
+
+        return horizontalSum(phi) + potentialScalar(p, x, y, z, q, j, count);
+    }
+
+    CPS_TARGET_AVX2
+    glm::dvec3 pairRowAvx2(
+        size_t i, size_t begin, size_t end,
+        const double* x, const double* y, const double* z, const double* q,
+        double* ex, double* ey, double* ez
+    ) {
+        const __m256d px = _mm256_set1_pd(x[i]);
+        const __m256d py = _mm256_set1_pd(y[i]);
+        const __m256d pz = _mm256_set1_pd(z[i]);
+        const __m256d qi = _mm256_set1_pd(q[i]);
+        const __m256d minDist2 = _mm256_set1_pd(MIN_DIST2);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+        __m256d Ex = _mm256_setzero_pd();
+        __m256d Ey = _mm256_setzero_pd();
+        __m256d Ez = _mm256_setzero_pd();
+
+        size_t j = begin;
+        for (; j + 4 <= end; j += 4) {
+            __m256d dx = _mm256_sub_pd(px, _mm256_loadu_pd(x + j));
+            __m256d dy = _mm256_sub_pd(py, _mm256_loadu_pd(y + j));
+            __m256d dz = _mm256_sub_pd(pz, _mm256_loadu_pd(z + j));
+            __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+
+            __m256d valid = _mm256_cmp_pd(r2, minDist2, _CMP_GE_OQ);
+            __m256d safeR2 = _mm256_blendv_pd(_mm256_set1_pd(1.0), r2, valid);
+
+            __m256d invR = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(safeR2)));
+            __m256d halfR2 = _mm256_mul_pd(half, safeR2);
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+            invR = _mm256_mul_pd(invR, _mm256_fnmadd_pd(halfR2, _mm256_mul_pd(invR, invR), threeHalves));
+
+            __m256d s = _mm256_and_pd(_mm256_mul_pd(invR, _mm256_mul_pd(invR, invR)), valid);
+            __m256d sj = _mm256_mul_pd(_mm256_loadu_pd(q + j), s);
+            __m256d si = _mm256_mul_pd(qi, s);
+
+            Ex = _mm256_fmadd_pd(sj, dx, Ex);
+            Ey = _mm256_fmadd_pd(sj, dy, Ey);
+            Ez = _mm256_fmadd_pd(sj, dz, Ez);
+            _mm256_storeu_pd(ex + (j - begin), _mm256_fnmadd_pd(si, dx, _mm256_loadu_pd(ex + (j - begin))));
+            _mm256_storeu_pd(ey + (j - begin), _mm256_fnmadd_pd(si, dy, _mm256_loadu_pd(ey + (j - begin))));
+            _mm256_storeu_pd(ez + (j - begin), _mm256_fnmadd_pd(si, dz, _mm256_loadu_pd(ez + (j - begin))));
+        }
+
+        const glm::dvec3 tail = pairRowScalar(i, j, end, x, y, z, q, ex + (j - begin), ey + (j - begin), ez + (j - begin));
+        return glm::dvec3(horizontalSum(Ex), horizontalSum(Ey), horizontalSum(Ez)) + tail;
+    }
+
+    CPS_TARGET_AVX512
+    glm::dvec3 pairRowAvx512(
+        size_t i, size_t begin, size_t end,
+        const double* x, const double* y, const double* z, const double* q,
+        double* ex, double* ey, double* ez
+    ) {
+        const __m512d px = _mm512_set1_pd(x[i]);
+        const __m512d py = _mm512_set1_pd(y[i]);
+        const __m512d pz = _mm512_set1_pd(z[i]);
+        const __m512d qi = _mm512_set1_pd(q[i]);
+        const __m512d minDist2 = _mm512_set1_pd(MIN_DIST2);
+        const __m512d half = _mm512_set1_pd(0.5);
+        const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+        __m512d Ex = _mm512_setzero_pd();
+        __m512d Ey = _mm512_setzero_pd();
+        __m512d Ez = _mm512_setzero_pd();
+
+        size_t j = begin;
+        for (; j + 8 <= end; j += 8) {
+            __m512d dx = _mm512_sub_pd(px, _mm512_loadu_pd(x + j));
+            __m512d dy = _mm512_sub_pd(py, _mm512_loadu_pd(y + j));
+            __m512d dz = _mm512_sub_pd(pz, _mm512_loadu_pd(z + j));
+            __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+
+            __mmask8 valid = _mm512_cmp_pd_mask(r2, minDist2, _CMP_GE_OQ);
+
+            __m512d invR = _mm512_maskz_rsqrt14_pd(valid, r2);
+            __m512d halfR2 = _mm512_mul_pd(half, r2);
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+            invR = _mm512_mul_pd(invR, _mm512_fnmadd_pd(halfR2, _mm512_mul_pd(invR, invR), threeHalves));
+
+            __m512d s = _mm512_mul_pd(invR, _mm512_mul_pd(invR, invR));
+            __m512d sj = _mm512_mul_pd(_mm512_loadu_pd(q + j), s);
+            __m512d si = _mm512_mul_pd(qi, s);
+
+            Ex = _mm512_fmadd_pd(sj, dx, Ex);
+            Ey = _mm512_fmadd_pd(sj, dy, Ey);
+            Ez = _mm512_fmadd_pd(sj, dz, Ez);
+            _mm512_storeu_pd(ex + (j - begin), _mm512_fnmadd_pd(si, dx, _mm512_loadu_pd(ex + (j - begin))));
+            _mm512_storeu_pd(ey + (j - begin), _mm512_fnmadd_pd(si, dy, _mm512_loadu_pd(ey + (j - begin))));
+            _mm512_storeu_pd(ez + (j - begin), _mm512_fnmadd_pd(si, dz, _mm512_loadu_pd(ez + (j - begin))));
+        }
+
+        const glm::dvec3 tail = pairRowScalar(i, j, end, x, y, z, q, ex + (j - begin), ey + (j - begin), ez + (j - begin));
+        return glm::dvec3(horizontalSum(Ex), horizontalSum(Ey), horizontalSum(Ez)) + tail;
+    }
+#endif
+}
+
+CoulombKernel::InstructionSet CoulombKernel::detect() {
+    static const InstructionSet detected = [] {
+#ifdef CPS_X86_SIMD
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool fma = (info[2] & (1 << 12)) != 0;
+        if (!osxsave || maxLeaf < 7) {
+            return InstructionSet::SCALAR;
+        }
+        unsigned long long xcr0 = _xgetbv(0);
+        bool avxState = (xcr0 & 0x6) == 0x6;
+        bool avx512State = (xcr0 & 0xE6) == 0xE6;
+        __cpuidex(info, 7, 0);
+        bool avx2 = (info[1] & (1 << 5)) != 0;
+        bool avx512f = (info[1] & (1 << 16)) != 0;
+        if (avx512f && avx512State) {
+            return InstructionSet::AVX512;
+        }
+        if (avx2 && fma && avxState) {
+            return InstructionSet::AVX2;
+        }
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return InstructionSet::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return InstructionSet::AVX2;
+        }
+#endif
+#endif
+        return InstructionSet::SCALAR;
+    }();
+    return detected;
+}
+
+CoulombKernel::InstructionSet CoulombKernel::active() {
+    return s_overrideSet.load(std::memory_order_relaxed)
+        ? s_override.load(std::memory_order_relaxed)
+        : detect();
+}
+
+void CoulombKernel::setInstructionSet(InstructionSet isa) {
+    // Never select an instruction set the CPU does not support
+    if (static_cast<int>(isa) > static_cast<int>(detect())) {
+        isa = detect();
+    }
+    s_override.store(isa, std::memory_order_relaxed);
+    s_overrideSet.store(true, std::memory_order_relaxed);
+}
+
+const char* CoulombKernel::name(InstructionSet isa) {
+    switch (isa) {
+        case InstructionSet::AVX2: return "AVX2";
+        case InstructionSet::AVX512: return "AVX-512";
+        case InstructionSet::SCALAR:
+        default: return "scalar";
+    }
+}
+
+glm::dvec3 CoulombKernel::fieldAt(
+    const glm::dvec3& evalPoint,
+    const double* x,
+    const double* y,
+    const double* z,
+    const double* q,
+    size_t count
+) {
+    glm::dvec3 E;
+    switch (active()) {
+#ifdef CPS_X86_SIMD
+        case InstructionSet::AVX512:
+            E = fieldAvx512(evalPoint, x, y, z, q, count);
+            break;
+        case InstructionSet::AVX2:
+            E = fieldAvx2(evalPoint, x, y, z, q, count);
+            break;
+#endif
+        default:
+            E = fieldScalar(evalPoint, x, y, z, q, 0, count);
+            break;
+    }
+    return PhysicsConstants::k * E;
+}
+
+glm::dvec3 CoulombKernel::fieldAt(const glm::dvec3& evalPoint, const ParticleStore& sources) {
+    return fieldAt(evalPoint, sources.x.data(), sources.y.data(), sources.z.data(),
+                   sources.q.data(), sources.size());
+}
+
+double CoulombKernel::potentialAt(
+    const glm::dvec3& evalPoint,
+    const double* x,
+    const double* y,
+    const double* z,
+    const double* q,
+    size_t count
+) {
+    double phi;
+    switch (active()) {
+#ifdef CPS_X86_SIMD
+        case InstructionSet::AVX512:
+            phi = potentialAvx512(evalPoint, x, y, z, q, count);
+            break;
+        case InstructionSet::AVX2:
+            phi = potentialAvx2(evalPoint, x, y, z, q, count);
+            break;
+#endif
+        default:
+            phi = potentialScalar(evalPoint, x, y, z, q, 0, count);
+            break;
+    }
+    return PhysicsConstants::k * phi;
+}
+
+double CoulombKernel::potentialAt(const glm::dvec3& evalPoint, const ParticleStore& sources) {
+    return potentialAt(evalPoint, sources.x.data(), sources.y.data(), sources.z.data(),
+                       sources.q.data(), sources.size());
+}
+
+void CoulombKernel::fieldAtPoints(
+    const glm::dvec3* points,
+    size_t pointCount,
+    const ParticleStore& sources,
+    glm::dvec3* out
+) {
+    for (size_t i = 0; i < pointCount; ++i) {
+        out[i] = fieldAt(points[i], sources);
+    }
+}
+
+void CoulombKernel::fieldAtSources(const ParticleStore& sources, std::vector<glm::dvec3>& out) {
+    out.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        out[i] = fieldAt(sources.position(i), sources);
+    }
+}
+
+void CoulombKernel::pairwiseFields(const ParticleStore& particles, std::vector<glm::dvec3>& out, ThreadPool* pool) {
+    const size_t count = particles.size();
+    out.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    PairRow row = pairRowScalar;
+#ifdef CPS_X86_SIMD
+    switch (active()) {
+        case InstructionSet::AVX512: row = pairRowAvx512; break;
+        case InstructionSet::AVX2: row = pairRowAvx2; break;
+        default: break;
+    }
+#endif
+
+    // Tiles are grouped into blocks; a lane is one block pair (A, B), A <= B, and
+    // owns the tile pairs (I, J), I <= J, with I in A and J in B
+    const size_t tiles = (count + PAIR_TILE_SIZE - 1) / PAIR_TILE_SIZE;
+    const size_t blocks = std::min(PAIR_BLOCKS, tiles);
+    const size_t lanes = blocks * (blocks + 1) / 2;
+    auto blockBegin = [&](size_t block) {
+        return std::min(tiles * block / blocks * PAIR_TILE_SIZE, count);
+    };
+
+    // Lanes accumulate only into the particles of their two blocks (one for
+    // A = B): x, y, z partial sums of A, then of B
+    std::vector<size_t> laneOffsets(1, 0);
+    std::vector<std::pair<size_t, size_t>> laneBlocks;
+    for (size_t A = 0; A < blocks; ++A) {
+        for (size_t B = A; B < blocks; ++B) {
+            const size_t particlesA = blockBegin(A + 1) - blockBegin(A);
+            const size_t particlesB = A == B ? 0 : blockBegin(B + 1) - blockBegin(B);
+            laneBlocks.emplace_back(A, B);
+            laneOffsets.push_back(laneOffsets.back() + 3 * (particlesA + particlesB));
+        }
+    }
+
+    // Per-lane sums; kept per calling thread to avoid reallocating every step
+    thread_local ParticleStore::AlignedVector<double> partial;
+    partial.resize(laneOffsets[lanes]);
+    double* sums = partial.data();  // Workers must not name the thread_local themselves
+
+    const double* x = particles.x.data();
+    const double* y = particles.y.data();
+    const double* z = particles.z.data();
+    const double* q = particles.q.data();
+
+    auto runLanes = [&](size_t laneBegin, size_t laneEnd, size_t) {
+        for (size_t lane = laneBegin; lane < laneEnd; ++lane) {
+            const auto [A, B] = laneBlocks[lane];
+            const size_t a0 = blockBegin(A);
+            const size_t a1 = blockBegin(A + 1);
+            const size_t b0 = blockBegin(B);
+            const size_t b1 = blockBegin(B + 1);
+            double* rowX = sums + laneOffsets[lane];
+            double* rowY = rowX + (a1 - a0);
+            double* rowZ = rowY + (a1 - a0);
+            double* columnX = A == B ? rowX : rowZ + (a1 - a0);
+            double* columnY = A == B ? rowY : columnX + (b1 - b0);
+            double* columnZ = A == B ? rowZ : columnY + (b1 - b0);
+            std::fill(sums + laneOffsets[lane], sums + laneOffsets[lane + 1], 0.0);
+
+            for (size_t i0 = a0; i0 < a1; i0 += PAIR_TILE_SIZE) {
+                const size_t i1 = std::min(i0 + PAIR_TILE_SIZE, a1);
+                for (size_t j0 = std::max(b0, i0); j0 < b1; j0 += PAIR_TILE_SIZE) {
+                    const size_t j1 = std::min(j0 + PAIR_TILE_SIZE, b1);
+                    for (size_t i = i0; i < i1; ++i) {
+                        const size_t begin = i0 == j0 ? i + 1 : j0;
+                        const glm::dvec3 E = row(i, begin, j1, x, y, z, q,
+                                                 columnX + (begin - b0), columnY + (begin - b0), columnZ + (begin - b0));
+                        rowX[i - a0] += E.x;
+                        rowY[i - a0] += E.y;
+                        rowZ[i - a0] += E.z;
+                    }
+                }
+            }
+        }
+    };
+
+    // Sum the lanes of each block in a fixed order (as column of the pairs
+    // (A, C), A < C, then as row of (C, B), B >= C), so results do not depend
+    // on the thread count
+    auto laneOf = [&](size_t A, size_t B) {
+        return A * blocks - A * (A - 1) / 2 + (B - A);
+    };
+    auto reduce = [&](size_t blockFirst, size_t blockLast, size_t) {
+        for (size_t C = blockFirst; C < blockLast; ++C) {
+            const size_t c0 = blockBegin(C);
+            const size_t c1 = blockBegin(C + 1);
+            const size_t n = c1 - c0;
+            for (size_t i = c0; i < c1; ++i) {
+                glm::dvec3 E(0.0);
+                for (size_t A = 0; A < C; ++A) {
+                    const size_t rowsA = blockBegin(A + 1) - blockBegin(A);
+                    const double* column = sums + laneOffsets[laneOf(A, C)] + 3 * rowsA;
+                    E += glm::dvec3(column[i - c0], column[n + i - c0], column[2 * n + i - c0]);
+                }
+                for (size_t B = C; B < blocks; ++B) {
+                    const double* rows = sums + laneOffsets[laneOf(C, B)];
+                    E += glm::dvec3(rows[i - c0], rows[n + i - c0], rows[2 * n + i - c0]);
+                }
+                out[i] = PhysicsConstants::k * E;
+            }
+        }
+    };
+
+    if (pool) {
+        // Diagonal lanes have half the pairs of the others: balance dynamically
+        pool->parallelForDynamic(0, lanes, runLanes);
+        pool->parallelFor(0, blocks, reduce);
+    } else {
+        runLanes(0, lanes, 0);
+        reduce(0, blocks, 0);
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+#include "ParticleStore.hpp"
+
+class ThreadPool;
+
+/**
+ * Vectorized Coulomb Kernel
+ *
+ * Sums E = k * q * r / |r|³ (or the potential φ = k * q / |r|) over
+ * structure-of-arrays sources, evaluating 4 (AVX2) or 8 (AVX-512) sources per
+ * instruction. 1/|r| comes from the hardware reciprocal square root estimate
+ * refined with Newton-Raphson iterations, so no sqrt or division is issued in
+ * the inner loop.
+ *
+ * The instruction set is selected at runtime from CPU features; the scalar path
+ * is used on other architectures or older CPUs. Sources closer than
+ * MIN_SAFE_DISTANCE are skipped (self-interaction), matching ElectricField::totalField.
+ *
+ * pairwiseFields() is the exact all-particle sum: each pair is evaluated once and
+ * applied to both particles (Newton's third law), half the work of fieldAtSources().
+ */
+class CoulombKernel {
+public:
+    // Particles per tile of pairwiseFields(): positions, charges and partial
+    // fields of two tiles (28 KB) stay in L1 while their pairs are evaluated
+    static constexpr size_t PAIR_TILE_SIZE = 256;
+
+    // Tile blocks of pairwiseFields(): each block pair is one lane of work, so
+    // 16 blocks give 136 lanes, handed out dynamically to any number of threads
+    static constexpr size_t PAIR_BLOCKS = 16;
+    static constexpr size_t PAIR_LANES = PAIR_BLOCKS * (PAIR_BLOCKS + 1) / 2;
+
+    enum class InstructionSet {
+        SCALAR,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * Best instruction set supported by this CPU (detected once)
+     */
+    static InstructionSet detect();
+
+    /**
+     * Instruction set currently used by the kernel
+     */
+    static InstructionSet active();
+
+    /**
+     * Force a specific instruction set (ignored if unsupported); used for testing
+     * and benchmarking. Pass detect() to restore the default.
+     */
+    static void setInstructionSet(InstructionSet isa);
+
+    /**
+     * Human-readable instruction set name
+     */
+    static const char* name(InstructionSet isa);
+
+    /**
+     * Total field at one point from raw SoA source arrays
+     *
+     * @param evalPoint Point where field is evaluated (meters)
+     * @param x, y, z Source positions (meters)
+     * @param q Source charges (coulombs)
+     * @param count Number of sources
+     * @return Electric field vector in N/C
+     */
+    static glm::dvec3 fieldAt(
+        const glm::dvec3& evalPoint,
+        const double* x,
+        const double* y,
+        const double* z,
+        const double* q,
+        size_t count
+    );
+
+    /**
+     * Total field at one point from a particle store
+     */
+    static glm::dvec3 fieldAt(const glm::dvec3& evalPoint, const ParticleStore& sources);
+
+    /**
+     * Electrostatic potential at one point from raw SoA source arrays
+     *
+     * @return Potential in volts
+     */
+    static double potentialAt(
+        const glm::dvec3& evalPoint,
+        const double* x,
+        const double* y,
+        const double* z,
+        const double* q,
+        size_t count
+    );
+
+    /**
+     * Electrostatic potential at one point from a particle store
+     */
+    static double potentialAt(const glm::dvec3& evalPoint, const ParticleStore& sources);
+
+    /**
+     * Total field at a batch of points (e.g. field line or grid evaluation points)
+     *
+     * @param points Evaluation points
+     * @param pointCount Number of points
+     * @param sources Source particles
+     * @param out Output fields, one per point
+     */
+    static void fieldAtPoints(
+        const glm::dvec3* points,
+        size_t pointCount,
+        const ParticleStore& sources,
+        glm::dvec3* out
+    );
+
+    /**
+     * Field at every source particle due to all others (particle-particle forces)
+     *
+     * @param sources Source particles (also the targets)
+     * @param out Output fields, resized to sources.size()
+     */
+    static void fieldAtSources(const ParticleStore& sources, std::vector<glm::dvec3>& out);
+
+    /**
+     * Field at every particle due to all others, each pair evaluated once
+     *
+     * One r/|r|³ per pair i < j gives both E_i += k q_j r/|r|³ and E_j -= k q_i r/|r|³.
+     * Particles are cut into tiles of PAIR_TILE_SIZE, the tiles into up to
+     * PAIR_BLOCKS blocks, and the block pairs (A <= B) are the lanes, up to
+     * PAIR_LANES. Each lane accumulates into its own buffer over just the
+     * particles of A and B, so lanes run in parallel without atomics, and the
+     * buffers are summed in lane order: results are the same for any thread count.
+     *
+     * @param particles Particles (sources and targets)
+     * @param out Output fields in N/C, resized to particles.size()
+     * @param pool Threads for the ranges and the reduction (nullptr = calling thread)
+     */
+    static void pairwiseFields(const ParticleStore& particles, std::vector<glm::dvec3>& out,
+                               ThreadPool* pool = nullptr);
+
+private:
+    CoulombKernel() = delete;
+};
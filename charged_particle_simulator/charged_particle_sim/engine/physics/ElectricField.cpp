@@ -1,4 +1,5 @@
 #include "ElectricField.hpp"
+#include "CoulombKernel.hpp"
 #include "engine/core/Logger.hpp"
 #include <cmath>
 
@@ -9,22 +10,19 @@ glm::dvec3 ElectricField::fromPointCharge(
 ) {
     // Vector from charge to evaluation point
     glm::dvec3 r = evalPoint - chargePos;
-    double rMag = glm::length(r);
+    double r2 = glm::dot(r, r);
     
     // Prevent singularity at charge location
-    if (rMag < PhysicsConstants::MIN_SAFE_DISTANCE) {
+    if (r2 < PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE) {
         // Return zero field if too close to charge
         return glm::dvec3(0.0);
     }
     
-    // Unit vector in direction from charge to evaluation point
-    glm::dvec3 rHat = r / rMag;
-    
-    // Coulomb's law: E = k * q / r² * r̂
+    // Coulomb's law: E = k * q / r² * r̂ = k * q * r / |r|³
     // Field points away from positive charges, toward negative charges
-    double fieldMagnitude = PhysicsConstants::k * q / (rMag * rMag);
+    double invR = 1.0 / std::sqrt(r2);
     
-    return fieldMagnitude * rHat;
+    return (PhysicsConstants::k * q * invR * invR * invR) * r;
 }
 
 glm::dvec3 ElectricField::totalField(
@@ -34,18 +32,40 @@ glm::dvec3 ElectricField::totalField(
     glm::dvec3 totalE(0.0);
     
     // Sum contributions from all particles
+    // (fromPointCharge skips particles at the evaluation point, i.e. self-interaction)
     for (const auto& particle : particles) {
-        // Skip if particle is at evaluation point (self-interaction)
-        if (glm::length(evalPoint - particle.position) < PhysicsConstants::MIN_SAFE_DISTANCE) {
-            continue;
-        }
-        
         totalE += fromPointCharge(evalPoint, particle.position, particle.charge);
     }
     
     return totalE;
 }
 
+glm::dvec3 ElectricField::totalField(
+    const glm::dvec3& evalPoint,
+    const ParticleStore& sources
+) {
+    return CoulombKernel::fieldAt(evalPoint, sources);
+}
+
+double ElectricField::totalPotential(
+    const glm::dvec3& evalPoint,
+    const std::vector<Particle>& particles
+) {
+    double phi = 0.0;
+    
+    // φ = k * q / |r|, zero reference at infinity
+    for (const auto& particle : particles) {
+        glm::dvec3 r = evalPoint - particle.position;
+        double r2 = glm::dot(r, r);
+        if (r2 < PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE) {
+            continue;
+        }
+        phi += PhysicsConstants::k * particle.charge / std::sqrt(r2);
+    }
+    
+    return phi;
+}
+
 double ElectricField::magnitude(
     const glm::dvec3& evalPoint,
     const std::vector<Particle>& particles
@@ -81,44 +101,10 @@ glm::dvec3 ElectricField::retardedField(
     double retardedTime = currentTime - distance / PhysicsConstants::c;
     
     // Look up particle position at retarded time from history
+    // (binary search over timestamps, Hermite interpolation between samples)
     glm::dvec3 retardedPosition = source.position;
-    
-    if (!source.history.empty()) {
-        // Find closest history point to retarded time
-        double minTimeDiff = std::numeric_limits<double>::max();
-        int bestIndex = -1;
-        
-        for (size_t i = 0; i < source.history.size(); ++i) {
-            double timeDiff = std::abs(source.history[i].timestamp - retardedTime);
-            if (timeDiff < minTimeDiff) {
-                minTimeDiff = timeDiff;
-                bestIndex = static_cast<int>(i);
-            }
-        }
-        
-        if (bestIndex >= 0) {
-            // Use exact match if found, otherwise interpolate
-            if (minTimeDiff < 1e-9) {
-                retardedPosition = source.history[bestIndex].position;
-            } else if (bestIndex > 0 && bestIndex < static_cast<int>(source.history.size()) - 1) {
-                // Linear interpolation between adjacent history points
-                const auto& p1 = source.history[bestIndex - 1];
-                const auto& p2 = source.history[bestIndex + 1];
-                
-                double t1 = p1.timestamp;
-                double t2 = p2.timestamp;
-                
-                if (std::abs(t2 - t1) > 1e-9) {
-                    double alpha = (retardedTime - t1) / (t2 - t1);
-                    retardedPosition = p1.position + alpha * (p2.position - p1.position);
-                } else {
-                    retardedPosition = source.history[bestIndex].position;
-                }
-            } else {
-                retardedPosition = source.history[bestIndex].position;
-            }
-        }
-    }
+    glm::dvec3 retardedVelocity;
+    source.history.sample(retardedTime, retardedPosition, retardedVelocity);
     
     // Calculate field from retarded position
     return fromPointCharge(evalPoint, retardedPosition, source.charge);
@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include "Particle.hpp"
+#include "ParticleStore.hpp"
 #include "engine/core/Constants.hpp"
 
 /**
@@ -45,6 +46,36 @@ public:
         const std::vector<Particle>& particles
     );
     
+    /**
+     * Compute total electric field at point p from structure-of-arrays sources
+     * 
+     * Same result as the std::vector<Particle> overload, but streams only
+     * positions and charges through the vectorized CoulombKernel.
+     * 
+     * @param evalPoint Point where field is evaluated (meters)
+     * @param sources Particle store (positions and charges are read)
+     * @return Total electric field vector in N/C
+     */
+    static glm::dvec3 totalField(
+        const glm::dvec3& evalPoint,
+        const ParticleStore& sources
+    );
+    
+    /**
+     * Compute electrostatic potential at point p from all particles
+     * 
+     * φ = k * q / r summed over particles (zero at infinity); E = -∇φ.
+     * Particles at the evaluation point are skipped, as in totalField.
+     * 
+     * @param evalPoint Point where potential is evaluated (meters)
+     * @param particles Vector of all charged particles
+     * @return Potential in volts
+     */
+    static double totalPotential(
+        const glm::dvec3& evalPoint,
+        const std::vector<Particle>& particles
+    );
+    
     /**
      * Compute electric field magnitude at point p
      * 
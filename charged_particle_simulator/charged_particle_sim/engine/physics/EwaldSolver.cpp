@@ -0,0 +1,223 @@
+#include "EwaldSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Cost of one real-space pair term relative to one particle-wave term of the
+    // reciprocal sum (measured); weights α towards the cheaper sum
+    constexpr double PAIR_COST_RATIO = 32.0;
+
+    // Particles per task in the real-space and reciprocal field loops
+    constexpr size_t PARTICLE_CHUNK_SIZE = 64;
+
+    // Wave vectors per task of the structure factor loop
+    constexpr size_t WAVE_CHUNK_SIZE = 16;
+
+    // a b c written out: std::complex multiplication checks for NaN/infinity
+    std::complex<double> product(const std::complex<double>& a, const std::complex<double>& b,
+                                 const std::complex<double>& c) {
+        const double re = a.real() * b.real() - a.imag() * b.imag();
+        const double im = a.real() * b.imag() + a.imag() * b.real();
+        return {re * c.real() - im * c.imag(), re * c.imag() + im * c.real()};
+    }
+}
+
+EwaldSolver::EwaldSolver()
+    : m_accuracy(DEFAULT_ACCURACY)
+    , m_tunedCount(0)
+    , m_tuned(false)
+    , m_alpha(1.0)
+    , m_cutoff(0.5)
+    , m_waveCutoff(0.0)
+    , m_maxIndex(0)
+{
+}
+
+void EwaldSolver::setBox(const PeriodicBox& box) {
+    if (box != m_box) {
+        m_box = box;
+        m_tuned = false;
+    }
+}
+
+void EwaldSolver::setAccuracy(double accuracy) {
+    const double value = std::clamp(std::isfinite(accuracy) ? accuracy : DEFAULT_ACCURACY, MIN_ACCURACY, MAX_ACCURACY);
+    if (value != m_accuracy) {
+        m_accuracy = value;
+        m_tuned = false;
+    }
+}
+
+void EwaldSolver::tune(size_t count) {
+    if (m_tuned && count == m_tunedCount) {
+        return;
+    }
+    const double volume = m_box.volume();
+    const double s = std::sqrt(-std::log(m_accuracy));
+
+    // Balance N² r_c³ / V pair terms against N k_c³ V wave terms, then keep the
+    // image list within one box: r_c <= L/2
+    m_alpha = std::sqrt(M_PI) * std::pow(PAIR_COST_RATIO * static_cast<double>(count) / (volume * volume), 1.0 / 6.0);
+    m_cutoff = s / m_alpha;
+    if (m_cutoff > 0.5 * m_box.shortestSide()) {
+        m_cutoff = 0.5 * m_box.shortestSide();
+        m_alpha = s / m_cutoff;
+    }
+    m_waveCutoff = 2.0 * m_alpha * s;
+
+    const glm::dvec3 size = m_box.getSize();
+    for (int axis = 0; axis < 3; ++axis) {
+        m_maxIndex[axis] = static_cast<int>(std::floor(m_waveCutoff * size[axis] / (2.0 * M_PI)));
+    }
+
+    // Half of k-space: the -k term equals the k term
+    m_waves.clear();
+    const double waveCutoff2 = m_waveCutoff * m_waveCutoff;
+    const double coefficient = 2.0 * 4.0 * M_PI * PhysicsConstants::k / volume;
+    const double inverseFourAlpha2 = 1.0 / (4.0 * m_alpha * m_alpha);
+    for (int mx = 0; mx <= m_maxIndex.x; ++mx) {
+        for (int my = -m_maxIndex.y; my <= m_maxIndex.y; ++my) {
+            for (int mz = -m_maxIndex.z; mz <= m_maxIndex.z; ++mz) {
+                if (mx == 0 && (my < 0 || (my == 0 && mz <= 0))) {
+                    continue;
+                }
+                const glm::dvec3 k = 2.0 * M_PI * glm::dvec3(mx, my, mz) / size;
+                const double k2 = glm::dot(k, k);
+                if (k2 > waveCutoff2) {
+                    continue;
+                }
+                m_waves.push_back({glm::ivec3(mx, my, mz), k, coefficient * std::exp(-k2 * inverseFourAlpha2) / k2});
+            }
+        }
+    }
+    m_tunedCount = count;
+    m_tuned = true;
+}
+
+void EwaldSolver::computeFields(const ParticleStore& store, ThreadPool* pool) {
+    const size_t count = store.size();
+    m_fields.assign(count, glm::dvec3(0.0));
+    if (count == 0 || !m_box.isValid()) {
+        return;
+    }
+    tune(count);
+
+    // Wrapped positions come first in the image list; both sums read them there
+    m_box.buildImages(store, m_cutoff, m_images);
+    realSpace(pool);
+    reciprocalSpace(store, pool);
+}
+
+void EwaldSolver::realSpace(ThreadPool* pool) {
+    const size_t count = m_images.primaryCount;
+    m_neighborGrid.build(m_images.x.data(), m_images.y.data(), m_images.z.data(), m_images.size(), m_cutoff);
+    const double alpha = m_alpha;
+    const double twoAlphaOverSqrtPi = 2.0 * alpha / std::sqrt(M_PI);
+    const double minDistance2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+    auto particles = [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::dvec3 position(m_images.x[i], m_images.y[i], m_images.z[i]);
+            glm::dvec3 field(0.0);
+            m_neighborGrid.forEachNeighbor(position, m_cutoff, [&](size_t j, double d2) {
+                if (j == i || d2 < minDistance2) {
+                    return;
+                }
+                const double r = std::sqrt(d2);
+                const double radial = std::erfc(alpha * r) / r + twoAlphaOverSqrtPi * std::exp(-alpha * alpha * d2);
+                const double scale = PhysicsConstants::k * m_images.q[j] * radial / d2;
+                field += scale * (position - glm::dvec3(m_images.x[j], m_images.y[j], m_images.z[j]));
+            });
+            m_fields[i] = field;
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, count, particles, PARTICLE_CHUNK_SIZE);
+    } else {
+        particles(0, count, 0);
+    }
+}
+
+void EwaldSolver::reciprocalSpace(const ParticleStore& store, ThreadPool* pool) {
+    const size_t count = m_images.primaryCount;
+    const size_t waveCount = m_waves.size();
+    if (waveCount == 0) {
+        return;
+    }
+    const glm::dvec3 low = m_box.getLow();
+    const glm::dvec3 size = m_box.getSize();
+    const double* coordinates[3] = {m_images.x.data(), m_images.y.data(), m_images.z.data()};
+
+    auto run = [pool](size_t end, size_t chunk, const auto& body) {
+        if (pool) {
+            pool->parallelFor(0, end, body, chunk);
+        } else {
+            body(0, end, 0);
+        }
+    };
+
+    // Phase tables e^(i 2π m x / L) for m in [-max, max], by recurrence from m = 1;
+    // laid out by m so the loops over particles read them contiguously
+    for (int axis = 0; axis < 3; ++axis) {
+        const int maxIndex = m_maxIndex[axis];
+        std::vector<Complex>& phases = m_phases[axis];
+        phases.resize(static_cast<size_t>(2 * maxIndex + 1) * count);
+        const double* u = coordinates[axis];
+        const double scale = 2.0 * M_PI / size[axis];
+        run(count, PARTICLE_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                const Complex step = std::polar(1.0, scale * (u[i] - low[axis]));
+                Complex phase(1.0, 0.0);
+                phases[static_cast<size_t>(maxIndex) * count + i] = phase;
+                for (int m = 1; m <= maxIndex; ++m) {
+                    phase *= step;
+                    phases[static_cast<size_t>(maxIndex + m) * count + i] = phase;
+                    phases[static_cast<size_t>(maxIndex - m) * count + i] = std::conj(phase);
+                }
+            }
+        });
+    }
+    auto phaseRow = [&](int axis, int m) {
+        return m_phases[axis].data() + static_cast<size_t>(m_maxIndex[axis] + m) * count;
+    };
+
+    // Structure factors S(k) = Σ_j q_j e^(ik·r_j), each summed in particle order
+    m_structure.resize(waveCount);
+    run(waveCount, WAVE_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+        for (size_t w = begin; w < end; ++w) {
+            const glm::ivec3& index = m_waves[w].index;
+            const Complex* px = phaseRow(0, index.x);
+            const Complex* py = phaseRow(1, index.y);
+            const Complex* pz = phaseRow(2, index.z);
+            double re = 0.0;
+            double im = 0.0;
+            for (size_t j = 0; j < count; ++j) {
+                const Complex phase = product(px[j], py[j], pz[j]);
+                re += store.q[j] * phase.real();
+                im += store.q[j] * phase.imag();
+            }
+            m_structure[w] = Complex(re, im);
+        }
+    });
+
+    // E_i += Σ_k weight k Im(e^(ik·r_i) S(k)*), a block of particles per wave
+    run(count, PARTICLE_CHUNK_SIZE, [&](size_t begin, size_t end, size_t) {
+        for (size_t w = 0; w < waveCount; ++w) {
+            const Wave& wave = m_waves[w];
+            const Complex* px = phaseRow(0, wave.index.x);
+            const Complex* py = phaseRow(1, wave.index.y);
+            const Complex* pz = phaseRow(2, wave.index.z);
+            const glm::dvec3 weighted = wave.weight * wave.k;
+            const Complex structure = m_structure[w];
+            for (size_t i = begin; i < end; ++i) {
+                const Complex phase = product(px[i], py[i], pz[i]);
+                const double sine = phase.imag() * structure.real() - phase.real() * structure.imag();
+                m_fields[i] += sine * weighted;
+            }
+        }
+    });
+}
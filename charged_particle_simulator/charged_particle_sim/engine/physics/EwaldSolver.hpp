@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <complex>
+#include <vector>
+#include "ParticleStore.hpp"
+#include "PeriodicBox.hpp"
+#include "NeighborGrid.hpp"
+#include "engine/core/ThreadPool.hpp"
+
+/**
+ * Ewald Summation Solver
+ *
+ * Coulomb field at every particle of a periodic box, including all periodic
+ * images, to a requested accuracy. The interaction is split with a Gaussian of
+ * width 1/α:
+ * - real space: k q (erfc(αr)/r + 2α/√π e^(-α²r²)) r/r² over the pairs closer
+ *   than the cutoff r_c, found with a NeighborGrid over the particles and their
+ *   images near the box faces (PeriodicBox::buildImages)
+ * - reciprocal space: (4π k / V) Σ_k e^(-k²/4α²)/k² k Im(e^(ik·r_i) S(k)*) over the
+ *   wave vectors with |k| <= k_c, where the structure factors S(k) = Σ_j q_j e^(ik·r_j)
+ *   are computed once per evaluation from per-axis phase tables (k and -k are
+ *   one term)
+ *
+ * Unlike P3MSolver, nothing is interpolated: both sums are exact up to their
+ * truncation, which setAccuracy() controls. With s = √(-ln accuracy), the cutoffs
+ * are r_c = s/α and k_c = 2αs, so both truncated tails are of order the accuracy
+ * relative to the field. α balances the two sums for the particle count
+ * (α = √π (w N / V²)^(1/6), w the relative cost of a pair term), which makes an
+ * evaluation O(N^1.5); r_c is at most half the shortest box side.
+ *
+ * The mean field is zero, as if a uniform background neutralized any net charge.
+ * Parameters are retuned when the box, the accuracy or the particle count changes.
+ */
+class EwaldSolver {
+public:
+    static constexpr double DEFAULT_ACCURACY = 1e-6;
+    static constexpr double MIN_ACCURACY = 1e-12;
+    static constexpr double MAX_ACCURACY = 1e-2;
+
+    EwaldSolver();
+
+    void setBox(const PeriodicBox& box);
+    const PeriodicBox& getBox() const { return m_box; }
+
+    /**
+     * Relative truncation error of both sums (clamped to MIN_ACCURACY to MAX_ACCURACY)
+     */
+    void setAccuracy(double accuracy);
+    double getAccuracy() const { return m_accuracy; }
+
+    /**
+     * Parameters of the last computeFields(): splitting α (1/m), real-space
+     * cutoff (m), reciprocal cutoff (1/m) and number of wave vectors (k, -k counted once)
+     */
+    double getSplitting() const { return m_alpha; }
+    double getCutoff() const { return m_cutoff; }
+    double getWaveCutoff() const { return m_waveCutoff; }
+    size_t getWaveCount() const { return m_waves.size(); }
+
+    /**
+     * Compute the field at every particle (positions outside the box are wrapped)
+     * Results are available through getFields() in particle order.
+     *
+     * @param pool Optional thread pool for the real-space and reciprocal loops
+     */
+    void computeFields(const ParticleStore& store, ThreadPool* pool = nullptr);
+
+    const std::vector<glm::dvec3>& getFields() const { return m_fields; }
+
+private:
+    using Complex = std::complex<double>;
+
+    struct Wave {
+        glm::ivec3 index;     // Multiples of 2π/L per axis (x >= 0)
+        glm::dvec3 k;
+        double weight;        // 2 (4π k / V) e^(-k²/4α²) / k²: the k and -k terms
+    };
+
+    /**
+     * Choose α, the cutoffs and the wave vectors for the box, accuracy and count
+     */
+    void tune(size_t count);
+
+    void realSpace(ThreadPool* pool);
+    void reciprocalSpace(const ParticleStore& store, ThreadPool* pool);
+
+    // Settings
+    PeriodicBox m_box;
+    double m_accuracy;
+    size_t m_tunedCount;           // 0 until tuned
+    bool m_tuned;
+
+    // Derived from the settings
+    double m_alpha;
+    double m_cutoff;
+    double m_waveCutoff;
+    glm::ivec3 m_maxIndex;         // Largest wave index per axis
+    std::vector<Wave> m_waves;
+
+    // Per-evaluation state
+    PeriodicBox::Images m_images;
+    NeighborGrid m_neighborGrid;
+    std::vector<Complex> m_phases[3];       // [axis][(m + offset) * N + i]: e^(i 2π m x_i / L)
+    std::vector<Complex> m_structure;       // [wave]: S(k)
+    std::vector<glm::dvec3> m_fields;
+};
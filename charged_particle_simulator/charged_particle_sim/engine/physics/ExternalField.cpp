@@ -0,0 +1,22 @@
+#include "ExternalField.hpp"
+
+ExternalField::ExternalField()
+    : m_uniformE(0.0)
+    , m_uniformB(0.0)
+    , m_revision(0)
+{
+}
+
+bool ExternalField::isActive() const {
+    return m_uniformE != glm::dvec3(0.0) || m_uniformB != glm::dvec3(0.0) || hasFunction();
+}
+
+void ExternalField::evaluate(const glm::dvec3& position, double time, glm::dvec3& E, glm::dvec3& B) const {
+    glm::dvec3 functionE(0.0);
+    glm::dvec3 functionB(0.0);
+    if (m_function) {
+        m_function(position, time, functionE, functionB);
+    }
+    E = m_uniformE + functionE;
+    B = m_uniformB + functionB;
+}
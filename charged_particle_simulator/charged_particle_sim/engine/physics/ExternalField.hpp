@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+
+/**
+ * External Field
+ *
+ * Applied electric and magnetic fields that do not come from the particles
+ * (capacitor plates, solenoids, traps). The field at a point is the sum of a
+ * uniform part and an optional user-defined function of position and time.
+ *
+ * The function is called from the force loop's worker threads, so it must be
+ * safe to call concurrently (a pure function of its arguments). Only the uniform
+ * part is saved in checkpoints.
+ */
+class ExternalField {
+public:
+    /**
+     * User-defined field: adds its contribution to E and B (both start at zero)
+     */
+    using FieldFunction = std::function<void(const glm::dvec3& position, double time,
+                                             glm::dvec3& E, glm::dvec3& B)>;
+
+    ExternalField();
+
+    /**
+     * Uniform fields (V/m and tesla)
+     */
+    void setUniformElectric(const glm::dvec3& E) { m_uniformE = E; ++m_revision; }
+    void setUniformMagnetic(const glm::dvec3& B) { m_uniformB = B; ++m_revision; }
+    const glm::dvec3& getUniformElectric() const { return m_uniformE; }
+    const glm::dvec3& getUniformMagnetic() const { return m_uniformB; }
+
+    /**
+     * Set the position and time dependent part (empty function removes it)
+     */
+    void setFunction(FieldFunction function) { m_function = std::move(function); ++m_revision; }
+    bool hasFunction() const { return static_cast<bool>(m_function); }
+
+    /**
+     * True if any external field is set
+     */
+    bool isActive() const;
+
+    /**
+     * Incremented by every setter (lets callers detect field changes)
+     */
+    uint64_t getRevision() const { return m_revision; }
+
+    /**
+     * Total external field at a point
+     *
+     * @param position Evaluation point (meters)
+     * @param time Simulation time (seconds)
+     * @param E Electric field (output)
+     * @param B Magnetic field (output)
+     */
+    void evaluate(const glm::dvec3& position, double time, glm::dvec3& E, glm::dvec3& B) const;
+
+private:
+    glm::dvec3 m_uniformE;
+    glm::dvec3 m_uniformB;
+    FieldFunction m_function;
+    uint64_t m_revision;
+};
@@ -0,0 +1,267 @@
+#include "FieldGrid.hpp"
+#include "CoulombKernel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Catmull-Rom weights of nodes -1, 0, 1, 2 at position t in [0, 1] of a cell
+    void catmullRomWeights(double t, double* w) {
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        w[0] = 0.5 * (-t3 + 2.0 * t2 - t);
+        w[1] = 0.5 * (3.0 * t3 - 5.0 * t2 + 2.0);
+        w[2] = 0.5 * (-3.0 * t3 + 4.0 * t2 + t);
+        w[3] = 0.5 * (t3 - t2);
+    }
+}
+
+FieldGrid::FieldGrid()
+    : m_resolution(64)
+    , m_interpolation(Interpolation::TRICUBIC)
+    , m_exactRadius(2.0)
+    , m_padding(0.5)
+    , m_settingsChanged(false)
+    , m_built(false)
+    , m_origin(0.0)
+    , m_cellSize(1.0)
+    , m_counts(0)
+    , m_exactDistance(0.0)
+{
+}
+
+void FieldGrid::setResolution(int cells) {
+    m_resolution = std::max(cells, 2);
+    m_settingsChanged = true;
+}
+
+void FieldGrid::setInterpolation(Interpolation interpolation) {
+    m_interpolation = interpolation;
+    m_settingsChanged = true;
+}
+
+void FieldGrid::setExactRadius(double cells) {
+    m_exactRadius = std::max(cells, 0.0);
+    m_settingsChanged = true;
+}
+
+void FieldGrid::setPadding(double fraction) {
+    m_padding = std::max(fraction, 0.0);
+    m_settingsChanged = true;
+}
+
+void FieldGrid::build(const std::vector<Particle>& particles, const FieldFunction& source, ThreadPool* pool) {
+    m_store.loadFrom(particles);
+    m_source = source;
+    m_settingsChanged = false;
+    m_built = true;
+    m_nodes.clear();
+    m_cellStart.clear();
+    m_cellParticles.clear();
+    m_counts = glm::ivec3(0);
+
+    // Without extent there is nothing to interpolate: every point is exact
+    if (particles.empty()) {
+        return;
+    }
+    glm::dvec3 low = particles[0].position;
+    glm::dvec3 high = low;
+    for (const auto& p : particles) {
+        low = glm::min(low, p.position);
+        high = glm::max(high, p.position);
+    }
+    const glm::dvec3 size = high - low;
+    const double extent = std::max(size.x, std::max(size.y, size.z));
+    if (!(extent > 0.0) || !std::isfinite(extent)) {
+        return;
+    }
+
+    const double padding = m_padding * extent;
+    m_cellSize = (extent + 2.0 * padding) / m_resolution;
+    m_origin = low - glm::dvec3(padding);
+    for (int axis = 0; axis < 3; ++axis) {
+        m_counts[axis] = static_cast<int>(std::ceil((size[axis] + 2.0 * padding) / m_cellSize)) + 1;
+        m_counts[axis] = std::max(m_counts[axis], 2);
+    }
+
+    // Sample nodes slice by slice
+    m_nodes.resize(static_cast<size_t>(m_counts.x) * m_counts.y * m_counts.z);
+    auto sampleSlices = [this](size_t begin, size_t end, size_t) {
+        for (size_t z = begin; z < end; ++z) {
+            for (int y = 0; y < m_counts.y; ++y) {
+                for (int x = 0; x < m_counts.x; ++x) {
+                    glm::dvec3 node = m_origin + m_cellSize * glm::dvec3(x, y, static_cast<double>(z));
+                    m_nodes[nodeIndex(x, y, static_cast<int>(z))] = exactFieldAt(node);
+                }
+            }
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, static_cast<size_t>(m_counts.z), sampleSlices);
+    } else {
+        sampleSlices(0, static_cast<size_t>(m_counts.z), 0);
+    }
+
+    m_exactDistance = m_exactRadius * m_cellSize;
+    listCellParticles();
+}
+
+void FieldGrid::listCellParticles() {
+    const size_t cells = m_nodes.size();
+    m_cellStart.assign(cells + 1, 0);
+    m_cellParticles.clear();
+    if (!(m_exactDistance > 0.0)) {
+        return;
+    }
+    const double radius2 = m_exactDistance * m_exactDistance;
+    const glm::ivec3 lastCell = m_counts - 2;
+
+    // Visit the cells each particle's exact sphere reaches, as visit(cell, particle)
+    auto forEachReach = [&](auto&& visit) {
+        for (size_t i = 0; i < m_store.size(); ++i) {
+            const glm::dvec3 p = m_store.position(i);
+            const glm::dvec3 u = (p - m_origin) / m_cellSize;
+            glm::ivec3 from = glm::clamp(glm::ivec3(glm::floor(u - m_exactRadius)), glm::ivec3(0), lastCell);
+            glm::ivec3 to = glm::clamp(glm::ivec3(glm::floor(u + m_exactRadius)), glm::ivec3(0), lastCell);
+            for (int z = from.z; z <= to.z; ++z) {
+                for (int y = from.y; y <= to.y; ++y) {
+                    for (int x = from.x; x <= to.x; ++x) {
+                        // Distance from the particle to the nearest point of the cell
+                        const glm::dvec3 low = m_origin + m_cellSize * glm::dvec3(x, y, z);
+                        const glm::dvec3 gap = glm::max(glm::max(low - p, p - low - m_cellSize), glm::dvec3(0.0));
+                        if (glm::dot(gap, gap) < radius2) {
+                            visit(nodeIndex(x, y, z), static_cast<uint32_t>(i));
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    // Counting sort of (cell, particle) pairs by cell
+    forEachReach([this](size_t cell, uint32_t) { ++m_cellStart[cell + 1]; });
+    for (size_t c = 0; c < cells; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+    m_cellParticles.resize(m_cellStart[cells]);
+    std::vector<uint32_t> next(m_cellStart.begin(), m_cellStart.end() - 1);
+    forEachReach([this, &next](size_t cell, uint32_t particle) { m_cellParticles[next[cell]++] = particle; });
+}
+
+bool FieldGrid::matches(const std::vector<Particle>& particles) const {
+    if (!m_built || m_settingsChanged || particles.size() != m_store.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < particles.size(); ++i) {
+        if (particles[i].position != m_store.position(i) || particles[i].charge != m_store.q[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+glm::dvec3 FieldGrid::fieldAt(const glm::dvec3& point) const {
+    Stencil stencil;
+    if (!stencilAt(point, stencil)) {
+        return exactFieldAt(point);
+    }
+    glm::dvec3 E = interpolate(stencil);
+
+    const size_t cell = nodeIndex(stencil.cell.x, stencil.cell.y, stencil.cell.z);
+    const uint32_t begin = m_cellStart[cell];
+    const uint32_t end = m_cellStart[cell + 1];
+    if (begin == end) {
+        return E;
+    }
+
+    // Nearby charges: swap the interpolation of their own field for the exact one.
+    // For charge q at x that is q * Σ c_n (x - s_n) / |x - s_n|³ over sources s_n:
+    // the stencil nodes with their weights and the point itself with weight -1.
+    alignas(64) double x[MAX_STENCIL_SOURCES];
+    alignas(64) double y[MAX_STENCIL_SOURCES];
+    alignas(64) double z[MAX_STENCIL_SOURCES];
+    alignas(64) double c[MAX_STENCIL_SOURCES];
+    size_t sources = 0;
+    for (int k = 0; k < stencil.size; ++k) {
+        for (int j = 0; j < stencil.size; ++j) {
+            for (int i = 0; i < stencil.size; ++i) {
+                const glm::dvec3 node = m_origin + m_cellSize * glm::dvec3(stencil.first + glm::ivec3(i, j, k));
+                x[sources] = node.x;
+                y[sources] = node.y;
+                z[sources] = node.z;
+                c[sources] = stencil.weights[0][i] * stencil.weights[1][j] * stencil.weights[2][k];
+                ++sources;
+            }
+        }
+    }
+    x[sources] = point.x;
+    y[sources] = point.y;
+    z[sources] = point.z;
+    c[sources] = -1.0;
+    ++sources;
+
+    for (uint32_t n = begin; n < end; ++n) {
+        const uint32_t j = m_cellParticles[n];
+        E += m_store.q[j] * CoulombKernel::fieldAt(m_store.position(j), x, y, z, c, sources);
+    }
+    return E;
+}
+
+bool FieldGrid::interpolates(const glm::dvec3& point) const {
+    Stencil stencil;
+    return stencilAt(point, stencil);
+}
+
+glm::dvec3 FieldGrid::exactFieldAt(const glm::dvec3& point) const {
+    return m_source ? m_source(point) : CoulombKernel::fieldAt(point, m_store);
+}
+
+bool FieldGrid::stencilAt(const glm::dvec3& point, Stencil& stencil) const {
+    if (m_nodes.empty()) {
+        return false;
+    }
+    const glm::dvec3 u = (point - m_origin) / m_cellSize;
+    const glm::dvec3 last(m_counts - 1);
+    // Negated test also rejects NaN
+    if (!(glm::all(glm::greaterThanEqual(u, glm::dvec3(0.0))) && glm::all(glm::lessThanEqual(u, last)))) {
+        return false;
+    }
+    // Points on the far faces belong to the last cell
+    stencil.cell = glm::min(glm::ivec3(glm::floor(u)), m_counts - 2);
+    const glm::dvec3 t = u - glm::dvec3(stencil.cell);
+
+    // Tricubic stencils need one more node on each side; trilinear at the border
+    if (m_interpolation == Interpolation::TRICUBIC &&
+        glm::all(glm::greaterThanEqual(stencil.cell, glm::ivec3(1))) &&
+        glm::all(glm::lessThanEqual(stencil.cell, m_counts - 3))) {
+        stencil.first = stencil.cell - 1;
+        stencil.size = 4;
+        for (int axis = 0; axis < 3; ++axis) {
+            catmullRomWeights(t[axis], stencil.weights[axis]);
+        }
+    } else {
+        stencil.first = stencil.cell;
+        stencil.size = 2;
+        for (int axis = 0; axis < 3; ++axis) {
+            stencil.weights[axis][0] = 1.0 - t[axis];
+            stencil.weights[axis][1] = t[axis];
+        }
+    }
+    return true;
+}
+
+glm::dvec3 FieldGrid::interpolate(const Stencil& stencil) const {
+    glm::dvec3 E(0.0);
+    for (int k = 0; k < stencil.size; ++k) {
+        glm::dvec3 plane(0.0);
+        for (int j = 0; j < stencil.size; ++j) {
+            const size_t row = nodeIndex(stencil.first.x, stencil.first.y + j, stencil.first.z + k);
+            glm::dvec3 line(0.0);
+            for (int i = 0; i < stencil.size; ++i) {
+                line += stencil.weights[0][i] * m_nodes[row + i];
+            }
+            plane += stencil.weights[1][j] * line;
+        }
+        E += stencil.weights[2][k] * plane;
+    }
+    return E;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Particle.hpp"
+#include "ParticleStore.hpp"
+#include "engine/core/ThreadPool.hpp"
+
+/**
+ * Field Grid (3D lookup texture)
+ *
+ * Electric field sampled on a uniform grid for fast repeated evaluation, e.g.
+ * field line tracing. build() costs one field evaluation per node; afterwards
+ * fieldAt() interpolates the 8 (trilinear) or 64 (tricubic Catmull-Rom) nodes
+ * around a point in O(1), whatever the particle count.
+ *
+ * The grid covers the particles' bounding box plus a padding margin with cubic
+ * cells, `resolution` cells along the longest side; points outside it use the
+ * exact field source. Interpolation cannot follow the 1/r² singularity of a
+ * nearby charge, so for every particle within about exactRadius cells of a point
+ * the interpolated part of its own field is replaced by its exact Coulomb field:
+ * the same stencil weights are applied to that particle's field at the stencil
+ * nodes and the result subtracted (one vectorized CoulombKernel sum over the
+ * stencil per nearby particle). Near charges the singular terms are thus exact
+ * at O(1) cost, never an O(N) sum. The particles reaching into each cell are
+ * listed at build time.
+ *
+ * matches() tells whether the grid was built from the given positions and
+ * charges with the current settings, so callers can reuse it until particles
+ * move. Queries are read-only and thread-safe after build().
+ */
+class FieldGrid {
+public:
+    enum class Interpolation {
+        TRILINEAR,
+        TRICUBIC
+    };
+
+    /**
+     * Field source for nodes and exact evaluations (must be thread-safe)
+     */
+    using FieldFunction = std::function<glm::dvec3(const glm::dvec3&)>;
+
+    FieldGrid();
+
+    /**
+     * Cells along the longest side of the grid (at least 2)
+     */
+    void setResolution(int cells);
+    int getResolution() const { return m_resolution; }
+
+    void setInterpolation(Interpolation interpolation);
+    Interpolation getInterpolation() const { return m_interpolation; }
+
+    /**
+     * Distance from a particle, in cells, within which its own field is evaluated
+     * exactly rather than interpolated (default 2). Larger radii are more accurate
+     * in dense clouds but each nearby particle costs a stencil-sized sum.
+     */
+    void setExactRadius(double cells);
+    double getExactRadius() const { return m_exactRadius; }
+
+    /**
+     * Margin around the particles' bounding box, as a fraction of its longest side
+     */
+    void setPadding(double fraction);
+    double getPadding() const { return m_padding; }
+
+    /**
+     * Sample the field of the particles on the grid
+     *
+     * @param particles Source particles (copied)
+     * @param source Field source for nodes and exact evaluations (empty = direct sum)
+     * @param pool Optional thread pool for sampling nodes
+     */
+    void build(const std::vector<Particle>& particles, const FieldFunction& source = nullptr,
+               ThreadPool* pool = nullptr);
+
+    /**
+     * True if built from exactly these positions and charges with the current settings
+     */
+    bool matches(const std::vector<Particle>& particles) const;
+
+    /**
+     * Make matches() fail until the next build (e.g. the field source changed)
+     */
+    void invalidate() { m_settingsChanged = true; }
+
+    /**
+     * Field at a point: interpolated with exact near terms, or exact outside the grid
+     */
+    glm::dvec3 fieldAt(const glm::dvec3& point) const;
+
+    /**
+     * True if fieldAt() uses the grid at the point (false outside it)
+     */
+    bool interpolates(const glm::dvec3& point) const;
+
+    /**
+     * Field from the exact source
+     */
+    glm::dvec3 exactFieldAt(const glm::dvec3& point) const;
+
+    bool isBuilt() const { return m_built; }
+    size_t getNodeCount() const { return m_nodes.size(); }
+    double getCellSize() const { return m_cellSize; }
+    const glm::dvec3& getOrigin() const { return m_origin; }
+
+private:
+    size_t nodeIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * m_counts.y + static_cast<size_t>(y)) * m_counts.x + static_cast<size_t>(x);
+    }
+
+    /**
+     * Interpolation stencil: `size` nodes per axis from `first`, with weights
+     */
+    static constexpr size_t MAX_STENCIL_SOURCES = 4 * 4 * 4 + 1;
+
+    struct Stencil {
+        glm::ivec3 first;
+        glm::ivec3 cell;          // Cell containing the point
+        int size;
+        double weights[3][4];
+    };
+
+    /**
+     * Stencil at a point (tricubic, or trilinear at the border); false outside the grid
+     */
+    bool stencilAt(const glm::dvec3& point, Stencil& stencil) const;
+
+    /**
+     * Weighted sum of sampled nodes
+     */
+    glm::dvec3 interpolate(const Stencil& stencil) const;
+
+    /**
+     * List the particles whose exact sphere reaches into each cell
+     */
+    void listCellParticles();
+
+    // Settings
+    int m_resolution;
+    Interpolation m_interpolation;
+    double m_exactRadius;
+    double m_padding;
+    bool m_settingsChanged;       // Settings or source differ from the last build
+
+    // Sources of the last build
+    bool m_built;
+    ParticleStore m_store;
+    FieldFunction m_source;
+
+    // Grid
+    glm::dvec3 m_origin;          // Node (0, 0, 0)
+    double m_cellSize;
+    glm::ivec3 m_counts;          // Nodes per axis (0 if nothing is interpolated)
+    std::vector<glm::dvec3> m_nodes;       // [nodeIndex]: sampled field
+    double m_exactDistance;       // exactRadius in meters
+    std::vector<uint32_t> m_cellStart;     // [cell (nodeIndex of its low corner)], [cell + 1]: range in m_cellParticles
+    std::vector<uint32_t> m_cellParticles; // Particles reaching into each cell
+};
@@ -1,7 +1,9 @@
 #include "FieldLineGenerator.hpp"
+#include "CoulombKernel.hpp"
 #include "engine/core/Logger.hpp"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -10,108 +12,216 @@
 // Golden angle for Fibonacci sphere distribution
 const double GOLDEN_ANGLE = M_PI * (3.0 - sqrt(5.0));
 
+// Seeds handed to a thread at a time during parallel tracing
+constexpr size_t TRACE_GRAIN_SIZE = 2;
+
 FieldLine FieldLineGenerator::generate(
     const glm::dvec3& seedPoint,
     const std::vector<Particle>& particles,
     const FieldLineConfig& config,
     bool traceForward
+) {
+    // Determine source charge (nearest particle)
+    return trace(seedPoint, particles, config, traceForward, nearestParticle(seedPoint, particles));
+}
+
+FieldLine FieldLineGenerator::trace(
+    const glm::dvec3& seedPoint,
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    bool traceForward,
+    int sourceIndex
 ) {
     FieldLine line;
     line.isForward = traceForward;
+    if (sourceIndex >= 0) {
+        line.sourceCharge = static_cast<float>(particles[sourceIndex].charge);
+    }
     
-    glm::dvec3 pos = seedPoint;
-    double h = config.stepSize;
+    const double sign = traceForward ? 1.0 : -1.0;
+    if (config.integrator == FieldLineIntegrator::DORMAND_PRINCE) {
+        traceDormandPrince(line, seedPoint, particles, config, sign);
+    } else {
+        traceRK4(line, seedPoint, particles, config, sign);
+    }
     
-    // Determine source charge (nearest particle)
-    if (!particles.empty()) {
-        double minDist = std::numeric_limits<double>::max();
-        for (const auto& p : particles) {
-            double dist = glm::length(pos - p.position);
-            if (dist < minDist) {
-                minDist = dist;
-                line.sourceCharge = static_cast<float>(p.charge);
-            }
-        }
+    if (!line.isComplete && line.points.size() >= static_cast<size_t>(config.maxStepsPerLine)) {
+        // Reached maximum steps
+        line.isComplete = true;
     }
     
+    return line;
+}
+
+void FieldLineGenerator::traceRK4(
+    FieldLine& line,
+    const glm::dvec3& seedPoint,
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    double sign
+) {
+    const double h = config.stepSize;
+    
+    glm::dvec3 pos = seedPoint;
+    double curvature = 0.0;  // Direction change per unit length over the previous step
+    double nearestDistance2 = 0.0;
+    
+    // Field at the current point: termination test, stored magnitude and k1
+    glm::dvec3 E = evaluateField(pos, particles, config, line.fieldEvaluations);
+    
     for (int step = 0; step < config.maxStepsPerLine; ++step) {
-        // Evaluate electric field at current position
-        glm::dvec3 E = ElectricField::totalField(pos, particles);
-        double EMag = glm::length(E);
-        
-        // === Termination Conditions ===
-        
-        // 1. Field magnitude too weak
-        if (EMag < config.minFieldMagnitude) {
-            line.isComplete = true;
+        // Abandon the trace if the caller no longer needs it
+        if (cancelled(config)) {
             break;
         }
         
-        // 2. Distance from origin too large
-        if (glm::length(pos) > config.maxDistance) {
-            line.isComplete = true;
+        double EMag = glm::length(E);
+        if (!acceptPoint(line, pos, EMag, particles, config, nearestDistance2)) {
             break;
         }
         
-        // 3. Entered a particle (opposite sign charge)
-        int particleIndex = -1;
-        if (isInsideParticle(pos, particles, particleIndex)) {
-            // Check if charge sign matches
-            if (particleIndex >= 0 && particleIndex < static_cast<int>(particles.size())) {
-                const Particle& p = particles[particleIndex];
-                int sourceSign = (line.sourceCharge > 0) ? 1 : -1;
-                int targetSign = (p.charge > 0) ? 1 : -1;
-                
-                // Terminate if opposite sign (field line ends at opposite charge)
-                if (sourceSign != targetSign) {
-                    line.isComplete = true;
-                    break;
-                }
-            }
-        }
-        
-        // === Store Point ===
-        line.points.push_back(pos);
-        line.fieldMagnitudes.push_back(static_cast<float>(EMag));
-        
         // === RK4 Integration ===
         
-        // Field direction (normalized)
-        glm::dvec3 direction = traceForward ? glm::normalize(E) : -glm::normalize(E);
+        // dy/ds = field direction (normalized)
+        glm::dvec3 k1 = (sign / EMag) * E;
         
         // Adaptive step sizing based on curvature
         double adaptiveH = h;
         if (config.useAdaptiveStep) {
-            double curvature = estimateCurvature(pos, direction, particles);
             adaptiveH = h / (1.0 + curvature * config.adaptiveStepFactor);
         }
         
-        // RK4 step: integrate along field direction
-        // dy/dt = direction (field direction is constant for small steps)
-        // We can use a simplified RK4 for this
-        glm::dvec3 k1 = direction;
-        glm::dvec3 k2 = ElectricField::direction(pos + 0.5 * adaptiveH * k1, particles);
-        if (glm::length(k2) < 1e-10) k2 = k1; // Fallback if field too weak
-        if (!traceForward) k2 = -k2;
-        
-        glm::dvec3 k3 = ElectricField::direction(pos + 0.5 * adaptiveH * k2, particles);
-        if (glm::length(k3) < 1e-10) k3 = k2;
-        if (!traceForward) k3 = -k3;
-        
-        glm::dvec3 k4 = ElectricField::direction(pos + adaptiveH * k3, particles);
-        if (glm::length(k4) < 1e-10) k4 = k3;
-        if (!traceForward) k4 = -k4;
+        glm::dvec3 k2 = stageDirection(pos + 0.5 * adaptiveH * k1, sign, k1, particles, config, line.fieldEvaluations);
+        glm::dvec3 k3 = stageDirection(pos + 0.5 * adaptiveH * k2, sign, k2, particles, config, line.fieldEvaluations);
+        glm::dvec3 k4 = stageDirection(pos + adaptiveH * k3, sign, k3, particles, config, line.fieldEvaluations);
         
         // Update position using RK4
         pos = pos + (adaptiveH / 6.0) * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+        
+        // Curvature from stage data: turn of the direction across this step
+        curvature = glm::length(k4 - k1) / adaptiveH;
+        
+        E = evaluateField(pos, particles, config, line.fieldEvaluations);
     }
+}
+
+void FieldLineGenerator::traceDormandPrince(
+    FieldLine& line,
+    const glm::dvec3& seedPoint,
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    double sign
+) {
+    glm::dvec3 pos = seedPoint;
+    double h = config.stepSize;
+    double nearestDistance2 = 0.0;
     
-    if (!line.isComplete && line.points.size() >= static_cast<size_t>(config.maxStepsPerLine)) {
-        // Reached maximum steps
+    // Stage derivative: signed unit field. The last stage of a step is evaluated at
+    // the new point, so `lastField` then holds the field there for the next k1.
+    glm::dvec3 lastField(0.0);
+    glm::dvec3 lastDirection(0.0);
+    std::function<glm::dvec3(const glm::dvec3&, double)> direction =
+        [&](const glm::dvec3& p, double) {
+            lastField = evaluateField(p, particles, config, line.fieldEvaluations);
+            double mag = glm::length(lastField);
+            // Keep the previous stage direction if the field is too weak to define one
+            if (mag >= 1e-20) {
+                lastDirection = (sign / mag) * lastField;
+            }
+            return lastDirection;
+        };
+    
+    glm::dvec3 k1 = direction(pos, 0.0);
+    glm::dvec3 E = lastField;
+    
+    for (int step = 0; step < config.maxStepsPerLine; ++step) {
+        if (cancelled(config)) {
+            break;
+        }
+        
+        double EMag = glm::length(E);
+        if (!acceptPoint(line, pos, EMag, particles, config, nearestDistance2)) {
+            break;
+        }
+        
+        // Never step further than halfway to the nearest charge
+        double maxH = config.maxStepSize;
+        if (!particles.empty()) {
+            maxH = std::min(maxH, 0.5 * std::sqrt(nearestDistance2));
+        }
+        h = std::max(std::min(h, maxH), config.minStepSize);
+        
+        EmbeddedStepResult<glm::dvec3, glm::dvec3> result;
+        while (true) {
+            lastDirection = k1;
+            result = dormandPrinceStep<glm::dvec3, glm::dvec3>(pos, 0.0, h, k1, direction);
+            
+            // RMS of the per-component error relative to the mixed tolerance
+            double errorNorm2 = 0.0;
+            for (int c = 0; c < 3; ++c) {
+                double scale = config.absoluteTolerance +
+                    config.relativeTolerance * std::max(std::abs(pos[c]), std::abs(result.y[c]));
+                double e = result.error[c] / scale;
+                errorNorm2 += e * e;
+            }
+            double errorNorm = std::sqrt(errorNorm2 / 3.0);
+            
+            if (errorNorm <= 1.0 || h <= config.minStepSize) {
+                h *= embeddedStepFactor(errorNorm, 4, 1.0, config.maxStepGrowth);
+                break;
+            }
+            
+            // Reject: retry with a smaller step
+            ++line.rejectedSteps;
+            h = std::max(h * embeddedStepFactor(errorNorm, 4, config.maxStepShrink, 1.0), config.minStepSize);
+            if (cancelled(config)) {
+                return;
+            }
+        }
+        
+        pos = result.y;
+        k1 = result.fsal;
+        E = lastField;
+    }
+}
+
+bool FieldLineGenerator::acceptPoint(
+    FieldLine& line,
+    const glm::dvec3& pos,
+    double fieldMagnitude,
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    double& nearestDistance2
+) {
+    // === Termination Conditions ===
+    
+    // 1. Field magnitude too weak
+    if (fieldMagnitude < config.minFieldMagnitude) {
         line.isComplete = true;
+        return false;
     }
     
-    return line;
+    // 2. Distance from origin too large
+    if (glm::dot(pos, pos) > config.maxDistance * config.maxDistance) {
+        line.isComplete = true;
+        return false;
+    }
+    
+    // 3. Entered a particle of opposite sign (field line ends at opposite charge)
+    int sourceSign = (line.sourceCharge > 0) ? 1 : -1;
+    if (reachedOppositeCharge(pos, particles, sourceSign, nearestDistance2)) {
+        line.isComplete = true;
+        return false;
+    }
+    
+    // === Store Point ===
+    line.points.push_back(pos);
+    line.fieldMagnitudes.push_back(static_cast<float>(fieldMagnitude));
+    return true;
+}
+
+bool FieldLineGenerator::cancelled(const FieldLineConfig& config) {
+    return config.cancelFlag && config.cancelFlag->load(std::memory_order_relaxed);
 }
 
 std::vector<glm::dvec3> FieldLineGenerator::generateSeedPoints(
@@ -121,82 +231,174 @@ std::vector<glm::dvec3> FieldLineGenerator::generateSeedPoints(
     std::vector<glm::dvec3> seedPoints;
     seedPoints.reserve(count);
     
-    // Fibonacci sphere algorithm for uniform distribution
     for (int i = 0; i < count; ++i) {
-        double theta = GOLDEN_ANGLE * i;
-        double y = 1.0 - (2.0 * i) / (count - 1.0); // y goes from 1 to -1
-        double radius = sqrt(1.0 - y * y);
-        
-        double x = cos(theta) * radius;
-        double z = sin(theta) * radius;
-        
-        // Scale by particle visual radius and offset by particle position
-        // Cast visualRadius (float) to double for dvec3 multiplication
-        glm::dvec3 point = source.position + static_cast<double>(source.visualRadius) * glm::dvec3(x, y, z);
-        seedPoints.push_back(point);
+        seedPoints.push_back(seedPoint(source, i, count));
     }
     
     return seedPoints;
 }
 
+glm::dvec3 FieldLineGenerator::seedPoint(
+    const Particle& source,
+    int index,
+    int count
+) {
+    // Fibonacci sphere algorithm for uniform distribution
+    double theta = GOLDEN_ANGLE * index;
+    double y = 1.0 - (2.0 * index) / (count - 1.0); // y goes from 1 to -1
+    double radius = sqrt(1.0 - y * y);
+    
+    double x = cos(theta) * radius;
+    double z = sin(theta) * radius;
+    
+    // Scale by particle visual radius and offset by particle position
+    // Cast visualRadius (float) to double for dvec3 multiplication
+    return source.position + static_cast<double>(source.visualRadius) * glm::dvec3(x, y, z);
+}
+
 std::vector<FieldLine> FieldLineGenerator::generateAll(
     const std::vector<Particle>& particles,
-    const FieldLineConfig& config
+    const FieldLineConfig& config,
+    ThreadPool* pool
 ) {
+    std::vector<size_t> seedIds(particles.size() * static_cast<size_t>(std::max(config.seedPointsPerParticle, 0)));
+    for (size_t i = 0; i < seedIds.size(); ++i) {
+        seedIds[i] = i;
+    }
+    
+    std::vector<FieldLine> slots = generateSeeds(particles, config, seedIds, pool);
+    
     std::vector<FieldLine> allLines;
+    allLines.reserve(slots.size());
+    for (auto& line : slots) {
+        if (line.points.size() > 1) { // Only add if line has points
+            allLines.push_back(std::move(line));
+        }
+    }
     
-    for (const auto& particle : particles) {
-        // Generate seed points around this particle
-        std::vector<glm::dvec3> seedPoints = generateSeedPoints(particle, config.seedPointsPerParticle);
-        
-        // Generate field line from each seed point
-        for (const auto& seed : seedPoints) {
-            // Trace forward (away from positive, toward negative)
-            FieldLine line = generate(seed, particles, config, true);
-            if (line.points.size() > 1) { // Only add if line has points
-                allLines.push_back(line);
+    return allLines;
+}
+
+std::vector<FieldLine> FieldLineGenerator::generateSeeds(
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    const std::vector<size_t>& seedIds,
+    ThreadPool* pool
+) {
+    const size_t seedsPerParticle = static_cast<size_t>(std::max(config.seedPointsPerParticle, 1));
+    
+    // Without a custom evaluator, trace through the vectorized kernel on SoA sources
+    ParticleStore sources;
+    FieldLineConfig kernelConfig;
+    const FieldLineConfig* activeConfig = &config;
+    if (!config.fieldEvaluator) {
+        sources.loadFrom(particles);
+        kernelConfig = config;
+        kernelConfig.fieldEvaluator = [&sources](const glm::dvec3& p) {
+            return CoulombKernel::fieldAt(p, sources);
+        };
+        activeConfig = &kernelConfig;
+    }
+    
+    // Each seed traces into its own slot: no shared push_back, and the output
+    // order does not depend on which thread traced which line
+    std::vector<FieldLine> slots(seedIds.size());
+    auto traceRange = [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (cancelled(config)) {
+                return;
             }
+            
+            const Particle& source = particles[seedIds[i] / seedsPerParticle];
+            int seedIndex = static_cast<int>(seedIds[i] % seedsPerParticle);
+            glm::dvec3 seed = seedPoint(source, seedIndex, config.seedPointsPerParticle);
+            
+            // Trace forward (away from positive, toward negative); the source is the seeding particle
+            slots[i] = trace(seed, particles, *activeConfig, true, static_cast<int>(seedIds[i] / seedsPerParticle));
         }
+    };
+    
+    if (pool) {
+        // Line lengths vary from a few steps to maxStepsPerLine, so balance dynamically
+        pool->parallelForDynamic(0, seedIds.size(), traceRange, TRACE_GRAIN_SIZE);
+    } else {
+        traceRange(0, seedIds.size(), 0);
     }
     
-    return allLines;
+    return slots;
 }
 
-double FieldLineGenerator::estimateCurvature(
+glm::dvec3 FieldLineGenerator::evaluateField(
     const glm::dvec3& pos,
-    const glm::dvec3& dir,
-    const std::vector<Particle>& particles
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    size_t& evaluations
 ) {
-    // Estimate curvature by checking how much direction changes over small step
-    double eps = 0.01;
-    glm::dvec3 E_ahead = ElectricField::totalField(pos + eps * dir, particles);
-    double EMag_ahead = glm::length(E_ahead);
-    
-    if (EMag_ahead < 1e-20) {
-        return 0.0; // Field too weak, no curvature
+    ++evaluations;
+    if (config.fieldEvaluator) {
+        return config.fieldEvaluator(pos);
     }
+    return ElectricField::totalField(pos, particles);
+}
+
+glm::dvec3 FieldLineGenerator::stageDirection(
+    const glm::dvec3& pos,
+    double sign,
+    const glm::dvec3& fallback,
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    size_t& evaluations
+) {
+    glm::dvec3 E = evaluateField(pos, particles, config, evaluations);
+    double EMag = glm::length(E);
     
-    glm::dvec3 dir_ahead = glm::normalize(E_ahead);
-    double curvature = glm::length(dir_ahead - dir) / eps;
+    // Keep the previous stage direction if the field is too weak to define one
+    if (EMag < 1e-20) {
+        return fallback;
+    }
     
-    return curvature;
+    return (sign / EMag) * E;
 }
 
-bool FieldLineGenerator::isInsideParticle(
+int FieldLineGenerator::nearestParticle(
+    const glm::dvec3& point,
+    const std::vector<Particle>& particles
+) {
+    int nearest = -1;
+    double minDist2 = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < particles.size(); ++i) {
+        glm::dvec3 d = point - particles[i].position;
+        double dist2 = glm::dot(d, d);
+        if (dist2 < minDist2) {
+            minDist2 = dist2;
+            nearest = static_cast<int>(i);
+        }
+    }
+    return nearest;
+}
+
+bool FieldLineGenerator::reachedOppositeCharge(
     const glm::dvec3& point,
     const std::vector<Particle>& particles,
-    int& particleIndex
+    int sourceSign,
+    double& nearestDistance2
 ) {
-    particleIndex = -1;
-    
+    // Squared distances: one multiply-add pass, no sqrt per particle
+    nearestDistance2 = std::numeric_limits<double>::max();
+    int inside = -1;
     for (size_t i = 0; i < particles.size(); ++i) {
-        double dist = glm::length(point - particles[i].position);
-        if (dist < particles[i].visualRadius * 0.5) {
-            particleIndex = static_cast<int>(i);
-            return true;
+        glm::dvec3 d = point - particles[i].position;
+        double dist2 = glm::dot(d, d);
+        nearestDistance2 = std::min(nearestDistance2, dist2);
+        double radius = particles[i].visualRadius * 0.5;
+        if (inside < 0 && dist2 < radius * radius) {
+            inside = static_cast<int>(i);
         }
     }
     
-    return false;
+    if (inside < 0) {
+        return false;
+    }
+    int targetSign = (particles[inside].charge > 0) ? 1 : -1;
+    return targetSign != sourceSign;
 }
-
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <atomic>
+#include <functional>
 #include <vector>
 #include "Particle.hpp"
 #include "ElectricField.hpp"
 #include "engine/math/Integrators.hpp"
+#include "engine/core/ThreadPool.hpp"
 
 /**
  * Field Line Data Structure
@@ -17,8 +20,18 @@ struct FieldLine {
     float sourceCharge;                       // Charge of source particle
     bool isComplete;                          // True if line reached termination condition
     bool isForward;                           // True if traced forward, false if backward
+    size_t fieldEvaluations;                  // Field evaluations spent tracing this line
+    size_t rejectedSteps;                     // Steps retried with a smaller size (adaptive integrator)
     
-    FieldLine() : isComplete(false), isForward(true), sourceCharge(0.0f) {}
+    FieldLine() : sourceCharge(0.0f), isComplete(false), isForward(true), fieldEvaluations(0), rejectedSteps(0) {}
+};
+
+/**
+ * Integration scheme used to trace field lines
+ */
+enum class FieldLineIntegrator {
+    RK4,                // Fixed step (optionally curvature-scaled), 4 evaluations per step
+    DORMAND_PRINCE      // Embedded 5(4) with error control, 6 evaluations per accepted step
 };
 
 /**
@@ -27,18 +40,38 @@ struct FieldLine {
 struct FieldLineConfig {
     int seedPointsPerParticle = 24;           // Number of seed points distributed on sphere
     int maxStepsPerLine = 1000;               // Maximum integration steps per line
-    double stepSize = 0.01;                   // Base integration step size
+    double stepSize = 0.01;                   // Base (RK4) or initial (Dormand-Prince) step size
     double minFieldMagnitude = 1e-6;          // Stop if field magnitude below this
     double maxDistance = 100.0;               // Stop if distance from origin exceeds this
+    FieldLineIntegrator integrator = FieldLineIntegrator::DORMAND_PRINCE;
+    
+    // RK4: curvature heuristic h / (1 + curvature * adaptiveStepFactor)
     bool useAdaptiveStep = true;              // Use adaptive step sizing
     double adaptiveStepFactor = 10.0;         // Factor for adaptive step adjustment
+    
+    // Dormand-Prince: per-component local error <= absoluteTolerance + relativeTolerance * |x|
+    double absoluteTolerance = 1e-6;          // Position error tolerance (meters)
+    double relativeTolerance = 1e-6;          // Position error tolerance relative to |coordinate|
+    double minStepSize = 1e-12;               // Steps this small are accepted regardless of error
+    double maxStepSize = 0.1;                 // Upper bound on step length (polyline resolution)
+    double maxStepGrowth = 5.0;               // Largest step increase after an accepted step
+    double maxStepShrink = 0.2;               // Largest step decrease after a rejected step
+    
+    // Optional field source used for tracing (e.g. FmmSolver::fieldAt).
+    // Falls back to the direct ElectricField::totalField sum when empty.
+    // Must be thread-safe when lines are traced in parallel.
+    std::function<glm::dvec3(const glm::dvec3&)> fieldEvaluator;
+    
+    // Optional cancellation flag: tracing stops early (lines left incomplete) once set
+    const std::atomic<bool>* cancelFlag = nullptr;
 };
 
 /**
  * Field Line Generator
  * 
  * Generates electric field lines by numerically integrating along field direction.
- * Uses RK4 integration to trace field lines from seed points around particles.
+ * Uses Dormand-Prince 5(4) with error control (or fixed-step RK4) to trace field
+ * lines from seed points around particles.
  */
 class FieldLineGenerator {
 public:
@@ -74,32 +107,150 @@ public:
     /**
      * Generate all field lines for all particles
      * 
+     * With a thread pool, seeds are traced in parallel with work stealing.
+     * Lines are returned in the same order as the serial trace (by particle,
+     * then seed), so results are identical either way.
+     * 
      * @param particles All charged particles
      * @param config Configuration for field line generation
+     * @param pool Optional thread pool for parallel tracing
      * @return Vector of all generated field lines
      */
     static std::vector<FieldLine> generateAll(
         const std::vector<Particle>& particles,
-        const FieldLineConfig& config
+        const FieldLineConfig& config,
+        ThreadPool* pool = nullptr
+    );
+    
+    /**
+     * Trace the lines of selected seeds (used for incremental regeneration)
+     * 
+     * Seed id = particleIndex * seedPointsPerParticle + seedIndex, matching the
+     * order of generateAll(). One line is returned per id, in the given order,
+     * including lines with fewer than two points.
+     * 
+     * @param particles All charged particles
+     * @param config Configuration for field line generation
+     * @param seedIds Seeds to trace
+     * @param pool Optional thread pool for parallel tracing
+     * @return One field line per seed id
+     */
+    static std::vector<FieldLine> generateSeeds(
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        const std::vector<size_t>& seedIds,
+        ThreadPool* pool = nullptr
     );
 
 private:
     /**
-     * Estimate curvature at a point to adjust step size
+     * Seed point `index` of `count` on the Fibonacci sphere around a particle
+     */
+    static glm::dvec3 seedPoint(
+        const Particle& source,
+        int index,
+        int count
+    );
+    
+    /**
+     * Trace a line from a seed whose source particle is known (-1 = none)
+     * 
+     * Integrates the unit field direction with the configured integrator. The
+     * field evaluated at each accepted point is the termination/colour sample and
+     * the next step's k1.
      */
-    static double estimateCurvature(
+    static FieldLine trace(
+        const glm::dvec3& seedPoint,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        bool traceForward,
+        int sourceIndex
+    );
+    
+    /**
+     * RK4 tracer: four evaluations per step; the adaptive step uses the direction
+     * change between k1 and k4 of the previous step as its curvature estimate
+     */
+    static void traceRK4(
+        FieldLine& line,
+        const glm::dvec3& seedPoint,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        double sign
+    );
+    
+    /**
+     * Dormand-Prince tracer: steps sized from the embedded error estimate, rejected
+     * and retried when the error exceeds the tolerance, and never longer than half
+     * the distance to the nearest particle (so lines cannot jump over a charge)
+     */
+    static void traceDormandPrince(
+        FieldLine& line,
+        const glm::dvec3& seedPoint,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        double sign
+    );
+    
+    /**
+     * Shared termination test at an accepted point; records the point if tracing continues
+     * 
+     * @return false if the line ends here (line.isComplete set)
+     */
+    static bool acceptPoint(
+        FieldLine& line,
         const glm::dvec3& pos,
-        const glm::dvec3& dir,
+        double fieldMagnitude,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        double& nearestDistance2
+    );
+    
+    /**
+     * Tracing was cancelled through config.cancelFlag
+     */
+    static bool cancelled(const FieldLineConfig& config);
+    
+    /**
+     * Evaluate the field at a point using the configured field source
+     */
+    static glm::dvec3 evaluateField(
+        const glm::dvec3& pos,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        size_t& evaluations
+    );
+    
+    /**
+     * RK stage direction: signed unit field at a point, or `fallback` if the field vanishes
+     */
+    static glm::dvec3 stageDirection(
+        const glm::dvec3& pos,
+        double sign,
+        const glm::dvec3& fallback,
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        size_t& evaluations
+    );
+    
+    /**
+     * Index of the nearest particle to a point (-1 if there are none)
+     */
+    static int nearestParticle(
+        const glm::dvec3& point,
         const std::vector<Particle>& particles
     );
     
     /**
-     * Check if point is inside any particle
+     * Check if point is inside a particle whose charge sign differs from sourceSign
+     * (the first particle containing the point decides, as in the original test)
+     * 
+     * @param nearestDistance2 Set to the squared distance to the nearest particle
      */
-    static bool isInsideParticle(
+    static bool reachedOppositeCharge(
         const glm::dvec3& point,
         const std::vector<Particle>& particles,
-        int& particleIndex
+        int sourceSign,
+        double& nearestDistance2
     );
 };
-
@@ -1,15 +1,42 @@
 #include "FieldLineManager.hpp"
 #include "engine/core/Logger.hpp"
+#include "engine/core/Constants.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
+
+namespace {
+    // Smallest per-thread range when updating line error bounds
+    constexpr size_t BOUND_CHUNK_SIZE = 64;
+}
 
 FieldLineManager::FieldLineManager()
     : m_dirty(true)
     , m_maxRegenerationRate(10.0)  // 10 Hz default
     , m_lastRegenerationTime(std::chrono::high_resolution_clock::now())
+    , m_useFmm(false)
+    , m_useFieldGrid(false)
+    , m_threadPool(nullptr)
+    , m_incremental(false)
+    , m_incrementalTolerance(1e-3)
+    , m_seedsPerParticle(0)
+    , m_async(false)
+    , m_jobInFlight(false)
+    , m_asyncStop(false)
+    , m_cancelInFlight(false)
+    , m_consecutiveCancels(0)
+    , m_hasCompleted(false)
+    , m_hasDisplayed(false)
+    , m_lastLatency(0.0)
+    , m_completedCount(0)
+    , m_cancelledCount(0)
 {
 }
 
+FieldLineManager::~FieldLineManager() {
+    stopAsync();
+}
+
 const std::vector<FieldLine>& FieldLineManager::getFieldLines(
     const std::vector<Particle>& particles,
     const FieldLineConfig& config
@@ -19,27 +46,454 @@ const std::vector<FieldLine>& FieldLineManager::getFieldLines(
                             particlesHaveMoved(particles) ||
                             shouldRegenerate();
     
-    if (needsRegeneration) {
+    if (m_async) {
+        // Never trace here: show the newest finished set and queue a new snapshot
+        collectAsync();
+        if (needsRegeneration) {
+            submitAsync(particles, config);
+        }
+        return m_cachedLines;
+    }
+    
+    if (!needsRegeneration) {
+        m_lastStats.retracedLines = 0;
+        m_lastStats.retracedFraction = 0.0;
+        m_lastStats.fullRegeneration = false;
+        return m_cachedLines;
+    }
+    
+    regenerate(particles, config, m_dirty, m_threadPool, nullptr, m_cachedLines, m_lastStats);
+    
+    // Cache particle positions
+    rememberPositions(particles);
+    
+    // Mark as clean
+    m_dirty = false;
+    m_lastRegenerationTime = std::chrono::high_resolution_clock::now();
+    
+    return m_cachedLines;
+}
+
+bool FieldLineManager::regenerate(
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    bool forceFull,
+    ThreadPool* pool,
+    const std::atomic<bool>* cancel,
+    std::vector<FieldLine>& out,
+    RegenerationStats& stats
+) {
+    FieldLineConfig cancellableConfig = config;
+    cancellableConfig.cancelFlag = cancel;
+    
+    bool canUpdateIncrementally = m_incremental && !forceFull &&
+                                  !m_slotLines.empty() &&
+                                  particles.size() == m_tracedPositions.size() &&
+                                  config.seedPointsPerParticle == m_seedsPerParticle;
+    
+    bool completed;
+    if (canUpdateIncrementally) {
+        completed = regenerateIncremental(particles, cancellableConfig, pool, out, stats);
+    } else {
         LOG_DEBUG("Regenerating field lines...");
+        completed = regenerateAll(particles, cancellableConfig, pool, out, stats);
+        if (completed) {
+            LOG_DEBUG("Generated " + std::to_string(out.size()) + " field lines");
+        }
+    }
+    
+    if (completed && m_incremental) {
+        m_tracedPositions.clear();
+        m_tracedPositions.reserve(particles.size());
+        for (const auto& p : particles) {
+            m_tracedPositions.push_back(p.position);
+        }
+    }
+    return completed;
+}
+
+bool FieldLineManager::regenerateAll(
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    ThreadPool* pool,
+    std::vector<FieldLine>& out,
+    RegenerationStats& stats
+) {
+    stats.fieldGridRebuilt = false;
+    FieldLineConfig traceConfig = tracingConfig(particles, config, pool, stats);
+    auto cancelled = [&] {
+        return config.cancelFlag && config.cancelFlag->load(std::memory_order_relaxed);
+    };
+    
+    if (!m_incremental) {
+        std::vector<FieldLine> lines = FieldLineGenerator::generateAll(particles, traceConfig, pool);
+        if (cancelled()) {
+            return false;
+        }
+        out = std::move(lines);
+        m_slotLines.clear();
+        m_lineBounds.clear();
+        stats.retracedLines = out.size();
+        stats.totalLines = out.size();
+    } else {
+        // Keep one line per seed so later updates can retrace individual seeds
+        std::vector<size_t> seedIds(particles.size() * static_cast<size_t>(std::max(config.seedPointsPerParticle, 0)));
+        for (size_t i = 0; i < seedIds.size(); ++i) {
+            seedIds[i] = i;
+        }
         
-        // Generate new field lines
-        m_cachedLines = FieldLineGenerator::generateAll(particles, config);
+        std::vector<FieldLine> slots = FieldLineGenerator::generateSeeds(particles, traceConfig, seedIds, pool);
+        if (cancelled()) {
+            return false;
+        }
+        m_seedsPerParticle = config.seedPointsPerParticle;
+        m_slotLines = std::move(slots);
+        m_lineBounds.assign(m_slotLines.size(), LineBound());
+        for (size_t i = 0; i < m_slotLines.size(); ++i) {
+            computeLineBound(m_slotLines[i], m_lineBounds[i]);
+        }
+        compactSlots(out);
+        stats.retracedLines = m_slotLines.size();
+        stats.totalLines = m_slotLines.size();
+    }
+    
+    stats.retracedFraction = stats.totalLines > 0 ? 1.0 : 0.0;
+    stats.fullRegeneration = true;
+    return true;
+}
+
+bool FieldLineManager::regenerateIncremental(
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    ThreadPool* pool,
+    std::vector<FieldLine>& out,
+    RegenerationStats& stats
+) {
+    const size_t seedsPerParticle = static_cast<size_t>(m_seedsPerParticle);
+    const size_t slotCount = m_slotLines.size();
+    
+    // Particles moved since the last trace, and how far
+    struct MovedCharge {
+        glm::dvec3 position;
+        double strength;   // 2 k |q| delta: dipole moment of the displacement
+        size_t index;
+    };
+    std::vector<MovedCharge> moved;
+    for (size_t j = 0; j < particles.size(); ++j) {
+        double delta = glm::length(particles[j].position - m_tracedPositions[j]);
+        if (delta > MOVEMENT_THRESHOLD) {
+            moved.push_back({
+                particles[j].position,
+                2.0 * PhysicsConstants::k * std::abs(particles[j].charge) * delta,
+                j
+            });
+        }
+    }
+    
+    // Grow each line's error bound; lines are independent, so split across threads.
+    // Bounds go to a scratch copy and are only committed if the trace completes.
+    std::vector<uint8_t> retrace(slotCount, 0);
+    std::vector<double> errorBounds(slotCount);
+    for (size_t i = 0; i < slotCount; ++i) {
+        errorBounds[i] = m_lineBounds[i].errorBound;
+    }
+    for (const auto& charge : moved) {
+        // Seeds ride along with their particle
+        for (size_t s = 0; s < seedsPerParticle; ++s) {
+            retrace[charge.index * seedsPerParticle + s] = 1;
+        }
+    }
+    
+    auto updateBounds = [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (retrace[i] || moved.empty()) {
+                continue;
+            }
+            
+            const LineBound& bound = m_lineBounds[i];
+            if (bound.chunks.empty()) {
+                // Line terminated at its seed; cheap to retrace and cannot be bounded
+                retrace[i] = 1;
+                continue;
+            }
+            
+            for (const auto& charge : moved) {
+                double worst = 0.0;
+                for (const auto& chunk : bound.chunks) {
+                    double d = glm::length(charge.position - chunk.center) - chunk.radius;
+                    if (d <= 0.0 || chunk.minField <= 0.0) {
+                        worst = std::numeric_limits<double>::infinity();
+                        break;
+                    }
+                    worst = std::max(worst, charge.strength / (d * d * d * chunk.minField));
+                }
+                errorBounds[i] += worst;
+            }
+            
+            if (errorBounds[i] > m_incrementalTolerance) {
+                retrace[i] = 1;
+            }
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, slotCount, updateBounds, BOUND_CHUNK_SIZE);
+    } else {
+        updateBounds(0, slotCount, 0);
+    }
+    
+    std::vector<size_t> seedIds;
+    for (size_t i = 0; i < slotCount; ++i) {
+        if (retrace[i]) {
+            seedIds.push_back(i);
+        }
+    }
+    
+    stats.fieldGridRebuilt = false;
+    if (!seedIds.empty()) {
+        FieldLineConfig traceConfig = tracingConfig(particles, config, pool, stats);
+        std::vector<FieldLine> traced = FieldLineGenerator::generateSeeds(particles, traceConfig, seedIds, pool);
+        if (config.cancelFlag && config.cancelFlag->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        for (size_t n = 0; n < seedIds.size(); ++n) {
+            m_slotLines[seedIds[n]] = std::move(traced[n]);
+        }
+    }
+    
+    // Commit: retraced lines get fresh bounds, the rest keep their grown bounds
+    for (size_t i = 0; i < slotCount; ++i) {
+        if (retrace[i]) {
+            computeLineBound(m_slotLines[i], m_lineBounds[i]);
+        } else {
+            m_lineBounds[i].errorBound = errorBounds[i];
+        }
+    }
+    if (!seedIds.empty() || out.empty()) {
+        compactSlots(out);
+    }
+    
+    stats.retracedLines = seedIds.size();
+    stats.totalLines = slotCount;
+    stats.retracedFraction = slotCount > 0 ? static_cast<double>(seedIds.size()) / slotCount : 0.0;
+    stats.fullRegeneration = false;
+    
+    if (!seedIds.empty()) {
+        LOG_DEBUG("Retraced " + std::to_string(seedIds.size()) + " of " +
+                  std::to_string(slotCount) + " field lines");
+    }
+    return true;
+}
+
+FieldLineConfig FieldLineManager::tracingConfig(
+    const std::vector<Particle>& particles,
+    const FieldLineConfig& config,
+    ThreadPool* pool,
+    RegenerationStats& stats
+) {
+    FieldLineConfig traceConfig = config;
+    
+    // An up-to-date grid still holds the FMM (or direct) source it was built from
+    const bool gridCurrent = m_useFieldGrid && m_fieldGrid.matches(particles);
+    if (m_useFmm && !gridCurrent) {
+        m_fmm.build(particles);
+        traceConfig.fieldEvaluator = [this](const glm::dvec3& p) { return m_fmm.fieldAt(p); };
+    }
+    
+    if (m_useFieldGrid) {
+        if (!gridCurrent) {
+            m_fieldGrid.build(particles, traceConfig.fieldEvaluator, pool);
+            stats.fieldGridRebuilt = true;
+            LOG_DEBUG("Sampled field grid (" + std::to_string(m_fieldGrid.getNodeCount()) + " nodes)");
+        }
+        traceConfig.fieldEvaluator = [this](const glm::dvec3& p) { return m_fieldGrid.fieldAt(p); };
+    }
+    return traceConfig;
+}
+
+void FieldLineManager::computeLineBound(const FieldLine& line, LineBound& bound) {
+    bound.chunks.clear();
+    bound.errorBound = 0.0;
+    
+    for (size_t begin = 0; begin < line.points.size(); begin += CHUNK_POINTS) {
+        size_t end = std::min(begin + CHUNK_POINTS, line.points.size());
         
-        // Cache particle positions
-        m_lastParticlePositions.clear();
-        m_lastParticlePositions.reserve(particles.size());
-        for (const auto& p : particles) {
-            m_lastParticlePositions.push_back(p.position);
+        LineChunk chunk;
+        chunk.center = glm::dvec3(0.0);
+        chunk.minField = std::numeric_limits<double>::max();
+        for (size_t p = begin; p < end; ++p) {
+            chunk.center += line.points[p];
+            chunk.minField = std::min(chunk.minField, static_cast<double>(line.fieldMagnitudes[p]));
         }
+        chunk.center /= static_cast<double>(end - begin);
         
-        // Mark as clean
-        m_dirty = false;
-        m_lastRegenerationTime = std::chrono::high_resolution_clock::now();
+        chunk.radius = 0.0;
+        for (size_t p = begin; p < end; ++p) {
+            chunk.radius = std::max(chunk.radius, glm::length(line.points[p] - chunk.center));
+        }
+        bound.chunks.push_back(chunk);
+    }
+}
+
+void FieldLineManager::compactSlots(std::vector<FieldLine>& out) const {
+    out.clear();
+    for (const auto& line : m_slotLines) {
+        if (line.points.size() > 1) {
+            out.push_back(line);
+        }
+    }
+}
+
+void FieldLineManager::rememberPositions(const std::vector<Particle>& particles) {
+    m_lastParticlePositions.clear();
+    m_lastParticlePositions.reserve(particles.size());
+    for (const auto& p : particles) {
+        m_lastParticlePositions.push_back(p.position);
+    }
+}
+
+void FieldLineManager::setAsync(bool enabled, size_t threadCount) {
+    stopAsync();
+    m_async = enabled;
+    m_dirty = true;
+    
+    if (enabled) {
+        if (threadCount > 1) {
+            m_asyncPool = std::make_unique<ThreadPool>(threadCount);
+        }
+        m_asyncStop = false;
+        m_asyncThread = std::thread(&FieldLineManager::asyncLoop, this);
+    }
+}
+
+void FieldLineManager::stopAsync() {
+    if (m_asyncThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            m_asyncStop = true;
+            m_pendingJob.reset();
+        }
+        m_cancelInFlight = true;
+        m_asyncWake.notify_all();
+        m_asyncThread.join();
+    }
+    
+    m_asyncPool.reset();
+    m_jobInFlight = false;
+    m_cancelInFlight = false;
+    m_consecutiveCancels = 0;
+    m_hasCompleted = false;
+    m_completedLines.clear();
+}
+
+void FieldLineManager::submitAsync(const std::vector<Particle>& particles, const FieldLineConfig& config) {
+    auto job = std::make_unique<AsyncJob>();
+    // History is not needed for tracing
+    job->particles.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        job->particles[i].copyStateFrom(particles[i]);
+    }
+    job->config = config;
+    job->fullRegeneration = m_dirty;
+    job->snapshotTime = Clock::now();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        
+        // Latest snapshot wins, but a superseded structural change still forces a full trace
+        if (m_pendingJob && m_pendingJob->fullRegeneration) {
+            job->fullRegeneration = true;
+        }
+        m_pendingJob = std::move(job);
         
-        LOG_DEBUG("Generated " + std::to_string(m_cachedLines.size()) + " field lines");
+        if (m_jobInFlight && m_consecutiveCancels < MAX_CONSECUTIVE_CANCELS) {
+            m_cancelInFlight = true;
+        }
     }
+    m_asyncWake.notify_one();
     
-    return m_cachedLines;
+    rememberPositions(particles);
+    m_dirty = false;
+    m_lastRegenerationTime = std::chrono::high_resolution_clock::now();
+}
+
+void FieldLineManager::collectAsync() {
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+    if (!m_hasCompleted) {
+        return;
+    }
+    
+    // Swap buffers: the old front buffer is reused for the next result
+    m_cachedLines.swap(m_completedLines);
+    m_lastStats = m_completedStats;
+    m_displayedSnapshotTime = m_completedSnapshotTime;
+    m_hasDisplayed = true;
+    m_hasCompleted = false;
+}
+
+FieldLineManager::AsyncStats FieldLineManager::getAsyncStats() const {
+    AsyncStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        stats.lastLatency = m_lastLatency;
+        stats.completed = m_completedCount;
+        stats.cancelled = m_cancelledCount;
+        stats.inFlight = m_jobInFlight || m_pendingJob != nullptr;
+    }
+    if (m_hasDisplayed) {
+        stats.staleness = std::chrono::duration<double>(Clock::now() - m_displayedSnapshotTime).count();
+    }
+    return stats;
+}
+
+bool FieldLineManager::waitForAsync(double timeoutSeconds) {
+    std::unique_lock<std::mutex> lock(m_asyncMutex);
+    return m_asyncIdle.wait_for(
+        lock,
+        std::chrono::duration<double>(timeoutSeconds),
+        [this] { return !m_jobInFlight && !m_pendingJob; }
+    );
+}
+
+void FieldLineManager::asyncLoop() {
+    while (true) {
+        std::unique_ptr<AsyncJob> job;
+        {
+            std::unique_lock<std::mutex> lock(m_asyncMutex);
+            m_asyncWake.wait(lock, [this] { return m_asyncStop || m_pendingJob != nullptr; });
+            if (m_asyncStop) {
+                return;
+            }
+            job = std::move(m_pendingJob);
+            m_jobInFlight = true;
+            m_cancelInFlight = false;
+        }
+        
+        std::vector<FieldLine> lines;
+        RegenerationStats stats;
+        bool completed = regenerate(job->particles, job->config, job->fullRegeneration,
+                                    m_asyncPool.get(), &m_cancelInFlight, lines, stats);
+        
+        {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            m_jobInFlight = false;
+            if (completed) {
+                m_completedLines = std::move(lines);
+                m_completedStats = stats;
+                m_completedSnapshotTime = job->snapshotTime;
+                m_hasCompleted = true;
+                m_lastLatency = std::chrono::duration<double>(Clock::now() - job->snapshotTime).count();
+                ++m_completedCount;
+                m_consecutiveCancels = 0;
+            } else {
+                ++m_cancelledCount;
+                ++m_consecutiveCancels;
+                if (job->fullRegeneration && m_pendingJob) {
+                    m_pendingJob->fullRegeneration = true;
+                }
+            }
+        }
+        m_asyncIdle.notify_all();
+    }
 }
 
 void FieldLineManager::markDirty() {
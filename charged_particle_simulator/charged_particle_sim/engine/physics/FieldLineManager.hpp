@@ -1,8 +1,16 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "FieldGrid.hpp"
 #include "FieldLineGenerator.hpp"
+#include "FmmSolver.hpp"
 #include "Particle.hpp"
 
 /**
@@ -10,10 +18,34 @@
  * 
  * Manages field line generation and caching.
  * Implements dirty flag system and throttling to avoid regenerating lines every frame.
+ * 
+ * In incremental mode, movement no longer discards every cached line. Each line
+ * keeps an error bound that grows with the field perturbation caused by moved
+ * particles, and only lines whose bound exceeds the tolerance are retraced:
+ * - lines seeded on a moved particle move with it and are always retraced
+ * - otherwise a charge q moved by delta changes the field at distance d by at
+ *   most ~2 k |q| delta / d³ (the field of the dipole q * delta); relative to the
+ *   weakest |E| on a stretch of the line, this bounds how far the line bends
+ * 
+ * In field grid mode, lines are traced through a FieldGrid sampled from the direct
+ * sum (or the FMM), exact only near charges. The grid is kept while positions and
+ * charges are unchanged (throttled regenerations, incremental retraces) and rebuilt
+ * automatically before the first trace after they change.
+ * 
+ * In async mode, getFieldLines() never traces: it snapshots the particles and hands
+ * them to a background thread, and keeps returning the previous lines until the new
+ * set is ready (double buffering). A newer snapshot replaces a queued one and
+ * cancels the one being traced, except that after MAX_CONSECUTIVE_CANCELS
+ * cancellations in a row the running trace is allowed to finish, so continuous
+ * motion cannot starve the display.
  */
 class FieldLineManager {
 public:
     FieldLineManager();
+    ~FieldLineManager();
+    
+    FieldLineManager(const FieldLineManager&) = delete;
+    FieldLineManager& operator=(const FieldLineManager&) = delete;
     
     /**
      * Get current field lines (regenerates if dirty)
@@ -46,6 +78,93 @@ public:
      * Get maximum regeneration rate (Hz)
      */
     double getMaxRegenerationRate() const { return m_maxRegenerationRate; }
+    
+    /**
+     * Trace field lines through the FMM solver instead of the direct sum
+     * (worthwhile for large particle counts)
+     */
+    void setUseFmm(bool enabled) { m_useFmm = enabled; m_fieldGrid.invalidate(); m_dirty = true; }
+    bool getUseFmm() const { return m_useFmm; }
+    
+    /**
+     * Access FMM solver settings (expansion order, opening angle)
+     */
+    FmmSolver& getFmmSolver() { return m_fmm; }
+    
+    /**
+     * Trace field lines through an interpolated field grid (worthwhile when many
+     * evaluations per particle are made, i.e. many lines or long lines)
+     */
+    void setUseFieldGrid(bool enabled) { m_useFieldGrid = enabled; m_dirty = true; }
+    bool getUseFieldGrid() const { return m_useFieldGrid; }
+    
+    /**
+     * Access field grid settings (resolution, interpolation, exact radius)
+     */
+    FieldGrid& getFieldGrid() { return m_fieldGrid; }
+    
+    /**
+     * Enable incremental regeneration (retrace only lines affected by moved particles)
+     */
+    void setIncremental(bool enabled) { m_incremental = enabled; m_dirty = true; }
+    bool getIncremental() const { return m_incremental; }
+    
+    /**
+     * Relative field perturbation a cached line may accumulate before it is retraced
+     */
+    void setIncrementalTolerance(double tolerance) { m_incrementalTolerance = tolerance; }
+    double getIncrementalTolerance() const { return m_incrementalTolerance; }
+    
+    /**
+     * Statistics of the most recent getFieldLines() call
+     */
+    struct RegenerationStats {
+        size_t retracedLines = 0;      // Lines traced this call
+        size_t totalLines = 0;         // Seed slots (traced or cached)
+        double retracedFraction = 0.0; // retracedLines / totalLines
+        bool fullRegeneration = false; // True if every line was traced
+        bool fieldGridRebuilt = false; // True if the field grid was resampled
+    };
+    const RegenerationStats& getLastRegenerationStats() const { return m_lastStats; }
+    
+    /**
+     * Trace lines in parallel on a thread pool (not owned; nullptr = serial)
+     * e.g. ParticleSystem::getThreadPool(), called from the same thread as step()
+     */
+    void setThreadPool(ThreadPool* pool) { m_threadPool = pool; }
+    
+    /**
+     * Enable asynchronous generation on a background thread
+     * 
+     * While enabled, the FMM solver, field grid, incremental state and custom field
+     * evaluator are used from the background thread; configure them before enabling.
+     * 
+     * @param enabled True to trace in the background
+     * @param threadCount Threads used by the background trace (owned pool, 1 = serial)
+     */
+    void setAsync(bool enabled, size_t threadCount = 1);
+    bool getAsync() const { return m_async; }
+    
+    /**
+     * Background generation metrics
+     */
+    struct AsyncStats {
+        double lastLatency = 0.0;     // Snapshot to result ready, last completed generation (s)
+        double staleness = 0.0;       // Age of the snapshot behind the displayed lines (s)
+        size_t completed = 0;         // Generations that produced results
+        size_t cancelled = 0;         // Generations abandoned for a newer snapshot
+        bool inFlight = false;        // A generation is queued or running
+    };
+    AsyncStats getAsyncStats() const;
+    
+    /**
+     * Block until no background generation is queued or running
+     * Results are picked up by the next getFieldLines() call.
+     * 
+     * @param timeoutSeconds Maximum wait
+     * @return True if the background thread is idle
+     */
+    bool waitForAsync(double timeoutSeconds);
 
 private:
     // Cached field lines
@@ -59,6 +178,140 @@ private:
     double m_maxRegenerationRate;  // Maximum regeneration rate in Hz
     std::chrono::high_resolution_clock::time_point m_lastRegenerationTime;
     
+    // Optional FMM field source for tracing
+    bool m_useFmm;
+    FmmSolver m_fmm;
+    
+    // Optional interpolated field source for tracing
+    bool m_useFieldGrid;
+    FieldGrid m_fieldGrid;
+    
+    // Optional pool for parallel tracing (not owned)
+    ThreadPool* m_threadPool;
+    
+    // Incremental regeneration state
+    struct LineChunk {
+        glm::dvec3 center;   // Bounding sphere of a run of line points
+        double radius;
+        double minField;     // Weakest |E| on this run
+    };
+    struct LineBound {
+        std::vector<LineChunk> chunks;
+        double errorBound = 0.0;  // Accumulated relative field perturbation
+    };
+    bool m_incremental;
+    double m_incrementalTolerance;
+    int m_seedsPerParticle;
+    std::vector<FieldLine> m_slotLines;      // One line per seed, including empty ones
+    std::vector<LineBound> m_lineBounds;     // Parallel to m_slotLines
+    std::vector<glm::dvec3> m_tracedPositions; // Particle positions behind m_slotLines
+    RegenerationStats m_lastStats;
+    
+    // Async generation state (guarded by m_asyncMutex unless noted)
+    using Clock = std::chrono::steady_clock;
+    struct AsyncJob {
+        std::vector<Particle> particles;   // Snapshot without history
+        FieldLineConfig config;
+        bool fullRegeneration;             // Structural change: skip incremental update
+        Clock::time_point snapshotTime;
+    };
+    bool m_async;                                   // Render thread only
+    std::unique_ptr<ThreadPool> m_asyncPool;        // Background thread only
+    std::thread m_asyncThread;
+    mutable std::mutex m_asyncMutex;
+    std::condition_variable m_asyncWake;
+    std::condition_variable m_asyncIdle;
+    std::unique_ptr<AsyncJob> m_pendingJob;
+    bool m_jobInFlight;
+    bool m_asyncStop;
+    std::atomic<bool> m_cancelInFlight;
+    int m_consecutiveCancels;
+    std::vector<FieldLine> m_completedLines;        // Back buffer
+    bool m_hasCompleted;
+    RegenerationStats m_completedStats;
+    Clock::time_point m_completedSnapshotTime;
+    Clock::time_point m_displayedSnapshotTime;      // Render thread only
+    bool m_hasDisplayed;                            // Render thread only
+    double m_lastLatency;
+    size_t m_completedCount;
+    size_t m_cancelledCount;
+    
+    /**
+     * Trace lines for a particle state into `out`
+     * 
+     * Uses the incremental update when possible. Incremental state is only
+     * committed if the trace was not cancelled.
+     * 
+     * @return False if cancelled (out and incremental state untouched)
+     */
+    bool regenerate(
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        bool forceFull,
+        ThreadPool* pool,
+        const std::atomic<bool>* cancel,
+        std::vector<FieldLine>& out,
+        RegenerationStats& stats
+    );
+    
+    /**
+     * Trace every line (and rebuild incremental state if enabled)
+     */
+    bool regenerateAll(
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        ThreadPool* pool,
+        std::vector<FieldLine>& out,
+        RegenerationStats& stats
+    );
+    
+    /**
+     * Grow line error bounds from particle motion and retrace lines over tolerance
+     */
+    bool regenerateIncremental(
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        ThreadPool* pool,
+        std::vector<FieldLine>& out,
+        RegenerationStats& stats
+    );
+    
+    /**
+     * Config used for tracing (FMM or field grid evaluator attached when enabled;
+     * the grid is rebuilt here if the particles changed)
+     */
+    FieldLineConfig tracingConfig(
+        const std::vector<Particle>& particles,
+        const FieldLineConfig& config,
+        ThreadPool* pool,
+        RegenerationStats& stats
+    );
+    
+    /**
+     * Rebuild the bounding chunks of one line and reset its error bound
+     */
+    static void computeLineBound(const FieldLine& line, LineBound& bound);
+    
+    /**
+     * Copy lines with at least two points from m_slotLines into out
+     */
+    void compactSlots(std::vector<FieldLine>& out) const;
+    
+    void rememberPositions(const std::vector<Particle>& particles);
+    
+    /**
+     * Queue a snapshot for background generation (render thread)
+     */
+    void submitAsync(const std::vector<Particle>& particles, const FieldLineConfig& config);
+    
+    /**
+     * Swap in a finished background result, if any (render thread)
+     */
+    void collectAsync();
+    
+    void asyncLoop();
+    void stopAsync();
+    
     /**
      * Check if particles have moved significantly
      */
@@ -73,5 +326,15 @@ private:
      * Threshold for considering a particle "moved" (meters)
      */
     static constexpr double MOVEMENT_THRESHOLD = 1e-12;
+    
+    /**
+     * Line points per bounding chunk
+     */
+    static constexpr size_t CHUNK_POINTS = 16;
+    
+    /**
+     * Cancellations in a row after which the running generation is kept
+     */
+    static constexpr int MAX_CONSECUTIVE_CANCELS = 2;
 };
 
@@ -0,0 +1,583 @@
+#include "FmmSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // Number of multi-indices with |alpha| <= order
+    constexpr int termCount(int order) {
+        return (order + 1) * (order + 2) * (order + 3) / 6;
+    }
+
+    // Scratch size large enough for Taylor coefficients up to MAX_ORDER + 1
+    constexpr int MAX_TERMS = termCount(FmmSolver::MAX_ORDER + 1);
+}
+
+FmmSolver::FmmSolver()
+    : m_order(6)
+    , m_theta(0.5)
+    , m_leafCapacity(64)
+    , m_lookupStride(0)
+    , m_termCount(0)
+    , m_derivTermCount(0)
+{
+    buildTables();
+}
+
+void FmmSolver::setExpansionOrder(int order) {
+    order = std::clamp(order, 1, MAX_ORDER);
+    if (order != m_order) {
+        m_order = order;
+        buildTables();
+        m_nodes.clear();  // Expansions must be rebuilt for the new order
+    }
+}
+
+void FmmSolver::setOpeningAngle(double theta) {
+    m_theta = std::clamp(theta, 1e-3, 1.0);
+}
+
+void FmmSolver::buildTables() {
+    const int p = m_order;
+    const int maxDegree = p + 1;
+
+    m_lookupStride = maxDegree + 1;
+    m_indexLookup.assign(m_lookupStride * m_lookupStride * m_lookupStride, -1);
+    m_exponents.clear();
+
+    // Order multi-indices by total degree so recurrences only look backwards
+    for (int n = 0; n <= maxDegree; ++n) {
+        for (int ax = n; ax >= 0; --ax) {
+            for (int ay = n - ax; ay >= 0; --ay) {
+                int az = n - ax - ay;
+                m_indexLookup[(ax * m_lookupStride + ay) * m_lookupStride + az] =
+                    static_cast<int>(m_exponents.size());
+                m_exponents.push_back({ax, ay, az});
+            }
+        }
+    }
+    m_termCount = termCount(p);
+    m_derivTermCount = termCount(maxDegree);
+
+    // Binomial coefficients
+    std::vector<std::vector<double>> binom(2 * maxDegree + 1);
+    for (int n = 0; n <= 2 * maxDegree; ++n) {
+        binom[n].assign(n + 1, 1.0);
+        for (int k = 1; k < n; ++k) {
+            binom[n][k] = binom[n - 1][k - 1] + binom[n - 1][k];
+        }
+    }
+    auto multiBinom = [&](const std::array<int, 3>& top, const std::array<int, 3>& bottom) {
+        return binom[top[0]][bottom[0]] * binom[top[1]][bottom[1]] * binom[top[2]][bottom[2]];
+    };
+
+    // Taylor recurrence: n r² a_alpha = -(2n - 1) sum_i R_i a_(alpha - e_i) - (n - 1) sum_i a_(alpha - 2 e_i)
+    m_taylorTerms.assign(m_derivTermCount, {});
+    for (int i = 1; i < m_derivTermCount; ++i) {
+        const auto& alpha = m_exponents[i];
+        int n = alpha[0] + alpha[1] + alpha[2];
+        for (int c = 0; c < 3; ++c) {
+            if (alpha[c] < 1) {
+                continue;
+            }
+            std::array<int, 3> lower = alpha;
+            lower[c] -= 1;
+            m_taylorTerms[i].push_back({multiIndex(lower[0], lower[1], lower[2]), c, -(2.0 * n - 1.0) / n});
+            if (alpha[c] >= 2) {
+                lower[c] -= 1;
+                m_taylorTerms[i].push_back({multiIndex(lower[0], lower[1], lower[2]), -1, -(n - 1.0) / n});
+            }
+        }
+    }
+
+    m_m2mTerms.assign(m_termCount, {});
+    m_m2lTerms.assign(m_termCount, {});
+    m_l2lTerms.assign(m_termCount, {});
+
+    for (int out = 0; out < m_termCount; ++out) {
+        const auto& g = m_exponents[out];
+        int degree = g[0] + g[1] + g[2];
+
+        // M2M: M_gamma = sum_{alpha <= gamma} C(gamma, alpha) M'_alpha (-d)^(gamma - alpha)
+        for (int ax = 0; ax <= g[0]; ++ax) {
+            for (int ay = 0; ay <= g[1]; ++ay) {
+                for (int az = 0; az <= g[2]; ++az) {
+                    std::array<int, 3> alpha = {ax, ay, az};
+                    m_m2mTerms[out].push_back({
+                        multiIndex(ax, ay, az),
+                        multiIndex(g[0] - ax, g[1] - ay, g[2] - az),
+                        multiBinom(g, alpha)
+                    });
+                }
+            }
+        }
+
+        // M2L: L_beta = sum_{|gamma| <= p - |beta|} C(beta + gamma, beta) a_(beta + gamma) M_gamma
+        for (int src = 0; src < termCount(p - degree); ++src) {
+            const auto& gamma = m_exponents[src];
+            std::array<int, 3> sum = {g[0] + gamma[0], g[1] + gamma[1], g[2] + gamma[2]};
+            m_m2lTerms[out].push_back({
+                src,
+                multiIndex(sum[0], sum[1], sum[2]),
+                multiBinom(sum, g)
+            });
+        }
+
+        // L2L: L''_nu = sum_{beta >= nu} C(beta, nu) L_beta e^(beta - nu)
+        for (int src = 0; src < m_termCount; ++src) {
+            const auto& beta = m_exponents[src];
+            if (beta[0] < g[0] || beta[1] < g[1] || beta[2] < g[2]) {
+                continue;
+            }
+            m_l2lTerms[out].push_back({
+                src,
+                multiIndex(beta[0] - g[0], beta[1] - g[1], beta[2] - g[2]),
+                multiBinom(beta, g)
+            });
+        }
+    }
+}
+
+void FmmSolver::taylorCoefficients(const glm::dvec3& R, int maxOrder, double* out) const {
+    // Recurrence for a_alpha = D^alpha(1/r) / alpha! (see m_taylorTerms)
+    double r2 = glm::dot(R, R);
+    double invR2 = 1.0 / r2;
+    out[0] = std::sqrt(invR2);
+
+    int count = termCount(maxOrder);
+    for (int i = 1; i < count; ++i) {
+        double sum = 0.0;
+        for (const Term& term : m_taylorTerms[i]) {
+            double factor = term.second >= 0 ? R[term.second] : 1.0;
+            sum += term.coeff * factor * out[term.first];
+        }
+        out[i] = sum * invR2;
+    }
+}
+
+void FmmSolver::monomials(const glm::dvec3& d, double* out) const {
+    double px[MAX_ORDER + 2], py[MAX_ORDER + 2], pz[MAX_ORDER + 2];
+    px[0] = py[0] = pz[0] = 1.0;
+    for (int n = 1; n <= m_order; ++n) {
+        px[n] = px[n - 1] * d.x;
+        py[n] = py[n - 1] * d.y;
+        pz[n] = pz[n - 1] * d.z;
+    }
+    for (int i = 0; i < m_termCount; ++i) {
+        const auto& e = m_exponents[i];
+        out[i] = px[e[0]] * py[e[1]] * pz[e[2]];
+    }
+}
+
+void FmmSolver::build(const std::vector<Particle>& particles) {
+    m_positions.clear();
+    m_charges.clear();
+    m_positions.reserve(particles.size());
+    m_charges.reserve(particles.size());
+    for (const auto& p : particles) {
+        m_positions.push_back(p.position);
+        m_charges.push_back(p.charge);
+    }
+    buildFromSources();
+}
+
+void FmmSolver::build(const ParticleStore& store) {
+    m_positions.resize(store.size());
+    m_charges.assign(store.q.begin(), store.q.end());
+    for (size_t i = 0; i < store.size(); ++i) {
+        m_positions[i] = store.position(i);
+    }
+    buildFromSources();
+}
+
+void FmmSolver::buildFromSources() {
+    m_nodes.clear();
+    m_originalIndex.resize(m_positions.size());
+    for (size_t i = 0; i < m_positions.size(); ++i) {
+        m_originalIndex[i] = static_cast<int>(i);
+    }
+    m_fields.assign(m_positions.size(), glm::dvec3(0.0));
+
+    if (m_positions.empty()) {
+        return;
+    }
+
+    glm::dvec3 minCorner(std::numeric_limits<double>::max());
+    glm::dvec3 maxCorner(std::numeric_limits<double>::lowest());
+    for (const auto& p : m_positions) {
+        minCorner = glm::min(minCorner, p);
+        maxCorner = glm::max(maxCorner, p);
+    }
+
+    glm::dvec3 center = 0.5 * (minCorner + maxCorner);
+    glm::dvec3 extent = maxCorner - minCorner;
+    double halfSize = 0.5 * std::max({extent.x, extent.y, extent.z});
+    halfSize = halfSize * (1.0 + 1e-9) + PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    m_nodes.reserve(2 * m_positions.size() / static_cast<size_t>(m_leafCapacity) + 16);
+    buildNode(0, static_cast<int>(m_positions.size()), center, halfSize, 0);
+
+    m_multipoles.assign(m_nodes.size() * m_termCount, 0.0);
+    m_locals.assign(m_nodes.size() * m_termCount, 0.0);
+    upwardPass(0);
+}
+
+int FmmSolver::buildNode(int begin, int end, const glm::dvec3& center, double halfSize, int depth) {
+    int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    Node& node = m_nodes[nodeIndex];
+    node.center = center;
+    node.halfSize = halfSize;
+    node.begin = begin;
+    node.end = end;
+    node.isLeaf = (end - begin) <= m_leafCapacity || depth >= MAX_DEPTH;
+    std::fill(std::begin(node.children), std::end(node.children), -1);
+
+    double radius = 0.0;
+    for (int i = begin; i < end; ++i) {
+        radius = std::max(radius, glm::length(m_positions[i] - center));
+    }
+    node.radius = radius;
+
+    if (node.isLeaf) {
+        return nodeIndex;
+    }
+
+    // Counting sort of the range into octants
+    int counts[8] = {0};
+    std::vector<int> octants(end - begin);
+    for (int i = begin; i < end; ++i) {
+        const glm::dvec3& p = m_positions[i];
+        int octant = (p.x >= center.x ? 1 : 0) |
+                     (p.y >= center.y ? 2 : 0) |
+                     (p.z >= center.z ? 4 : 0);
+        octants[i - begin] = octant;
+        ++counts[octant];
+    }
+
+    int offsets[9] = {0};
+    for (int o = 0; o < 8; ++o) {
+        offsets[o + 1] = offsets[o] + counts[o];
+    }
+
+    std::vector<glm::dvec3> sortedPositions(end - begin);
+    std::vector<double> sortedCharges(end - begin);
+    std::vector<int> sortedIndices(end - begin);
+    int cursor[8];
+    std::copy(offsets, offsets + 8, cursor);
+    for (int i = begin; i < end; ++i) {
+        int slot = cursor[octants[i - begin]]++;
+        sortedPositions[slot] = m_positions[i];
+        sortedCharges[slot] = m_charges[i];
+        sortedIndices[slot] = m_originalIndex[i];
+    }
+    std::copy(sortedPositions.begin(), sortedPositions.end(), m_positions.begin() + begin);
+    std::copy(sortedCharges.begin(), sortedCharges.end(), m_charges.begin() + begin);
+    std::copy(sortedIndices.begin(), sortedIndices.end(), m_originalIndex.begin() + begin);
+
+    double childHalf = 0.5 * halfSize;
+    for (int o = 0; o < 8; ++o) {
+        if (counts[o] == 0) {
+            continue;
+        }
+        glm::dvec3 childCenter = center + childHalf * glm::dvec3(
+            (o & 1) ? 1.0 : -1.0,
+            (o & 2) ? 1.0 : -1.0,
+            (o & 4) ? 1.0 : -1.0
+        );
+        int child = buildNode(begin + offsets[o], begin + offsets[o + 1], childCenter, childHalf, depth + 1);
+        m_nodes[nodeIndex].children[o] = child;
+    }
+
+    return nodeIndex;
+}
+
+void FmmSolver::upwardPass(int nodeIndex) {
+    const Node& node = m_nodes[nodeIndex];
+    double* M = &m_multipoles[nodeIndex * m_termCount];
+    double mono[MAX_TERMS];
+
+    if (node.isLeaf) {
+        // P2M: M_gamma = sum q (-s)^gamma
+        for (int i = node.begin; i < node.end; ++i) {
+            monomials(node.center - m_positions[i], mono);
+            for (int t = 0; t < m_termCount; ++t) {
+                M[t] += m_charges[i] * mono[t];
+            }
+        }
+        return;
+    }
+
+    for (int child : node.children) {
+        if (child < 0) {
+            continue;
+        }
+        upwardPass(child);
+
+        // M2M: shift child expansion to this centre
+        const double* childM = &m_multipoles[child * m_termCount];
+        monomials(node.center - m_nodes[child].center, mono);
+        for (int g = 0; g < m_termCount; ++g) {
+            double sum = 0.0;
+            for (const Term& term : m_m2mTerms[g]) {
+                sum += term.coeff * childM[term.first] * mono[term.second];
+            }
+            M[g] += sum;
+        }
+    }
+}
+
+void FmmSolver::computeFields() {
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::fill(m_locals.begin(), m_locals.end(), 0.0);
+    m_treeFields.assign(m_positions.size(), glm::dvec3(0.0));
+
+    interact(0, 0);
+    downwardPass(0);
+
+    for (size_t i = 0; i < m_positions.size(); ++i) {
+        m_fields[m_originalIndex[i]] = m_treeFields[i];
+    }
+}
+
+void FmmSolver::interact(int target, int source) {
+    const Node& A = m_nodes[target];
+    const Node& B = m_nodes[source];
+
+    if (target == source) {
+        if (A.isLeaf) {
+            particleToParticle(target, source);
+            return;
+        }
+        for (int a : A.children) {
+            if (a < 0) continue;
+            for (int b : A.children) {
+                if (b < 0) continue;
+                interact(a, b);
+            }
+        }
+        return;
+    }
+
+    double distance = glm::length(A.center - B.center);
+    if (A.radius + B.radius < m_theta * distance) {
+        multipoleToLocal(target, source);
+        return;
+    }
+
+    if (A.isLeaf && B.isLeaf) {
+        particleToParticle(target, source);
+        return;
+    }
+
+    // Split the larger cell
+    bool splitTarget = B.isLeaf || (!A.isLeaf && A.radius >= B.radius);
+    if (splitTarget) {
+        for (int a : A.children) {
+            if (a >= 0) interact(a, source);
+        }
+    } else {
+        for (int b : B.children) {
+            if (b >= 0) interact(target, b);
+        }
+    }
+}
+
+void FmmSolver::multipoleToLocal(int target, int source) {
+    double a[MAX_TERMS];
+    taylorCoefficients(m_nodes[target].center - m_nodes[source].center, m_order, a);
+
+    const double* M = &m_multipoles[source * m_termCount];
+    double* L = &m_locals[target * m_termCount];
+    for (int b = 0; b < m_termCount; ++b) {
+        double sum = 0.0;
+        for (const Term& term : m_m2lTerms[b]) {
+            sum += term.coeff * a[term.second] * M[term.first];
+        }
+        L[b] += sum;
+    }
+}
+
+void FmmSolver::particleToParticle(int target, int source) {
+    const Node& A = m_nodes[target];
+    const Node& B = m_nodes[source];
+    const double minDist2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    for (int i = A.begin; i < A.end; ++i) {
+        glm::dvec3 E(0.0);
+        for (int j = B.begin; j < B.end; ++j) {
+            glm::dvec3 r = m_positions[i] - m_positions[j];
+            double r2 = glm::dot(r, r);
+            if (r2 < minDist2) {
+                continue;
+            }
+            double rMag = std::sqrt(r2);
+            E += (m_charges[j] / (r2 * rMag)) * r;
+        }
+        m_treeFields[i] += PhysicsConstants::k * E;
+    }
+}
+
+void FmmSolver::downwardPass(int nodeIndex) {
+    const Node& node = m_nodes[nodeIndex];
+    const double* L = &m_locals[nodeIndex * m_termCount];
+    double mono[MAX_TERMS];
+
+    if (node.isLeaf) {
+        // L2P: E = -k grad(sum L_beta t^beta)
+        for (int i = node.begin; i < node.end; ++i) {
+            monomials(m_positions[i] - node.center, mono);
+            glm::dvec3 grad(0.0);
+            for (int b = 1; b < m_termCount; ++b) {
+                const auto& beta = m_exponents[b];
+                if (beta[0] > 0) grad.x += L[b] * beta[0] * mono[multiIndex(beta[0] - 1, beta[1], beta[2])];
+                if (beta[1] > 0) grad.y += L[b] * beta[1] * mono[multiIndex(beta[0], beta[1] - 1, beta[2])];
+                if (beta[2] > 0) grad.z += L[b] * beta[2] * mono[multiIndex(beta[0], beta[1], beta[2] - 1)];
+            }
+            m_treeFields[i] -= PhysicsConstants::k * grad;
+        }
+        return;
+    }
+
+    for (int child : node.children) {
+        if (child < 0) {
+            continue;
+        }
+
+        // L2L: shift local expansion to the child centre
+        monomials(m_nodes[child].center - node.center, mono);
+        double* childL = &m_locals[child * m_termCount];
+        for (int n = 0; n < m_termCount; ++n) {
+            double sum = 0.0;
+            for (const Term& term : m_l2lTerms[n]) {
+                sum += term.coeff * L[term.first] * mono[term.second];
+            }
+            childL[n] += sum;
+        }
+
+        downwardPass(child);
+    }
+}
+
+glm::dvec3 FmmSolver::multipoleField(const Node& node, int nodeIndex, const glm::dvec3& evalPoint) const {
+    double a[MAX_TERMS];
+    taylorCoefficients(evalPoint - node.center, m_order + 1, a);
+
+    // E_i = -k sum_alpha (alpha_i + 1) a_(alpha + e_i) M_alpha
+    const double* M = &m_multipoles[nodeIndex * m_termCount];
+    glm::dvec3 grad(0.0);
+    for (int t = 0; t < m_termCount; ++t) {
+        const auto& alpha = m_exponents[t];
+        grad.x += (alpha[0] + 1) * a[multiIndex(alpha[0] + 1, alpha[1], alpha[2])] * M[t];
+        grad.y += (alpha[1] + 1) * a[multiIndex(alpha[0], alpha[1] + 1, alpha[2])] * M[t];
+        grad.z += (alpha[2] + 1) * a[multiIndex(alpha[0], alpha[1], alpha[2] + 1)] * M[t];
+    }
+    return -PhysicsConstants::k * grad;
+}
+
+double FmmSolver::multipolePotential(int nodeIndex, const glm::dvec3& evalPoint) const {
+    double a[MAX_TERMS];
+    taylorCoefficients(evalPoint - m_nodes[nodeIndex].center, m_order, a);
+
+    // phi = k sum_alpha a_alpha M_alpha
+    const double* M = &m_multipoles[nodeIndex * m_termCount];
+    double phi = 0.0;
+    for (int t = 0; t < m_termCount; ++t) {
+        phi += a[t] * M[t];
+    }
+    return PhysicsConstants::k * phi;
+}
+
+glm::dvec3 FmmSolver::fieldAt(const glm::dvec3& evalPoint) const {
+    glm::dvec3 totalE(0.0);
+    if (m_nodes.empty()) {
+        return totalE;
+    }
+
+    const double minDist2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        int nodeIndex = stack[--stackSize];
+        const Node& node = m_nodes[nodeIndex];
+
+        double distance = glm::length(evalPoint - node.center);
+        if (node.radius < m_theta * distance) {
+            totalE += multipoleField(node, nodeIndex, evalPoint);
+            continue;
+        }
+
+        if (node.isLeaf) {
+            for (int i = node.begin; i < node.end; ++i) {
+                glm::dvec3 r = evalPoint - m_positions[i];
+                double r2 = glm::dot(r, r);
+                if (r2 < minDist2) {
+                    continue;
+                }
+                double rMag = std::sqrt(r2);
+                totalE += (PhysicsConstants::k * m_charges[i] / (r2 * rMag)) * r;
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child >= 0) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+
+    return totalE;
+}
+
+double FmmSolver::potentialAt(const glm::dvec3& evalPoint) const {
+    double totalPhi = 0.0;
+    if (m_nodes.empty()) {
+        return totalPhi;
+    }
+
+    const double minDist2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        int nodeIndex = stack[--stackSize];
+        const Node& node = m_nodes[nodeIndex];
+
+        double distance = glm::length(evalPoint - node.center);
+        if (node.radius < m_theta * distance) {
+            totalPhi += multipolePotential(nodeIndex, evalPoint);
+            continue;
+        }
+
+        if (node.isLeaf) {
+            for (int i = node.begin; i < node.end; ++i) {
+                glm::dvec3 r = evalPoint - m_positions[i];
+                double r2 = glm::dot(r, r);
+                if (r2 < minDist2) {
+                    continue;
+                }
+                totalPhi += PhysicsConstants::k * m_charges[i] / std::sqrt(r2);
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child >= 0) {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+
+    return totalPhi;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+#include "Particle.hpp"
+#include "ParticleStore.hpp"
+
+/**
+ * Fast Multipole Method Solver
+ *
+ * Computes the Coulomb field at every particle in O(N) using Cartesian Taylor
+ * expansions on an adaptive octree:
+ * - P2M / M2M: multipole moments built bottom-up
+ * - M2L: multipole-to-local translation between well-separated cells
+ *   (found by dual tree traversal)
+ * - L2L / L2P: local expansions pushed down to particles
+ * - P2P: direct sum between neighbouring leaves
+ *
+ * The expansion order p is a runtime parameter; the error of an M2L interaction
+ * scales roughly as theta^(p+1), where theta is the opening angle.
+ *
+ * The field and potential at arbitrary points (e.g. for field line tracing or
+ * potential grids) are served by evaluating the multipole expansions directly
+ * (M2P) with the same acceptance test.
+ */
+class FmmSolver {
+public:
+    FmmSolver();
+
+    /**
+     * Set expansion order p (clamped to [1, MAX_ORDER])
+     */
+    void setExpansionOrder(int order);
+    int getExpansionOrder() const { return m_order; }
+
+    /**
+     * Set opening angle: cells interact via expansions when
+     * (radiusA + radiusB) < theta * distance (clamped to (0, 1])
+     */
+    void setOpeningAngle(double theta);
+    double getOpeningAngle() const { return m_theta; }
+
+    /**
+     * Set maximum number of particles per leaf cell
+     */
+    void setLeafCapacity(int capacity) { m_leafCapacity = capacity < 1 ? 1 : capacity; }
+
+    /**
+     * Build the octree and multipole expansions (P2M, M2M)
+     *
+     * @param particles Source particles (copied; the solver does not keep a reference)
+     */
+    void build(const std::vector<Particle>& particles);
+
+    /**
+     * Build from structure-of-arrays particle data
+     */
+    void build(const ParticleStore& store);
+
+    /**
+     * Compute the field at every particle (M2L, L2L, L2P, P2P)
+     * Results are available through getFields() in the original particle order.
+     */
+    void computeFields();
+
+    /**
+     * Get fields computed by computeFields(), indexed like the particles passed to build()
+     */
+    const std::vector<glm::dvec3>& getFields() const { return m_fields; }
+
+    /**
+     * Compute the field at an arbitrary point from the built expansions
+     *
+     * Sources closer than MIN_SAFE_DISTANCE are skipped. Thread-safe after build().
+     *
+     * @param evalPoint Point where field is evaluated (meters)
+     * @return Electric field vector in N/C
+     */
+    glm::dvec3 fieldAt(const glm::dvec3& evalPoint) const;
+
+    /**
+     * Compute the electrostatic potential at an arbitrary point (M2P, same
+     * acceptance test as fieldAt()). Thread-safe after build().
+     *
+     * @param evalPoint Point where potential is evaluated (meters)
+     * @return Potential in volts
+     */
+    double potentialAt(const glm::dvec3& evalPoint) const;
+
+    /**
+     * Check if solver has been built with at least one particle
+     */
+    bool empty() const { return m_nodes.empty(); }
+
+    static constexpr int MAX_ORDER = 16;
+
+private:
+    struct Node {
+        glm::dvec3 center;   // Expansion centre (geometric cell centre)
+        double halfSize;     // Half edge length of the cubic cell
+        double radius;       // Max distance from centre to any particle in the cell
+        int children[8];     // Child node indices (-1 if empty)
+        int begin;           // First particle in tree order
+        int end;             // One past last particle in tree order
+        bool isLeaf;
+    };
+
+    // Precomputed translation term: out[target] += coeff * a[source] * b[other]
+    struct Term {
+        int first;
+        int second;
+        double coeff;
+    };
+
+    int m_order;
+    double m_theta;
+    int m_leafCapacity;
+
+    std::vector<Node> m_nodes;
+
+    // Particle data in tree order
+    std::vector<glm::dvec3> m_positions;
+    std::vector<double> m_charges;
+    std::vector<int> m_originalIndex;       // Tree order -> input order
+    std::vector<glm::dvec3> m_treeFields;   // Field per particle in tree order
+
+    // Field per particle in input order
+    std::vector<glm::dvec3> m_fields;
+
+    // Expansion coefficients, nodeCount * termCount(order)
+    std::vector<double> m_multipoles;
+    std::vector<double> m_locals;
+
+    // Multi-index tables (up to order + 1 for field derivatives)
+    std::vector<std::array<int, 3>> m_exponents;   // index -> (ax, ay, az)
+    std::vector<int> m_indexLookup;                // (ax, ay, az) -> index
+    int m_lookupStride;
+    int m_termCount;                                // Terms with |alpha| <= order
+    int m_derivTermCount;                           // Terms with |alpha| <= order + 1
+
+    // Translation tables, one list per output coefficient
+    std::vector<std::vector<Term>> m_m2mTerms;   // gamma: (alpha, gamma - alpha, C(gamma, alpha))
+    std::vector<std::vector<Term>> m_m2lTerms;   // beta: (gamma, beta + gamma, C(beta + gamma, beta))
+    std::vector<std::vector<Term>> m_l2lTerms;   // nu: (beta, beta - nu, C(beta, nu))
+
+    // Taylor coefficient recurrence, one list per coefficient:
+    // first = lower index, second = component (or -1 for the a_(alpha - 2 e_i) term)
+    std::vector<std::vector<Term>> m_taylorTerms;
+
+    static constexpr int MAX_DEPTH = 32;
+
+    /**
+     * Rebuild multi-index and translation tables for the current order
+     */
+    void buildTables();
+
+    int multiIndex(int ax, int ay, int az) const {
+        return m_indexLookup[(ax * m_lookupStride + ay) * m_lookupStride + az];
+    }
+
+    /**
+     * Build tree and expansions over the sources currently in m_positions / m_charges
+     */
+    void buildFromSources();
+
+    int buildNode(int begin, int end, const glm::dvec3& center, double halfSize, int depth);
+
+    /**
+     * Taylor coefficients of 1/|R + u| in u, i.e. D^alpha(1/r)(R) / alpha!, up to maxOrder
+     */
+    void taylorCoefficients(const glm::dvec3& R, int maxOrder, double* out) const;
+
+    /**
+     * Monomials d^alpha for all |alpha| <= order
+     */
+    void monomials(const glm::dvec3& d, double* out) const;
+
+    void upwardPass(int nodeIndex);
+    void interact(int target, int source);
+    void multipoleToLocal(int target, int source);
+    void particleToParticle(int target, int source);
+    void downwardPass(int nodeIndex);
+
+    /**
+     * Field of a node's multipole expansion at a point (M2P)
+     */
+    glm::dvec3 multipoleField(const Node& node, int nodeIndex, const glm::dvec3& evalPoint) const;
+
+    /**
+     * Potential of a node's multipole expansion at a point (M2P)
+     */
+    double multipolePotential(int nodeIndex, const glm::dvec3& evalPoint) const;
+};
@@ -0,0 +1,47 @@
+#include "MagneticField.hpp"
+#include "CoulombKernel.hpp"
+#include "engine/core/Constants.hpp"
+
+namespace {
+    constexpr double K_OVER_C2 = PhysicsConstants::k / (PhysicsConstants::c * PhysicsConstants::c);
+}
+
+glm::dvec3 MagneticField::fromMovingCharge(
+    const glm::dvec3& evalPoint,
+    const glm::dvec3& chargePos,
+    const glm::dvec3& velocity,
+    double q
+) {
+    glm::dvec3 r = evalPoint - chargePos;
+    double distance = glm::length(r);
+    if (distance < PhysicsConstants::MIN_SAFE_DISTANCE) {
+        return glm::dvec3(0.0);
+    }
+    return K_OVER_C2 * q * glm::cross(velocity, r) / (distance * distance * distance);
+}
+
+glm::dvec3 MagneticField::totalField(
+    const glm::dvec3& evalPoint,
+    const double* x,
+    const double* y,
+    const double* z,
+    const double* qvx,
+    const double* qvy,
+    const double* qvz,
+    size_t count
+) {
+    // G_a = k Σ (q v_a) r / r³, so (v × r)-sums are cross combinations of the G_a
+    glm::dvec3 gx = CoulombKernel::fieldAt(evalPoint, x, y, z, qvx, count);
+    glm::dvec3 gy = CoulombKernel::fieldAt(evalPoint, x, y, z, qvy, count);
+    glm::dvec3 gz = CoulombKernel::fieldAt(evalPoint, x, y, z, qvz, count);
+    constexpr double invC2 = 1.0 / (PhysicsConstants::c * PhysicsConstants::c);
+    return invC2 * glm::dvec3(gy.z - gz.y, gz.x - gx.z, gx.y - gy.x);
+}
+
+glm::dvec3 MagneticField::totalField(const glm::dvec3& evalPoint, const ParticleStore& sources) {
+    glm::dvec3 total(0.0);
+    for (size_t j = 0; j < sources.size(); ++j) {
+        total += fromMovingCharge(evalPoint, sources.position(j), sources.velocity(j), sources.q[j]);
+    }
+    return total;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include "ParticleStore.hpp"
+
+/**
+ * Magnetic Field of Moving Charges
+ *
+ * Biot–Savart field of point charges moving at low speed:
+ *
+ *   B = (μ₀/4π) q v × r̂ / r² = (k/c²) q v × r / r³
+ *
+ * This is the first-order (v/c) field; the retarded force method covers the
+ * fully relativistic case. The field of a charge at its own position is zero
+ * (sources closer than MIN_SAFE_DISTANCE are skipped, as for E).
+ */
+class MagneticField {
+public:
+    /**
+     * Magnetic field at evalPoint from one moving charge
+     *
+     * @param evalPoint Point where field is evaluated (meters)
+     * @param chargePos Position of the charge (meters)
+     * @param velocity Velocity of the charge (m/s)
+     * @param q Charge in coulombs
+     * @return Magnetic field in tesla
+     */
+    static glm::dvec3 fromMovingCharge(
+        const glm::dvec3& evalPoint,
+        const glm::dvec3& chargePos,
+        const glm::dvec3& velocity,
+        double q
+    );
+
+    /**
+     * Total magnetic field at evalPoint from SoA sources and their currents q·v
+     *
+     * Each current component acts like a charge in the Coulomb sum, so the field is
+     * assembled from three vectorized CoulombKernel passes:
+     * B = (1/c²) Σ_a e_a × G_a with G_a = k Σ (q v_a) r / r³.
+     *
+     * @param evalPoint Point where field is evaluated (meters)
+     * @param x, y, z Source positions (meters)
+     * @param qvx, qvy, qvz Source currents q·v (C·m/s)
+     * @param count Number of sources
+     * @return Magnetic field in tesla
+     */
+    static glm::dvec3 totalField(
+        const glm::dvec3& evalPoint,
+        const double* x,
+        const double* y,
+        const double* z,
+        const double* qvx,
+        const double* qvy,
+        const double* qvz,
+        size_t count
+    );
+
+    /**
+     * Total magnetic field at evalPoint from all particles in a store
+     * (reference sum, one source at a time)
+     */
+    static glm::dvec3 totalField(const glm::dvec3& evalPoint, const ParticleStore& sources);
+
+private:
+    // Prevent instantiation (static class)
+    MagneticField() = delete;
+};
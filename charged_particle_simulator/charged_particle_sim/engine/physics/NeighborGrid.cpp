@@ -0,0 +1,113 @@
+#include "NeighborGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Cell coordinates are clamped so far-away particles cannot overflow int64
+    constexpr double MAX_CELL_COORDINATE = 4.0e18;
+
+    int64_t toCell(double value) {
+        double cell = std::floor(value);
+        if (!(cell > -MAX_CELL_COORDINATE)) {
+            return static_cast<int64_t>(-MAX_CELL_COORDINATE);
+        }
+        if (!(cell < MAX_CELL_COORDINATE)) {
+            return static_cast<int64_t>(MAX_CELL_COORDINATE);
+        }
+        return static_cast<int64_t>(cell);
+    }
+}
+
+NeighborGrid::NeighborGrid()
+    : m_cellSize(1.0)
+    , m_inverseCellSize(1.0)
+    , m_bucketMask(0)
+{
+}
+
+void NeighborGrid::build(const ParticleStore& store, double cellSize) {
+    build(store.x.data(), store.y.data(), store.z.data(), store.size(), cellSize);
+}
+
+void NeighborGrid::build(const double* x, const double* y, const double* z, size_t count, double cellSize) {
+    m_cellSize = cellSize > 0.0 ? cellSize : 1.0;
+    m_inverseCellSize = 1.0 / m_cellSize;
+
+    // About two buckets per particle keeps collisions between occupied cells rare
+    size_t buckets = 1;
+    while (buckets < 2 * count) {
+        buckets <<= 1;
+    }
+    m_bucketMask = buckets - 1;
+
+    // Counting sort by bucket (stable: ascending indices within a bucket)
+    m_bucket.resize(count);
+    m_bucketStart.assign(buckets + 1, 0);
+    m_occupied.assign((buckets + 63) / 64, 0);
+    for (size_t i = 0; i < count; ++i) {
+        Cell cell = cellOf(x[i], y[i], z[i]);
+        m_bucket[i] = bucketOf(cell.x, cell.y, cell.z);
+        ++m_bucketStart[m_bucket[i] + 1];
+        m_occupied[m_bucket[i] >> 6] |= uint64_t(1) << (m_bucket[i] & 63);
+    }
+    for (size_t b = 0; b < buckets; ++b) {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+
+    m_index.resize(count);
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = m_bucketStart[m_bucket[i]]++;
+        m_index[slot] = static_cast<uint32_t>(i);
+        m_x[slot] = x[i];
+        m_y[slot] = y[i];
+        m_z[slot] = z[i];
+    }
+
+    // The scatter advanced every start to the next bucket's start
+    for (size_t b = buckets; b > 0; --b) {
+        m_bucketStart[b] = m_bucketStart[b - 1];
+    }
+    m_bucketStart[0] = 0;
+}
+
+std::vector<size_t> NeighborGrid::neighbors(const glm::dvec3& point, double radius) const {
+    std::vector<size_t> result;
+    forEachNeighbor(point, radius, [&result](size_t j, double) { result.push_back(j); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+NeighborGrid::Cell NeighborGrid::cellOf(double x, double y, double z) const {
+    return Cell{toCell(x * m_inverseCellSize), toCell(y * m_inverseCellSize), toCell(z * m_inverseCellSize)};
+}
+
+size_t NeighborGrid::bucketOf(int64_t x, int64_t y, int64_t z) const {
+    return mix(hashX(x) ^ hashY(y) ^ hashZ(z));
+}
+
+int NeighborGrid::neighborBuckets(const Cell& cell, size_t* buckets) const {
+    // Axis hashes combine by XOR, so 9 multiplications cover all 27 cells
+    uint64_t hx[3], hy[3], hz[3];
+    for (int d = 0; d < 3; ++d) {
+        hx[d] = hashX(cell.x + d - 1);
+        hy[d] = hashY(cell.y + d - 1);
+        hz[d] = hashZ(cell.z + d - 1);
+    }
+    int count = 0;
+    for (int dx = 0; dx < 3; ++dx) {
+        for (int dy = 0; dy < 3; ++dy) {
+            const uint64_t hxy = hx[dx] ^ hy[dy];
+            for (int dz = 0; dz < 3; ++dz) {
+                size_t bucket = mix(hxy ^ hz[dz]);
+                if (m_occupied[bucket >> 6] >> (bucket & 63) & 1) {
+                    buckets[count++] = bucket;
+                }
+            }
+        }
+    }
+    std::sort(buckets, buckets + count);
+    return static_cast<int>(std::unique(buckets, buckets + count) - buckets);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "ParticleStore.hpp"
+
+/**
+ * Neighbor Grid (spatial hash)
+ *
+ * Finds short-range pairs in O(N) instead of testing all N² pairs. Space is cut
+ * into cubic cells of the query radius, and every cell is hashed into a table of
+ * about 2N buckets, so unbounded or sparse scenes need no bounding box and memory
+ * stays O(N). build() is a counting sort by bucket: count, prefix sum, scatter.
+ * Particles of one bucket are contiguous, in ascending index order, with copies
+ * of their positions next to them.
+ *
+ * Neighbors within the cell size are in the 27 cells around a particle's cell.
+ * An occupancy bitmap (one bit per bucket) skips empty cells without touching the
+ * bucket table. Distinct cells can share a bucket, so queries visit each distinct
+ * bucket once and check real distances. Queries are read-only and thread-safe after build().
+ *
+ * Used for collision prevention; point queries serve picking, dragging and other
+ * short-range features.
+ */
+class NeighborGrid {
+public:
+    NeighborGrid();
+
+    /**
+     * Sort particles into cells
+     *
+     * @param cellSize Cell edge length, normally the largest query radius (> 0)
+     */
+    void build(const double* x, const double* y, const double* z, size_t count, double cellSize);
+    void build(const ParticleStore& store, double cellSize);
+
+    /**
+     * Visit every pair closer than radius once, as visit(i, j, distanceSquared)
+     * with i < j (original indices). radius must not exceed the cell size.
+     */
+    template <typename Visit>
+    void forEachPair(double radius, Visit&& visit) const;
+
+    /**
+     * Visit every particle closer than radius to point, as visit(j, distanceSquared)
+     * (any radius; large ones visit more cells)
+     */
+    template <typename Visit>
+    void forEachNeighbor(const glm::dvec3& point, double radius, Visit&& visit) const;
+
+    /**
+     * All particles within radius of point, in ascending index order
+     */
+    std::vector<size_t> neighbors(const glm::dvec3& point, double radius) const;
+
+    size_t size() const { return m_index.size(); }
+    double getCellSize() const { return m_cellSize; }
+
+private:
+    struct Cell {
+        int64_t x, y, z;
+    };
+
+    Cell cellOf(double x, double y, double z) const;
+    size_t bucketOf(int64_t x, int64_t y, int64_t z) const;
+
+    // Large odd multipliers per axis spread neighboring cells over the table
+    static uint64_t hashX(int64_t x) { return static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull; }
+    static uint64_t hashY(int64_t y) { return static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full; }
+    static uint64_t hashZ(int64_t z) { return static_cast<uint64_t>(z) * 0x165667B19E3779F9ull; }
+    size_t mix(uint64_t h) const { return static_cast<size_t>(h ^ (h >> 29)) & m_bucketMask; }
+
+    /**
+     * Distinct occupied buckets of the 27 cells around cell (sorted, at most 27)
+     */
+    int neighborBuckets(const Cell& cell, size_t* buckets) const;
+
+    double m_cellSize;
+    double m_inverseCellSize;
+    size_t m_bucketMask;                  // Bucket count - 1 (power of two)
+
+    std::vector<uint32_t> m_bucketStart;  // [bucket], [bucket + 1]: slots of the bucket
+    std::vector<uint32_t> m_index;        // [slot]: original particle index
+    std::vector<double> m_x, m_y, m_z;    // [slot]: positions in bucket order
+    std::vector<uint64_t> m_occupied;     // Bit per bucket: small enough to stay in cache
+    std::vector<size_t> m_bucket;         // [particle]: scratch for the sort
+};
+
+template <typename Visit>
+void NeighborGrid::forEachPair(double radius, Visit&& visit) const {
+    const double radius2 = radius * radius;
+    size_t buckets[27];
+    const size_t slots = m_index.size();
+    for (size_t s = 0; s < slots; ++s) {
+        const uint32_t i = m_index[s];
+        const double xi = m_x[s];
+        const double yi = m_y[s];
+        const double zi = m_z[s];
+        const int count = neighborBuckets(cellOf(xi, yi, zi), buckets);
+        for (int b = 0; b < count; ++b) {
+            const uint32_t end = m_bucketStart[buckets[b] + 1];
+            for (uint32_t t = m_bucketStart[buckets[b]]; t < end; ++t) {
+                const uint32_t j = m_index[t];
+                if (j <= i) {
+                    continue;
+                }
+                const double dx = m_x[t] - xi;
+                const double dy = m_y[t] - yi;
+                const double dz = m_z[t] - zi;
+                const double d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 < radius2) {
+                    visit(static_cast<size_t>(i), static_cast<size_t>(j), d2);
+                }
+            }
+        }
+    }
+}
+
+template <typename Visit>
+void NeighborGrid::forEachNeighbor(const glm::dvec3& point, double radius, Visit&& visit) const {
+    if (m_index.empty()) {
+        return;
+    }
+    const double radius2 = radius * radius;
+    const Cell low = cellOf(point.x - radius, point.y - radius, point.z - radius);
+    const Cell high = cellOf(point.x + radius, point.y + radius, point.z + radius);
+
+    // Beyond one cell per bucket on average, scanning everything is cheaper
+    const double cells = static_cast<double>(high.x - low.x + 1) *
+                         static_cast<double>(high.y - low.y + 1) *
+                         static_cast<double>(high.z - low.z + 1);
+    auto test = [&](uint32_t t) {
+        const double dx = m_x[t] - point.x;
+        const double dy = m_y[t] - point.y;
+        const double dz = m_z[t] - point.z;
+        const double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 < radius2) {
+            visit(static_cast<size_t>(m_index[t]), d2);
+        }
+    };
+    if (cells > static_cast<double>(m_bucketMask + 1)) {
+        for (uint32_t t = 0; t < m_index.size(); ++t) {
+            test(t);
+        }
+        return;
+    }
+
+    // Collect distinct buckets so colliding cells are not scanned twice
+    std::vector<size_t> buckets;
+    buckets.reserve(static_cast<size_t>(cells));
+    for (int64_t x = low.x; x <= high.x; ++x) {
+        for (int64_t y = low.y; y <= high.y; ++y) {
+            for (int64_t z = low.z; z <= high.z; ++z) {
+                buckets.push_back(bucketOf(x, y, z));
+            }
+        }
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    for (size_t bucket : buckets) {
+        if (!(m_occupied[bucket >> 6] >> (bucket & 63) & 1)) {
+            continue;
+        }
+        for (uint32_t t = m_bucketStart[bucket]; t < m_bucketStart[bucket + 1]; ++t) {
+            test(t);
+        }
+    }
+}
@@ -0,0 +1,312 @@
+#include "P3MSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include "engine/math/Fft.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // α r_c with erfc(α r_c) ≈ 1e-5: the short-range sum is truncated at that level
+    constexpr double CUTOFF_SPLITTING = 3.12;
+
+    // Aliases k + 2π n / h with |n| <= ALIAS_RANGE per axis in the influence function
+    constexpr int ALIAS_RANGE = 2;
+
+    // Particles per task in the interpolation and short-range loop
+    constexpr size_t PARTICLE_CHUNK_SIZE = 64;
+
+    // erfc(x) e^(x²) for x >= 0 (Abramowitz & Stegun 7.1.26, error below 1.5e-7,
+    // far below the truncation at 1e-5): the pair kernel needs e^(-x²) anyway,
+    // so one exp serves both terms
+    double scaledErfc(double x) {
+        const double t = 1.0 / (1.0 + 0.3275911 * x);
+        return t * (0.254829592 + t * (-0.284496736 + t * (1.421413741 + t * (-1.453152027 + t * 1.061405429))));
+    }
+
+    double sinc(double x) {
+        return std::abs(x) < 1e-12 ? 1.0 : std::sin(x) / x;
+    }
+
+    int wrapIndex(int index, int count) {
+        index %= count;
+        return index < 0 ? index + count : index;
+    }
+}
+
+P3MSolver::P3MSolver()
+    : m_requestedMeshSize(0)
+    , m_meshSize(MIN_AUTO_MESH_SIZE)
+    , m_assignment(Assignment::TSC)
+    , m_requestedCutoff(0.0)
+    , m_prepared(false)
+    , m_cellSize(1.0)
+    , m_alpha(1.0)
+    , m_cutoff(1.0)
+{
+}
+
+void P3MSolver::setBox(const PeriodicBox& box) {
+    if (box != m_box) {
+        m_box = box;
+        m_prepared = false;
+    }
+}
+
+void P3MSolver::setMeshSize(int nodes) {
+    m_requestedMeshSize = nodes > 0
+        ? static_cast<int>(Fft::nextPowerOfTwo(static_cast<size_t>(std::min(std::max(nodes, 4), MAX_MESH_SIZE))))
+        : 0;
+}
+
+void P3MSolver::setAssignment(Assignment assignment) {
+    if (assignment != m_assignment) {
+        m_assignment = assignment;
+        m_prepared = false;
+    }
+}
+
+void P3MSolver::setCutoff(double cutoff) {
+    const double value = cutoff > 0.0 ? cutoff : 0.0;
+    if (value != m_requestedCutoff) {
+        m_requestedCutoff = value;
+        m_prepared = false;
+    }
+}
+
+double P3MSolver::getCutoff() const {
+    const glm::dvec3 cell = m_box.getSize() / static_cast<double>(m_meshSize);
+    const double automatic = AUTO_CUTOFF_CELLS * std::max(cell.x, std::max(cell.y, cell.z));
+    return std::min(m_requestedCutoff > 0.0 ? m_requestedCutoff : automatic, 0.5 * m_box.shortestSide());
+}
+
+double P3MSolver::getSplitting() const {
+    return CUTOFF_SPLITTING / getCutoff();
+}
+
+int P3MSolver::stencil(double u, double* weights) const {
+    if (m_assignment == Assignment::CIC) {
+        const double base = std::floor(u);
+        const double f = u - base;
+        weights[0] = 1.0 - f;
+        weights[1] = f;
+        return static_cast<int>(base);
+    }
+    const double nearest = std::floor(u + 0.5);
+    const double d = u - nearest;
+    weights[0] = 0.5 * (0.5 - d) * (0.5 - d);
+    weights[1] = 0.75 - d * d;
+    weights[2] = 0.5 * (0.5 + d) * (0.5 + d);
+    return static_cast<int>(nearest) - 1;
+}
+
+void P3MSolver::prepare(ThreadPool* pool) {
+    if (m_prepared) {
+        return;
+    }
+    const int n = m_meshSize;
+    const size_t nodes = static_cast<size_t>(n) * n * n;
+    m_cellSize = m_box.getSize() / static_cast<double>(n);
+    m_cutoff = getCutoff();
+    m_alpha = getSplitting();
+
+    // Per axis and wave index: aliased wave numbers and squared assignment
+    // transforms U², sinc^(2p) of k h / 2
+    const int aliases = 2 * ALIAS_RANGE + 1;
+    const int p = order();
+    std::vector<double> kAlias[3];
+    std::vector<double> u2Alias[3];
+    std::vector<double> u2Sum[3];
+    std::vector<double> kPrincipal[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        kAlias[axis].resize(static_cast<size_t>(n) * aliases);
+        u2Alias[axis].resize(static_cast<size_t>(n) * aliases);
+        u2Sum[axis].assign(n, 0.0);
+        kPrincipal[axis].resize(n);
+        for (int m = 0; m < n; ++m) {
+            const int signedIndex = m < n / 2 ? m : m - n;
+            kPrincipal[axis][m] = 2.0 * M_PI * signedIndex / m_box.getSize()[axis];
+            for (int a = 0; a < aliases; ++a) {
+                const double shifted = signedIndex + static_cast<double>(a - ALIAS_RANGE) * n;
+                const double u = std::pow(sinc(M_PI * shifted / n), 2 * p);
+                kAlias[axis][m * aliases + a] = 2.0 * M_PI * shifted / m_box.getSize()[axis];
+                u2Alias[axis][m * aliases + a] = u;
+                u2Sum[axis][m] += u;
+            }
+        }
+    }
+
+    // Optimal influence function for ik-differentiation (Hockney & Eastwood):
+    // G(k) = k · Σ_n U²(k_n) k_n R(k_n) / (|k|² (Σ_n U²(k_n))²), with the
+    // reference potential R(k) = 4π k exp(-k²/4α²) / k² of the long-range part
+    m_influence.assign(nodes, 0.0);
+    const double coefficient = 4.0 * M_PI * PhysicsConstants::k / static_cast<double>(nodes);
+    const double inverseFourAlpha2 = 1.0 / (4.0 * m_alpha * m_alpha);
+    auto planes = [&](size_t begin, size_t end, size_t) {
+        for (size_t mz = begin; mz < end; ++mz) {
+            for (int my = 0; my < n; ++my) {
+                for (int mx = 0; mx < n; ++mx) {
+                    const glm::dvec3 k(kPrincipal[0][mx], kPrincipal[1][my], kPrincipal[2][mz]);
+                    const double k2 = glm::dot(k, k);
+                    if (k2 == 0.0) {
+                        continue;  // Mean field: neutralizing background
+                    }
+                    double numerator = 0.0;
+                    for (int az = 0; az < aliases; ++az) {
+                        const double kz = kAlias[2][mz * aliases + az];
+                        const double uz = u2Alias[2][mz * aliases + az];
+                        for (int ay = 0; ay < aliases; ++ay) {
+                            const double ky = kAlias[1][my * aliases + ay];
+                            const double uyz = uz * u2Alias[1][my * aliases + ay];
+                            for (int ax = 0; ax < aliases; ++ax) {
+                                const double kx = kAlias[0][mx * aliases + ax];
+                                const double u = uyz * u2Alias[0][mx * aliases + ax];
+                                const double kn2 = kx * kx + ky * ky + kz * kz;
+                                if (u < 1e-30 || kn2 == 0.0) {
+                                    continue;
+                                }
+                                numerator += u * (k.x * kx + k.y * ky + k.z * kz) *
+                                             std::exp(-kn2 * inverseFourAlpha2) / kn2;
+                            }
+                        }
+                    }
+                    const double sum = u2Sum[0][mx] * u2Sum[1][my] * u2Sum[2][mz];
+                    m_influence[meshIndex(mx, my, static_cast<int>(mz))] = coefficient * numerator / (k2 * sum * sum);
+                }
+            }
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, static_cast<size_t>(n), planes);
+    } else {
+        planes(0, static_cast<size_t>(n), 0);
+    }
+    m_prepared = true;
+}
+
+void P3MSolver::computeFields(const ParticleStore& store, ThreadPool* pool) {
+    const size_t count = store.size();
+    m_fields.assign(count, glm::dvec3(0.0));
+    if (count == 0 || !m_box.isValid()) {
+        return;
+    }
+
+    int meshSize = m_requestedMeshSize;
+    if (meshSize == 0) {
+        const double nodes = std::cbrt(static_cast<double>(AUTO_NODES_PER_PARTICLE) * static_cast<double>(count));
+        meshSize = static_cast<int>(Fft::nextPowerOfTwo(static_cast<size_t>(std::ceil(nodes))));
+        meshSize = std::clamp(meshSize, MIN_AUTO_MESH_SIZE, MAX_MESH_SIZE);
+    }
+    if (meshSize != m_meshSize) {
+        m_meshSize = meshSize;
+        m_prepared = false;
+    }
+    prepare(pool);
+
+    const int n = m_meshSize;
+    const size_t nodes = static_cast<size_t>(n) * n * n;
+    const glm::ivec3 counts(n);
+    const glm::dvec3 low = m_box.getLow();
+    const double inverseCellVolume = 1.0 / (m_cellSize.x * m_cellSize.y * m_cellSize.z);
+    const int p = order();
+
+    // Wrapped positions come first in the image list, which also serves the
+    // short-range search below
+    m_box.buildImages(store, m_cutoff, m_images);
+
+    // Charge density on the mesh (scattered serially: stencils of nearby
+    // particles overlap)
+    m_density.assign(nodes, Complex(0.0, 0.0));
+    for (size_t i = 0; i < count; ++i) {
+        double w[3][3];
+        int first[3];
+        const glm::dvec3 u = (glm::dvec3(m_images.x[i], m_images.y[i], m_images.z[i]) - low) / m_cellSize;
+        for (int axis = 0; axis < 3; ++axis) {
+            first[axis] = stencil(u[axis], w[axis]);
+        }
+        const double density = store.q[i] * inverseCellVolume;
+        for (int c = 0; c < p; ++c) {
+            const int z = wrapIndex(first[2] + c, n);
+            for (int b = 0; b < p; ++b) {
+                const int y = wrapIndex(first[1] + b, n);
+                const double wyz = density * w[2][c] * w[1][b];
+                for (int a = 0; a < p; ++a) {
+                    m_density[meshIndex(wrapIndex(first[0] + a, n), y, z)] += wyz * w[0][a];
+                }
+            }
+        }
+    }
+    Fft::transform3d(m_density.data(), counts, false, pool);
+
+    // E_d = IFFT(-i k_d G ρ̂); the Nyquist wave number has no sign, so its
+    // derivative is dropped to keep the field real
+    m_work.resize(nodes);
+    for (int axis = 0; axis < 3; ++axis) {
+        const double length = m_box.getSize()[axis];
+        for (size_t index = 0; index < nodes; ++index) {
+            const int m = axis == 0 ? static_cast<int>(index % n)
+                        : axis == 1 ? static_cast<int>((index / n) % n)
+                                    : static_cast<int>(index / (static_cast<size_t>(n) * n));
+            const int signedIndex = m < n / 2 ? m : m - n;
+            const double k = signedIndex == -n / 2 ? 0.0 : 2.0 * M_PI * signedIndex / length;
+            const double scale = k * m_influence[index];
+            const Complex rho = m_density[index];
+            m_work[index] = Complex(scale * rho.imag(), -scale * rho.real());
+        }
+        Fft::transform3d(m_work.data(), counts, true, pool);
+        m_meshFields[axis].resize(nodes);
+        for (size_t index = 0; index < nodes; ++index) {
+            m_meshFields[axis][index] = m_work[index].real();
+        }
+    }
+
+    // Interpolation with the assignment weights plus the short-range pairs
+    m_neighborGrid.build(m_images.x.data(), m_images.y.data(), m_images.z.data(), m_images.size(), m_cutoff);
+    const double alpha = m_alpha;
+    const double twoAlphaOverSqrtPi = 2.0 * alpha / std::sqrt(M_PI);
+    const double minDistance2 = PhysicsConstants::MIN_SAFE_DISTANCE * PhysicsConstants::MIN_SAFE_DISTANCE;
+    auto particles = [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::dvec3 position(m_images.x[i], m_images.y[i], m_images.z[i]);
+            double w[3][3];
+            int first[3];
+            const glm::dvec3 u = (position - low) / m_cellSize;
+            for (int axis = 0; axis < 3; ++axis) {
+                first[axis] = stencil(u[axis], w[axis]);
+            }
+            glm::dvec3 field(0.0);
+            for (int c = 0; c < p; ++c) {
+                const int z = wrapIndex(first[2] + c, n);
+                for (int b = 0; b < p; ++b) {
+                    const int y = wrapIndex(first[1] + b, n);
+                    const double wyz = w[2][c] * w[1][b];
+                    for (int a = 0; a < p; ++a) {
+                        const size_t index = meshIndex(wrapIndex(first[0] + a, n), y, z);
+                        const double weight = wyz * w[0][a];
+                        field += weight * glm::dvec3(m_meshFields[0][index], m_meshFields[1][index],
+                                                     m_meshFields[2][index]);
+                    }
+                }
+            }
+
+            m_neighborGrid.forEachNeighbor(position, m_cutoff, [&](size_t j, double d2) {
+                if (j == i || d2 < minDistance2) {
+                    return;
+                }
+                const double r = std::sqrt(d2);
+                const double gaussian = std::exp(-alpha * alpha * d2);
+                const double radial = gaussian * (scaledErfc(alpha * r) / r + twoAlphaOverSqrtPi);
+                const double scale = PhysicsConstants::k * m_images.q[j] * radial / d2;
+                field += scale * (position - glm::dvec3(m_images.x[j], m_images.y[j], m_images.z[j]));
+            });
+            m_fields[i] = field;
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, count, particles, PARTICLE_CHUNK_SIZE);
+    } else {
+        particles(0, count, 0);
+    }
+}
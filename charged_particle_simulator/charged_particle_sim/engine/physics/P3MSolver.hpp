@@ -0,0 +1,136 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <complex>
+#include <vector>
+#include "ParticleStore.hpp"
+#include "PeriodicBox.hpp"
+#include "NeighborGrid.hpp"
+#include "engine/core/ThreadPool.hpp"
+
+/**
+ * Particle-Particle Particle-Mesh (P3M) Solver
+ *
+ * Coulomb field at every particle of a periodic box, including all periodic
+ * images, in O(N + M log M) for a mesh of M nodes. The interaction is split with
+ * a Gaussian of width 1/α (Ewald splitting):
+ * - long range, smooth: charges are assigned to the mesh (CIC or TSC), the
+ *   Poisson equation is solved with FFTs using the Hockney–Eastwood optimal
+ *   influence function for ik-differentiation, and the field is interpolated
+ *   back to the particles with the same assignment weights
+ * - short range: k q erfc(αr)/r² terms between particles closer than the cutoff
+ *   r_c, found with a NeighborGrid over the particles and their images near the
+ *   box faces (PeriodicBox::buildImages)
+ *
+ * α is chosen so that erfc(α r_c) ≈ 1e-5; the default cutoff is AUTO_CUTOFF_CELLS
+ * mesh cells (at most half the shortest box side), which keeps the rms field
+ * error near 1e-3 with TSC. Longer cutoffs move work from the mesh to the pair
+ * sum and lower the error further. The mean field is zero, as if a uniform
+ * background neutralized any net charge. The mesh part conserves momentum only
+ * approximately (small self-forces of order the mesh error).
+ *
+ * Mesh sizes are powers of two (self-contained radix-2 Fft). By default the mesh
+ * follows the particle count, about AUTO_NODES_PER_PARTICLE nodes per particle,
+ * so the pairs within the cutoff stay O(1) per particle and the cost O(N log N).
+ * The influence function is recomputed only when the box or the mesh changes.
+ */
+class P3MSolver {
+public:
+    /**
+     * Charge assignment: cloud-in-cell (8 nodes, linear) or triangular-shaped
+     * cloud (27 nodes, quadratic; smoother, lower aliasing error)
+     */
+    enum class Assignment {
+        CIC,
+        TSC
+    };
+
+    static constexpr int MAX_MESH_SIZE = 512;
+    static constexpr int MIN_AUTO_MESH_SIZE = 16;
+    static constexpr int AUTO_NODES_PER_PARTICLE = 8;
+    static constexpr double AUTO_CUTOFF_CELLS = 8.0;
+
+    P3MSolver();
+
+    void setBox(const PeriodicBox& box);
+    const PeriodicBox& getBox() const { return m_box; }
+
+    /**
+     * Mesh nodes per axis (rounded up to a power of two, 4 to MAX_MESH_SIZE;
+     * 0 = automatic from the particle count, the default)
+     */
+    void setMeshSize(int nodes);
+    int getMeshSize() const { return m_requestedMeshSize; }
+
+    /**
+     * Mesh nodes per axis of the last computeFields()
+     */
+    int getMeshNodes() const { return m_meshSize; }
+
+    void setAssignment(Assignment assignment);
+    Assignment getAssignment() const { return m_assignment; }
+
+    /**
+     * Short-range cutoff in meters (0 = automatic, the default); clamped to half
+     * the shortest box side
+     */
+    void setCutoff(double cutoff);
+    double getRequestedCutoff() const { return m_requestedCutoff; }
+
+    /**
+     * Effective cutoff and splitting parameter α (1/m) for the current box and mesh
+     */
+    double getCutoff() const;
+    double getSplitting() const;
+
+    /**
+     * Compute the field at every particle (positions outside the box are wrapped)
+     * Results are available through getFields() in particle order.
+     *
+     * @param pool Optional thread pool for the FFTs and the per-particle loops
+     */
+    void computeFields(const ParticleStore& store, ThreadPool* pool = nullptr);
+
+    const std::vector<glm::dvec3>& getFields() const { return m_fields; }
+
+private:
+    using Complex = std::complex<double>;
+
+    /**
+     * Assignment stencil of a coordinate in mesh units: first node and the
+     * weights of the order nodes from it
+     */
+    int stencil(double u, double* weights) const;
+    int order() const { return m_assignment == Assignment::CIC ? 2 : 3; }
+
+    /**
+     * Recompute the influence function if the box or a setting changed
+     */
+    void prepare(ThreadPool* pool);
+
+    size_t meshIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * m_meshSize + static_cast<size_t>(y)) * m_meshSize + static_cast<size_t>(x);
+    }
+
+    // Settings
+    PeriodicBox m_box;
+    int m_requestedMeshSize;       // 0 = automatic
+    int m_meshSize;                // In use
+    Assignment m_assignment;
+    double m_requestedCutoff;
+    bool m_prepared;               // Influence function matches the settings
+
+    // Derived from the settings
+    glm::dvec3 m_cellSize;
+    double m_alpha;
+    double m_cutoff;
+    std::vector<double> m_influence;        // [meshIndex]: optimal G(k), including 1/M³
+
+    // Per-evaluation state
+    std::vector<Complex> m_density;         // Charge density, then its transform
+    std::vector<Complex> m_work;            // One field component in k-space
+    std::vector<double> m_meshFields[3];    // Field components at the nodes
+    PeriodicBox::Images m_images;
+    NeighborGrid m_neighborGrid;
+    std::vector<glm::dvec3> m_fields;
+};
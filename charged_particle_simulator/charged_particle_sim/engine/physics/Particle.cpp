@@ -83,21 +83,23 @@ void Particle::updateColorFromCharge() {
     }
 }
 
+void Particle::copyStateFrom(const Particle& source) {
+    position = source.position;
+    velocity = source.velocity;
+    acceleration = source.acceleration;
+    charge = source.charge;
+    mass = source.mass;
+    visualRadius = source.visualRadius;
+    color = source.color;
+    isBeingDragged = source.isBeingDragged;
+    isFixed = source.isFixed;
+}
+
 void Particle::recordHistory(double timestamp) {
-    HistoryPoint point;
-    point.position = position;
-    point.velocity = velocity;
-    point.timestamp = timestamp;
-    
-    history.push_back(point);
-    
-    // Maintain maximum history size
-    if (history.size() > MAX_HISTORY) {
-        history.pop_front();
-    }
+    // Oldest sample is overwritten once the buffer is full
+    history.record(timestamp, position, velocity);
 }
 
 void Particle::clearHistory() {
     history.clear();
 }
-
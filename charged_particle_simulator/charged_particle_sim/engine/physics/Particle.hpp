@@ -3,7 +3,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "engine/core/Constants.hpp"
-#include <deque>
+#include "ParticleHistory.hpp"
 #include <chrono>
 
 /**
@@ -35,14 +35,11 @@ struct Particle {
     bool isBeingDragged;      // True when particle is being dragged by user
     bool isFixed;             // True if particle is immovable (anchor)
     
+    // (New state fields must also be copied in copyStateFrom())
+    
     // === History (for retarded potentials - Phase 5) ===
-    struct HistoryPoint {
-        glm::dvec3 position;
-        glm::dvec3 velocity;
-        double timestamp;
-    };
-    std::deque<HistoryPoint> history;  // Ring buffer for time-delayed lookups
-    static constexpr size_t MAX_HISTORY = 10000;
+    ParticleHistory history;  // Ring buffer for time-delayed lookups (allocated on first record)
+    static constexpr size_t MAX_HISTORY = ParticleHistory::DEFAULT_CAPACITY;
     
     // === Factory Methods ===
     
@@ -78,6 +75,12 @@ struct Particle {
      */
     void updateColorFromCharge();
     
+    /**
+     * Copy every field except the history (snapshots for rendering and field lines)
+     * History already held by this particle is kept.
+     */
+    void copyStateFrom(const Particle& source);
+    
     /**
      * Record current state to history buffer
      */
@@ -0,0 +1,176 @@
+#include "ParticleHistory.hpp"
+#include <algorithm>
+#include <cmath>
+
+ParticleHistory::ParticleHistory(size_t capacity)
+    : m_capacity(std::max<size_t>(1, capacity))
+    , m_head(0)
+    , m_size(0)
+{
+}
+
+void ParticleHistory::setCapacity(size_t capacity) {
+    capacity = std::max<size_t>(1, capacity);
+    if (capacity != m_capacity) {
+        // Reallocated lazily on the next record()
+        m_capacity = capacity;
+        m_t.clear();
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+        m_vx.clear();
+        m_vy.clear();
+        m_vz.clear();
+        m_t.shrink_to_fit();
+        m_x.shrink_to_fit();
+        m_y.shrink_to_fit();
+        m_z.shrink_to_fit();
+        m_vx.shrink_to_fit();
+        m_vy.shrink_to_fit();
+        m_vz.shrink_to_fit();
+    }
+    clear();
+}
+
+void ParticleHistory::clear() {
+    m_head = 0;
+    m_size = 0;
+}
+
+void ParticleHistory::record(double timestamp, const glm::dvec3& position, const glm::dvec3& velocity) {
+    if (m_t.size() != m_capacity) {
+        m_t.resize(m_capacity);
+        m_x.resize(m_capacity);
+        m_y.resize(m_capacity);
+        m_z.resize(m_capacity);
+        m_vx.resize(m_capacity);
+        m_vy.resize(m_capacity);
+        m_vz.resize(m_capacity);
+    }
+
+    size_t s;
+    if (m_size < m_capacity) {
+        s = slot(m_size);
+        ++m_size;
+    } else {
+        // Full: overwrite the oldest sample
+        s = m_head;
+        m_head = slot(1);
+    }
+
+    m_t[s] = timestamp;
+    m_x[s] = position.x;
+    m_y[s] = position.y;
+    m_z[s] = position.z;
+    m_vx[s] = velocity.x;
+    m_vy[s] = velocity.y;
+    m_vz[s] = velocity.z;
+}
+
+glm::dvec3 ParticleHistory::position(size_t index) const {
+    size_t s = slot(index);
+    return glm::dvec3(m_x[s], m_y[s], m_z[s]);
+}
+
+glm::dvec3 ParticleHistory::velocity(size_t index) const {
+    size_t s = slot(index);
+    return glm::dvec3(m_vx[s], m_vy[s], m_vz[s]);
+}
+
+ParticleHistory::Sample ParticleHistory::operator[](size_t index) const {
+    Sample sample;
+    sample.position = position(index);
+    sample.velocity = velocity(index);
+    sample.timestamp = timestamp(index);
+    return sample;
+}
+
+size_t ParticleHistory::findInterval(double time) const {
+    if (m_size == 0 || time < oldestTime()) {
+        return m_size;
+    }
+    const size_t last = m_size - 1;
+    if (time >= newestTime()) {
+        return last;
+    }
+
+    // Invariant: timestamp(low) <= time < timestamp(high)
+    size_t low = 0;
+    size_t high = last;
+
+    // Interpolation probe: lands on the right interval when dt is uniform
+    double span = newestTime() - oldestTime();
+    if (span > 0.0) {
+        double guess = (time - oldestTime()) / span * static_cast<double>(last);
+        size_t probe = std::min(static_cast<size_t>(guess), last - 1);
+        if (timestamp(probe) <= time) {
+            if (time < timestamp(probe + 1)) {
+                return probe;
+            }
+            low = probe + 1;
+        } else {
+            high = probe;
+        }
+    }
+
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (timestamp(mid) <= time) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool ParticleHistory::sample(double time, glm::dvec3& position, glm::dvec3& velocity) const {
+    if (m_size == 0) {
+        return false;
+    }
+
+    size_t i = findInterval(time);
+    if (i == m_size) {
+        // Before the oldest sample: clamp
+        position = this->position(0);
+        velocity = this->velocity(0);
+        return true;
+    }
+    double t0 = timestamp(i);
+    if (i == m_size - 1 || time == t0) {
+        position = this->position(i);
+        velocity = this->velocity(i);
+        return true;
+    }
+
+    double t1 = timestamp(i + 1);
+    double h = t1 - t0;
+    if (!(h > 0.0)) {
+        position = this->position(i);
+        velocity = this->velocity(i);
+        return true;
+    }
+
+    // Cubic Hermite on [t0, t1] with p' = v at both ends
+    glm::dvec3 p0 = this->position(i);
+    glm::dvec3 p1 = this->position(i + 1);
+    glm::dvec3 m0 = this->velocity(i) * h;
+    glm::dvec3 m1 = this->velocity(i + 1) * h;
+    double s = (time - t0) / h;
+    double s2 = s * s;
+    double s3 = s2 * s;
+
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    double h10 = s3 - 2.0 * s2 + s;
+    double h01 = -2.0 * s3 + 3.0 * s2;
+    double h11 = s3 - s2;
+    position = h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1;
+
+    // d/dt of the same cubic
+    double d00 = 6.0 * s2 - 6.0 * s;
+    double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = -6.0 * s2 + 6.0 * s;
+    double d11 = 3.0 * s2 - 2.0 * s;
+    velocity = (d00 * p0 + d10 * m0 + d01 * p1 + d11 * m1) / h;
+    return true;
+}
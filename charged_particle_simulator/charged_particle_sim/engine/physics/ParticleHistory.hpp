@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Particle History (fixed-capacity ring buffer)
+ *
+ * Past positions and velocities of one particle for retarded-time lookups.
+ * Timestamps, positions and velocities live in separate arrays, so a search over
+ * timestamps touches only the timestamp array.
+ *
+ * The arrays are allocated once, at full capacity, on the first record(); after
+ * that recording never allocates and overwrites the oldest sample when full.
+ * A history that was never recorded to costs no memory, so particles without
+ * history stay cheap to copy.
+ *
+ * Samples must be recorded in non-decreasing time order. Index 0 is the oldest
+ * retained sample.
+ */
+class ParticleHistory {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 10000;
+
+    struct Sample {
+        glm::dvec3 position;
+        glm::dvec3 velocity;
+        double timestamp;
+    };
+
+    explicit ParticleHistory(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Change the capacity (discards all samples)
+     */
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return m_capacity; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * Remove all samples (keeps the allocation)
+     */
+    void clear();
+
+    /**
+     * Append a sample, overwriting the oldest one when full
+     */
+    void record(double timestamp, const glm::dvec3& position, const glm::dvec3& velocity);
+
+    /**
+     * Sample by age order (0 = oldest, size() - 1 = newest)
+     */
+    double timestamp(size_t index) const { return m_t[slot(index)]; }
+    glm::dvec3 position(size_t index) const;
+    glm::dvec3 velocity(size_t index) const;
+    Sample operator[](size_t index) const;
+
+    double oldestTime() const { return timestamp(0); }
+    double newestTime() const { return timestamp(m_size - 1); }
+
+    /**
+     * Index of the last sample with timestamp <= time
+     *
+     * Starts with one interpolation-search probe (exact for uniform time steps)
+     * and falls back to binary search, so the cost is O(1) for uniform spacing
+     * and O(log n) otherwise.
+     *
+     * @return Index in [0, size() - 1], or size() if time < oldestTime() or empty
+     */
+    size_t findInterval(double time) const;
+
+    /**
+     * Interpolated state at a past time
+     *
+     * Cubic Hermite interpolation between the bracketing samples, using their
+     * velocities as end-point derivatives; the velocity is the derivative of the
+     * same cubic. Times outside the recorded range are clamped to the oldest or
+     * newest sample.
+     *
+     * @return false if the history is empty (position/velocity unchanged)
+     */
+    bool sample(double time, glm::dvec3& position, glm::dvec3& velocity) const;
+
+private:
+    size_t slot(size_t index) const {
+        size_t s = m_head + index;
+        return s >= m_capacity ? s - m_capacity : s;
+    }
+
+    size_t m_capacity;
+    size_t m_head;     // Slot of the oldest sample
+    size_t m_size;
+    std::vector<double> m_t;
+    std::vector<double> m_x, m_y, m_z;
+    std::vector<double> m_vx, m_vy, m_vz;
+};
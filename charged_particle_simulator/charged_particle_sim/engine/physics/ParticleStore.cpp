@@ -0,0 +1,65 @@
+#include "ParticleStore.hpp"
+
+void ParticleStore::resize(size_t count) {
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    vx.resize(count);
+    vy.resize(count);
+    vz.resize(count);
+    ax.resize(count);
+    ay.resize(count);
+    az.resize(count);
+    q.resize(count);
+    m.resize(count);
+    flags.resize(count);
+}
+
+void ParticleStore::loadFrom(const std::vector<Particle>& particles) {
+    if (particles.size() != size()) {
+        resize(particles.size());
+    }
+    
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Particle& p = particles[i];
+        x[i] = p.position.x;
+        y[i] = p.position.y;
+        z[i] = p.position.z;
+        vx[i] = p.velocity.x;
+        vy[i] = p.velocity.y;
+        vz[i] = p.velocity.z;
+        ax[i] = p.acceleration.x;
+        ay[i] = p.acceleration.y;
+        az[i] = p.acceleration.z;
+        q[i] = p.charge;
+        m[i] = p.mass;
+        flags[i] = static_cast<uint8_t>((p.isFixed ? FLAG_FIXED : 0) |
+                                        (p.isBeingDragged ? FLAG_DRAGGED : 0));
+    }
+}
+
+void ParticleStore::storeKinematics(std::vector<Particle>& particles) const {
+    for (size_t i = 0; i < particles.size() && i < size(); ++i) {
+        Particle& p = particles[i];
+        p.position = glm::dvec3(x[i], y[i], z[i]);
+        p.velocity = glm::dvec3(vx[i], vy[i], vz[i]);
+        p.acceleration = glm::dvec3(ax[i], ay[i], az[i]);
+    }
+}
+
+bool ParticleStore::matches(const std::vector<Particle>& particles) const {
+    if (particles.size() != size()) {
+        return false;
+    }
+    for (size_t i = 0; i < particles.size(); ++i) {
+        const Particle& p = particles[i];
+        uint8_t particleFlags = static_cast<uint8_t>((p.isFixed ? FLAG_FIXED : 0) |
+                                                     (p.isBeingDragged ? FLAG_DRAGGED : 0));
+        if (x[i] != p.position.x || y[i] != p.position.y || z[i] != p.position.z ||
+            vx[i] != p.velocity.x || vy[i] != p.velocity.y || vz[i] != p.velocity.z ||
+            q[i] != p.charge || m[i] != p.mass || flags[i] != particleFlags) {
+            return false;
+        }
+    }
+    return true;
+}
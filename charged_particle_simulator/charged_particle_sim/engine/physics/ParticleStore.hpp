@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Particle.hpp"
+#include "engine/core/AlignedAllocator.hpp"
+
+/**
+ * Particle Store (structure of arrays)
+ * 
+ * Physics-only particle data in separate contiguous, 64-byte aligned arrays
+ * so the force and integration loops stream just the fields they use.
+ * 
+ * The std::vector<Particle> owned by ParticleSystem remains the AoS view used by
+ * rendering and interaction (ParticleRenderer, ParticlePicker, DragController).
+ * The two are synchronized at step boundaries via loadFrom() / storeKinematics().
+ */
+struct ParticleStore {
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, 64>>;
+    
+    // State flag bits
+    enum Flag : uint8_t {
+        FLAG_FIXED = 1 << 0,     // Particle is immovable (anchor)
+        FLAG_DRAGGED = 1 << 1    // Particle is being dragged by user
+    };
+    
+    // === Physical Properties (SI Units) ===
+    AlignedVector<double> x, y, z;       // Position in meters
+    AlignedVector<double> vx, vy, vz;    // Velocity in m/s
+    AlignedVector<double> ax, ay, az;    // Acceleration in m/s²
+    AlignedVector<double> q;             // Charge in coulombs
+    AlignedVector<double> m;             // Mass in kilograms
+    AlignedVector<uint8_t> flags;        // Flag bits
+    
+    /**
+     * Get particle count
+     */
+    size_t size() const { return x.size(); }
+    
+    /**
+     * Resize all arrays
+     */
+    void resize(size_t count);
+    
+    /**
+     * Copy physical properties and flags from AoS particles (resizes if needed)
+     */
+    void loadFrom(const std::vector<Particle>& particles);
+    
+    /**
+     * Copy positions, velocities and accelerations back to AoS particles
+     */
+    void storeKinematics(std::vector<Particle>& particles) const;
+    
+    /**
+     * True if positions, velocities, charges, masses and flags equal the particles'
+     * (bitwise), i.e. nothing was edited since the last storeKinematics()
+     */
+    bool matches(const std::vector<Particle>& particles) const;
+    
+    /**
+     * True if the particle is integrated (not fixed or dragged)
+     */
+    bool isMovable(size_t i) const { return flags[i] == 0; }
+    
+    glm::dvec3 position(size_t i) const { return glm::dvec3(x[i], y[i], z[i]); }
+    glm::dvec3 velocity(size_t i) const { return glm::dvec3(vx[i], vy[i], vz[i]); }
+    glm::dvec3 acceleration(size_t i) const { return glm::dvec3(ax[i], ay[i], az[i]); }
+    
+    void setPosition(size_t i, const glm::dvec3& p) { x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+    void setVelocity(size_t i, const glm::dvec3& v) { vx[i] = v.x; vy[i] = v.y; vz[i] = v.z; }
+    void setAcceleration(size_t i, const glm::dvec3& a) { ax[i] = a.x; ay[i] = a.y; az[i] = a.z; }
+};
@@ -0,0 +1,104 @@
+#include "PeriodicBox.hpp"
+#include <algorithm>
+#include <cmath>
+
+PeriodicBox::PeriodicBox()
+    : m_low(0.0)
+    , m_size(1.0)
+{
+}
+
+PeriodicBox::PeriodicBox(const glm::dvec3& low, const glm::dvec3& high)
+    : m_low(glm::min(low, high))
+    , m_size(glm::abs(high - low))
+{
+}
+
+double PeriodicBox::shortestSide() const {
+    return std::min(m_size.x, std::min(m_size.y, m_size.z));
+}
+
+bool PeriodicBox::isValid() const {
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(m_size[axis] > 0.0) || !std::isfinite(m_size[axis]) || !std::isfinite(m_low[axis])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+glm::dvec3 PeriodicBox::wrap(const glm::dvec3& position) const {
+    glm::dvec3 wrapped = position;
+    for (int axis = 0; axis < 3; ++axis) {
+        // Inside already: keep the value bit for bit
+        if (position[axis] >= m_low[axis] && position[axis] - m_low[axis] < m_size[axis]) {
+            continue;
+        }
+        double offset = position[axis] - m_low[axis];
+        offset -= m_size[axis] * std::floor(offset / m_size[axis]);
+        wrapped[axis] = m_low[axis] + offset;
+        // Rounding can land a tiny negative offset exactly on the upper face
+        if (!(offset < m_size[axis]) || !(wrapped[axis] - m_low[axis] < m_size[axis])) {
+            wrapped[axis] = m_low[axis];
+        }
+    }
+    return wrapped;
+}
+
+glm::dvec3 PeriodicBox::minimumImage(const glm::dvec3& separation) const {
+    glm::dvec3 image;
+    for (int axis = 0; axis < 3; ++axis) {
+        image[axis] = separation[axis] - m_size[axis] * std::round(separation[axis] / m_size[axis]);
+    }
+    return image;
+}
+
+void PeriodicBox::buildImages(const ParticleStore& store, double margin, Images& images) const {
+    const size_t count = store.size();
+    images.x.resize(count);
+    images.y.resize(count);
+    images.z.resize(count);
+    images.q.resize(count);
+    images.source.resize(count);
+    images.primaryCount = count;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::dvec3 p = wrap(store.position(i));
+        images.x[i] = p.x;
+        images.y[i] = p.y;
+        images.z[i] = p.z;
+        images.q[i] = store.q[i];
+        images.source[i] = static_cast<uint32_t>(i);
+    }
+
+    // Particles within the margin of a face reappear beyond the opposite face;
+    // near an edge or corner also across the neighbouring faces (up to 7 images)
+    const glm::dvec3 high = getHigh();
+    for (size_t i = 0; i < count; ++i) {
+        const glm::dvec3 p(images.x[i], images.y[i], images.z[i]);
+        double shifts[3][2];
+        int shiftCount[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            shiftCount[axis] = 1;
+            shifts[axis][0] = 0.0;
+            if (p[axis] < m_low[axis] + margin) {
+                shifts[axis][shiftCount[axis]++] = m_size[axis];
+            } else if (p[axis] >= high[axis] - margin) {
+                shifts[axis][shiftCount[axis]++] = -m_size[axis];
+            }
+        }
+        for (int sx = 0; sx < shiftCount[0]; ++sx) {
+            for (int sy = 0; sy < shiftCount[1]; ++sy) {
+                for (int sz = 0; sz < shiftCount[2]; ++sz) {
+                    if (sx == 0 && sy == 0 && sz == 0) {
+                        continue;
+                    }
+                    images.x.push_back(p.x + shifts[0][sx]);
+                    images.y.push_back(p.y + shifts[1][sy]);
+                    images.z.push_back(p.z + shifts[2][sz]);
+                    images.q.push_back(store.q[i]);
+                    images.source.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "ParticleStore.hpp"
+
+/**
+ * Periodic Box
+ *
+ * Rectangular cell [low, high) repeated along all three axes: a particle leaving
+ * through one face enters through the opposite one, and every particle interacts
+ * with all periodic images of the others (P3MSolver).
+ *
+ * Short-range searches across the faces use explicit images: buildImages() lists
+ * the wrapped particles followed by copies of those within a margin of a face,
+ * shifted by the box size, so a NeighborGrid over the list finds every pair
+ * closer than the margin, including pairs that straddle a face.
+ */
+class PeriodicBox {
+public:
+    /**
+     * Wrapped particles followed by their images near the faces
+     */
+    struct Images {
+        std::vector<double> x, y, z, q;
+        std::vector<uint32_t> source;  // [image]: original particle index
+        size_t primaryCount = 0;       // Entries [0, primaryCount) are the particles themselves, in order
+
+        size_t size() const { return x.size(); }
+    };
+
+    PeriodicBox();
+    PeriodicBox(const glm::dvec3& low, const glm::dvec3& high);
+
+    const glm::dvec3& getLow() const { return m_low; }
+    glm::dvec3 getHigh() const { return m_low + m_size; }
+    const glm::dvec3& getSize() const { return m_size; }
+    double volume() const { return m_size.x * m_size.y * m_size.z; }
+    double shortestSide() const;
+
+    /**
+     * True if every side is positive and finite
+     */
+    bool isValid() const;
+
+    /**
+     * Image of a position inside [low, high)
+     */
+    glm::dvec3 wrap(const glm::dvec3& position) const;
+
+    /**
+     * Shortest periodic image of a separation vector
+     */
+    glm::dvec3 minimumImage(const glm::dvec3& separation) const;
+
+    /**
+     * List wrapped particles and their images within margin of a face
+     *
+     * @param margin At most half the shortest side
+     */
+    void buildImages(const ParticleStore& store, double margin, Images& images) const;
+
+    bool operator==(const PeriodicBox& other) const { return m_low == other.m_low && m_size == other.m_size; }
+    bool operator!=(const PeriodicBox& other) const { return !(*this == other); }
+
+private:
+    glm::dvec3 m_low;
+    glm::dvec3 m_size;
+};
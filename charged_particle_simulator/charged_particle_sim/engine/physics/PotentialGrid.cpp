@@ -0,0 +1,223 @@
+#include "PotentialGrid.hpp"
+#include "CoulombKernel.hpp"
+#include <algorithm>
+#include <cmath>
+
+PotentialGrid::PotentialGrid()
+    : m_resolution(64)
+    , m_padding(0.5)
+    , m_fixedBounds(false)
+    , m_boundsLow(0.0)
+    , m_boundsHigh(0.0)
+    , m_method(Method::DIRECT)
+    , m_incrementalFraction(0.1)
+    , m_settingsChanged(false)
+    , m_built(false)
+    , m_incrementalUpdates(0)
+    , m_origin(0.0)
+    , m_cellSize(1.0)
+    , m_counts(0)
+{
+}
+
+void PotentialGrid::setResolution(int cells) {
+    m_resolution = std::max(cells, 2);
+    m_settingsChanged = true;
+}
+
+void PotentialGrid::setPadding(double fraction) {
+    m_padding = std::max(fraction, 0.0);
+    m_settingsChanged = true;
+}
+
+void PotentialGrid::setBounds(const glm::dvec3& low, const glm::dvec3& high) {
+    m_fixedBounds = true;
+    m_boundsLow = glm::min(low, high);
+    m_boundsHigh = glm::max(low, high);
+    m_settingsChanged = true;
+}
+
+void PotentialGrid::clearBounds() {
+    m_fixedBounds = false;
+    m_settingsChanged = true;
+}
+
+void PotentialGrid::setMethod(Method method) {
+    m_method = method;
+    m_settingsChanged = true;
+}
+
+void PotentialGrid::setIncrementalFraction(double fraction) {
+    m_incrementalFraction = std::clamp(fraction, 0.0, 1.0);
+}
+
+const PotentialGrid::UpdateStats& PotentialGrid::update(const std::vector<Particle>& particles, ThreadPool* pool) {
+    m_lastStats = UpdateStats();
+    bool full = !m_built || m_settingsChanged || particles.size() != m_store.size();
+
+    // Particles whose contribution differs from the one in the grid
+    std::vector<size_t> changed;
+    if (!full) {
+        for (size_t i = 0; i < particles.size(); ++i) {
+            if (particles[i].position != m_store.position(i) || particles[i].charge != m_store.q[i]) {
+                changed.push_back(i);
+            }
+        }
+        if (changed.empty()) {
+            m_lastStats.nodeCount = m_values.size();
+            return m_lastStats;
+        }
+        full = static_cast<double>(changed.size()) > m_incrementalFraction * static_cast<double>(particles.size()) ||
+               m_incrementalUpdates >= REFRESH_INTERVAL;
+    }
+
+    if (full) {
+        m_store.loadFrom(particles);
+        placeGrid();
+        evaluateFull(pool);
+        m_settingsChanged = false;
+        m_built = true;
+        m_incrementalUpdates = 0;
+        m_lastStats.fullEvaluation = true;
+    } else {
+        // Old contribution with negated charge, followed by the new one
+        ParticleStore delta;
+        delta.resize(2 * changed.size());
+        for (size_t n = 0; n < changed.size(); ++n) {
+            const size_t i = changed[n];
+            delta.setPosition(2 * n, m_store.position(i));
+            delta.q[2 * n] = -m_store.q[i];
+            delta.setPosition(2 * n + 1, particles[i].position);
+            delta.q[2 * n + 1] = particles[i].charge;
+            m_store.setPosition(i, particles[i].position);
+            m_store.q[i] = particles[i].charge;
+        }
+        addDirect(delta, pool);
+        ++m_incrementalUpdates;
+        m_lastStats.changedParticles = changed.size();
+    }
+
+    m_lastStats.nodeCount = m_values.size();
+    return m_lastStats;
+}
+
+void PotentialGrid::placeGrid() {
+    m_counts = glm::ivec3(0);
+    m_values.clear();
+
+    glm::dvec3 low = m_boundsLow;
+    glm::dvec3 high = m_boundsHigh;
+    double padding = 0.0;
+    if (!m_fixedBounds) {
+        if (m_store.size() == 0) {
+            return;
+        }
+        low = high = m_store.position(0);
+        for (size_t i = 1; i < m_store.size(); ++i) {
+            low = glm::min(low, m_store.position(i));
+            high = glm::max(high, m_store.position(i));
+        }
+    }
+    const glm::dvec3 size = high - low;
+    const double extent = std::max(size.x, std::max(size.y, size.z));
+
+    // Without extent there is no length scale (e.g. a single particle; use setBounds)
+    if (!(extent > 0.0) || !std::isfinite(extent)) {
+        return;
+    }
+    if (!m_fixedBounds) {
+        padding = m_padding * extent;
+    }
+
+    m_cellSize = (extent + 2.0 * padding) / m_resolution;
+    m_origin = low - glm::dvec3(padding);
+    for (int axis = 0; axis < 3; ++axis) {
+        m_counts[axis] = static_cast<int>(std::ceil((size[axis] + 2.0 * padding) / m_cellSize)) + 1;
+        m_counts[axis] = std::max(m_counts[axis], 2);
+    }
+    m_values.assign(static_cast<size_t>(m_counts.x) * m_counts.y * m_counts.z, 0.0);
+}
+
+glm::dvec3 PotentialGrid::nodePositionAt(size_t index) const {
+    const size_t x = index % static_cast<size_t>(m_counts.x);
+    const size_t rest = index / static_cast<size_t>(m_counts.x);
+    const size_t y = rest % static_cast<size_t>(m_counts.y);
+    const size_t z = rest / static_cast<size_t>(m_counts.y);
+    return m_origin + m_cellSize * glm::dvec3(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z));
+}
+
+void PotentialGrid::evaluateFull(ThreadPool* pool) {
+    if (m_values.empty()) {
+        return;
+    }
+
+    if (m_method == Method::DIRECT) {
+        addDirect(m_store, pool);
+        return;
+    }
+
+    // Tree traversal cost varies from node to node: hand out small ranges
+    if (m_method == Method::BARNES_HUT) {
+        m_tree.build(m_store);
+    } else {
+        m_fmm.build(m_store);
+    }
+    auto evaluate = [this](size_t begin, size_t end, size_t) {
+        for (size_t n = begin; n < end; ++n) {
+            const glm::dvec3 node = nodePositionAt(n);
+            m_values[n] = m_method == Method::BARNES_HUT ? m_tree.potentialAt(node) : m_fmm.potentialAt(node);
+        }
+    };
+    if (pool) {
+        pool->parallelForDynamic(0, m_values.size(), evaluate, 64);
+    } else {
+        evaluate(0, m_values.size(), 0);
+    }
+}
+
+void PotentialGrid::addDirect(const ParticleStore& sources, ThreadPool* pool) {
+    const size_t nodes = m_values.size();
+    const size_t count = sources.size();
+    if (nodes == 0 || count == 0) {
+        return;
+    }
+
+    const double* x = sources.x.data();
+    const double* y = sources.y.data();
+    const double* z = sources.z.data();
+    const double* q = sources.q.data();
+
+    // Each block of nodes meets the sources one tile at a time; tiles are summed in
+    // the same order for any thread count
+    const size_t blocks = (nodes + NODE_BLOCK - 1) / NODE_BLOCK;
+    auto sweepBlocks = [&](size_t begin, size_t end, size_t) {
+        glm::dvec3 points[NODE_BLOCK];
+        for (size_t block = begin; block < end; ++block) {
+            const size_t n0 = block * NODE_BLOCK;
+            const size_t n1 = std::min(n0 + NODE_BLOCK, nodes);
+            for (size_t n = n0; n < n1; ++n) {
+                points[n - n0] = nodePositionAt(n);
+            }
+            for (size_t t0 = 0; t0 < count; t0 += SOURCE_TILE) {
+                const size_t length = std::min(SOURCE_TILE, count - t0);
+                for (size_t n = n0; n < n1; ++n) {
+                    m_values[n] += CoulombKernel::potentialAt(points[n - n0], x + t0, y + t0, z + t0, q + t0, length);
+                }
+            }
+        }
+    };
+    if (pool) {
+        pool->parallelFor(0, blocks, sweepBlocks);
+    } else {
+        sweepBlocks(0, blocks, 0);
+    }
+}
+
+void PotentialGrid::extractEquipotential(double level, IsosurfaceMesh& mesh) const {
+    MarchingCubes::ScalarGrid grid;
+    grid.values = m_values.data();
+    grid.counts = m_values.empty() ? glm::ivec3(0) : m_counts;
+    grid.origin = m_origin;
+    grid.cellSize = m_cellSize;
+    MarchingCubes::extract(grid, level, mesh);
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Particle.hpp"
+#include "ParticleStore.hpp"
+#include "BarnesHutTree.hpp"
+#include "FmmSolver.hpp"
+#include "engine/core/ThreadPool.hpp"
+#include "engine/math/MarchingCubes.hpp"
+
+/**
+ * Potential Grid
+ *
+ * Electrostatic potential φ sampled on a uniform grid, for equipotential
+ * surfaces. The grid covers the particles' bounding box plus a padding margin
+ * with cubic cells, `resolution` cells along the longest side, or a fixed box
+ * set with setBounds().
+ *
+ * Full evaluations use one of:
+ * - DIRECT: exact sum, cache-blocked: each block of nodes is swept against one
+ *   L1-sized tile of sources at a time through the vectorized CoulombKernel
+ * - BARNES_HUT / FMM: multipole expansions of the tree (quadrupole) or FMM
+ *   solver (order p, more accurate but costlier per node), O(log N) per node;
+ *   nodes are handed out with work stealing
+ *
+ * update() compares the particles with those of the last evaluation. When only
+ * a few moved or changed charge (at most the incremental fraction), their old
+ * contributions are subtracted and the new ones added at every node, so
+ * dragging a charge costs O(nodes * moved) instead of a full evaluation. The
+ * grid box is kept during incremental updates; a full evaluation runs every
+ * REFRESH_INTERVAL incremental updates so rounding cannot accumulate.
+ *
+ * Equipotentials are extracted with MarchingCubes; their normals point toward
+ * higher potential, i.e. against E.
+ */
+class PotentialGrid {
+public:
+    enum class Method {
+        DIRECT,
+        BARNES_HUT,
+        FMM
+    };
+
+    struct UpdateStats {
+        bool fullEvaluation = false;   // True if every contribution was summed anew
+        size_t changedParticles = 0;   // Particles whose contribution was replaced (incremental)
+        size_t nodeCount = 0;
+    };
+
+    // Incremental updates between full evaluations
+    static constexpr int REFRESH_INTERVAL = 64;
+
+    PotentialGrid();
+
+    /**
+     * Cells along the longest side of the grid (at least 2)
+     */
+    void setResolution(int cells);
+    int getResolution() const { return m_resolution; }
+
+    /**
+     * Margin around the particles' bounding box, as a fraction of its longest side
+     */
+    void setPadding(double fraction);
+    double getPadding() const { return m_padding; }
+
+    /**
+     * Sample a fixed box instead of following the particles (resolution cells
+     * along its longest side)
+     */
+    void setBounds(const glm::dvec3& low, const glm::dvec3& high);
+
+    /**
+     * Follow the particles' bounding box again
+     */
+    void clearBounds();
+
+    void setMethod(Method method);
+    Method getMethod() const { return m_method; }
+
+    /**
+     * Largest fraction of particles that may change for an incremental update
+     * (0 = always evaluate fully)
+     */
+    void setIncrementalFraction(double fraction);
+    double getIncrementalFraction() const { return m_incrementalFraction; }
+
+    /**
+     * Access solver settings (opening angle, expansion order, leaf capacity);
+     * call invalidate() after changing them
+     */
+    BarnesHutTree& getTree() { return m_tree; }
+    FmmSolver& getFmm() { return m_fmm; }
+
+    /**
+     * Bring the grid up to date with the particles (full or incremental)
+     *
+     * @param particles Source particles (positions and charges are copied)
+     * @param pool Optional thread pool for the node loops
+     * @return Statistics of this update
+     */
+    const UpdateStats& update(const std::vector<Particle>& particles, ThreadPool* pool = nullptr);
+
+    /**
+     * Force a full evaluation on the next update()
+     */
+    void invalidate() { m_settingsChanged = true; }
+
+    /**
+     * Extract the equipotential surface φ = level (volts)
+     */
+    void extractEquipotential(double level, IsosurfaceMesh& mesh) const;
+
+    /**
+     * Potential at a node
+     */
+    double nodePotential(int x, int y, int z) const { return m_values[nodeIndex(x, y, z)]; }
+
+    /**
+     * Position of a node
+     */
+    glm::dvec3 nodePosition(int x, int y, int z) const { return m_origin + m_cellSize * glm::dvec3(x, y, z); }
+
+    bool isBuilt() const { return m_built; }
+    const std::vector<double>& getValues() const { return m_values; }
+    const glm::ivec3& getCounts() const { return m_counts; }
+    size_t getNodeCount() const { return m_values.size(); }
+    double getCellSize() const { return m_cellSize; }
+    const glm::dvec3& getOrigin() const { return m_origin; }
+    const UpdateStats& getLastUpdateStats() const { return m_lastStats; }
+
+private:
+    // Nodes per block and sources per tile of the direct sum: a tile's positions
+    // and charges (32 KB) stay in L1 while a block of nodes is swept against it
+    static constexpr size_t NODE_BLOCK = 256;
+    static constexpr size_t SOURCE_TILE = 1024;
+
+    size_t nodeIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * m_counts.y + static_cast<size_t>(y)) * m_counts.x + static_cast<size_t>(x);
+    }
+
+    glm::dvec3 nodePositionAt(size_t index) const;
+
+    /**
+     * Place the grid over the particles (or the fixed box)
+     */
+    void placeGrid();
+
+    /**
+     * Sum every contribution at every node with the current method
+     */
+    void evaluateFull(ThreadPool* pool);
+
+    /**
+     * Add the potential of the given sources to every node (direct, blocked)
+     */
+    void addDirect(const ParticleStore& sources, ThreadPool* pool);
+
+    // Settings
+    int m_resolution;
+    double m_padding;
+    bool m_fixedBounds;
+    glm::dvec3 m_boundsLow;
+    glm::dvec3 m_boundsHigh;
+    Method m_method;
+    double m_incrementalFraction;
+    bool m_settingsChanged;       // Settings differ from the last full evaluation
+
+    // Sources the grid currently represents
+    bool m_built;
+    ParticleStore m_store;
+    int m_incrementalUpdates;     // Since the last full evaluation
+
+    BarnesHutTree m_tree;
+    FmmSolver m_fmm;
+
+    // Grid
+    glm::dvec3 m_origin;          // Node (0, 0, 0)
+    double m_cellSize;
+    glm::ivec3 m_counts;          // Nodes per axis
+    std::vector<double> m_values; // [nodeIndex]: potential in volts
+
+    UpdateStats m_lastStats;
+};
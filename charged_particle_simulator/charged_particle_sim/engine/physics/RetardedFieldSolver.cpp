@@ -0,0 +1,340 @@
+#include "RetardedFieldSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include "engine/core/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Targets per dispatched range (each target loops over all sources)
+    constexpr size_t TARGET_CHUNK_SIZE = 8;
+}
+
+RetardedFieldSolver::RetardedFieldSolver()
+    : m_historyFrames(DEFAULT_HISTORY_FRAMES)
+    , m_tolerance(1e-9)
+    , m_maxIterations(16)
+    , m_oldestTime(0.0)
+    , m_newestTime(0.0)
+    , m_frameScale(0.0)
+    , m_meanIterations(0.0)
+{
+}
+
+void RetardedFieldSolver::setHistoryFrames(size_t frames) {
+    frames = std::max<size_t>(2, frames);
+    if (frames != m_historyFrames) {
+        m_historyFrames = frames;
+        m_history = History();
+        m_coefficients.clear();
+    }
+}
+
+void RetardedFieldSolver::clear() {
+    m_history.head = 0;
+    m_history.frames = 0;
+}
+
+void RetardedFieldSolver::setHistory(const History& history) {
+    const size_t values = history.capacity * history.particleCount;
+    if (history.t.size() != history.capacity || history.x.size() != values || history.y.size() != values ||
+        history.z.size() != values || history.vx.size() != values || history.vy.size() != values ||
+        history.vz.size() != values || history.frames > history.capacity ||
+        (history.capacity > 0 && history.head >= history.capacity)) {
+        LOG_WARN("Ignoring inconsistent retarded field history");
+        m_history = History();
+        m_coefficients.clear();
+        return;
+    }
+    m_history = history;
+    if (history.capacity >= 2) {
+        m_historyFrames = history.capacity;
+    }
+    m_coefficients.assign(values * 12, 0.0);
+    for (size_t frame = 0; frame + 1 < history.frames; ++frame) {
+        buildInterval(frame);
+    }
+}
+
+void RetardedFieldSolver::record(double time, const ParticleStore& store) {
+    const size_t count = store.size();
+    History& h = m_history;
+
+    if (h.capacity != m_historyFrames || h.particleCount != count) {
+        if (h.frames > 0 && h.particleCount != count) {
+            LOG_INFO("Particle count changed, retarded field history restarted");
+        }
+        // One allocation for the whole run: capacity frames of every particle
+        const size_t values = m_historyFrames * count;
+        h.capacity = m_historyFrames;
+        h.particleCount = count;
+        h.head = 0;
+        h.frames = 0;
+        h.t.assign(h.capacity, 0.0);
+        h.x.assign(values, 0.0);
+        h.y.assign(values, 0.0);
+        h.z.assign(values, 0.0);
+        h.vx.assign(values, 0.0);
+        h.vy.assign(values, 0.0);
+        h.vz.assign(values, 0.0);
+        m_coefficients.assign(values * 12, 0.0);
+    }
+
+    size_t s;
+    if (h.frames < h.capacity) {
+        s = slot(h.frames);
+        ++h.frames;
+    } else {
+        // Full: overwrite the oldest frame
+        s = h.head;
+        h.head = slot(1);
+    }
+
+    h.t[s] = time;
+    const size_t base = s * count;
+    std::copy(store.x.begin(), store.x.end(), h.x.begin() + base);
+    std::copy(store.y.begin(), store.y.end(), h.y.begin() + base);
+    std::copy(store.z.begin(), store.z.end(), h.z.begin() + base);
+    std::copy(store.vx.begin(), store.vx.end(), h.vx.begin() + base);
+    std::copy(store.vy.begin(), store.vy.end(), h.vy.begin() + base);
+    std::copy(store.vz.begin(), store.vz.end(), h.vz.begin() + base);
+
+    // Interpolant between the previous newest frame and this one
+    if (h.frames >= 2) {
+        buildInterval(h.frames - 2);
+    }
+}
+
+void RetardedFieldSolver::buildInterval(size_t frame) {
+    const History& h = m_history;
+    const size_t n = h.particleCount;
+    const size_t s0 = slot(frame);
+    const size_t s1 = slot(frame + 1);
+    const double step = h.t[s1] - h.t[s0];
+    const double invStep = step > 0.0 ? 1.0 / step : 0.0;
+    const double invStep2 = invStep * invStep;
+
+    const double* p0[3] = {&h.x[s0 * n], &h.y[s0 * n], &h.z[s0 * n]};
+    const double* p1[3] = {&h.x[s1 * n], &h.y[s1 * n], &h.z[s1 * n]};
+    const double* v0[3] = {&h.vx[s0 * n], &h.vy[s0 * n], &h.vz[s0 * n]};
+    const double* v1[3] = {&h.vx[s1 * n], &h.vy[s1 * n], &h.vz[s1 * n]};
+    double* out = &m_coefficients[s0 * n * 12];
+
+    // Hermite cubic in u = time - t0: p0 + v0 u + c2 u² + c3 u³
+    for (size_t j = 0; j < n; ++j) {
+        for (int axis = 0; axis < 3; ++axis) {
+            double dp = p1[axis][j] - p0[axis][j];
+            double a = v0[axis][j];
+            double b = v1[axis][j];
+            double* c = out + j * 12 + axis * 4;
+            c[0] = p0[axis][j];
+            c[1] = a;
+            c[2] = (3.0 * dp * invStep - 2.0 * a - b) * invStep;
+            c[3] = (-2.0 * dp * invStep + a + b) * invStep2;
+        }
+    }
+}
+
+long RetardedFieldSolver::findFrame(double time) const {
+    const History& h = m_history;
+    const long last = static_cast<long>(h.frames) - 1;
+    if (time < m_oldestTime) {
+        return -1;
+    }
+    if (time >= m_newestTime) {
+        return last;
+    }
+
+    // Invariant: t(low) <= time < t(high)
+    long low = 0;
+    long high = last;
+
+    // Interpolation probe: exact for uniform steps (the usual case)
+    long probe = std::min(static_cast<long>((time - m_oldestTime) * m_frameScale), last - 1);
+    if (h.t[slot(static_cast<size_t>(probe))] <= time) {
+        if (time < h.t[slot(static_cast<size_t>(probe + 1))]) {
+            return probe;
+        }
+        low = probe + 1;
+    } else {
+        high = probe;
+    }
+
+    while (high - low > 1) {
+        long mid = low + (high - low) / 2;
+        if (h.t[slot(static_cast<size_t>(mid))] <= time) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void RetardedFieldSolver::sourceState(
+    size_t source,
+    long frame,
+    double time,
+    glm::dvec3& pos,
+    glm::dvec3& vel
+) const {
+    const History& h = m_history;
+    const size_t n = h.particleCount;
+
+    if (frame < 0 || frame == static_cast<long>(h.frames) - 1) {
+        // Outside the recorded window: uniform motion from the nearest frame
+        size_t s = slot(frame < 0 ? 0 : static_cast<size_t>(frame));
+        size_t i = s * n + source;
+        vel = glm::dvec3(h.vx[i], h.vy[i], h.vz[i]);
+        pos = glm::dvec3(h.x[i], h.y[i], h.z[i]) + vel * (time - h.t[s]);
+        return;
+    }
+
+    const size_t s = slot(static_cast<size_t>(frame));
+    const double u = time - h.t[s];
+    const double* c = &m_coefficients[(s * n + source) * 12];
+    pos = glm::dvec3(((c[3] * u + c[2]) * u + c[1]) * u + c[0],
+                     ((c[7] * u + c[6]) * u + c[5]) * u + c[4],
+                     ((c[11] * u + c[10]) * u + c[9]) * u + c[8]);
+    vel = glm::dvec3((3.0 * c[3] * u + 2.0 * c[2]) * u + c[1],
+                     (3.0 * c[7] * u + 2.0 * c[6]) * u + c[5],
+                     (3.0 * c[11] * u + 2.0 * c[10]) * u + c[9]);
+}
+
+glm::dvec3 RetardedFieldSolver::sourceAcceleration(size_t source, long frame, double time) const {
+    const History& h = m_history;
+    if (frame < 0 || frame == static_cast<long>(h.frames) - 1) {
+        return glm::dvec3(0.0);
+    }
+    const size_t s = slot(static_cast<size_t>(frame));
+    const double u = time - h.t[s];
+    const double* c = &m_coefficients[(s * h.particleCount + source) * 12];
+    return glm::dvec3(6.0 * c[3] * u + 2.0 * c[2],
+                      6.0 * c[7] * u + 2.0 * c[6],
+                      6.0 * c[11] * u + 2.0 * c[10]);
+}
+
+void RetardedFieldSolver::lienardWiechert(
+    const glm::dvec3& evalPoint,
+    const glm::dvec3& sourcePos,
+    const glm::dvec3& sourceVel,
+    const glm::dvec3& sourceAcc,
+    double q,
+    glm::dvec3& E,
+    glm::dvec3& B
+) {
+    const double c = PhysicsConstants::c;
+    glm::dvec3 R = evalPoint - sourcePos;
+    double distance = glm::length(R);
+    if (distance < PhysicsConstants::MIN_SAFE_DISTANCE) {
+        E = glm::dvec3(0.0);
+        B = glm::dvec3(0.0);
+        return;
+    }
+
+    glm::dvec3 n = R / distance;
+    glm::dvec3 beta = sourceVel / c;
+    glm::dvec3 betaDot = sourceAcc / c;
+    double kappa = 1.0 - glm::dot(n, beta);
+    double invKappa3 = 1.0 / (kappa * kappa * kappa);
+    glm::dvec3 nMinusBeta = n - beta;
+
+    // Velocity (generalized Coulomb) term, ~1/R²
+    glm::dvec3 velocityTerm = nMinusBeta * ((1.0 - glm::dot(beta, beta)) * invKappa3 / (distance * distance));
+    // Acceleration (radiation) term, ~1/R
+    glm::dvec3 accelerationTerm = glm::cross(n, glm::cross(nMinusBeta, betaDot)) * (invKappa3 / (c * distance));
+
+    E = PhysicsConstants::k * q * (velocityTerm + accelerationTerm);
+    B = glm::cross(n, E) / c;
+}
+
+void RetardedFieldSolver::computeFields(const ParticleStore& store, double time, ThreadPool& pool) {
+    const size_t count = store.size();
+    m_electric.assign(count, glm::dvec3(0.0));
+    m_magnetic.assign(count, glm::dvec3(0.0));
+    m_iterations.assign(count, 0);
+    m_meanIterations = 0.0;
+    if (count == 0) {
+        return;
+    }
+    if (m_history.frames == 0 || m_history.particleCount != count) {
+        // Nothing recorded for these particles yet: the present state is all there is
+        record(time, store);
+    }
+
+    const History& h = m_history;
+    m_oldestTime = h.t[slot(0)];
+    m_newestTime = h.t[slot(h.frames - 1)];
+    m_frameScale = h.frames > 1 ? static_cast<double>(h.frames - 1) / (m_newestTime - m_oldestTime) : 0.0;
+
+    const double c = PhysicsConstants::c;
+    const double invC = 1.0 / c;
+    const double c2 = c * c;
+
+    pool.parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!store.isMovable(i)) {
+                continue;
+            }
+            const glm::dvec3 target = store.position(i);
+            glm::dvec3 E(0.0);
+            glm::dvec3 B(0.0);
+            size_t iterations = 0;
+
+            for (size_t j = 0; j < count; ++j) {
+                if (j == i) {
+                    continue;
+                }
+
+                // Initial guess: exact travel time if the source keeps its current
+                // velocity, i.e. the root of |R0 + v τ| = c τ
+                glm::dvec3 R0 = target - store.position(j);
+                glm::dvec3 v = store.velocity(j);
+                double R0v = glm::dot(R0, v);
+                double R02 = glm::dot(R0, R0);
+                double a = c2 - glm::dot(v, v);
+                double tau = a > 0.0 ? (R0v + std::sqrt(R0v * R0v + a * R02)) / a : std::sqrt(R02) * invC;
+
+                // Newton on g(τ) = τ - |R(τ)|/c; the state at the last τ is used once
+                // the update is below tolerance (its error is then O(β · tolerance))
+                glm::dvec3 pos;
+                glm::dvec3 vel;
+                long frame = 0;
+                for (int k = 0; k < m_maxIterations; ++k) {
+                    frame = findFrame(time - tau);
+                    sourceState(j, frame, time - tau, pos, vel);
+                    ++iterations;
+                    glm::dvec3 R = target - pos;
+                    double distance = glm::length(R);
+                    if (distance < PhysicsConstants::MIN_SAFE_DISTANCE) {
+                        break;
+                    }
+                    double kappa = 1.0 - glm::dot(R, vel) / (distance * c);
+                    double delta = (tau - distance * invC) / kappa;
+                    if (std::abs(delta) <= m_tolerance * tau) {
+                        break;
+                    }
+                    tau -= delta;
+                }
+
+                glm::dvec3 acc = sourceAcceleration(j, frame, time - tau);
+                glm::dvec3 Ej;
+                glm::dvec3 Bj;
+                lienardWiechert(target, pos, vel, acc, store.q[j], Ej, Bj);
+                E += Ej;
+                B += Bj;
+            }
+
+            m_electric[i] = E;
+            m_magnetic[i] = B;
+            m_iterations[i] = iterations;
+        }
+    }, TARGET_CHUNK_SIZE);
+
+    size_t totalIterations = 0;
+    size_t pairs = 0;
+    for (size_t i = 0; i < count; ++i) {
+        totalIterations += m_iterations[i];
+        pairs += m_iterations[i] > 0 ? count - 1 : 0;
+    }
+    m_meanIterations = pairs > 0 ? static_cast<double>(totalIterations) / static_cast<double>(pairs) : 0.0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include "ParticleStore.hpp"
+#include "engine/core/ThreadPool.hpp"
+
+/**
+ * Retarded Field Solver (Liénard–Wiechert)
+ *
+ * Computes the electric and magnetic fields at every particle from the retarded
+ * positions, velocities and accelerations of all other particles:
+ *
+ *   E = kq [ (n - β)(1 - β²) / (κ³R²) + n × ((n - β) × β̇) / (cκ³R) ]
+ *   B = n × E / c
+ *
+ * with R = r - r_s(t_r), n = R/|R|, β = v_s/c, β̇ = a_s/c, κ = 1 - n·β, evaluated
+ * at the retarded time t_r solving t - t_r = |r - r_s(t_r)| / c.
+ *
+ * History: every record() stores the positions and velocities of all particles
+ * at one time. All particles share one timeline, so the frame bracketing a
+ * retarded time is found from a single small timestamp array (one
+ * interpolation-search probe, exact when the step size is uniform, with binary
+ * search as fallback). Between frames, positions, velocities and accelerations
+ * come from the cubic Hermite interpolant of the bracketing frames. Its
+ * polynomial coefficients are computed once per source and interval when a frame
+ * is recorded (O(N) per step) and shared by all N targets, so each lookup is a
+ * Horner evaluation from 96 contiguous bytes; coefficients are interval-major,
+ * so a sweep over sources at similar lags streams through memory. Before the
+ * oldest frame, sources are assumed to have moved uniformly.
+ *
+ * The retarded time of each pair is found by Newton iteration on the light
+ * travel time τ = t - t_r: g(τ) = τ - |r - r_s(t - τ)|/c with g'(τ) = κ. The
+ * initial guess is the exact root for uniform motion at the source's current
+ * velocity, so one evaluation usually meets the tolerance.
+ *
+ * Targets are split across the thread pool; each target only writes its own
+ * fields, so results do not depend on the thread count. Cost is O(N²) per step.
+ */
+class RetardedFieldSolver {
+public:
+    static constexpr size_t DEFAULT_HISTORY_FRAMES = 64;
+
+    /**
+     * Recorded frames (ring buffer, frame-major)
+     */
+    struct History {
+        size_t capacity = 0;        // Frames
+        size_t particleCount = 0;
+        size_t head = 0;            // Slot of the oldest frame
+        size_t frames = 0;          // Frames currently stored
+        std::vector<double> t;      // [slot]
+        std::vector<double> x, y, z, vx, vy, vz;  // [slot * particleCount + particle]
+    };
+
+    RetardedFieldSolver();
+
+    /**
+     * Frames kept for retarded lookups (discards the history)
+     * Should cover the light travel time across the system in steps.
+     */
+    void setHistoryFrames(size_t frames);
+    size_t getHistoryFrames() const { return m_historyFrames; }
+
+    /**
+     * Newton convergence: stop when the retarded-time update is below
+     * tolerance × light travel time of the pair
+     */
+    void setTolerance(double tolerance) { m_tolerance = tolerance; }
+    double getTolerance() const { return m_tolerance; }
+    void setMaxIterations(int iterations) { m_maxIterations = iterations < 1 ? 1 : iterations; }
+
+    /**
+     * Record the current state of all particles at time t
+     *
+     * Times must increase. A change in particle count discards the history.
+     */
+    void record(double time, const ParticleStore& store);
+
+    /**
+     * Discard all recorded frames
+     */
+    void clear();
+
+    /**
+     * Compute E and B at every particle at time t (the last recorded time)
+     *
+     * Fixed and dragged particles act as sources only.
+     */
+    void computeFields(const ParticleStore& store, double time, ThreadPool& pool);
+
+    const std::vector<glm::dvec3>& getElectricFields() const { return m_electric; }
+    const std::vector<glm::dvec3>& getMagneticFields() const { return m_magnetic; }
+
+    /**
+     * Mean Newton iterations per pair in the last computeFields()
+     */
+    double getMeanIterations() const { return m_meanIterations; }
+
+    /**
+     * History access for checkpoints
+     */
+    const History& getHistory() const { return m_history; }
+    void setHistory(const History& history);
+
+    /**
+     * Liénard–Wiechert field of one moving charge
+     *
+     * @param evalPoint Observation point
+     * @param sourcePos Source position at the retarded time
+     * @param sourceVel Source velocity at the retarded time
+     * @param sourceAcc Source acceleration at the retarded time
+     * @param q Source charge
+     * @param E Electric field (output)
+     * @param B Magnetic field (output)
+     */
+    static void lienardWiechert(
+        const glm::dvec3& evalPoint,
+        const glm::dvec3& sourcePos,
+        const glm::dvec3& sourceVel,
+        const glm::dvec3& sourceAcc,
+        double q,
+        glm::dvec3& E,
+        glm::dvec3& B
+    );
+
+private:
+    /**
+     * Interpolated source position and velocity at time, in interval `frame`
+     * (from findFrame())
+     */
+    void sourceState(size_t source, long frame, double time, glm::dvec3& pos, glm::dvec3& vel) const;
+    glm::dvec3 sourceAcceleration(size_t source, long frame, double time) const;
+    
+    /**
+     * Hermite coefficients of the interval starting at frame (both frames recorded)
+     */
+    void buildInterval(size_t frame);
+
+    /**
+     * Index i of the frame pair [i, i + 1] bracketing time (-1 before the oldest
+     * frame, frames - 1 at or after the newest)
+     */
+    long findFrame(double time) const;
+    
+    size_t slot(size_t frame) const {
+        size_t s = m_history.head + frame;
+        return s >= m_history.capacity ? s - m_history.capacity : s;
+    }
+
+    size_t m_historyFrames;
+    double m_tolerance;
+    int m_maxIterations;
+
+    History m_history;
+    std::vector<double> m_coefficients;  // [(slot * particleCount + particle) * 12]: c0..c3 for x, y, z
+    double m_oldestTime;                 // Cached by computeFields() for findFrame()
+    double m_newestTime;
+    double m_frameScale;                 // (frames - 1) / (newest - oldest)
+
+    std::vector<glm::dvec3> m_electric;
+    std::vector<glm::dvec3> m_magnetic;
+    std::vector<size_t> m_iterations;  // Per target, summed into m_meanIterations
+    double m_meanIterations;
+};
@@ -1,19 +1,47 @@
 #include "ParticleSystem.hpp"
 #include "engine/core/Logger.hpp"
 #include "engine/core/Constants.hpp"
+#include "engine/physics/CoulombKernel.hpp"
 #include <algorithm>
 #include <cmath>
 
+namespace {
+    // Smallest per-thread ranges worth dispatching (force loop is O(N) per particle)
+    constexpr size_t FORCE_CHUNK_SIZE = 8;
+    constexpr size_t INTEGRATION_CHUNK_SIZE = 4096;
+}
+
 ParticleSystem::ParticleSystem()
     : m_integrationMethod(IntegrationMethod::VERLET)
+    , m_forceMethod(ForceMethod::DIRECT)
     , m_collisionPrevention(true)
     , m_minSeparation(1e-12)  // Minimum separation in meters
+    , m_stepCount(0)
+    , m_simulationTime(0.0)
+    , m_magneticInteraction(false)
+    , m_forcesCurrent(false)
+    , m_forcesFieldRevision(0)
+    , m_forceErrorPending(false)
+    , m_forceEvaluations(0)
+    , m_particleForceEvaluations(0)
+    , m_timeStepMode(TimeStepMode::FIXED)
+    , m_timeStepAccuracy(0.02)
+    , m_maxTimeStepLevel(10)
+    , m_timeStepStateValid(false)
+    , m_periodic(false)
+    , m_forceErrorSampleCount(16)
+    , m_forceErrorSampleInterval(60)
+    , m_forceErrorTolerance(0.0)  // Report only by default
+    , m_pairwiseFieldsCurrent(false)
+    , m_threadCount(0)            // One thread per logical core
+    , m_pinThreads(false)
 {
 }
 
 void ParticleSystem::addParticle(const Particle& particle) {
     m_particles.push_back(particle);
     m_initialParticles.push_back(particle);
+    m_forcesCurrent = false;
     
     LOG_DEBUG("Added particle: q=" + std::to_string(particle.charge) + 
               " C, m=" + std::to_string(particle.mass) + " kg");
@@ -22,6 +50,7 @@ void ParticleSystem::addParticle(const Particle& particle) {
 void ParticleSystem::removeParticle(int index) {
     if (index >= 0 && index < static_cast<int>(m_particles.size())) {
         m_particles.erase(m_particles.begin() + index);
+        m_forcesCurrent = false;
         if (index < static_cast<int>(m_initialParticles.size())) {
             m_initialParticles.erase(m_initialParticles.begin() + index);
         }
@@ -34,56 +63,487 @@ void ParticleSystem::step(double dt) {
         return;
     }
     
-    // Compute forces and update accelerations
-    for (auto& particle : m_particles) {
-        if (particle.isFixed || particle.isBeingDragged) {
-            // Skip fixed or dragged particles
-            continue;
+    // Forces from the end of the previous step stay valid unless particles were
+    // edited (dragging, flags, charges) or a setting changed since
+    const bool particlesUnchanged = m_store.matches(m_particles);
+    bool forcesCurrent = m_forcesCurrent && particlesUnchanged &&
+                         m_forcesFieldRevision == m_externalField.getRevision();
+    
+    // Time step levels carry over while the same particles keep stepping adaptively
+    bool timeStepStateValid = m_timeStepStateValid && particlesUnchanged &&
+                              m_timeStepLevels.size() == m_particles.size();
+    
+    // Pull external edits (dragging, flags, charges) into the SoA store
+    m_store.loadFrom(m_particles);
+    const double time = m_simulationTime;
+    
+    if (m_forceMethod == ForceMethod::RETARDED) {
+        // Current state becomes the newest frame of the retarded history
+        m_retarded.record(time, m_store);
+    }
+    
+    // Periodically measure the approximation error against the direct sum
+    m_forceErrorPending = m_stepCount % static_cast<size_t>(m_forceErrorSampleInterval) == 0;
+    
+    const bool verletType = m_integrationMethod == IntegrationMethod::VERLET ||
+                            m_integrationMethod == IntegrationMethod::YOSHIDA4;
+    switch (m_timeStepMode) {
+        case TimeStepMode::BLOCK:
+            if (m_integrationMethod == IntegrationMethod::VERLET) {
+                blockStep(dt, time, forcesCurrent, timeStepStateValid);
+                break;
+            }
+            adaptiveStep(dt, time, forcesCurrent, timeStepStateValid);
+            break;
+            
+        case TimeStepMode::GLOBAL:
+            adaptiveStep(dt, time, forcesCurrent, timeStepStateValid);
+            break;
+            
+        case TimeStepMode::FIXED:
+        default:
+            integrate(dt, time, forcesCurrent);
+            break;
+    }
+    m_timeStepStateValid = m_timeStepMode != TimeStepMode::FIXED;
+    
+    // Clamp velocities to prevent numerical instability
+    clampVelocities();
+    
+    // Back into the periodic box; only P3M and EWALD forces are the same for every image
+    const bool wrapped = m_periodic && wrapPositions();
+    
+    // Publish results to the AoS view used by rendering and interaction
+    m_store.storeKinematics(m_particles);
+    
+    // Verlet-type steps end with the forces at the new positions
+    m_forcesCurrent = verletType && (!wrapped || isPeriodicMethod(effectiveForceMethod()));
+    m_forcesFieldRevision = m_externalField.getRevision();
+    
+    ++m_stepCount;
+    m_simulationTime += dt;
+}
+
+void ParticleSystem::integrate(double dt, double time, bool forcesCurrent) {
+    const size_t count = m_store.size();
+    ThreadPool& pool = getThreadPool();
+    
+    switch (m_integrationMethod) {
+        case IntegrationMethod::VERLET:
+            // Kick-drift-kick; the closing forces open the next step
+            if (!forcesCurrent) {
+                computeForces(time);
+            }
+            kick(0.5 * dt);
+            drift(dt);
+            computeForces(time + dt);
+            kick(0.5 * dt);
+            break;
+            
+        case IntegrationMethod::YOSHIDA4: {
+            // Three Verlet substeps; the closing forces of one open the next
+            if (!forcesCurrent) {
+                computeForces(time);
+            }
+            double substepTime = time;
+            for (double weight : {YOSHIDA4_W1, YOSHIDA4_W0, YOSHIDA4_W1}) {
+                kick(0.5 * weight * dt);
+                drift(weight * dt);
+                substepTime += weight * dt;
+                computeForces(substepTime);
+                kick(0.5 * weight * dt);
+            }
+            break;
+        }
+            
+        case IntegrationMethod::RK4:
+            rungeKuttaStep(dt, time);
+            break;
+            
+        case IntegrationMethod::BORIS:
+            computeForces(time);
+            pool.parallelFor(0, count, [this, dt](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (!m_store.isMovable(i)) {
+                        continue;
+                    }
+                    // Boris pusher: E kicks around an exact-magnitude B rotation
+                    BorisResult result = borisStep(
+                        m_store.position(i),
+                        m_store.velocity(i),
+                        m_electricFields[i],
+                        m_magneticFields[i],
+                        m_store.q[i] / m_store.m[i],
+                        dt,
+                        m_repulsionAccelerations[i]
+                    );
+                    m_store.setPosition(i, result.position);
+                    m_store.setVelocity(i, result.velocity);
+                }
+            }, INTEGRATION_CHUNK_SIZE);
+            break;
+            
+        case IntegrationMethod::EULER:
+        default:
+            computeForces(time);
+            pool.parallelFor(0, count, [this, dt](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (!m_store.isMovable(i)) {
+                        continue;
+                    }
+                    // Semi-implicit Euler
+                    EulerResult result = eulerStep(
+                        m_store.position(i),
+                        m_store.velocity(i),
+                        m_store.acceleration(i),
+                        dt
+                    );
+                    m_store.setPosition(i, result.position);
+                    m_store.setVelocity(i, result.velocity);
+                }
+            }, INTEGRATION_CHUNK_SIZE);
+            break;
+    }
+}
+
+void ParticleSystem::adaptiveStep(double dt, double time, bool forcesCurrent, bool stateValid) {
+    const size_t count = m_store.size();
+    const uint64_t ticks = uint64_t(1) << m_maxTimeStepLevel;
+    const bool verletType = m_integrationMethod == IntegrationMethod::VERLET ||
+                            m_integrationMethod == IntegrationMethod::YOSHIDA4;
+    
+    // All particles share the finest level any of them asked for
+    int level = m_maxTimeStepLevel;
+    if (stateValid) {
+        level = *std::max_element(m_timeStepLevels.begin(), m_timeStepLevels.end());
+        level = std::min(level, m_maxTimeStepLevel);
+    }
+    m_previousAccelerations.resize(count);
+    
+    // Store accelerations are forces of an earlier state of these particles,
+    // so the change over a substep estimates the jerk
+    bool baseline = stateValid;
+    uint64_t tick = 0;
+    while (tick < ticks) {
+        const double h = std::ldexp(dt, -level);
+        for (size_t i = 0; i < count; ++i) {
+            m_previousAccelerations[i] = m_store.acceleration(i);
         }
         
-        // Compute net force: F = q * E_total
-        glm::dvec3 force = computeNetForce(particle);
+        integrate(h, time + std::ldexp(dt, -m_maxTimeStepLevel) * static_cast<double>(tick), forcesCurrent);
+        forcesCurrent = verletType;
+        tick += ticks >> level;
         
-        // Update acceleration: a = F / m
-        particle.acceleration = force / particle.mass;
+        int desired = level;
+        if (baseline) {
+            desired = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (m_store.isMovable(i)) {
+                    desired = std::max(desired, desiredLevel(i, dt, h));
+                }
+            }
+        }
+        baseline = true;
+        level = nextLevel(level, desired, tick);
     }
     
-    // Integrate motion
-    for (auto& particle : m_particles) {
-        if (particle.isFixed || particle.isBeingDragged) {
+    m_timeStepLevels.assign(count, static_cast<uint8_t>(level));
+}
+
+void ParticleSystem::blockStep(double dt, double time, bool forcesCurrent, bool stateValid) {
+    const size_t count = m_store.size();
+    const uint64_t ticks = uint64_t(1) << m_maxTimeStepLevel;
+    const double tickDt = std::ldexp(dt, -m_maxTimeStepLevel);
+    ThreadPool& pool = getThreadPool();
+    
+    if (!forcesCurrent) {
+        computeForces(time);
+    }
+    
+    // Without a jerk estimate, start at the finest level and coarsen from there
+    if (!stateValid) {
+        m_timeStepLevels.assign(count, static_cast<uint8_t>(m_maxTimeStepLevel));
+        m_previousAccelerations.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_previousAccelerations[i] = m_store.acceleration(i);
+        }
+    }
+    
+    // Opening half kicks at each particle's own step
+    m_nextTicks.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        int level = std::min(static_cast<int>(m_timeStepLevels[i]), m_maxTimeStepLevel);
+        m_timeStepLevels[i] = static_cast<uint8_t>(level);
+        m_nextTicks[i] = ticks >> level;
+        if (m_store.isMovable(i)) {
+            m_store.setVelocity(i, verletKick(m_store.velocity(i), m_store.acceleration(i), 0.5 * std::ldexp(dt, -level)));
+        }
+    }
+    
+    uint64_t tick = 0;
+    while (tick < ticks) {
+        // Everyone drifts to the next substep end; only the particles ending
+        // their substep there get new forces and kicks
+        uint64_t next = ticks;
+        for (size_t i = 0; i < count; ++i) {
+            if (m_store.isMovable(i)) {
+                next = std::min(next, m_nextTicks[i]);
+            }
+        }
+        drift(tickDt * static_cast<double>(next - tick));
+        tick = next;
+        
+        m_activeParticles.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (m_store.isMovable(i) && m_nextTicks[i] == tick) {
+                m_activeParticles.push_back(i);
+            }
+        }
+        if (m_activeParticles.empty()) {
             continue;
         }
+        computeForces(time + tickDt * static_cast<double>(tick), &m_activeParticles);
         
-        if (m_integrationMethod == IntegrationMethod::VERLET) {
-            // Velocity Verlet integration
-            VerletResult result = verletStep(
-                particle.position,
-                particle.velocity,
-                particle.acceleration,
-                dt
-            );
-            particle.position = result.position;
-            particle.velocity = result.velocity;
-        } else {
-            // Semi-implicit Euler
-            EulerResult result = eulerStep(
-                particle.position,
-                particle.velocity,
-                particle.acceleration,
-                dt
-            );
-            particle.position = result.position;
-            particle.velocity = result.velocity;
-        }
-    }
-    
-    // Apply collision prevention
+        pool.parallelFor(0, m_activeParticles.size(), [this, dt, tick, ticks](size_t begin, size_t end, size_t) {
+            for (size_t a = begin; a < end; ++a) {
+                const size_t i = m_activeParticles[a];
+                const int level = m_timeStepLevels[i];
+                const double h = std::ldexp(dt, -level);
+                const glm::dvec3 acceleration = m_store.acceleration(i);
+                
+                // Closing kick, then the next substep opens at the new level
+                m_store.setVelocity(i, verletKick(m_store.velocity(i), acceleration, 0.5 * h));
+                int newLevel = nextLevel(level, desiredLevel(i, dt, h), tick);
+                m_previousAccelerations[i] = acceleration;
+                m_timeStepLevels[i] = static_cast<uint8_t>(newLevel);
+                if (tick < ticks) {
+                    m_store.setVelocity(i, verletKick(m_store.velocity(i), acceleration, 0.5 * std::ldexp(dt, -newLevel)));
+                    m_nextTicks[i] = tick + (ticks >> newLevel);
+                }
+            }
+        }, INTEGRATION_CHUNK_SIZE);
+    }
+}
+
+int ParticleSystem::desiredLevel(size_t index, double dt, double h) const {
+    // Step η |a| / |da/dt| with the jerk from the last two evaluations; the larger
+    // of the two accelerations keeps a sign change from forcing the finest level
+    const glm::dvec3 acceleration = m_store.acceleration(index);
+    const glm::dvec3& previous = m_previousAccelerations[index];
+    const double jerk = glm::length(acceleration - previous) / h;
+    const double magnitude = std::max(glm::length(acceleration), glm::length(previous));
+    if (!(jerk > 0.0)) {
+        return 0;
+    }
+    
+    const double ratio = dt * jerk / (m_timeStepAccuracy * magnitude);
+    if (!(ratio > 1.0)) {
+        return 0;
+    }
+    if (!(ratio < std::ldexp(1.0, m_maxTimeStepLevel))) {
+        return m_maxTimeStepLevel;
+    }
+    return static_cast<int>(std::ceil(std::log2(ratio)));
+}
+
+int ParticleSystem::nextLevel(int current, int desired, uint64_t tick) const {
+    // Finer steps always fit; coarser ones by one level, where the coarser step begins
+    if (desired >= current) {
+        return std::min(desired, m_maxTimeStepLevel);
+    }
+    const uint64_t coarserTicks = (uint64_t(1) << m_maxTimeStepLevel) >> (current - 1);
+    return tick % coarserTicks == 0 ? current - 1 : current;
+}
+
+void ParticleSystem::setMaxTimeStepLevel(int level) {
+    m_maxTimeStepLevel = std::clamp(level, 0, MAX_TIME_STEP_LEVEL);
+}
+
+void ParticleSystem::computeForces(double time, const std::vector<size_t>* active) {
+    const size_t count = m_store.size();
+    ThreadPool& pool = getThreadPool();
+    const ForceMethod method = effectiveForceMethod();
+    
+    // Build the tree once per evaluation for approximate force methods
+    if (method == ForceMethod::BARNES_HUT) {
+        m_tree.build(m_store);
+    } else if (method == ForceMethod::FMM) {
+        m_fmm.build(m_store);
+        m_fmm.computeFields();
+    } else if (method == ForceMethod::RETARDED) {
+        m_retarded.computeFields(m_store, time, pool);
+    } else if (method == ForceMethod::P3M) {
+        m_p3m.setBox(m_periodicBox);
+        m_p3m.computeFields(m_store, &pool);
+    } else if (method == ForceMethod::EWALD) {
+        m_ewald.setBox(m_periodicBox);
+        m_ewald.computeFields(m_store, &pool);
+    }
+    
+    // Exact fields at most particles: one evaluation per pair (N²/2) beats one
+    // sum per target (N per movable particle). Block steps update few particles.
+    m_pairwiseFieldsCurrent = false;
+    if (method == ForceMethod::DIRECT && !active) {
+        size_t movable = 0;
+        for (size_t i = 0; i < count; ++i) {
+            movable += m_store.isMovable(i) ? 1 : 0;
+        }
+        if (2 * movable > count) {
+            CoulombKernel::pairwiseFields(m_store, m_pairwiseFields, &pool);
+            m_pairwiseFieldsCurrent = true;
+        }
+    }
+    
+    // Currents q·v of all sources for the magnetic interaction
+    if (m_magneticInteraction && m_forceMethod != ForceMethod::RETARDED) {
+        m_currentX.resize(count);
+        m_currentY.resize(count);
+        m_currentZ.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            m_currentX[i] = m_store.q[i] * m_store.vx[i];
+            m_currentY[i] = m_store.q[i] * m_store.vy[i];
+            m_currentZ[i] = m_store.q[i] * m_store.vz[i];
+        }
+    }
+    
+    // The Boris pusher needs E, B and the collision repulsion separately, not just
+    // the acceleration
+    const bool boris = m_integrationMethod == IntegrationMethod::BORIS;
+    if (boris) {
+        m_electricFields.resize(count);
+        m_magneticFields.resize(count);
+        m_repulsionAccelerations.assign(count, glm::dvec3(0.0));
+    }
+    
+    // Compute forces and update accelerations
+    // (each particle only writes its own acceleration, so chunks are independent)
+    const size_t targets = active ? active->size() : count;
+    pool.parallelFor(0, targets, [this, boris, time, active](size_t begin, size_t end, size_t) {
+        for (size_t t = begin; t < end; ++t) {
+            const size_t i = active ? (*active)[t] : t;
+            if (!m_store.isMovable(i)) {
+                // Skip fixed or dragged particles
+                continue;
+            }
+            
+            glm::dvec3 E;
+            glm::dvec3 B;
+            computeTotalFields(i, time, E, B);
+            if (boris) {
+                m_electricFields[i] = E;
+                m_magneticFields[i] = B;
+            }
+            
+            // Lorentz force: F = q * (E + v × B), a = F / m
+            glm::dvec3 force = m_store.q[i] * (E + glm::cross(m_store.velocity(i), B));
+            m_store.setAcceleration(i, force / m_store.m[i]);
+        }
+    }, FORCE_CHUNK_SIZE);
+    
+    // First evaluation of a sampling step: compare against the direct sum
+    if (m_forceErrorPending &&
+        (m_forceMethod == ForceMethod::BARNES_HUT || m_forceMethod == ForceMethod::FMM) &&
+        m_forceErrorSampleCount > 0) {
+        sampleForceError();
+    }
+    m_forceErrorPending = false;
+    
+    // Soft repulsion acts as part of the force
     if (m_collisionPrevention) {
-        applyCollisionPrevention();
+        applyCollisionPrevention(active);
     }
     
-    // Clamp velocities to prevent numerical instability
-    clampVelocities();
+    ++m_forceEvaluations;
+    m_particleForceEvaluations += targets;
+}
+
+void ParticleSystem::kick(double h) {
+    getThreadPool().parallelFor(0, m_store.size(), [this, h](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (m_store.isMovable(i)) {
+                m_store.setVelocity(i, verletKick(m_store.velocity(i), m_store.acceleration(i), h));
+            }
+        }
+    }, INTEGRATION_CHUNK_SIZE);
+}
+
+bool ParticleSystem::wrapPositions() {
+    bool moved = false;
+    for (size_t i = 0; i < m_store.size(); ++i) {
+        if (m_store.isMovable(i)) {
+            const glm::dvec3 position = m_store.position(i);
+            const glm::dvec3 wrapped = m_periodicBox.wrap(position);
+            if (wrapped != position) {
+                m_store.setPosition(i, wrapped);
+                moved = true;
+            }
+        }
+    }
+    return moved;
+}
+
+void ParticleSystem::drift(double h) {
+    getThreadPool().parallelFor(0, m_store.size(), [this, h](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (m_store.isMovable(i)) {
+                m_store.setPosition(i, verletDrift(m_store.position(i), m_store.velocity(i), h));
+            }
+        }
+    }, INTEGRATION_CHUNK_SIZE);
+}
+
+void ParticleSystem::rungeKuttaStep(double dt, double time) {
+    const size_t count = m_store.size();
+    ThreadPool& pool = getThreadPool();
+    
+    m_startPositions.resize(count);
+    m_startVelocities.resize(count);
+    m_positionSums.assign(count, glm::dvec3(0.0));
+    m_velocitySums.assign(count, glm::dvec3(0.0));
+    for (size_t i = 0; i < count; ++i) {
+        m_startPositions[i] = m_store.position(i);
+        m_startVelocities[i] = m_store.velocity(i);
+    }
+    
+    // Stage s is evaluated at start + node[s] * dt * (derivative of stage s - 1)
+    const double nodes[4] = {0.0, 0.5, 0.5, 1.0};
+    const double weights[4] = {1.0, 2.0, 2.0, 1.0};
+    for (int stage = 0; stage < 4; ++stage) {
+        if (stage > 0) {
+            const double h = nodes[stage] * dt;
+            pool.parallelFor(0, count, [this, h](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (m_store.isMovable(i)) {
+                        glm::dvec3 velocity = m_store.velocity(i);
+                        m_store.setPosition(i, m_startPositions[i] + h * velocity);
+                        m_store.setVelocity(i, m_startVelocities[i] + h * m_store.acceleration(i));
+                    }
+                }
+            }, INTEGRATION_CHUNK_SIZE);
+        }
+        
+        computeForces(time + nodes[stage] * dt);
+        
+        const double weight = weights[stage];
+        pool.parallelFor(0, count, [this, weight](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                if (m_store.isMovable(i)) {
+                    m_positionSums[i] += weight * m_store.velocity(i);
+                    m_velocitySums[i] += weight * m_store.acceleration(i);
+                }
+            }
+        }, INTEGRATION_CHUNK_SIZE);
+    }
+    
+    // y_new = y + (dt/6) * (k1 + 2*k2 + 2*k3 + k4)
+    pool.parallelFor(0, count, [this, dt](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            if (m_store.isMovable(i)) {
+                m_store.setPosition(i, m_startPositions[i] + (dt / 6.0) * m_positionSums[i]);
+                m_store.setVelocity(i, m_startVelocities[i] + (dt / 6.0) * m_velocitySums[i]);
+            }
+        }
+    }, INTEGRATION_CHUNK_SIZE);
 }
 
 void ParticleSystem::reset() {
@@ -95,56 +555,353 @@ void ParticleSystem::reset() {
         particle.acceleration = glm::dvec3(0.0);
         particle.isBeingDragged = false;
     }
+    m_stepCount = 0;
+    m_simulationTime = 0.0;
+    m_forceEvaluations = 0;
+    m_particleForceEvaluations = 0;
+    m_forcesCurrent = false;
+    m_timeStepStateValid = false;
+    m_retarded.clear();
     
     LOG_INFO("Particle system reset to initial state");
 }
 
-glm::dvec3 ParticleSystem::computeNetForce(const Particle& target) const {
-    // Compute total electric field at target position
-    glm::dvec3 E_total = ElectricField::totalField(target.position, m_particles);
+ParticleSystem::Snapshot ParticleSystem::createSnapshot() const {
+    Snapshot snapshot;
+    snapshot.particles = m_particles;
+    snapshot.initialParticles = m_initialParticles;
+    snapshot.integrationMethod = m_integrationMethod;
+    snapshot.forceMethod = m_forceMethod;
+    snapshot.collisionPrevention = m_collisionPrevention;
+    snapshot.minSeparation = m_minSeparation;
+    snapshot.stepCount = m_stepCount;
+    snapshot.simulationTime = m_simulationTime;
+    snapshot.treeOpeningAngle = m_tree.getOpeningAngle();
+    snapshot.fmmOpeningAngle = m_fmm.getOpeningAngle();
+    snapshot.expansionOrder = m_fmm.getExpansionOrder();
+    snapshot.forceErrorSampleCount = m_forceErrorSampleCount;
+    snapshot.forceErrorSampleInterval = m_forceErrorSampleInterval;
+    snapshot.forceErrorTolerance = m_forceErrorTolerance;
+    snapshot.forceErrorStats = m_forceErrorStats;
+    snapshot.retardedHistory = m_retarded.getHistory();
+    snapshot.retardedHistoryFrames = m_retarded.getHistoryFrames();
+    snapshot.magneticInteraction = m_magneticInteraction;
+    snapshot.forcesCurrent = m_forcesCurrent && m_store.matches(m_particles) &&
+                             m_forcesFieldRevision == m_externalField.getRevision();
+    snapshot.externalElectric = m_externalField.getUniformElectric();
+    snapshot.externalMagnetic = m_externalField.getUniformMagnetic();
+    snapshot.periodic = m_periodic;
+    snapshot.periodicLow = m_periodicBox.getLow();
+    snapshot.periodicHigh = m_periodicBox.getHigh();
+    snapshot.meshSize = m_p3m.getMeshSize();
+    snapshot.chargeAssignment = m_p3m.getAssignment();
+    snapshot.shortRangeCutoff = m_p3m.getRequestedCutoff();
+    snapshot.ewaldAccuracy = m_ewald.getAccuracy();
+    snapshot.timeStepMode = m_timeStepMode;
+    snapshot.timeStepAccuracy = m_timeStepAccuracy;
+    snapshot.maxTimeStepLevel = m_maxTimeStepLevel;
+    snapshot.timeStepStateValid = m_timeStepStateValid && m_store.matches(m_particles) &&
+                                  m_timeStepLevels.size() == m_particles.size();
+    if (snapshot.timeStepStateValid) {
+        snapshot.timeStepLevels = m_timeStepLevels;
+        snapshot.previousAccelerations = m_previousAccelerations;
+    }
+    return snapshot;
+}
+
+void ParticleSystem::restoreSnapshot(const Snapshot& snapshot) {
+    m_particles = snapshot.particles;
+    m_initialParticles = snapshot.initialParticles;
+    m_integrationMethod = snapshot.integrationMethod;
+    m_forceMethod = snapshot.forceMethod;
+    m_collisionPrevention = snapshot.collisionPrevention;
+    m_minSeparation = snapshot.minSeparation;
+    m_stepCount = static_cast<size_t>(snapshot.stepCount);
+    m_simulationTime = snapshot.simulationTime;
+    m_tree.setOpeningAngle(snapshot.treeOpeningAngle);
+    m_fmm.setOpeningAngle(snapshot.fmmOpeningAngle);
+    m_fmm.setExpansionOrder(snapshot.expansionOrder);
+    m_forceErrorSampleCount = snapshot.forceErrorSampleCount;
+    m_forceErrorSampleInterval = snapshot.forceErrorSampleInterval;
+    m_forceErrorTolerance = snapshot.forceErrorTolerance;
+    m_forceErrorStats = snapshot.forceErrorStats;
+    m_retarded.setHistoryFrames(snapshot.retardedHistoryFrames);
+    m_retarded.setHistory(snapshot.retardedHistory);
+    m_magneticInteraction = snapshot.magneticInteraction;
+    m_externalField.setUniformElectric(snapshot.externalElectric);
+    m_externalField.setUniformMagnetic(snapshot.externalMagnetic);
+    m_periodic = snapshot.periodic;
+    m_periodicBox = PeriodicBox(snapshot.periodicLow, snapshot.periodicHigh);
+    m_p3m.setMeshSize(snapshot.meshSize);
+    m_p3m.setAssignment(snapshot.chargeAssignment);
+    m_p3m.setCutoff(snapshot.shortRangeCutoff);
+    m_ewald.setAccuracy(snapshot.ewaldAccuracy);
+    m_timeStepMode = snapshot.timeStepMode;
+    m_timeStepAccuracy = snapshot.timeStepAccuracy;
+    m_maxTimeStepLevel = snapshot.maxTimeStepLevel;
+    m_timeStepLevels = snapshot.timeStepLevels;
+    m_previousAccelerations = snapshot.previousAccelerations;
     
-    // Force on charged particle: F = q * E
-    return target.charge * E_total;
+    // Saved accelerations are reused by Verlet-type steps exactly as in the original run
+    m_store.loadFrom(m_particles);
+    m_forcesCurrent = snapshot.forcesCurrent;
+    m_timeStepStateValid = snapshot.timeStepStateValid;
+    m_forcesFieldRevision = m_externalField.getRevision();
+    
+    LOG_INFO("Restored particle system at step " + std::to_string(m_stepCount) +
+             " (" + std::to_string(m_particles.size()) + " particles)");
 }
 
-void ParticleSystem::applyCollisionPrevention() {
-    // Soft repulsion between particles that are too close
-    for (size_t i = 0; i < m_particles.size(); ++i) {
-        for (size_t j = i + 1; j < m_particles.size(); ++j) {
-            Particle& p1 = m_particles[i];
-            Particle& p2 = m_particles[j];
-            
-            // Skip if either is fixed or being dragged
-            if (p1.isFixed || p1.isBeingDragged || p2.isFixed || p2.isBeingDragged) {
-                continue;
+void ParticleSystem::setThreadCount(size_t threadCount) {
+    if (threadCount != m_threadCount) {
+        m_threadCount = threadCount;
+        m_threadPool.reset();
+    }
+}
+
+size_t ParticleSystem::getThreadCount() const {
+    if (m_threadPool) {
+        return m_threadPool->getThreadCount();
+    }
+    return m_threadCount > 0 ? m_threadCount : ThreadPool::hardwareThreads();
+}
+
+void ParticleSystem::setThreadPinning(bool enabled) {
+    if (enabled != m_pinThreads) {
+        m_pinThreads = enabled;
+        m_threadPool.reset();
+    }
+}
+
+ThreadPool& ParticleSystem::getThreadPool() {
+    if (!m_threadPool) {
+        m_threadPool = std::make_unique<ThreadPool>(m_threadCount, m_pinThreads);
+    }
+    return *m_threadPool;
+}
+
+void ParticleSystem::setPeriodicBox(const glm::dvec3& low, const glm::dvec3& high) {
+    PeriodicBox box(low, high);
+    if (!box.isValid()) {
+        LOG_WARN("Ignoring periodic box with an empty or non-finite side");
+        return;
+    }
+    m_periodic = true;
+    m_periodicBox = box;
+    m_forcesCurrent = false;
+}
+
+void ParticleSystem::clearPeriodicBox() {
+    m_periodic = false;
+    m_forcesCurrent = false;
+}
+
+void ParticleSystem::setForceErrorSampling(int sampleCount, int interval) {
+    m_forceErrorSampleCount = std::max(0, sampleCount);
+    m_forceErrorSampleInterval = std::max(1, interval);
+}
+
+void ParticleSystem::setOpeningAngle(double theta) {
+    m_tree.setOpeningAngle(theta);
+    m_fmm.setOpeningAngle(theta);
+    m_forcesCurrent = false;
+}
+
+double ParticleSystem::getOpeningAngle() const {
+    return m_forceMethod == ForceMethod::FMM ? m_fmm.getOpeningAngle() : m_tree.getOpeningAngle();
+}
+
+glm::dvec3 ParticleSystem::computeField(size_t index) const {
+    switch (effectiveForceMethod()) {
+        case ForceMethod::BARNES_HUT:
+            return m_tree.fieldAt(m_store.position(index));
+        case ForceMethod::FMM:
+            return m_fmm.getFields()[index];
+        case ForceMethod::RETARDED:
+            return m_retarded.getElectricFields()[index];
+        case ForceMethod::P3M:
+            return m_p3m.getFields()[index];
+        case ForceMethod::EWALD:
+            return m_ewald.getFields()[index];
+        case ForceMethod::DIRECT:
+        default:
+            if (m_pairwiseFieldsCurrent) {
+                return m_pairwiseFields[index];
             }
+            return ElectricField::totalField(m_store.position(index), m_store);
+    }
+}
+
+glm::dvec3 ParticleSystem::computeMagneticField(size_t index) const {
+    if (m_forceMethod == ForceMethod::RETARDED) {
+        return m_retarded.getMagneticFields()[index];
+    }
+    if (!m_magneticInteraction) {
+        return glm::dvec3(0.0);
+    }
+    return MagneticField::totalField(
+        m_store.position(index),
+        m_store.x.data(), m_store.y.data(), m_store.z.data(),
+        m_currentX.data(), m_currentY.data(), m_currentZ.data(),
+        m_store.size()
+    );
+}
+
+void ParticleSystem::computeTotalFields(size_t index, double time, glm::dvec3& E, glm::dvec3& B) const {
+    E = computeField(index);
+    B = computeMagneticField(index);
+    
+    if (m_externalField.isActive()) {
+        glm::dvec3 externalE;
+        glm::dvec3 externalB;
+        m_externalField.evaluate(m_store.position(index), time, externalE, externalB);
+        E += externalE;
+        B += externalB;
+    }
+}
+
+void ParticleSystem::sampleForceError() {
+    size_t count = m_store.size();
+    size_t samples = std::min(count, static_cast<size_t>(m_forceErrorSampleCount));
+    if (samples == 0) {
+        return;
+    }
+    
+    // Evenly strided sample, rotated each time so all particles get checked eventually
+    size_t stride = count / samples;
+    size_t offset = (m_stepCount / static_cast<size_t>(m_forceErrorSampleInterval)) % stride;
+    
+    double maxError = 0.0;
+    double sumSquared = 0.0;
+    size_t measured = 0;
+    
+    for (size_t s = 0; s < samples; ++s) {
+        size_t index = offset + s * stride;
+        glm::dvec3 exact = ElectricField::totalField(m_store.position(index), m_store);
+        double exactMag = glm::length(exact);
+        if (exactMag < 1e-30) {
+            continue;
+        }
+        
+        double error = glm::length(computeField(index) - exact) / exactMag;
+        maxError = std::max(maxError, error);
+        sumSquared += error * error;
+        ++measured;
+    }
+    
+    m_forceErrorStats.maxRelativeError = maxError;
+    m_forceErrorStats.rmsRelativeError = measured > 0 ? std::sqrt(sumSquared / measured) : 0.0;
+    m_forceErrorStats.sampleCount = measured;
+    m_forceErrorStats.stepIndex = m_stepCount;
+    
+    // Keep the error bounded by tightening the opening angle
+    if (m_forceErrorTolerance > 0.0 && maxError > m_forceErrorTolerance) {
+        double theta = getOpeningAngle() * 0.8;
+        setOpeningAngle(theta);
+        LOG_WARN("Approximate force error " + std::to_string(maxError) +
+                 " exceeds tolerance, reducing opening angle to " + std::to_string(theta));
+    }
+}
+
+void ParticleSystem::applyCollisionPrevention(const std::vector<size_t>* active) {
+    if (!(m_minSeparation > 0.0)) {
+        return;
+    }
+    
+    // The Boris pusher reads the fields, not the acceleration: keep its share too
+    const bool boris = m_integrationMethod == IntegrationMethod::BORIS;
+    auto push = [this, boris](size_t i, const glm::dvec3& acceleration) {
+        m_store.setAcceleration(i, m_store.acceleration(i) + acceleration);
+        if (boris) {
+            m_repulsionAccelerations[i] += acceleration;
+        }
+    };
+    
+    // Soft repulsion between particles that are too close; with both = false only
+    // i is pushed (j is an image, pushed by its own pair with the image of i, or
+    // outside the active set)
+    auto repel = [this, &push](size_t i, size_t j, const glm::dvec3& separation, double distanceSquared, bool both) {
+        // Skip if either is fixed or being dragged
+        if (!m_store.isMovable(i) || !m_store.isMovable(j)) {
+            return;
+        }
+        
+        double distance = std::sqrt(distanceSquared);
+        if (distance > 1e-15) {
+            // Apply soft repulsion force
+            double overlap = m_minSeparation - distance;
+            double repulsionStrength = 1e-10;  // Small repulsion constant
             
-            glm::dvec3 r = p2.position - p1.position;
-            double distance = glm::length(r);
+            glm::dvec3 direction = separation / distance;
+            glm::dvec3 repulsionForce = direction * repulsionStrength * overlap;
             
-            if (distance < m_minSeparation && distance > 1e-15) {
-                // Apply soft repulsion force
-                double overlap = m_minSeparation - distance;
-                double repulsionStrength = 1e-10;  // Small repulsion constant
-                
-                glm::dvec3 direction = glm::normalize(r);
-                glm::dvec3 repulsionForce = direction * repulsionStrength * overlap;
-                
-                // Apply force (inverse mass weighting)
-                double totalMass = p1.mass + p2.mass;
-                p1.acceleration -= repulsionForce / p1.mass;
-                p2.acceleration += repulsionForce / p2.mass;
+            // Apply force (inverse mass weighting)
+            push(i, -repulsionForce / m_store.m[i]);
+            if (both) {
+                push(j, repulsionForce / m_store.m[j]);
+            }
+        }
+    };
+    
+    // Only pairs closer than the minimum separation matter: find them in O(N)
+    if (!m_periodic) {
+        m_neighborGrid.build(m_store, m_minSeparation);
+        if (active) {
+            // Block substep: only the active particles get new forces
+            for (size_t i : *active) {
+                const glm::dvec3 position = m_store.position(i);
+                m_neighborGrid.forEachNeighbor(position, m_minSeparation, [&](size_t j, double distanceSquared) {
+                    if (j != i) {
+                        repel(i, j, m_store.position(j) - position, distanceSquared, false);
+                    }
+                });
             }
+            return;
+        }
+        m_neighborGrid.forEachPair(m_minSeparation, [&](size_t i, size_t j, double distanceSquared) {
+            repel(i, j, m_store.position(j) - m_store.position(i), distanceSquared, true);
+        });
+        return;
+    }
+    
+    // Periodic box: images near the faces follow the particles, so pairs across
+    // a face are found too (pairs of two images are duplicates and skipped)
+    const PeriodicBox::Images& images = m_collisionImages;
+    const double margin = std::min(m_minSeparation, 0.5 * m_periodicBox.shortestSide());
+    m_periodicBox.buildImages(m_store, margin, m_collisionImages);
+    m_neighborGrid.build(images.x.data(), images.y.data(), images.z.data(), images.size(), m_minSeparation);
+    if (active) {
+        for (size_t a : *active) {
+            const glm::dvec3 position(images.x[a], images.y[a], images.z[a]);
+            m_neighborGrid.forEachNeighbor(position, margin, [&](size_t b, double distanceSquared) {
+                if (b != a) {
+                    const glm::dvec3 separation(images.x[b] - position.x, images.y[b] - position.y, images.z[b] - position.z);
+                    repel(a, images.source[b], separation, distanceSquared, false);
+                }
+            });
         }
+        return;
     }
+    m_neighborGrid.forEachPair(margin, [&](size_t a, size_t b, double distanceSquared) {
+        if (a >= images.primaryCount) {
+            return;
+        }
+        const glm::dvec3 separation(images.x[b] - images.x[a], images.y[b] - images.y[a], images.z[b] - images.z[a]);
+        repel(a, images.source[b], separation, distanceSquared, b < images.primaryCount);
+    });
 }
 
 void ParticleSystem::clampVelocities() {
-    for (auto& particle : m_particles) {
-        double speed = glm::length(particle.velocity);
-        if (speed > PhysicsConstants::MAX_VELOCITY) {
-            particle.velocity = glm::normalize(particle.velocity) * PhysicsConstants::MAX_VELOCITY;
+    const size_t count = m_store.size();
+    for (size_t i = 0; i < count; ++i) {
+        double speed2 = m_store.vx[i] * m_store.vx[i] +
+                        m_store.vy[i] * m_store.vy[i] +
+                        m_store.vz[i] * m_store.vz[i];
+        if (speed2 > PhysicsConstants::MAX_VELOCITY * PhysicsConstants::MAX_VELOCITY) {
+            double scale = PhysicsConstants::MAX_VELOCITY / std::sqrt(speed2);
+            m_store.vx[i] *= scale;
+            m_store.vy[i] *= scale;
+            m_store.vz[i] *= scale;
         }
     }
 }
-
@@ -1,15 +1,35 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include "engine/physics/Particle.hpp"
 #include "engine/physics/ElectricField.hpp"
+#include "engine/physics/MagneticField.hpp"
+#include "engine/physics/ExternalField.hpp"
+#include "engine/physics/ParticleStore.hpp"
+#include "engine/physics/BarnesHutTree.hpp"
+#include "engine/physics/FmmSolver.hpp"
+#include "engine/physics/NeighborGrid.hpp"
+#include "engine/physics/RetardedFieldSolver.hpp"
+#include "engine/physics/PeriodicBox.hpp"
+#include "engine/physics/P3MSolver.hpp"
+#include "engine/physics/EwaldSolver.hpp"
 #include "engine/math/Integrators.hpp"
+#include "engine/core/ThreadPool.hpp"
 
 /**
  * Particle System
  * 
  * Manages collection of particles and their physics simulation.
  * Handles force calculation, integration, and collision prevention.
+ * 
+ * Physics runs on a structure-of-arrays ParticleStore; the std::vector<Particle>
+ * returned by getParticles() is the AoS view for rendering and interaction and is
+ * synchronized with the store at the start and end of every step().
+ * 
+ * Force and integration loops are split across a persistent thread pool. Every
+ * particle is computed independently, so results do not depend on the thread count.
  */
 class ParticleSystem {
 public:
@@ -52,42 +72,497 @@ public:
      */
     void reset();
     
+    /**
+     * Simulation time in seconds (sum of all step() dt since construction or reset)
+     */
+    double getSimulationTime() const { return m_simulationTime; }
+    
+    /**
+     * Number of step() calls since construction or reset
+     */
+    size_t getStepCount() const { return m_stepCount; }
+    
+    /**
+     * Force evaluations (all particles) since construction or reset
+     */
+    size_t getForceEvaluationCount() const { return m_forceEvaluations; }
+    
+    /**
+     * Forces computed for individual particles (block steps evaluate only some)
+     */
+    size_t getParticleForceEvaluationCount() const { return m_particleForceEvaluations; }
+    
     /**
      * Set integration method
+     * 
+     * EULER: semi-implicit Euler (1 force evaluation per step)
+     * VERLET: kick-drift-kick velocity Verlet, 2nd order symplectic (1 evaluation:
+     *         the forces at the end of a step are reused by the next one)
+     * BORIS: Boris pusher (rotation about B); stable for magnetized particles at
+     *        steps where Verlet gains energy (see borisStep)
+     * YOSHIDA4: Yoshida / Forest-Ruth composition of three Verlet substeps, 4th order
+     *           symplectic (3 evaluations)
+     * RK4: classical Runge-Kutta, 4th order, not symplectic (4 evaluations)
      */
     enum class IntegrationMethod {
         EULER,
-        VERLET
+        VERLET,
+        BORIS,
+        YOSHIDA4,
+        RK4
+    };
+    void setIntegrationMethod(IntegrationMethod method) {
+        m_integrationMethod = method;
+        m_forcesCurrent = false;
+    }
+    IntegrationMethod getIntegrationMethod() const { return m_integrationMethod; }
+    
+    /**
+     * Time step control within step(dt)
+     * 
+     * FIXED: one step of dt for every particle
+     * GLOBAL: dt is split into 2^k equal substeps of the integration method; k is
+     *         chosen after every substep from the most demanding particle
+     * BLOCK: hierarchical block time steps: each particle advances at dt/2^k_i with
+     *        its own level k_i, and only particles at the end of their substep get
+     *        new forces (kick-drift-kick, so only with VERLET; other integration
+     *        methods fall back to GLOBAL)
+     * 
+     * A particle's step is η |a| / |da/dt|, with the jerk estimated from its last
+     * two force evaluations. Levels refine immediately and coarsen by one level at
+     * a time, only where the coarser step is aligned, so close encounters are
+     * resolved without shrinking the step of everything else.
+     */
+    enum class TimeStepMode {
+        FIXED,
+        GLOBAL,
+        BLOCK
+    };
+    static constexpr int MAX_TIME_STEP_LEVEL = 30;
+    void setTimeStepMode(TimeStepMode mode) { m_timeStepMode = mode; }
+    TimeStepMode getTimeStepMode() const { return m_timeStepMode; }
+    
+    /**
+     * Accuracy parameter η of the adaptive step (smaller = more substeps)
+     */
+    void setTimeStepAccuracy(double eta) { m_timeStepAccuracy = eta > 0.0 ? eta : m_timeStepAccuracy; }
+    double getTimeStepAccuracy() const { return m_timeStepAccuracy; }
+    
+    /**
+     * Deepest subdivision: substeps are never shorter than dt / 2^level
+     */
+    void setMaxTimeStepLevel(int level);
+    int getMaxTimeStepLevel() const { return m_maxTimeStepLevel; }
+    
+    /**
+     * Current level k of every particle (its step is dt / 2^k)
+     */
+    const std::vector<uint8_t>& getTimeStepLevels() const { return m_timeStepLevels; }
+    
+    /**
+     * Set force calculation method
+     * 
+     * DIRECT: exact O(N²) pairwise Coulomb sum (each pair evaluated once)
+     * BARNES_HUT: O(N log N) octree approximation controlled by the opening angle
+     * FMM: O(N) fast multipole method controlled by opening angle and expansion order
+     * RETARDED: O(N²) Liénard–Wiechert fields from retarded source states, with the
+     *           magnetic force q v × B (see RetardedFieldSolver)
+     * P3M: particle-particle particle-mesh Ewald sum over all periodic images,
+     *      O(N + M log M) (see P3MSolver); needs a periodic box and falls back to
+     *      DIRECT without one
+     * EWALD: Ewald sum over all periodic images to a requested accuracy, O(N^1.5)
+     *        (see EwaldSolver); needs a periodic box and falls back to DIRECT
+     *        without one
+     */
+    enum class ForceMethod {
+        DIRECT,
+        BARNES_HUT,
+        FMM,
+        RETARDED,
+        P3M,
+        EWALD
+    };
+    void setForceMethod(ForceMethod method) {
+        if (method == ForceMethod::RETARDED && m_forceMethod != ForceMethod::RETARDED) {
+            m_retarded.clear();  // History from an earlier retarded phase has a gap
+        }
+        m_forceMethod = method;
+        m_forcesCurrent = false;
+    }
+    ForceMethod getForceMethod() const { return m_forceMethod; }
+    
+    /**
+     * Set opening angle theta for approximate force methods (smaller = more accurate)
+     */
+    void setOpeningAngle(double theta);
+    double getOpeningAngle() const;
+    
+    /**
+     * Set FMM expansion order (higher = more accurate, 1 to FmmSolver::MAX_ORDER)
+     */
+    void setExpansionOrder(int order) {
+        m_fmm.setExpansionOrder(order);
+        m_forcesCurrent = false;
+    }
+    int getExpansionOrder() const { return m_fmm.getExpansionOrder(); }
+    
+    /**
+     * Periodic boundaries (off by default)
+     * 
+     * Particles leaving the box [low, high) re-enter through the opposite face:
+     * positions of movable particles are wrapped after every step, and collision
+     * prevention finds pairs across the faces. Only the P3M and EWALD force
+     * methods include the fields of the periodic images; the other methods see
+     * the particles of the box alone.
+     */
+    void setPeriodicBox(const glm::dvec3& low, const glm::dvec3& high);
+    void clearPeriodicBox();
+    bool isPeriodic() const { return m_periodic; }
+    const PeriodicBox& getPeriodicBox() const { return m_periodicBox; }
+    
+    /**
+     * P3M mesh nodes per axis (rounded up to a power of two; 0 = automatic from
+     * the particle count, the default)
+     */
+    void setMeshSize(int nodes) {
+        m_p3m.setMeshSize(nodes);
+        m_forcesCurrent = false;
+    }
+    int getMeshSize() const { return m_p3m.getMeshSize(); }
+    
+    /**
+     * P3M charge assignment scheme (CIC or TSC, the default)
+     */
+    void setChargeAssignment(P3MSolver::Assignment assignment) {
+        m_p3m.setAssignment(assignment);
+        m_forcesCurrent = false;
+    }
+    P3MSolver::Assignment getChargeAssignment() const { return m_p3m.getAssignment(); }
+    
+    /**
+     * P3M short-range cutoff in meters (0 = automatic, see P3MSolver)
+     */
+    void setShortRangeCutoff(double cutoff) {
+        m_p3m.setCutoff(cutoff);
+        m_forcesCurrent = false;
+    }
+    double getShortRangeCutoff() const { return m_p3m.getRequestedCutoff(); }
+    
+    /**
+     * Relative truncation error of the EWALD sums (see EwaldSolver::setAccuracy)
+     */
+    void setEwaldAccuracy(double accuracy) {
+        m_ewald.setAccuracy(accuracy);
+        m_forcesCurrent = false;
+    }
+    double getEwaldAccuracy() const { return m_ewald.getAccuracy(); }
+    
+    /**
+     * Magnetic interaction between moving charges (off by default)
+     * 
+     * Adds the Biot–Savart field of every moving particle, so the force becomes
+     * q (E + v × B). Computed as a vectorized direct sum, O(N²) for every force
+     * method. The RETARDED method always includes its own magnetic field.
+     */
+    void setMagneticInteraction(bool enabled) {
+        m_magneticInteraction = enabled;
+        m_forcesCurrent = false;
+    }
+    bool getMagneticInteraction() const { return m_magneticInteraction; }
+    
+    /**
+     * Applied electric and magnetic fields (uniform and/or user-defined)
+     */
+    ExternalField& getExternalField() { return m_externalField; }
+    const ExternalField& getExternalField() const { return m_externalField; }
+    
+    /**
+     * Steps of history kept for retarded lookups (RETARDED force method)
+     * Should cover the light travel time across the system; older retarded times
+     * assume uniform motion.
+     */
+    void setRetardedHistoryFrames(size_t frames) {
+        m_retarded.setHistoryFrames(frames);
+        m_forcesCurrent = false;
+    }
+    size_t getRetardedHistoryFrames() const { return m_retarded.getHistoryFrames(); }
+    
+    /**
+     * Force error statistics for approximate force methods
+     * 
+     * Measured by comparing the approximate field against the direct sum
+     * for a sample of particles every few steps.
+     */
+    struct ForceErrorStats {
+        double maxRelativeError = 0.0;   // Largest |E_approx - E_direct| / |E_direct| in sample
+        double rmsRelativeError = 0.0;   // RMS relative error over sample
+        size_t sampleCount = 0;          // Number of particles sampled
+        size_t stepIndex = 0;            // Step at which the sample was taken
     };
-    void setIntegrationMethod(IntegrationMethod method) { m_integrationMethod = method; }
+    const ForceErrorStats& getForceErrorStats() const { return m_forceErrorStats; }
+    
+    /**
+     * Configure force error sampling
+     * 
+     * @param sampleCount Particles checked against the direct sum (0 disables sampling)
+     * @param interval Sample every this many steps
+     */
+    void setForceErrorSampling(int sampleCount, int interval);
+    
+    /**
+     * Set maximum tolerated relative force error
+     * 
+     * When a sample exceeds this, the opening angle is tightened automatically.
+     * Set to 0 (default) to only report errors.
+     */
+    void setForceErrorTolerance(double tolerance) { m_forceErrorTolerance = tolerance; }
     
     /**
      * Enable/disable collision prevention
      */
-    void setCollisionPrevention(bool enabled) { m_collisionPrevention = enabled; }
+    void setCollisionPrevention(bool enabled) {
+        m_collisionPrevention = enabled;
+        m_forcesCurrent = false;
+    }
     
     /**
      * Set minimum separation distance for collision prevention
      */
-    void setMinSeparation(double minSep) { m_minSeparation = minSep; }
+    void setMinSeparation(double minSep) {
+        m_minSeparation = minSep;
+        m_forcesCurrent = false;
+    }
+    
+    /**
+     * Set number of threads used by step() (0 = one per logical core, default)
+     * The pool is recreated on the next step.
+     */
+    void setThreadCount(size_t threadCount);
+    size_t getThreadCount() const;
+    
+    /**
+     * Pin worker threads to cores (Linux and Windows; off by default)
+     */
+    void setThreadPinning(bool enabled);
+    bool getThreadPinning() const { return m_pinThreads; }
+    
+    /**
+     * Thread pool used by step(), created on first use
+     * Shared with other per-frame work (e.g. field line tracing).
+     */
+    ThreadPool& getThreadPool();
+    
+    /**
+     * Complete simulation state at a step boundary
+     * 
+     * Everything step() reads or that affects later steps, so restoring a snapshot
+     * and stepping gives bitwise-identical results to the original run. Thread count
+     * and pinning are not included (results do not depend on them), nor is a
+     * user-defined external field function (set it again after restoring).
+     */
+    struct Snapshot {
+        std::vector<Particle> particles;          // Includes flags and history
+        std::vector<Particle> initialParticles;   // Target of reset()
+        IntegrationMethod integrationMethod = IntegrationMethod::VERLET;
+        ForceMethod forceMethod = ForceMethod::DIRECT;
+        bool collisionPrevention = true;
+        double minSeparation = 0.0;
+        uint64_t stepCount = 0;
+        double simulationTime = 0.0;
+        double treeOpeningAngle = 0.5;
+        double fmmOpeningAngle = 0.5;
+        int expansionOrder = 4;
+        int forceErrorSampleCount = 0;
+        int forceErrorSampleInterval = 1;
+        double forceErrorTolerance = 0.0;
+        ForceErrorStats forceErrorStats;
+        RetardedFieldSolver::History retardedHistory;  // Past states for the RETARDED method
+        size_t retardedHistoryFrames = RetardedFieldSolver::DEFAULT_HISTORY_FRAMES;
+        bool magneticInteraction = false;
+        bool forcesCurrent = false;   // Particle accelerations are the forces at their positions
+        TimeStepMode timeStepMode = TimeStepMode::FIXED;
+        double timeStepAccuracy = 0.02;
+        int maxTimeStepLevel = 10;
+        bool timeStepStateValid = false;                // Levels and previous accelerations
+        std::vector<uint8_t> timeStepLevels;
+        std::vector<glm::dvec3> previousAccelerations;  // At each particle's previous force evaluation
+        glm::dvec3 externalElectric = glm::dvec3(0.0);   // Uniform part only: a field
+        glm::dvec3 externalMagnetic = glm::dvec3(0.0);   // function cannot be saved
+        bool periodic = false;
+        glm::dvec3 periodicLow = glm::dvec3(0.0);
+        glm::dvec3 periodicHigh = glm::dvec3(1.0);
+        int meshSize = 0;
+        P3MSolver::Assignment chargeAssignment = P3MSolver::Assignment::TSC;
+        double shortRangeCutoff = 0.0;
+        double ewaldAccuracy = EwaldSolver::DEFAULT_ACCURACY;
+    };
+    
+    /**
+     * Copy the current state (call between steps, not during step())
+     */
+    Snapshot createSnapshot() const;
+    
+    /**
+     * Replace the current state with a snapshot
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
 
 private:
     std::vector<Particle> m_particles;
     std::vector<Particle> m_initialParticles;  // For reset
+    ParticleStore m_store;                      // SoA physics data (hot loop)
     
     IntegrationMethod m_integrationMethod;
+    ForceMethod m_forceMethod;
     bool m_collisionPrevention;
     double m_minSeparation;
+    size_t m_stepCount;
+    double m_simulationTime;
+    bool m_magneticInteraction;
+    bool m_forcesCurrent;           // Store accelerations match the current state (Verlet reuse)
+    uint64_t m_forcesFieldRevision; // External field revision they were computed with
+    bool m_forceErrorPending;       // Sample the force error at the next evaluation
+    size_t m_forceEvaluations;
+    size_t m_particleForceEvaluations;
+    
+    // Adaptive time stepping
+    TimeStepMode m_timeStepMode;
+    double m_timeStepAccuracy;
+    int m_maxTimeStepLevel;
+    bool m_timeStepStateValid;                      // Levels/accelerations belong to the current particles
+    std::vector<uint8_t> m_timeStepLevels;
+    std::vector<glm::dvec3> m_previousAccelerations;
+    std::vector<uint64_t> m_nextTicks;              // Block steps: end of each particle's substep
+    std::vector<size_t> m_activeParticles;          // Block steps: particles at the end of their substep
+    ExternalField m_externalField;
+    bool m_periodic;
+    PeriodicBox m_periodicBox;
+    
+    // Approximate force solver state
+    BarnesHutTree m_tree;
+    NeighborGrid m_neighborGrid;  // Pairs closer than m_minSeparation
+    FmmSolver m_fmm;
+    RetardedFieldSolver m_retarded;
+    P3MSolver m_p3m;
+    EwaldSolver m_ewald;
+    PeriodicBox::Images m_collisionImages;  // Collision prevention across periodic faces
+    ForceErrorStats m_forceErrorStats;
+    int m_forceErrorSampleCount;
+    int m_forceErrorSampleInterval;
+    double m_forceErrorTolerance;
+    
+    // Per-step scratch: currents q·v for the magnetic interaction, pairwise direct
+    // fields, fields for Boris, start state and weighted stage sums for RK4
+    ParticleStore::AlignedVector<double> m_currentX, m_currentY, m_currentZ;
+    std::vector<glm::dvec3> m_pairwiseFields;
+    bool m_pairwiseFieldsCurrent;                   // m_pairwiseFields belong to this evaluation
+    std::vector<glm::dvec3> m_electricFields;
+    std::vector<glm::dvec3> m_magneticFields;
+    std::vector<glm::dvec3> m_repulsionAccelerations;  // Collision prevention share, for Boris
+    std::vector<glm::dvec3> m_startPositions;
+    std::vector<glm::dvec3> m_startVelocities;
+    std::vector<glm::dvec3> m_positionSums;
+    std::vector<glm::dvec3> m_velocitySums;
+    
+    // Parallel execution
+    std::unique_ptr<ThreadPool> m_threadPool;
+    size_t m_threadCount;
+    bool m_pinThreads;
+    
+    /**
+     * Evaluate accelerations of movable particles at the current store state
+     * 
+     * @param time Time of the state (external fields, retarded fields)
+     * @param active Particles to evaluate (nullptr = all)
+     */
+    void computeForces(double time, const std::vector<size_t>* active = nullptr);
+    
+    /**
+     * One step of the integration method for all particles
+     * 
+     * @param forcesCurrent Store accelerations are the forces at the current state
+     */
+    void integrate(double dt, double time, bool forcesCurrent);
+    
+    /**
+     * GLOBAL and BLOCK time stepping over dt (see TimeStepMode)
+     * 
+     * @param stateValid Levels and previous accelerations belong to this state
+     */
+    void adaptiveStep(double dt, double time, bool forcesCurrent, bool stateValid);
+    void blockStep(double dt, double time, bool forcesCurrent, bool stateValid);
+    
+    /**
+     * Level a particle asks for from its last two accelerations, h apart
+     */
+    int desiredLevel(size_t index, double dt, double h) const;
+    
+    /**
+     * Next level after a substep ending at tick (of 2^maxLevel per step)
+     */
+    int nextLevel(int current, int desired, uint64_t tick) const;
+    
+    /**
+     * v += a h and x += v h for all movable particles (Verlet substeps)
+     */
+    void kick(double h);
+    void drift(double h);
+    
+    /**
+     * Classical RK4 step of all movable particles (four force evaluations)
+     */
+    void rungeKuttaStep(double dt, double time);
+    
+    /**
+     * Force method in effect (P3M and EWALD without a periodic box run as DIRECT)
+     */
+    ForceMethod effectiveForceMethod() const {
+        return isPeriodicMethod(m_forceMethod) && !m_periodic ? ForceMethod::DIRECT : m_forceMethod;
+    }
+    
+    /**
+     * Force methods that include the periodic images
+     */
+    static bool isPeriodicMethod(ForceMethod method) {
+        return method == ForceMethod::P3M || method == ForceMethod::EWALD;
+    }
+    
+    /**
+     * Wrap positions of movable particles into the periodic box
+     * 
+     * @return true if any particle moved
+     */
+    bool wrapPositions();
+    
+    /**
+     * Compute electric field at a particle using the current force method
+     */
+    glm::dvec3 computeField(size_t index) const;
+    
+    /**
+     * Compute magnetic field at a particle (moving charges and RETARDED method)
+     */
+    glm::dvec3 computeMagneticField(size_t index) const;
+    
+    /**
+     * Compute total E and B at a particle, including external fields
+     */
+    void computeTotalFields(size_t index, double time, glm::dvec3& E, glm::dvec3& B) const;
     
     /**
-     * Compute net force on a particle from all other particles
+     * Compare approximate fields against the direct sum for a sample of particles
      */
-    glm::dvec3 computeNetForce(const Particle& target) const;
+    void sampleForceError();
     
     /**
      * Apply collision prevention (soft repulsion)
+     * Close pairs come from a neighbor grid with cells of m_minSeparation (O(N)),
+     * built over periodic images near the faces in a periodic box.
+     *
+     * @param active If set, only these particles are pushed, from point queries
+     *               around each of them (block time step substeps)
      */
-    void applyCollisionPrevention();
+    void applyCollisionPrevention(const std::vector<size_t>* active = nullptr);
     
     /**
      * Clamp velocity to maximum allowed
@@ -0,0 +1,327 @@
+#include "SceneLoader.hpp"
+#include "engine/core/Logger.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+    // Read the numbers left on a line; false if any token is not a number
+    bool readNumbers(std::istringstream& in, std::vector<double>& values) {
+        std::string token;
+        while (in >> token) {
+            char* end = nullptr;
+            double value = std::strtod(token.c_str(), &end);
+            if (end == token.c_str() || *end != '\0') {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return true;
+    }
+
+    const char* const DIRECTIVES[] = {
+        "electron", "proton", "particle", "fixed", "cloud",
+        "force_method", "opening_angle", "expansion_order", "retarded_history", "integrator",
+        "collision_prevention", "min_separation", "electric_field", "magnetic_field", "magnetic_interaction",
+        "time_step", "time_step_accuracy", "max_time_step_level", "periodic_box", "mesh_size",
+        "short_range_cutoff", "ewald_accuracy"
+    };
+
+    bool isDirective(const std::string& keyword) {
+        for (const char* directive : DIRECTIVES) {
+            if (keyword == directive) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // True if nothing but whitespace is left on the line
+    bool atEnd(std::istringstream& in) {
+        std::string rest;
+        return !(in >> rest);
+    }
+
+    bool isCount(double value) {
+        return value >= 0.0 && value == std::floor(value);
+    }
+
+    bool parseSwitch(const std::string& word, bool& value) {
+        if (word == "on" || word == "true" || word == "1") {
+            value = true;
+            return true;
+        }
+        if (word == "off" || word == "false" || word == "0") {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    // Uniform random points in a ball, alternating charge sign
+    void appendCloud(
+        std::vector<Particle>& particles,
+        int count, double radius, double charge, double mass, unsigned seed
+    ) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        for (int i = 0; i < count; ++i) {
+            glm::dvec3 p;
+            do {
+                p = glm::dvec3(unit(rng), unit(rng), unit(rng));
+            } while (glm::dot(p, p) > 1.0);
+            double q = (i % 2 == 0) ? charge : -charge;
+            particles.push_back(Particle::createCustom(radius * p, q, mass));
+        }
+    }
+}
+
+bool SceneLoader::loadFile(const std::string& path, ParticleSystem& system, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = path + ": cannot open scene file";
+        return false;
+    }
+    return load(file, system, error, path);
+}
+
+bool SceneLoader::load(
+    std::istream& input,
+    ParticleSystem& system,
+    std::string& error,
+    const std::string& name
+) {
+    // Parse everything first so a malformed file leaves the system untouched
+    std::vector<Particle> particles;
+    std::vector<std::function<void(ParticleSystem&)>> settings;
+
+    std::string rawLine;
+    int lineNumber = 0;
+    while (std::getline(input, rawLine)) {
+        ++lineNumber;
+        auto fail = [&](const std::string& message) {
+            error = name + ":" + std::to_string(lineNumber) + ": " + message;
+            return false;
+        };
+
+        std::string line = rawLine.substr(0, rawLine.find('#'));
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword)) {
+            continue;  // Blank or comment line
+        }
+        if (!isDirective(keyword)) {
+            return fail("unknown directive '" + keyword + "'");
+        }
+
+        std::vector<double> v;
+        bool wordValued = keyword == "force_method" || keyword == "integrator" ||
+                          keyword == "collision_prevention" || keyword == "magnetic_interaction" ||
+                          keyword == "time_step";
+        if (!wordValued && !readNumbers(in, v)) {
+            return fail(keyword + " expects numeric arguments");
+        }
+
+        if (keyword == "electron" || keyword == "proton") {
+            if (v.size() != 3 && v.size() != 6) {
+                return fail(keyword + " expects x y z [vx vy vz]");
+            }
+            glm::dvec3 pos(v[0], v[1], v[2]);
+            Particle p = keyword == "electron" ? Particle::createElectron(pos) : Particle::createProton(pos);
+            if (v.size() == 6) {
+                p.velocity = glm::dvec3(v[3], v[4], v[5]);
+            }
+            particles.push_back(p);
+        } else if (keyword == "particle") {
+            if (v.size() != 8) {
+                return fail("particle expects x y z vx vy vz charge mass");
+            }
+            if (!(v[7] > 0.0)) {
+                return fail("particle mass must be positive");
+            }
+            Particle p = Particle::createCustom(glm::dvec3(v[0], v[1], v[2]), v[6], v[7]);
+            p.velocity = glm::dvec3(v[3], v[4], v[5]);
+            particles.push_back(p);
+        } else if (keyword == "fixed") {
+            if (v.size() != 4) {
+                return fail("fixed expects x y z charge");
+            }
+            Particle p = Particle::createCustom(glm::dvec3(v[0], v[1], v[2]), v[3], 1.0);
+            p.isFixed = true;
+            particles.push_back(p);
+        } else if (keyword == "cloud") {
+            if ((v.size() != 4 && v.size() != 5) || !isCount(v[0]) || !(v[1] > 0.0) || !(v[3] > 0.0) ||
+                (v.size() == 5 && !isCount(v[4]))) {
+                return fail("cloud expects count radius charge mass [seed] (count, radius and mass positive)");
+            }
+            unsigned seed = v.size() == 5 ? static_cast<unsigned>(v[4]) : 1u;
+            appendCloud(particles, static_cast<int>(v[0]), v[1], v[2], v[3], seed);
+        } else if (keyword == "force_method") {
+            std::string method;
+            in >> method;
+            ParticleSystem::ForceMethod value;
+            if (!atEnd(in)) {
+                return fail("force_method expects one value");
+            }
+            if (method == "direct") {
+                value = ParticleSystem::ForceMethod::DIRECT;
+            } else if (method == "barnes_hut") {
+                value = ParticleSystem::ForceMethod::BARNES_HUT;
+            } else if (method == "fmm") {
+                value = ParticleSystem::ForceMethod::FMM;
+            } else if (method == "retarded") {
+                value = ParticleSystem::ForceMethod::RETARDED;
+            } else if (method == "p3m") {
+                value = ParticleSystem::ForceMethod::P3M;
+            } else if (method == "ewald") {
+                value = ParticleSystem::ForceMethod::EWALD;
+            } else {
+                return fail("force_method must be direct, barnes_hut, fmm, retarded, p3m or ewald");
+            }
+            settings.push_back([value](ParticleSystem& s) { s.setForceMethod(value); });
+        } else if (keyword == "opening_angle") {
+            if (v.size() != 1 || !(v[0] > 0.0)) {
+                return fail("opening_angle expects a positive number");
+            }
+            double theta = v[0];
+            settings.push_back([theta](ParticleSystem& s) { s.setOpeningAngle(theta); });
+        } else if (keyword == "expansion_order") {
+            if (v.size() != 1 || !isCount(v[0]) || v[0] < 1.0 || v[0] > FmmSolver::MAX_ORDER) {
+                return fail("expansion_order expects an integer from 1 to " +
+                            std::to_string(FmmSolver::MAX_ORDER));
+            }
+            int order = static_cast<int>(v[0]);
+            settings.push_back([order](ParticleSystem& s) { s.setExpansionOrder(order); });
+        } else if (keyword == "retarded_history") {
+            if (v.size() != 1 || !isCount(v[0]) || v[0] < 2.0) {
+                return fail("retarded_history expects a frame count of at least 2");
+            }
+            size_t frames = static_cast<size_t>(v[0]);
+            settings.push_back([frames](ParticleSystem& s) { s.setRetardedHistoryFrames(frames); });
+        } else if (keyword == "integrator") {
+            std::string method;
+            in >> method;
+            ParticleSystem::IntegrationMethod value;
+            if (!atEnd(in)) {
+                return fail("integrator expects one value");
+            }
+            if (method == "verlet") {
+                value = ParticleSystem::IntegrationMethod::VERLET;
+            } else if (method == "euler") {
+                value = ParticleSystem::IntegrationMethod::EULER;
+            } else if (method == "boris") {
+                value = ParticleSystem::IntegrationMethod::BORIS;
+            } else if (method == "yoshida4") {
+                value = ParticleSystem::IntegrationMethod::YOSHIDA4;
+            } else if (method == "rk4") {
+                value = ParticleSystem::IntegrationMethod::RK4;
+            } else {
+                return fail("integrator must be verlet, euler, boris, yoshida4 or rk4");
+            }
+            settings.push_back([value](ParticleSystem& s) { s.setIntegrationMethod(value); });
+        } else if (keyword == "collision_prevention") {
+            std::string word;
+            bool enabled;
+            if (!(in >> word) || !parseSwitch(word, enabled) || !atEnd(in)) {
+                return fail("collision_prevention must be on or off");
+            }
+            settings.push_back([enabled](ParticleSystem& s) { s.setCollisionPrevention(enabled); });
+        } else if (keyword == "min_separation") {
+            if (v.size() != 1 || !(v[0] >= 0.0)) {
+                return fail("min_separation expects a non-negative number");
+            }
+            double distance = v[0];
+            settings.push_back([distance](ParticleSystem& s) { s.setMinSeparation(distance); });
+        } else if (keyword == "electric_field" || keyword == "magnetic_field") {
+            if (v.size() != 3) {
+                return fail(keyword + " expects x y z components");
+            }
+            glm::dvec3 field(v[0], v[1], v[2]);
+            if (keyword == "electric_field") {
+                settings.push_back([field](ParticleSystem& s) { s.getExternalField().setUniformElectric(field); });
+            } else {
+                settings.push_back([field](ParticleSystem& s) { s.getExternalField().setUniformMagnetic(field); });
+            }
+        } else if (keyword == "magnetic_interaction") {
+            std::string word;
+            bool enabled;
+            if (!(in >> word) || !parseSwitch(word, enabled) || !atEnd(in)) {
+                return fail("magnetic_interaction must be on or off");
+            }
+            settings.push_back([enabled](ParticleSystem& s) { s.setMagneticInteraction(enabled); });
+        } else if (keyword == "time_step") {
+            std::string mode;
+            in >> mode;
+            ParticleSystem::TimeStepMode value;
+            if (!atEnd(in)) {
+                return fail("time_step expects one value");
+            }
+            if (mode == "fixed") {
+                value = ParticleSystem::TimeStepMode::FIXED;
+            } else if (mode == "global") {
+                value = ParticleSystem::TimeStepMode::GLOBAL;
+            } else if (mode == "block") {
+                value = ParticleSystem::TimeStepMode::BLOCK;
+            } else {
+                return fail("time_step must be fixed, global or block");
+            }
+            settings.push_back([value](ParticleSystem& s) { s.setTimeStepMode(value); });
+        } else if (keyword == "time_step_accuracy") {
+            if (v.size() != 1 || !(v[0] > 0.0)) {
+                return fail("time_step_accuracy expects a positive number");
+            }
+            double eta = v[0];
+            settings.push_back([eta](ParticleSystem& s) { s.setTimeStepAccuracy(eta); });
+        } else if (keyword == "max_time_step_level") {
+            if (v.size() != 1 || !isCount(v[0]) || v[0] > ParticleSystem::MAX_TIME_STEP_LEVEL) {
+                return fail("max_time_step_level expects an integer from 0 to " +
+                            std::to_string(ParticleSystem::MAX_TIME_STEP_LEVEL));
+            }
+            int level = static_cast<int>(v[0]);
+            settings.push_back([level](ParticleSystem& s) { s.setMaxTimeStepLevel(level); });
+        } else if (keyword == "periodic_box") {
+            if (v.size() != 6) {
+                return fail("periodic_box expects low x y z and high x y z corners");
+            }
+            glm::dvec3 low(v[0], v[1], v[2]);
+            glm::dvec3 high(v[3], v[4], v[5]);
+            if (!PeriodicBox(low, high).isValid()) {
+                return fail("periodic_box sides must be positive");
+            }
+            settings.push_back([low, high](ParticleSystem& s) { s.setPeriodicBox(low, high); });
+        } else if (keyword == "mesh_size") {
+            if (v.size() != 1 || !isCount(v[0]) || v[0] > P3MSolver::MAX_MESH_SIZE) {
+                return fail("mesh_size expects an integer from 0 (automatic) to " +
+                            std::to_string(P3MSolver::MAX_MESH_SIZE));
+            }
+            int nodes = static_cast<int>(v[0]);
+            settings.push_back([nodes](ParticleSystem& s) { s.setMeshSize(nodes); });
+        } else if (keyword == "short_range_cutoff") {
+            if (v.size() != 1 || !(v[0] >= 0.0)) {
+                return fail("short_range_cutoff expects a non-negative number");
+            }
+            double cutoff = v[0];
+            settings.push_back([cutoff](ParticleSystem& s) { s.setShortRangeCutoff(cutoff); });
+        } else if (keyword == "ewald_accuracy") {
+            if (v.size() != 1 || !(v[0] >= EwaldSolver::MIN_ACCURACY && v[0] <= EwaldSolver::MAX_ACCURACY)) {
+                return fail("ewald_accuracy expects a relative error from 1e-12 to 1e-2");
+            }
+            double accuracy = v[0];
+            settings.push_back([accuracy](ParticleSystem& s) { s.setEwaldAccuracy(accuracy); });
+        }
+    }
+
+    for (const auto& apply : settings) {
+        apply(system);
+    }
+    for (const auto& p : particles) {
+        system.addParticle(p);
+    }
+
+    LOG_INFO("Loaded scene " + name + ": " + std::to_string(particles.size()) + " particles");
+    return true;
+}
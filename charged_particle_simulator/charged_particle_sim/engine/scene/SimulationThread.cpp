@@ -0,0 +1,178 @@
+#include "SimulationThread.hpp"
+#include "engine/core/Logger.hpp"
+#include <algorithm>
+#include <sstream>
+
+SimulationThread::SimulationThread(ParticleSystem& system)
+    : m_system(system)
+    , m_dt(1e-9)
+    , m_substepsPerFrame(1)
+    , m_frameInterval(1.0 / 60.0)
+    , m_stop(false)
+    , m_paused(false)
+    , m_frames(0)
+    , m_droppedFrames(0)
+    , m_stepsPerSecond(0.0)
+{
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+    m_stop = false;
+
+    // The render thread has something to draw before the first frame
+    publish();
+    m_thread = std::thread(&SimulationThread::run, this);
+    std::ostringstream message;
+    message << "Simulation thread started (dt=" << m_dt << " s, " << m_substepsPerFrame << " steps per frame)";
+    LOG_INFO(message.str());
+}
+
+void SimulationThread::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+
+    // Commands posted after the last frame still apply
+    runCommands();
+}
+
+void SimulationThread::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = paused;
+    }
+    m_wake.notify_all();
+}
+
+void SimulationThread::post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_commands.push_back(std::move(command));
+    }
+    m_wake.notify_all();
+}
+
+const SimulationThread::State& SimulationThread::acquireState() {
+    m_states.acquire();
+    return m_states.front();
+}
+
+SimulationThread::Stats SimulationThread::getStats() const {
+    Stats stats;
+    stats.frames = m_frames;
+    stats.droppedFrames = m_droppedFrames;
+    stats.stepsPerSecond = m_stepsPerSecond;
+    return stats;
+}
+
+void SimulationThread::run() {
+    double accumulator = 0.0;
+    Clock::time_point last = Clock::now();
+    Clock::time_point rateStart = last;
+    size_t rateSteps = 0;
+
+    while (true) {
+        const double interval = m_frameInterval;
+        bool wasPaused;
+        {
+            // Sleep until the next frame is due, a command arrives or we are stopped
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto ready = [this] { return m_stop || !m_commands.empty(); };
+            wasPaused = m_paused;
+            if (wasPaused) {
+                m_wake.wait(lock, [this, &ready] { return ready() || !m_paused; });
+            } else if (interval > 0.0 && accumulator < interval) {
+                auto wait = std::chrono::duration<double>(interval - accumulator);
+                m_wake.wait_for(lock, wait, ready);
+            }
+            if (m_stop) {
+                return;
+            }
+        }
+
+        bool changed = runCommands();
+
+        Clock::time_point now = Clock::now();
+        // Time spent paused is not owed to the simulation
+        double elapsed = wasPaused ? 0.0 : std::chrono::duration<double>(now - last).count();
+        last = now;
+
+        int frames = 0;
+        if (m_paused) {
+            accumulator = 0.0;
+        } else if (interval > 0.0) {
+            // Fixed-timestep accumulator: whole frames only, bounded catch-up
+            accumulator += elapsed;
+            frames = static_cast<int>(accumulator / interval);
+            if (frames > MAX_CATCH_UP_FRAMES) {
+                m_droppedFrames += static_cast<uint64_t>(frames - MAX_CATCH_UP_FRAMES);
+                frames = MAX_CATCH_UP_FRAMES;
+                accumulator = 0.0;
+            } else {
+                accumulator -= frames * interval;
+            }
+        } else {
+            frames = 1;
+        }
+
+        const double dt = m_dt;
+        const int substeps = m_substepsPerFrame;
+        for (int f = 0; f < frames; ++f) {
+            for (int s = 0; s < substeps; ++s) {
+                m_system.step(dt);
+            }
+            ++m_frames;
+            rateSteps += static_cast<size_t>(substeps);
+        }
+
+        if (frames > 0 || changed) {
+            publish();
+        }
+
+        double rateSeconds = std::chrono::duration<double>(Clock::now() - rateStart).count();
+        if (rateSeconds >= 1.0) {
+            m_stepsPerSecond = static_cast<double>(rateSteps) / rateSeconds;
+            rateSteps = 0;
+            rateStart = Clock::now();
+        }
+    }
+}
+
+bool SimulationThread::runCommands() {
+    std::vector<Command> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        commands.swap(m_commands);
+    }
+    for (const Command& command : commands) {
+        command(m_system);
+    }
+    return !commands.empty();
+}
+
+void SimulationThread::publish() {
+    // Reuse the slot's storage; history is not needed for drawing or field lines
+    State& state = m_states.back();
+    const std::vector<Particle>& particles = m_system.getParticles();
+    state.particles.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        state.particles[i].copyStateFrom(particles[i]);
+    }
+    state.stepCount = m_system.getStepCount();
+    state.simulationTime = m_system.getSimulationTime();
+    state.frame = m_frames;
+    m_states.publish();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ParticleSystem.hpp"
+#include "engine/core/TripleBuffer.hpp"
+
+/**
+ * Simulation Thread
+ *
+ * Advances a ParticleSystem on its own thread at a fixed time step, decoupled
+ * from rendering. Wall-clock time is accumulated and spent in frames of
+ * `substepsPerFrame` steps of dt, one frame per `frameInterval` seconds (a
+ * fixed-timestep accumulator), so simulated time advances at a steady rate
+ * whatever the render loop's frame rate. If physics falls behind, at most
+ * MAX_CATCH_UP_FRAMES frames are run back to back and the rest of the backlog is
+ * dropped instead of spiralling. A frame interval of 0 runs frames back to back.
+ *
+ * After every frame the particle state (without history) is published through a
+ * lock-free triple buffer. The render thread calls acquireState() and draws the
+ * newest published state; neither thread ever blocks the other, so vsync does
+ * not limit physics throughput and a slow render cannot stall it.
+ *
+ * While the thread runs, the system belongs to it. Other threads change it only
+ * through post(), whose commands run between frames.
+ */
+class SimulationThread {
+public:
+    static constexpr int MAX_CATCH_UP_FRAMES = 4;
+
+    /**
+     * Published state: read-only for the render thread
+     */
+    struct State {
+        std::vector<Particle> particles;  // Without history
+        size_t stepCount = 0;
+        double simulationTime = 0.0;
+        uint64_t frame = 0;               // Frames simulated before this state
+    };
+
+    /**
+     * Simulation statistics (approximate while running)
+     */
+    struct Stats {
+        uint64_t frames = 0;          // Frames simulated
+        uint64_t droppedFrames = 0;   // Backlog discarded after falling behind
+        double stepsPerSecond = 0.0;  // Wall-clock step rate over the last second
+    };
+
+    using Command = std::function<void(ParticleSystem&)>;
+
+    explicit SimulationThread(ParticleSystem& system);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * Step settings (take effect at the next frame)
+     *
+     * @param dt Simulated time per step
+     * @param substepsPerFrame Steps per published frame
+     * @param frameInterval Wall-clock seconds per frame (0 = as fast as possible)
+     */
+    void setTimeStep(double dt) { m_dt = dt; }
+    double getTimeStep() const { return m_dt; }
+    void setSubstepsPerFrame(int substeps) { m_substepsPerFrame = substeps < 1 ? 1 : substeps; }
+    int getSubstepsPerFrame() const { return m_substepsPerFrame; }
+    void setFrameInterval(double seconds) { m_frameInterval = seconds > 0.0 ? seconds : 0.0; }
+    double getFrameInterval() const { return m_frameInterval; }
+
+    /**
+     * Start or stop the thread (the initial state is published by start())
+     */
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * Pause stepping (commands still run and publish their result)
+     */
+    void setPaused(bool paused);
+    bool isPaused() const { return m_paused; }
+
+    /**
+     * Run a command on the simulation thread between frames (e.g. dragging,
+     * adding particles, settings). The result appears in the next published state.
+     */
+    void post(Command command);
+
+    /**
+     * Render thread: newest published state (valid until the next call)
+     */
+    const State& acquireState();
+
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    bool runCommands();
+    void publish();
+
+    ParticleSystem& m_system;
+    std::atomic<double> m_dt;
+    std::atomic<int> m_substepsPerFrame;
+    std::atomic<double> m_frameInterval;
+
+    std::thread m_thread;
+    std::mutex m_mutex;                 // Guards commands and wake-up state
+    std::condition_variable m_wake;
+    std::vector<Command> m_commands;
+    bool m_stop;
+    std::atomic<bool> m_paused;
+
+    TripleBuffer<State> m_states;
+
+    std::atomic<uint64_t> m_frames;
+    std::atomic<uint64_t> m_droppedFrames;
+    std::atomic<double> m_stepsPerSecond;
+};
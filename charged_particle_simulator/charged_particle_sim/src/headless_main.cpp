@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "engine/core/Logger.hpp"
+#include "engine/io/Checkpoint.hpp"
+#include "engine/io/TrajectoryWriter.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+#include "engine/scene/SceneLoader.hpp"
+
+/**
+ * Headless batch driver
+ *
+ * Runs ParticleSystem::step at full speed without a window or OpenGL context,
+ * for offline runs on machines without a display or GPU.
+ *
+ * Usage: ChargedParticleSimHeadless <scene-file> [options]
+ *        ChargedParticleSimHeadless --restart <checkpoint> [options]
+ *   --dt <seconds>         Time step (default 1e-9)
+ *   --steps <n>            Total number of steps, including restored ones (default 1000)
+ *   --output-every <n>     Write a snapshot every n steps (default 0 = off)
+ *   --output <file>        Snapshot file (default trajectory.cpstraj / trajectory.csv)
+ *   --format <f>           binary (float64), binary32 (float32) or csv (default binary)
+ *   --drop-frames          Drop binary snapshots while the disk is behind instead of waiting
+ *   --threads <n>          Worker threads (default 0 = one per logical core)
+ *   --force-method <m>     direct, barnes_hut, fmm, retarded, p3m or ewald (overrides the scene)
+ *   --time-step <mode>     fixed, global or block (adaptive substeps, overrides the scene)
+ *   --log-level <level>    debug, info, warn or error (default warn)
+ *   --checkpoint <file>    Checkpoint file, written periodically and at the end
+ *   --checkpoint-every <s> Wall-clock seconds between checkpoints (default 60)
+ *   --restart <file>       Resume from a checkpoint instead of a scene
+ *
+ * Steps per second are measured over step() calls only; snapshot output is timed
+ * separately. Binary snapshots go through the streaming TrajectoryWriter, so the
+ * step loop only pays for packing the frame, not for the disk write; it waits only
+ * when every buffer is queued for the disk (or drops the frame with --drop-frames,
+ * which a complete trajectory must not use). Checkpoints
+ * likewise only copy the state between steps; CheckpointWriter does the write.
+ */
+
+namespace {
+    struct Options {
+        std::string scenePath;
+        double dt = 1e-9;
+        long long steps = 1000;
+        long long outputEvery = 0;
+        std::string outputPath;
+        std::string format = "binary";
+        bool dropFrames = false;
+        long long threads = 0;
+        std::string forceMethod;
+        std::string timeStepMode;
+        LogLevel logLevel = LogLevel::WARN;
+        std::string checkpointPath;
+        double checkpointEvery = 60.0;
+        std::string restartPath;
+    };
+
+    void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " <scene-file> [options]\n"
+                  << "       " << program << " --restart <checkpoint> [options]\n"
+                  << "  --dt <seconds>         Time step (default 1e-9)\n"
+                  << "  --steps <n>            Total number of steps, including restored ones (default 1000)\n"
+                  << "  --output-every <n>     Write a snapshot every n steps (default 0 = off)\n"
+                  << "  --output <file>        Snapshot file (default trajectory.cpstraj / trajectory.csv)\n"
+                  << "  --format <f>           binary (float64), binary32 (float32) or csv (default binary)\n"
+                  << "  --drop-frames          Drop binary snapshots while the disk is behind instead of waiting\n"
+                  << "  --threads <n>          Worker threads (default 0 = one per logical core)\n"
+                  << "  --force-method <m>     direct, barnes_hut, fmm, retarded, p3m or ewald (overrides the scene)\n"
+                  << "  --time-step <mode>     fixed, global or block (adaptive substeps, overrides the scene)\n"
+                  << "  --log-level <level>    debug, info, warn or error (default warn)\n"
+                  << "  --checkpoint <file>    Checkpoint file, written periodically and at the end\n"
+                  << "  --checkpoint-every <s> Wall-clock seconds between checkpoints (default 60)\n"
+                  << "  --restart <file>       Resume from a checkpoint instead of a scene\n";
+    }
+
+    bool parseNumber(const std::string& text, double& value) {
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end != text.c_str() && *end == '\0';
+    }
+
+    bool parseCount(const std::string& text, long long& value) {
+        char* end = nullptr;
+        value = std::strtoll(text.c_str(), &end, 10);
+        return end != text.c_str() && *end == '\0' && value >= 0;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            }
+            if (arg.rfind("--", 0) != 0) {
+                if (!options.scenePath.empty()) {
+                    std::cerr << "Unexpected argument: " << arg << std::endl;
+                    return false;
+                }
+                options.scenePath = arg;
+                continue;
+            }
+            if (arg == "--drop-frames") {
+                options.dropFrames = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            std::string value = argv[++i];
+            bool ok = true;
+            if (arg == "--dt") {
+                ok = parseNumber(value, options.dt) && options.dt > 0.0;
+            } else if (arg == "--steps") {
+                ok = parseCount(value, options.steps);
+            } else if (arg == "--output-every") {
+                ok = parseCount(value, options.outputEvery);
+            } else if (arg == "--output") {
+                options.outputPath = value;
+            } else if (arg == "--format") {
+                options.format = value;
+                ok = value == "binary" || value == "binary32" || value == "csv";
+            } else if (arg == "--threads") {
+                ok = parseCount(value, options.threads);
+            } else if (arg == "--force-method") {
+                options.forceMethod = value;
+                ok = value == "direct" || value == "barnes_hut" || value == "fmm" || value == "retarded" ||
+                     value == "p3m" || value == "ewald";
+            } else if (arg == "--time-step") {
+                options.timeStepMode = value;
+                ok = value == "fixed" || value == "global" || value == "block";
+            } else if (arg == "--checkpoint") {
+                options.checkpointPath = value;
+            } else if (arg == "--checkpoint-every") {
+                ok = parseNumber(value, options.checkpointEvery) && options.checkpointEvery >= 0.0;
+            } else if (arg == "--restart") {
+                options.restartPath = value;
+            } else if (arg == "--log-level") {
+                if (value == "debug") {
+                    options.logLevel = LogLevel::DEBUG;
+                } else if (value == "info") {
+                    options.logLevel = LogLevel::INFO;
+                } else if (value == "warn") {
+                    options.logLevel = LogLevel::WARN;
+                } else if (value == "error") {
+                    options.logLevel = LogLevel::ERROR;
+                } else {
+                    ok = false;
+                }
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+            if (!ok) {
+                std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+                return false;
+            }
+        }
+        if (options.scenePath.empty() == options.restartPath.empty()) {
+            std::cerr << "Expected either a scene file or --restart" << std::endl;
+            return false;
+        }
+        if (options.outputPath.empty()) {
+            options.outputPath = options.format == "csv" ? "trajectory.csv" : "trajectory.cpstraj";
+        }
+        return true;
+    }
+
+    void writeCsvSnapshot(std::ofstream& out, long long step, double time, const ParticleSystem& system) {
+        const auto& particles = system.getParticles();
+        for (size_t i = 0; i < particles.size(); ++i) {
+            const Particle& p = particles[i];
+            out << step << ',' << time << ',' << i << ','
+                << p.position.x << ',' << p.position.y << ',' << p.position.z << ','
+                << p.velocity.x << ',' << p.velocity.y << ',' << p.velocity.z << '\n';
+        }
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Logger::initialize("logs/headless.log", options.logLevel);
+
+    ParticleSystem system;
+    std::string error;
+    bool loaded = options.restartPath.empty()
+        ? SceneLoader::loadFile(options.scenePath, system, error)
+        : Checkpoint::load(options.restartPath, system, error);
+    if (!loaded) {
+        LOG_ERROR(error);
+        Logger::shutdown();
+        return 1;
+    }
+
+    if (options.forceMethod == "direct") {
+        system.setForceMethod(ParticleSystem::ForceMethod::DIRECT);
+    } else if (options.forceMethod == "barnes_hut") {
+        system.setForceMethod(ParticleSystem::ForceMethod::BARNES_HUT);
+    } else if (options.forceMethod == "fmm") {
+        system.setForceMethod(ParticleSystem::ForceMethod::FMM);
+    } else if (options.forceMethod == "retarded") {
+        system.setForceMethod(ParticleSystem::ForceMethod::RETARDED);
+    } else if (options.forceMethod == "p3m") {
+        system.setForceMethod(ParticleSystem::ForceMethod::P3M);
+    } else if (options.forceMethod == "ewald") {
+        system.setForceMethod(ParticleSystem::ForceMethod::EWALD);
+    }
+    if (options.timeStepMode == "fixed") {
+        system.setTimeStepMode(ParticleSystem::TimeStepMode::FIXED);
+    } else if (options.timeStepMode == "global") {
+        system.setTimeStepMode(ParticleSystem::TimeStepMode::GLOBAL);
+    } else if (options.timeStepMode == "block") {
+        system.setTimeStepMode(ParticleSystem::TimeStepMode::BLOCK);
+    }
+    system.setThreadCount(static_cast<size_t>(options.threads));
+
+    // Restored runs continue numbering from the checkpoint
+    const long long firstStep = static_cast<long long>(system.getStepCount()) + 1;
+
+    // Snapshot output: streaming binary trajectory or CSV text
+    const bool csv = options.format == "csv";
+    std::ofstream csvOutput;
+    TrajectoryWriter trajectory;
+    auto writeSnapshot = [&](long long step, double time) {
+        if (csv) {
+            writeCsvSnapshot(csvOutput, step, time, system);
+        } else {
+            trajectory.writeFrame(system.getParticles(), static_cast<uint64_t>(step), time);
+        }
+    };
+
+    if (options.outputEvery > 0) {
+        bool opened;
+        if (csv) {
+            csvOutput.open(options.outputPath);
+            opened = static_cast<bool>(csvOutput);
+            csvOutput << std::setprecision(17);
+            csvOutput << "step,time,particle,x,y,z,vx,vy,vz\n";
+        } else {
+            // Offline runs want every frame: wait for the disk unless told otherwise
+            TrajectoryWriter::Options trajectoryOptions;
+            trajectoryOptions.blockWhenFull = !options.dropFrames;
+            if (options.format == "binary32") {
+                trajectoryOptions.precision = TrajectoryWriter::Precision::FLOAT32;
+            }
+            opened = trajectory.open(options.outputPath, system.getParticles(), options.dt, trajectoryOptions);
+        }
+        if (!opened) {
+            LOG_ERROR("Cannot open output file " + options.outputPath);
+            Logger::shutdown();
+            return 1;
+        }
+        writeSnapshot(firstStep - 1, system.getSimulationTime());
+    }
+
+    const std::string& source = options.restartPath.empty() ? options.scenePath : options.restartPath;
+    std::cout << "Scene: " << source << " (" << system.getParticleCount() << " particles)\n"
+              << "dt: " << options.dt << " s, steps: " << options.steps
+              << ", threads: " << system.getThreadCount() << std::endl;
+    if (firstStep > 1) {
+        std::cout << "Resuming at step " << firstStep - 1 << " (t = " << system.getSimulationTime() << " s)" << std::endl;
+    }
+
+    // Checkpoints: state copied at a step boundary, written in the background
+    CheckpointWriter checkpoints;
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    double stepSeconds = 0.0;
+    double outputSeconds = 0.0;
+    auto runStart = std::chrono::steady_clock::now();
+
+    for (long long step = firstStep; step <= options.steps; ++step) {
+        auto start = std::chrono::steady_clock::now();
+        system.step(options.dt);
+        stepSeconds += secondsSince(start);
+
+        if (options.outputEvery > 0 && step % options.outputEvery == 0) {
+            start = std::chrono::steady_clock::now();
+            writeSnapshot(step, system.getSimulationTime());
+            outputSeconds += secondsSince(start);
+
+            std::cout << "step " << step << "/" << options.steps << "  "
+                      << std::fixed << std::setprecision(1) << (step - firstStep + 1) / stepSeconds << " steps/s"
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+
+        if (!options.checkpointPath.empty() && secondsSince(lastCheckpoint) >= options.checkpointEvery) {
+            start = std::chrono::steady_clock::now();
+            checkpoints.save(system, options.checkpointPath);
+            outputSeconds += secondsSince(start);
+            lastCheckpoint = std::chrono::steady_clock::now();
+        }
+    }
+    const long long stepsRun = std::max(0LL, options.steps - firstStep + 1);
+
+    // Flushing the remaining frames counts as output time
+    auto flushStart = std::chrono::steady_clock::now();
+    bool outputOk = true;
+    if (csvOutput.is_open()) {
+        csvOutput.close();
+        outputOk = !csvOutput.fail();
+    }
+    TrajectoryWriter::Stats trajectoryStats = trajectory.getStats();
+    if (trajectory.isOpen()) {
+        outputOk = trajectory.close();
+        trajectoryStats = trajectory.getStats();
+    }
+    if (!options.checkpointPath.empty()) {
+        checkpoints.save(system, options.checkpointPath);
+        outputOk = checkpoints.wait() && outputOk;
+    }
+    outputSeconds += secondsSince(flushStart);
+    double totalSeconds = secondsSince(runStart);
+
+    double stepsPerSecond = stepSeconds > 0.0 ? stepsRun / stepSeconds : 0.0;
+    std::cout << "Simulated " << stepsRun << " steps (" << stepsRun * options.dt << " s) in "
+              << totalSeconds << " s\n"
+              << "  step time:   " << stepSeconds << " s (" << stepsPerSecond << " steps/s, "
+              << stepsPerSecond * static_cast<double>(system.getParticleCount()) << " particle-steps/s)\n"
+              << "  output time: " << outputSeconds << " s" << std::endl;
+    if (stepsRun > 0 && system.getParticleCount() > 0) {
+        std::cout << "  forces:      " << system.getParticleForceEvaluationCount() << " particle evaluations ("
+                  << static_cast<double>(system.getParticleForceEvaluationCount()) /
+                     (static_cast<double>(stepsRun) * static_cast<double>(system.getParticleCount()))
+                  << " per particle-step)" << std::endl;
+    }
+    if (!csv && options.outputEvery > 0) {
+        std::cout << "  trajectory:  " << trajectoryStats.framesWritten << " frames, "
+                  << trajectoryStats.bytesWritten << " bytes, "
+                  << trajectoryStats.framesDropped << " dropped" << std::endl;
+    }
+    if (!options.checkpointPath.empty()) {
+        std::cout << "  checkpoint:  " << options.checkpointPath << " (" << checkpoints.getWrittenCount()
+                  << " written)" << std::endl;
+    }
+
+    Logger::shutdown();
+    return outputOk ? 0 : 1;
+}
@@ -2,6 +2,8 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <memory>
+#include <string>
 #include <vector>
 #include <iostream>
 
@@ -9,19 +11,29 @@
 #include "engine/core/Constants.hpp"
 #include "engine/interaction/Camera.hpp"
 #include "engine/physics/Particle.hpp"
-#include "engine/physics/ElectricField.hpp"
+#include "engine/physics/FieldLineManager.hpp"
 #include "engine/render/ParticleRenderer.hpp"
+#include "engine/render/FieldLineRenderer.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+#include "engine/scene/SimulationThread.hpp"
 
 // Global state
 Camera camera;
 ParticleRenderer particleRenderer;
-std::vector<Particle> particles;
+FieldLineRenderer fieldLineRenderer;
+std::unique_ptr<SimulationThread> simulation;
 bool simulationRunning = true;
 
 // Window dimensions
 const int WINDOW_WIDTH = 1280;
 const int WINDOW_HEIGHT = 720;
 
+// Physics runs at a fixed step on its own thread: SUBSTEPS_PER_FRAME steps of
+// TIME_STEP every FRAME_INTERVAL of wall-clock time, independent of the frame rate
+const double TIME_STEP = 1e-4;
+const int SUBSTEPS_PER_FRAME = 40;
+const double FRAME_INTERVAL = 1.0 / 60.0;
+
 // GLFW callbacks
 void setupCallbacks(GLFWwindow* window) {
     glfwSetWindowUserPointer(window, &camera);
@@ -50,6 +62,7 @@ void setupCallbacks(GLFWwindow* window) {
                 glfwSetWindowShouldClose(win, GL_TRUE);
             } else if (key == GLFW_KEY_SPACE) {
                 simulationRunning = !simulationRunning;
+                simulation->setPaused(!simulationRunning);
                 LOG_INFO(simulationRunning ? "Simulation resumed" : "Simulation paused");
             }
         }
@@ -98,25 +111,33 @@ int main() {
     setupCallbacks(window);
     
     // Initialize renderer
-    if (!particleRenderer.initialize()) {
-        LOG_ERROR("Failed to initialize ParticleRenderer");
+    if (!particleRenderer.initialize() || !fieldLineRenderer.initialize()) {
+        LOG_ERROR("Failed to initialize renderers");
         glfwTerminate();
         return -1;
     }
     
     // Create test particles
-    particles.push_back(Particle::createElectron(glm::dvec3(-1.0, 0.0, 0.0)));
-    particles.push_back(Particle::createProton(glm::dvec3(1.0, 0.0, 0.0)));
+    ParticleSystem system;
+    system.addParticle(Particle::createElectron(glm::dvec3(-1.0, 0.0, 0.0)));
+    system.addParticle(Particle::createProton(glm::dvec3(1.0, 0.0, 0.0)));
+    
+    LOG_INFO("Created " + std::to_string(system.getParticleCount()) + " test particles");
     
-    LOG_INFO("Created " + std::to_string(particles.size()) + " test particles");
+    simulation = std::make_unique<SimulationThread>(system);
+    simulation->setTimeStep(TIME_STEP);
+    simulation->setSubstepsPerFrame(SUBSTEPS_PER_FRAME);
+    simulation->setFrameInterval(FRAME_INTERVAL);
+    simulation->start();
     
-    // Main loop
-    double lastTime = glfwGetTime();
+    // Field lines trace in the background from the published states
+    FieldLineManager fieldLines;
+    FieldLineConfig fieldLineConfig;
+    fieldLines.setAsync(true);
     
+    // Main loop: draws the newest published state, never waits for physics
     while (!glfwWindowShouldClose(window)) {
-        double currentTime = glfwGetTime();
-        double deltaTime = currentTime - lastTime;
-        lastTime = currentTime;
+        const SimulationThread::State& state = simulation->acquireState();
         
         // Clear screen
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
@@ -134,8 +155,10 @@ int main() {
             1000.0f
         );
         
-        // Render particles
-        particleRenderer.render(particles, view, projection);
+        // Render field lines and particles
+        const std::vector<FieldLine>& lines = fieldLines.getFieldLines(state.particles, fieldLineConfig);
+        fieldLineRenderer.render(lines, view, projection, glfwGetTime());
+        particleRenderer.render(state.particles, view, projection);
         
         // Swap buffers and poll events
         glfwSwapBuffers(window);
@@ -143,6 +166,9 @@ int main() {
     }
     
     // Cleanup
+    simulation->stop();
+    simulation.reset();
+    fieldLineRenderer.cleanup();
     particleRenderer.cleanup();
     glfwDestroyWindow(window);
     glfwTerminate();
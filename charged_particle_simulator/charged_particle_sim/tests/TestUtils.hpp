@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "engine/physics/Particle.hpp"
+
+/**
+ * Fixtures and error measures shared by the unit tests
+ */
+
+/**
+ * Random particles in the cube [-halfSide, halfSide]³, reproducible from the seed
+ *
+ * @param charge Charge magnitude in coulombs; 0 = protons and electrons,
+ *               otherwise custom particles of unit mass
+ * @param mixedSigns Alternate positive and negative charges (all positive otherwise)
+ */
+inline std::vector<Particle> makeRandomCloud(int count, unsigned seed, double halfSide = 1.0,
+                                             double charge = 0.0, bool mixedSigns = true) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(-halfSide, halfSide);
+    std::vector<Particle> particles;
+    particles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        glm::dvec3 p(pos(rng), pos(rng), pos(rng));
+        bool negative = mixedSigns && (i % 2 == 1);
+        if (charge == 0.0) {
+            particles.push_back(negative ? Particle::createElectron(p) : Particle::createProton(p));
+        } else {
+            particles.push_back(Particle::createCustom(p, negative ? -charge : charge, 1.0));
+        }
+    }
+    return particles;
+}
+
+/**
+ * Largest per-point relative error |value - reference| / |reference|
+ */
+inline double maxRelativeError(const std::vector<glm::dvec3>& values, const std::vector<glm::dvec3>& reference) {
+    double worst = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        worst = std::max(worst, glm::length(values[i] - reference[i]) / glm::length(reference[i]));
+    }
+    return worst;
+}
+
+/**
+ * RMS error relative to the RMS reference (robust against near-zero references)
+ */
+inline double rmsRelativeError(const std::vector<glm::dvec3>& values, const std::vector<glm::dvec3>& reference) {
+    double error = 0.0;
+    double norm = 0.0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        error += glm::dot(values[i] - reference[i], values[i] - reference[i]);
+        norm += glm::dot(reference[i], reference[i]);
+    }
+    return std::sqrt(error / norm);
+}
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include "engine/physics/BarnesHutTree.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+#include "TestUtils.hpp"
+
+/**
+ * Unit tests for the Barnes-Hut octree force approximation
+ */
+
+double maxTreeError(const BarnesHutTree& tree, const std::vector<Particle>& particles) {
+    std::vector<glm::dvec3> exact;
+    std::vector<glm::dvec3> approx;
+    for (const auto& p : particles) {
+        exact.push_back(ElectricField::totalField(p.position, particles));
+        approx.push_back(tree.fieldAt(p.position));
+    }
+    return maxRelativeError(approx, exact);
+}
+
+void testZeroThetaIsExact() {
+    std::cout << "Testing theta = 0 matches direct sum..." << std::endl;
+    
+    std::vector<Particle> particles = makeRandomCloud(200, 1);
+    BarnesHutTree tree;
+    tree.setOpeningAngle(0.0);
+    tree.build(particles);
+    
+    assert(maxTreeError(tree, particles) < 1e-10);
+    
+    std::cout << "  ✓ Zero opening angle test passed" << std::endl;
+}
+
+void testErrorDecreasesWithTheta() {
+    std::cout << "Testing error decreases with opening angle..." << std::endl;
+    
+    // Same-sign cloud: relative error is well defined everywhere
+    std::vector<Particle> particles = makeRandomCloud(2000, 2, 1.0, 0.0, false);
+    BarnesHutTree tree;
+    tree.build(particles);
+    
+    tree.setOpeningAngle(0.8);
+    double coarse = maxTreeError(tree, particles);
+    tree.setOpeningAngle(0.3);
+    double fine = maxTreeError(tree, particles);
+    
+    std::cout << "  theta=0.8: " << coarse << ", theta=0.3: " << fine << std::endl;
+    assert(fine < coarse);
+    assert(fine < 1e-2);
+    
+    std::cout << "  ✓ Opening angle accuracy test passed" << std::endl;
+}
+
+void testFarFieldOfDipole() {
+    std::cout << "Testing far field of a neutral pair..." << std::endl;
+    
+    // Net-neutral cell: accuracy relies on the dipole term
+    std::vector<Particle> particles;
+    particles.push_back(Particle::createProton(glm::dvec3(0.01, 0.0, 0.0)));
+    particles.push_back(Particle::createElectron(glm::dvec3(-0.01, 0.0, 0.0)));
+    
+    BarnesHutTree tree;
+    tree.setLeafCapacity(1);
+    tree.setOpeningAngle(1.0);
+    tree.build(particles);
+    
+    glm::dvec3 evalPoint(3.0, 2.0, 1.0);
+    glm::dvec3 exact = ElectricField::totalField(evalPoint, particles);
+    glm::dvec3 approx = tree.fieldAt(evalPoint);
+    assert(glm::length(approx - exact) / glm::length(exact) < 1e-4);
+    
+    std::cout << "  ✓ Dipole far field test passed" << std::endl;
+}
+
+void testParticleSystemReportsError() {
+    std::cout << "Testing ParticleSystem Barnes-Hut error reporting..." << std::endl;
+    
+    ParticleSystem system;
+    for (const auto& p : makeRandomCloud(500, 3, 1.0, 0.0, false)) {
+        system.addParticle(p);
+    }
+    system.setForceMethod(ParticleSystem::ForceMethod::BARNES_HUT);
+    system.setForceErrorSampling(32, 1);
+    system.step(1e-15);
+    
+    const auto& stats = system.getForceErrorStats();
+    assert(stats.sampleCount > 0);
+    assert(stats.maxRelativeError < 1e-2);
+    
+    std::cout << "  ✓ Error reporting test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Barnes-Hut unit tests..." << std::endl;
+    std::cout << std::endl;
+    
+    try {
+        testZeroThetaIsExact();
+        testErrorDecreasesWithTheta();
+        testFarFieldOfDipole();
+        testParticleSystemReportsError();
+        
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
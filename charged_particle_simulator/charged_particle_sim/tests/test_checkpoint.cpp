@@ -0,0 +1,271 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "engine/io/Checkpoint.hpp"
+
+/**
+ * Unit tests for checkpoint/restart of the particle system
+ */
+
+void buildSystem(ParticleSystem& system, ParticleSystem::ForceMethod method) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1e-6, 1e-6);
+    for (int i = 0; i < 64; ++i) {
+        glm::dvec3 pos(dist(rng), dist(rng), dist(rng));
+        system.addParticle(i % 2 == 0 ? Particle::createProton(pos) : Particle::createElectron(pos));
+    }
+    system.addParticle(Particle::createCustom(glm::dvec3(0.0), 1e-18, 1.0));
+    system.getParticles().back().isFixed = true;
+    system.setForceMethod(method);
+    if (method == ParticleSystem::ForceMethod::P3M) {
+        system.setPeriodicBox(glm::dvec3(-1.5e-6), glm::dvec3(1.5e-6));
+        system.setMeshSize(16);
+        system.setChargeAssignment(P3MSolver::Assignment::CIC);
+    } else if (method == ParticleSystem::ForceMethod::EWALD) {
+        system.setPeriodicBox(glm::dvec3(-1.5e-6), glm::dvec3(1.5e-6));
+        system.setEwaldAccuracy(1e-5);
+    }
+    system.setForceErrorSampling(8, 5);
+    system.setForceErrorTolerance(1e-4);  // Tightens the opening angle mid-run
+    system.setThreadCount(2);
+}
+
+bool bitwiseEqual(const std::vector<Particle>& a, const std::vector<Particle>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].position != b[i].position || a[i].velocity != b[i].velocity ||
+            a[i].acceleration != b[i].acceleration || a[i].isFixed != b[i].isFixed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testBitwiseRestart() {
+    std::cout << "Testing bitwise-identical restart..." << std::endl;
+
+    const std::string path = "test_checkpoint_restart.cpschk";
+    const double dt = 1e-12;
+
+    for (auto method : {ParticleSystem::ForceMethod::DIRECT, ParticleSystem::ForceMethod::BARNES_HUT,
+                        ParticleSystem::ForceMethod::RETARDED, ParticleSystem::ForceMethod::P3M,
+                        ParticleSystem::ForceMethod::EWALD}) {
+        ParticleSystem original;
+        buildSystem(original, method);
+        for (int i = 0; i < 20; ++i) {
+            original.step(dt);
+        }
+
+        std::string error;
+        assert(Checkpoint::save(path, original, error));
+
+        for (int i = 0; i < 30; ++i) {
+            original.step(dt);
+        }
+
+        // Fresh system with different settings: everything comes from the file
+        ParticleSystem restored;
+        restored.setIntegrationMethod(ParticleSystem::IntegrationMethod::EULER);
+        assert(Checkpoint::load(path, restored, error));
+        assert(restored.getStepCount() == 20);
+        assert(std::abs(restored.getSimulationTime() - 20 * dt) < 1e-24);
+        for (int i = 0; i < 30; ++i) {
+            restored.step(dt);
+        }
+
+        assert(bitwiseEqual(original.getParticles(), restored.getParticles()));
+        assert(original.getSimulationTime() == restored.getSimulationTime());
+        assert(original.getOpeningAngle() == restored.getOpeningAngle());
+        assert(restored.isPeriodic() == original.isPeriodic());
+        assert(restored.getPeriodicBox() == original.getPeriodicBox());
+        assert(restored.getMeshSize() == original.getMeshSize());
+        assert(restored.getChargeAssignment() == original.getChargeAssignment());
+        assert(restored.getEwaldAccuracy() == original.getEwaldAccuracy());
+
+        // reset() still returns to the scene's initial state
+        original.reset();
+        restored.reset();
+        assert(bitwiseEqual(original.getParticles(), restored.getParticles()));
+        assert(restored.getSimulationTime() == 0.0);
+    }
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Bitwise restart test passed" << std::endl;
+}
+
+void testMagnetizedRestart() {
+    std::cout << "Testing magnetized restart..." << std::endl;
+
+    const std::string path = "test_checkpoint_magnetized.cpschk";
+    const double dt = 1e-12;
+
+    ParticleSystem original;
+    buildSystem(original, ParticleSystem::ForceMethod::DIRECT);
+    original.setIntegrationMethod(ParticleSystem::IntegrationMethod::BORIS);
+    original.setMagneticInteraction(true);
+    original.getExternalField().setUniformElectric(glm::dvec3(1e3, 0.0, 0.0));
+    original.getExternalField().setUniformMagnetic(glm::dvec3(0.0, 0.0, 2.0));
+    for (int i = 0; i < 10; ++i) {
+        original.step(dt);
+    }
+
+    std::string error;
+    assert(Checkpoint::save(path, original, error));
+    for (int i = 0; i < 10; ++i) {
+        original.step(dt);
+    }
+
+    ParticleSystem restored;
+    assert(Checkpoint::load(path, restored, error));
+    assert(restored.getMagneticInteraction());
+    assert(restored.getExternalField().getUniformMagnetic() == glm::dvec3(0.0, 0.0, 2.0));
+    for (int i = 0; i < 10; ++i) {
+        restored.step(dt);
+    }
+    assert(bitwiseEqual(original.getParticles(), restored.getParticles()));
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Magnetized restart test passed" << std::endl;
+}
+
+void testHistoryAndFlags() {
+    std::cout << "Testing history and flags..." << std::endl;
+
+    ParticleSystem system;
+    Particle p = Particle::createElectron(glm::dvec3(1.0, 2.0, 3.0));
+    p.history.setCapacity(64);  // Wraps around: oldest 36 samples overwritten
+    for (int i = 0; i < 100; ++i) {
+        p.position.x += 0.125;
+        p.recordHistory(i * 0.5);
+    }
+    p.isBeingDragged = true;
+    system.addParticle(p);
+
+    ParticleSystem::Snapshot snapshot = system.createSnapshot();
+    const std::string path = "test_checkpoint_history.cpschk";
+    std::string error;
+    assert(Checkpoint::write(path, snapshot, error));
+
+    ParticleSystem::Snapshot loaded;
+    assert(Checkpoint::read(path, loaded, error));
+    const Particle& q = loaded.particles[0];
+    assert(q.history.capacity() == 64);
+    assert(q.history.size() == 64);
+    assert(q.history[37].position == p.history[37].position);
+    assert(q.history[37].timestamp == 36.5);
+    assert(q.isBeingDragged && !q.isFixed);
+    assert(q.color == p.color && q.visualRadius == p.visualRadius);
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ History and flags test passed" << std::endl;
+}
+
+void testCorruptFiles() {
+    std::cout << "Testing corrupt checkpoints..." << std::endl;
+
+    ParticleSystem system;
+    buildSystem(system, ParticleSystem::ForceMethod::DIRECT);
+    const std::string path = "test_checkpoint_corrupt.cpschk";
+    std::string error;
+    assert(Checkpoint::save(path, system, error));
+
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    ParticleSystem::Snapshot snapshot;
+
+    // Flipped payload bit: checksum mismatch
+    bytes[bytes.size() / 2] ^= 0x10;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    assert(!Checkpoint::read(path, snapshot, error));
+    assert(error.find("corrupt") != std::string::npos);
+
+    // Truncated file
+    bytes[bytes.size() / 2] ^= 0x10;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 100));
+    }
+    assert(!Checkpoint::read(path, snapshot, error));
+
+    // Future version
+    bytes[8] = 99;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    assert(!Checkpoint::read(path, snapshot, error));
+    assert(error.find("version") != std::string::npos);
+
+    // A failed load leaves the system untouched
+    size_t count = system.getParticleCount();
+    assert(!Checkpoint::load(path, system, error));
+    assert(system.getParticleCount() == count);
+    assert(!Checkpoint::load("missing_checkpoint.cpschk", system, error));
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Corrupt checkpoint test passed" << std::endl;
+}
+
+void testBackgroundWriter() {
+    std::cout << "Testing background checkpoint writer..." << std::endl;
+
+    const std::string path = "test_checkpoint_async.cpschk";
+    ParticleSystem system;
+    buildSystem(system, ParticleSystem::ForceMethod::DIRECT);
+
+    CheckpointWriter writer;
+    for (int i = 0; i < 10; ++i) {
+        system.step(1e-12);
+        writer.save(system, path);
+    }
+    assert(writer.wait());
+    assert(writer.getWrittenCount() + writer.getSkippedCount() == 10);
+
+    // The file always holds the newest state
+    ParticleSystem restored;
+    std::string error;
+    assert(Checkpoint::load(path, restored, error));
+    assert(restored.getStepCount() == 10);
+    assert(bitwiseEqual(system.getParticles(), restored.getParticles()));
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Background writer test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running checkpoint unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testBitwiseRestart();
+        testMagnetizedRestart();
+        testHistoryAndFlags();
+        testCorruptFiles();
+        testBackgroundWriter();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
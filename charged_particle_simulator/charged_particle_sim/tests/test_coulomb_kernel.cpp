@@ -0,0 +1,159 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include "engine/physics/CoulombKernel.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "engine/core/ThreadPool.hpp"
+#include "TestUtils.hpp"
+
+/**
+ * Unit tests for the vectorized Coulomb kernel (fields and potentials)
+ * Every instruction set supported by the host CPU is checked against the scalar sum.
+ */
+
+std::vector<CoulombKernel::InstructionSet> supportedInstructionSets() {
+    std::vector<CoulombKernel::InstructionSet> sets = {CoulombKernel::InstructionSet::SCALAR};
+    if (CoulombKernel::detect() >= CoulombKernel::InstructionSet::AVX2) {
+        sets.push_back(CoulombKernel::InstructionSet::AVX2);
+    }
+    if (CoulombKernel::detect() >= CoulombKernel::InstructionSet::AVX512) {
+        sets.push_back(CoulombKernel::InstructionSet::AVX512);
+    }
+    return sets;
+}
+
+void testMatchesReferenceSum() {
+    std::cout << "Testing kernel matches reference sum..." << std::endl;
+    
+    // Odd count exercises the scalar tail after the vector loop
+    std::vector<Particle> particles = makeRandomCloud(203, 1, 1e-6);
+    ParticleStore store;
+    store.loadFrom(particles);
+    
+    // Potentials of mixed charges cancel: compare against the sum of magnitudes
+    std::vector<Particle> magnitudes = particles;
+    for (auto& p : magnitudes) {
+        p.charge = std::abs(p.charge);
+    }
+    
+    for (auto isa : supportedInstructionSets()) {
+        CoulombKernel::setInstructionSet(isa);
+        assert(CoulombKernel::active() == isa);
+        
+        for (size_t i = 0; i < particles.size(); i += 7) {
+            // Evaluate at a particle (self-interaction skipped) and next to it
+            for (const glm::dvec3& offset : {glm::dvec3(0.0), glm::dvec3(1e-8, -2e-8, 3e-8)}) {
+                glm::dvec3 point = particles[i].position + offset;
+                glm::dvec3 exact = ElectricField::totalField(point, particles);
+                glm::dvec3 fast = CoulombKernel::fieldAt(point, store);
+                assert(glm::length(fast - exact) <= 1e-10 * glm::length(exact));
+                
+                double phi = CoulombKernel::potentialAt(point, store);
+                double scale = ElectricField::totalPotential(point, magnitudes);
+                assert(std::abs(phi - ElectricField::totalPotential(point, particles)) <= 1e-12 * scale);
+            }
+        }
+        std::cout << "  ✓ " << CoulombKernel::name(isa) << std::endl;
+    }
+    
+    CoulombKernel::setInstructionSet(CoulombKernel::detect());
+    std::cout << "  ✓ Reference sum test passed" << std::endl;
+}
+
+void testBatchedEvaluation() {
+    std::cout << "Testing batched evaluation..." << std::endl;
+    
+    std::vector<Particle> particles = makeRandomCloud(64, 2, 1e-6);
+    ParticleStore store;
+    store.loadFrom(particles);
+    
+    // Particle-particle fields
+    std::vector<glm::dvec3> fields;
+    CoulombKernel::fieldAtSources(store, fields);
+    assert(fields.size() == particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        glm::dvec3 exact = ElectricField::totalField(particles[i].position, particles);
+        assert(glm::length(fields[i] - exact) <= 1e-10 * glm::length(exact));
+    }
+    
+    // Field line style evaluation points
+    std::vector<glm::dvec3> points;
+    for (int i = 0; i < 10; ++i) {
+        points.push_back(glm::dvec3(2e-6 * i, 1e-7, -3e-7));
+    }
+    std::vector<glm::dvec3> out(points.size());
+    CoulombKernel::fieldAtPoints(points.data(), points.size(), store, out.data());
+    for (size_t i = 0; i < points.size(); ++i) {
+        glm::dvec3 exact = ElectricField::totalField(points[i], particles);
+        assert(glm::length(out[i] - exact) <= 1e-10 * glm::length(exact));
+    }
+    
+    std::cout << "  ✓ Batched evaluation test passed" << std::endl;
+}
+
+void testPairwiseFields() {
+    std::cout << "Testing pairwise fields..." << std::endl;
+    
+    // Several tiles plus a partial one, and more tiles than blocks (blocks of
+    // one and two tiles); a duplicated position checks self-interaction skipping
+    for (int count : {1000, 20 * static_cast<int>(CoulombKernel::PAIR_TILE_SIZE) - 100}) {
+        std::vector<Particle> particles = makeRandomCloud(count, 3, 1e-6);
+        particles[700].position = particles[5].position;
+        ParticleStore store;
+        store.loadFrom(particles);
+        
+        for (auto isa : supportedInstructionSets()) {
+            CoulombKernel::setInstructionSet(isa);
+            
+            std::vector<glm::dvec3> fields;
+            CoulombKernel::pairwiseFields(store, fields);
+            assert(fields.size() == particles.size());
+            for (size_t i = 0; i < particles.size(); ++i) {
+                glm::dvec3 exact = ElectricField::totalField(particles[i].position, particles);
+                assert(glm::length(fields[i] - exact) <= 1e-10 * glm::length(exact));
+            }
+            
+            // Newton's third law: internal forces cancel
+            glm::dvec3 netForce(0.0);
+            double forceScale = 0.0;
+            for (size_t i = 0; i < particles.size(); ++i) {
+                netForce += particles[i].charge * fields[i];
+                forceScale += std::abs(particles[i].charge) * glm::length(fields[i]);
+            }
+            assert(glm::length(netForce) <= 1e-12 * forceScale);
+            
+            // Same bits for any thread count
+            for (size_t threads : {1, 2, 3}) {
+                ThreadPool pool(threads);
+                std::vector<glm::dvec3> parallel;
+                CoulombKernel::pairwiseFields(store, parallel, &pool);
+                for (size_t i = 0; i < particles.size(); ++i) {
+                    assert(parallel[i] == fields[i]);
+                }
+            }
+            std::cout << "  ✓ " << CoulombKernel::name(isa) << std::endl;
+        }
+    }
+    
+    CoulombKernel::setInstructionSet(CoulombKernel::detect());
+    std::cout << "  ✓ Pairwise fields test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Coulomb kernel unit tests (detected: "
+              << CoulombKernel::name(CoulombKernel::detect()) << ")..." << std::endl;
+    std::cout << std::endl;
+    
+    try {
+        testMatchesReferenceSum();
+        testBatchedEvaluation();
+        testPairwiseFields();
+        
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,156 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "engine/physics/EwaldSolver.hpp"
+#include "engine/physics/P3MSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+#include "PeriodicTestUtils.hpp"
+
+/**
+ * Unit tests for the Ewald summation solver
+ */
+
+void testAgainstBruteForce() {
+    std::cout << "Testing Ewald sum against brute force..." << std::endl;
+
+    const PeriodicBox box(glm::dvec3(-0.5, -0.5, -0.25), glm::dvec3(0.5, 0.5, 0.75));
+    ParticleStore store = makeNeutralBox(box, 40, 5);
+    const std::vector<glm::dvec3> reference = ewaldReference(store, box);
+
+    // Default accuracy; tuned parameters differ from the reference's
+    EwaldSolver solver;
+    solver.setBox(box);
+    solver.computeFields(store);
+    assert(solver.getAccuracy() == EwaldSolver::DEFAULT_ACCURACY);
+    assert(solver.getCutoff() <= 0.5 * box.shortestSide());
+    assert(std::abs(solver.getSplitting() * solver.getCutoff() - std::sqrt(-std::log(1e-6))) < 1e-12);
+    assert(solver.getWaveCount() > 0);
+    const double fineError = rmsRelativeError(solver.getFields(), reference);
+    assert(fineError < 1e-6);
+
+    // Results do not depend on the thread count
+    ThreadPool pool(3);
+    const std::vector<glm::dvec3> serial = solver.getFields();
+    solver.computeFields(store, &pool);
+    assert(solver.getFields() == serial);
+
+    // Coarser accuracy: fewer waves, error still within the request
+    const size_t fineWaves = solver.getWaveCount();
+    solver.setAccuracy(1e-3);
+    solver.computeFields(store, &pool);
+    assert(solver.getWaveCount() < fineWaves);
+    const double coarseError = rmsRelativeError(solver.getFields(), reference);
+    assert(coarseError < 1e-3);
+
+    // Out-of-range requests are clamped
+    solver.setAccuracy(0.0);
+    assert(solver.getAccuracy() == EwaldSolver::MIN_ACCURACY);
+    solver.setAccuracy(1.0);
+    assert(solver.getAccuracy() == EwaldSolver::MAX_ACCURACY);
+
+    // P3M agrees to its own (mesh) accuracy
+    P3MSolver p3m;
+    p3m.setBox(box);
+    p3m.computeFields(store);
+    assert(rmsRelativeError(p3m.getFields(), reference) < 2e-3);
+
+    std::cout << "  ✓ Brute force comparison passed (rms relative error " << fineError
+              << " at 1e-6, " << coarseError << " at 1e-3)" << std::endl;
+}
+
+void testRockSalt() {
+    std::cout << "Testing rock-salt lattice..." << std::endl;
+
+    // 4x4x4 cubic cells of alternating charges fill the box exactly: by symmetry
+    // the field vanishes at every ion
+    const int cells = 4;
+    const double spacing = 2.8e-10;
+    const PeriodicBox box(glm::dvec3(0.0), glm::dvec3(cells * spacing));
+    ParticleStore store;
+    store.resize(cells * cells * cells);
+    size_t n = 0;
+    for (int z = 0; z < cells; ++z) {
+        for (int y = 0; y < cells; ++y) {
+            for (int x = 0; x < cells; ++x) {
+                store.setPosition(n, spacing * glm::dvec3(x, y, z));
+                store.q[n] = (x + y + z) % 2 == 0 ? PhysicsConstants::e : -PhysicsConstants::e;
+                store.m[n] = 1.0;
+                ++n;
+            }
+        }
+    }
+    const double nearest = PhysicsConstants::k * PhysicsConstants::e / (spacing * spacing);
+
+    EwaldSolver solver;
+    solver.setBox(box);
+    solver.setAccuracy(1e-9);
+    solver.computeFields(store);
+    for (const glm::dvec3& field : solver.getFields()) {
+        assert(glm::length(field) < 1e-7 * nearest);
+    }
+
+    // Moving one ion moves its whole sublattice of images. The other charges are
+    // then a lattice with net charge -e per box plus the neutralizing background
+    // (e / V), whose field e d / (3 ε0 V) is the linear term; what remains is of
+    // third order (the rest of the lattice is centrosymmetric with cubic
+    // symmetry). Truncation errors would break this.
+    const glm::dvec3 site = store.position(0);
+    const glm::dvec3 displacement(0.05 * spacing, 0.02 * spacing, 0.0);
+    const double background = 4.0 * M_PI * PhysicsConstants::k * PhysicsConstants::e / (3.0 * box.volume());
+    store.setPosition(0, site + displacement);
+    solver.computeFields(store);
+    const double small = glm::length(solver.getFields()[0] - background * displacement);
+    store.setPosition(0, site + 2.0 * displacement);
+    solver.computeFields(store);
+    const double large = glm::length(solver.getFields()[0] - background * 2.0 * displacement);
+    assert(large > 7.0 * small && large < 9.0 * small);
+
+    std::cout << "  ✓ Rock-salt lattice test passed" << std::endl;
+}
+
+void testParticleSystem() {
+    std::cout << "Testing Ewald force method..." << std::endl;
+
+    // A close pair in a large box: the periodic images barely matter
+    const double side = 1e-6;
+    ParticleSystem system;
+    system.setCollisionPrevention(false);
+    system.addParticle(Particle::createProton(glm::dvec3(-1e-8, 2e-9, 0.0)));
+    system.addParticle(Particle::createElectron(glm::dvec3(1e-8, 0.0, 1e-9)));
+    system.setForceMethod(ParticleSystem::ForceMethod::EWALD);
+
+    // Without a box the Ewald method runs as the direct sum
+    system.step(1e-18);
+    const glm::dvec3 direct = system.getParticles()[0].acceleration;
+    system.reset();
+
+    system.setPeriodicBox(glm::dvec3(-0.5 * side), glm::dvec3(0.5 * side));
+    system.setEwaldAccuracy(1e-8);
+    assert(system.getEwaldAccuracy() == 1e-8);
+    system.step(1e-18);
+    const glm::dvec3 periodic = system.getParticles()[0].acceleration;
+    assert(periodic != direct);
+    assert(glm::length(periodic - direct) < 1e-3 * glm::length(direct));
+
+    std::cout << "  ✓ Ewald force method test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Ewald unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testAgainstBruteForce();
+        testRockSalt();
+        testParticleSystem();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,147 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include "engine/physics/FieldGrid.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "TestUtils.hpp"
+
+/**
+ * Unit tests for the precomputed field grid
+ */
+
+/**
+ * Mean relative error of interpolated points in the cloud's neighbourhood
+ */
+double meanInterpolationError(const FieldGrid& grid, const std::vector<Particle>& particles, size_t& interpolated) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> pos(-1.5, 1.5);
+    double sum = 0.0;
+    interpolated = 0;
+    for (int n = 0; n < 5000; ++n) {
+        glm::dvec3 point(pos(rng), pos(rng), pos(rng));
+        if (!grid.interpolates(point)) {
+            continue;
+        }
+        glm::dvec3 exact = ElectricField::totalField(point, particles);
+        sum += glm::length(grid.fieldAt(point) - exact) / glm::length(exact);
+        ++interpolated;
+    }
+    return sum / static_cast<double>(interpolated);
+}
+
+void testInterpolationAccuracy() {
+    std::cout << "Testing interpolation accuracy..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(20, 1, 1.0, 1e-6);
+
+    FieldGrid linear;
+    linear.setInterpolation(FieldGrid::Interpolation::TRILINEAR);
+    linear.build(particles);
+    size_t linearCount = 0;
+    double linearError = meanInterpolationError(linear, particles, linearCount);
+
+    // Nodes sampled on a thread pool
+    ThreadPool pool(3);
+    FieldGrid cubic;
+    cubic.setInterpolation(FieldGrid::Interpolation::TRICUBIC);
+    cubic.build(particles, nullptr, &pool);
+    size_t cubicCount = 0;
+    double cubicError = meanInterpolationError(cubic, particles, cubicCount);
+
+    // Most of the volume is interpolated; tricubic is clearly more accurate
+    assert(linearCount == cubicCount && linearCount > 4000);
+    assert(linearError < 5e-3);
+    assert(cubicError < 1e-3);
+    assert(cubicError < 0.5 * linearError);
+
+    std::cout << "  ✓ Interpolation accuracy test passed (mean error trilinear "
+              << linearError << ", tricubic " << cubicError << ")" << std::endl;
+}
+
+void testNearCharges() {
+    std::cout << "Testing field near charges..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(20, 2, 1.0, 1e-6);
+    FieldGrid grid;
+    grid.build(particles);
+    const double exactDistance = grid.getExactRadius() * grid.getCellSize();
+
+    // Within the exact radius the nearby charge's own field is exact, so the
+    // singularity does not show in the error however close the point gets
+    for (const auto& p : particles) {
+        for (double fraction : {0.001, 0.01, 0.5, 0.99}) {
+            glm::dvec3 point = p.position + glm::dvec3(fraction * exactDistance, 0.0, 0.0);
+            assert(grid.interpolates(point));
+            glm::dvec3 exact = ElectricField::totalField(point, particles);
+            assert(glm::length(grid.fieldAt(point) - exact) <= 1e-2 * glm::length(exact));
+        }
+    }
+
+    // Likewise outside the grid
+    glm::dvec3 outside(10.0, 0.0, 0.0);
+    assert(!grid.interpolates(outside));
+    assert(grid.fieldAt(outside) == grid.exactFieldAt(outside));
+
+    // Single particles have no extent to sample: everything is exact
+    FieldGrid single;
+    single.build({particles[0]});
+    assert(single.isBuilt() && single.getNodeCount() == 0);
+    assert(!single.interpolates(glm::dvec3(0.1)));
+
+    std::cout << "  ✓ Field near charges test passed" << std::endl;
+}
+
+void testMatches() {
+    std::cout << "Testing rebuild detection..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(8, 3, 1.0, 1e-6);
+    FieldGrid grid;
+    assert(!grid.matches(particles));
+    grid.build(particles);
+    assert(grid.matches(particles));
+
+    std::vector<Particle> moved = particles;
+    moved[3].position.y += 1e-9;
+    assert(!grid.matches(moved));
+
+    std::vector<Particle> recharged = particles;
+    recharged[5].charge *= 2.0;
+    assert(!grid.matches(recharged));
+
+    std::vector<Particle> added = particles;
+    added.push_back(Particle::createCustom(glm::dvec3(0.0), 1e-6, 1.0));
+    assert(!grid.matches(added));
+
+    // Velocities do not change the electrostatic field
+    std::vector<Particle> moving = particles;
+    moving[0].velocity = glm::dvec3(1.0, 2.0, 3.0);
+    assert(grid.matches(moving));
+
+    grid.setResolution(32);
+    assert(!grid.matches(particles));
+    grid.build(particles);
+    assert(grid.matches(particles));
+    grid.invalidate();
+    assert(!grid.matches(particles));
+
+    std::cout << "  ✓ Rebuild detection test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running field grid unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testInterpolationAccuracy();
+        testNearCharges();
+        testMatches();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
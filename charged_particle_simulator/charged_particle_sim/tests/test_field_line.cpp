@@ -0,0 +1,196 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include "engine/physics/FieldLineGenerator.hpp"
+#include "engine/physics/ElectricField.hpp"
+
+/**
+ * Unit tests for field line tracing
+ */
+
+std::vector<Particle> makeDipole() {
+    // Microcoulomb dipole on the x axis (meter scale)
+    std::vector<Particle> particles = {
+        Particle::createCustom(glm::dvec3(-1.0, 0.0, 0.0), 1e-6, 1.0),
+        Particle::createCustom(glm::dvec3(1.0, 0.0, 0.0), -1e-6, 1.0)
+    };
+    for (auto& p : particles) {
+        p.visualRadius = 0.1f;
+    }
+    return particles;
+}
+
+void testDipoleLineEndsAtNegativeCharge() {
+    std::cout << "Testing dipole field line termination..." << std::endl;
+
+    std::vector<Particle> particles = makeDipole();
+    FieldLineConfig config;
+    config.maxStepsPerLine = 2000;
+
+    // Seed just off the positive charge, heading towards the negative one
+    FieldLine line = FieldLineGenerator::generate(glm::dvec3(-0.85, 0.05, 0.0), particles, config, true);
+
+    assert(line.isComplete);
+    assert(line.sourceCharge > 0.0f);
+    assert(line.points.size() > 10);
+    assert(line.points.size() < static_cast<size_t>(config.maxStepsPerLine));
+    assert(line.points.size() == line.fieldMagnitudes.size());
+
+    // Line stops at the negative charge
+    glm::dvec3 end = line.points.back();
+    assert(glm::length(end - particles[1].position) < 0.2);
+
+    // Stored magnitudes are the field at the stored points
+    for (size_t i = 0; i < line.points.size(); i += 50) {
+        double expected = glm::length(ElectricField::totalField(line.points[i], particles));
+        assert(std::abs(line.fieldMagnitudes[i] - expected) <= expected * 1e-5);
+    }
+
+    std::cout << "  ✓ Dipole termination test passed" << std::endl;
+}
+
+void testFieldEvaluationsPerStep() {
+    std::cout << "Testing field evaluations per step..." << std::endl;
+
+    std::vector<Particle> particles = makeDipole();
+
+    // Count evaluations independently through the evaluator hook
+    std::atomic<size_t> calls{0};
+    FieldLineConfig config;
+    config.integrator = FieldLineIntegrator::RK4;
+    config.maxStepsPerLine = 2000;
+    config.fieldEvaluator = [&](const glm::dvec3& pos) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return ElectricField::totalField(pos, particles);
+    };
+
+    FieldLine line = FieldLineGenerator::generate(glm::dvec3(-0.85, 0.05, 0.0), particles, config, true);
+
+    // One evaluation at the seed, then three RK stages plus the accepted point per step
+    assert(line.fieldEvaluations == calls.load());
+    assert(line.fieldEvaluations == 1 + 4 * line.points.size());
+
+    // Lines traced by generateAll report their counts too
+    config.seedPointsPerParticle = 4;
+    std::vector<FieldLine> lines = FieldLineGenerator::generateAll(particles, config);
+    assert(!lines.empty());
+    for (const auto& l : lines) {
+        assert(l.fieldEvaluations <= 1 + 4 * l.points.size());
+        assert(l.fieldEvaluations > 4 * (l.points.size() - 1));
+    }
+
+    std::cout << "  ✓ Field evaluation count test passed" << std::endl;
+}
+
+// Flux function of the dipole: cos(theta+) - cos(theta-) is constant along a field line
+double dipoleFlux(const glm::dvec3& p, const std::vector<Particle>& particles) {
+    glm::dvec3 a = p - particles[0].position;
+    glm::dvec3 b = p - particles[1].position;
+    return a.x / glm::length(a) - b.x / glm::length(b);
+}
+
+double maxFluxDrift(const FieldLine& line, const std::vector<Particle>& particles) {
+    double flux0 = dipoleFlux(line.points.front(), particles);
+    double drift = 0.0;
+    for (const auto& p : line.points) {
+        drift = std::max(drift, std::abs(dipoleFlux(p, particles) - flux0));
+    }
+    return drift;
+}
+
+void testDormandPrinceAccuracy() {
+    std::cout << "Testing Dormand-Prince error control..." << std::endl;
+    
+    std::vector<Particle> particles = makeDipole();
+    glm::dvec3 seed(-0.85, 0.05, 0.0);
+    
+    FieldLineConfig rk4;
+    rk4.integrator = FieldLineIntegrator::RK4;
+    rk4.maxStepsPerLine = 5000;
+    FieldLine rk4Line = FieldLineGenerator::generate(seed, particles, rk4, true);
+    
+    FieldLineConfig dopri;
+    dopri.maxStepsPerLine = 5000;
+    FieldLine dopriLine = FieldLineGenerator::generate(seed, particles, dopri, true);
+    
+    // Both reach the negative charge
+    assert(rk4Line.isComplete && dopriLine.isComplete);
+    assert(glm::length(dopriLine.points.back() - particles[1].position) < 0.2);
+    
+    // Default tolerances: well within 1e-5 for a fraction of the fixed-step cost
+    double rk4Drift = maxFluxDrift(rk4Line, particles);
+    double dopriDrift = maxFluxDrift(dopriLine, particles);
+    assert(dopriDrift < 1e-5);
+    assert(dopriLine.fieldEvaluations * 10 < rk4Line.fieldEvaluations);
+    
+    // Tight tolerances: more accurate than fixed-step RK4, still far fewer evaluations
+    FieldLineConfig tight = dopri;
+    tight.absoluteTolerance = 1e-10;
+    tight.relativeTolerance = 1e-10;
+    FieldLine tightLine = FieldLineGenerator::generate(seed, particles, tight, true);
+    double tightDrift = maxFluxDrift(tightLine, particles);
+    assert(tightDrift < dopriDrift);
+    assert(tightDrift < rk4Drift);
+    assert(tightLine.fieldEvaluations * 4 < rk4Line.fieldEvaluations);
+    
+    // Accepted steps cost six evaluations, rejected ones six more
+    assert(dopriLine.fieldEvaluations <= 1 + 6 * (dopriLine.points.size() + dopriLine.rejectedSteps));
+    
+    std::cout << "  ✓ Dormand-Prince test passed (" << tightLine.fieldEvaluations << " vs "
+              << rk4Line.fieldEvaluations << " evaluations, drift " << tightDrift << " vs "
+              << rk4Drift << ")" << std::endl;
+}
+
+void testStepRejection() {
+    std::cout << "Testing step rejection and growth limits..." << std::endl;
+    
+    std::vector<Particle> particles = makeDipole();
+    
+    // An oversized initial step is rejected and shrunk until it meets the tolerance
+    FieldLineConfig config;
+    config.stepSize = 0.5;
+    config.maxStepSize = 1.0;
+    config.absoluteTolerance = 1e-10;
+    config.relativeTolerance = 1e-10;
+    config.maxStepsPerLine = 5000;
+    FieldLine line = FieldLineGenerator::generate(glm::dvec3(-0.85, 0.05, 0.0), particles, config, true);
+    assert(line.rejectedSteps > 0);
+    assert(maxFluxDrift(line, particles) < 1e-8);
+    
+    // Consecutive point spacing grows by at most maxStepGrowth and never exceeds maxStepSize
+    config.stepSize = 1e-4;
+    config.maxStepSize = 0.05;
+    line = FieldLineGenerator::generate(glm::dvec3(-0.85, 0.05, 0.0), particles, config, true);
+    for (size_t i = 1; i < line.points.size(); ++i) {
+        double spacing = glm::length(line.points[i] - line.points[i - 1]);
+        assert(spacing <= config.maxStepSize * (1.0 + 1e-9));
+        if (i == 1) {
+            assert(spacing <= config.stepSize * (1.0 + 1e-9));
+        } else {
+            double previous = glm::length(line.points[i - 1] - line.points[i - 2]);
+            assert(spacing <= previous * config.maxStepGrowth * 1.01);
+        }
+    }
+    
+    std::cout << "  ✓ Step rejection test passed (" << line.rejectedSteps << " rejected)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running field line unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testDipoleLineEndsAtNegativeCharge();
+        testFieldEvaluationsPerStep();
+        testDormandPrinceAccuracy();
+        testStepRejection();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,169 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include "engine/physics/FmmSolver.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "engine/physics/FieldLineGenerator.hpp"
+#include "TestUtils.hpp"
+
+/**
+ * Unit tests for the fast multipole method solver
+ */
+
+std::vector<glm::dvec3> directFields(const std::vector<Particle>& particles) {
+    std::vector<glm::dvec3> fields;
+    for (const auto& p : particles) {
+        fields.push_back(ElectricField::totalField(p.position, particles));
+    }
+    return fields;
+}
+
+void testExpansionOrder() {
+    std::cout << "Testing error against expansion order..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(1000, 11);
+    const std::vector<glm::dvec3> exact = directFields(particles);
+
+    FmmSolver solver;
+    solver.setLeafCapacity(8);
+    double previous = 1.0;
+    double errors[4] = {};
+    int n = 0;
+    for (int order : {2, 4, 6, 8}) {
+        solver.setExpansionOrder(order);
+        assert(solver.getExpansionOrder() == order);
+        solver.build(particles);
+        solver.computeFields();
+        assert(solver.getFields().size() == particles.size());
+        double error = rmsRelativeError(solver.getFields(), exact);
+        assert(error < previous);
+        previous = error;
+        errors[n++] = error;
+    }
+    // The error keeps falling with the order (roughly as theta^(p+1), theta = 0.5)
+    assert(errors[3] < 1e-4);
+    assert(errors[3] < 0.25 * errors[1]);
+
+    // Orders are clamped
+    solver.setExpansionOrder(0);
+    assert(solver.getExpansionOrder() == 1);
+    solver.setExpansionOrder(FmmSolver::MAX_ORDER + 1);
+    assert(solver.getExpansionOrder() == FmmSolver::MAX_ORDER);
+
+    // Building from structure-of-arrays data gives the same fields
+    solver.setExpansionOrder(6);
+    solver.build(particles);
+    solver.computeFields();
+    const std::vector<glm::dvec3> fromParticles = solver.getFields();
+    ParticleStore store;
+    store.loadFrom(particles);
+    solver.build(store);
+    solver.computeFields();
+    assert(solver.getFields() == fromParticles);
+
+    std::cout << "  ✓ Expansion order test passed (rms relative error " << errors[0]
+              << " at order 2, " << errors[3] << " at order 8)" << std::endl;
+}
+
+void testArbitraryPoints() {
+    std::cout << "Testing field and potential at arbitrary points..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(800, 12);
+    FmmSolver solver;
+    assert(solver.empty());
+    solver.setExpansionOrder(8);
+    solver.setLeafCapacity(8);
+    solver.build(particles);
+    assert(!solver.empty());
+
+    // Points inside the cloud and well outside it
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<double> coordinate(-3.0, 3.0);
+    std::vector<glm::dvec3> fields;
+    std::vector<glm::dvec3> exactFields;
+    double potentialError = 0.0;
+    double potentialNorm = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        glm::dvec3 point(coordinate(rng), coordinate(rng), coordinate(rng));
+        fields.push_back(solver.fieldAt(point));
+        exactFields.push_back(ElectricField::totalField(point, particles));
+        double exact = ElectricField::totalPotential(point, particles);
+        potentialError += std::pow(solver.potentialAt(point) - exact, 2);
+        potentialNorm += exact * exact;
+    }
+    double fieldError = rmsRelativeError(fields, exactFields);
+    potentialError = std::sqrt(potentialError / potentialNorm);
+    // M2P accepts cells at the opening angle: error of order theta^(p+1)
+    assert(fieldError < 2e-3);
+    assert(potentialError < 1e-3);
+
+    // At a particle, fieldAt() skips the particle itself like computeFields()
+    std::vector<glm::dvec3> atParticles;
+    for (const auto& p : particles) {
+        atParticles.push_back(solver.fieldAt(p.position));
+    }
+    assert(rmsRelativeError(atParticles, directFields(particles)) < 2e-3);
+
+    std::cout << "  ✓ Arbitrary point test passed (rms relative error " << fieldError
+              << " field, " << potentialError << " potential)" << std::endl;
+}
+
+void testFieldEvaluatorHook() {
+    std::cout << "Testing field line tracing through the solver..." << std::endl;
+
+    // A microcoulomb dipole among weaker charges; leaves of one particle force expansions
+    std::vector<Particle> particles = makeRandomCloud(30, 14, 2.0, 1e-7);
+    particles.push_back(Particle::createCustom(glm::dvec3(-1.0, 0.0, 0.0), 1e-6, 1.0));
+    particles.push_back(Particle::createCustom(glm::dvec3(1.0, 0.0, 0.0), -1e-6, 1.0));
+    for (auto& p : particles) {
+        p.visualRadius = 0.05f;
+    }
+    FmmSolver solver;
+    solver.setExpansionOrder(10);
+    solver.setLeafCapacity(1);
+    solver.build(particles);
+
+    FieldLineConfig config;
+    config.maxStepsPerLine = 500;
+    const glm::dvec3 seed(-0.9, 0.05, 0.0);
+    FieldLine direct = FieldLineGenerator::generate(seed, particles, config, true);
+
+    std::atomic<size_t> calls{0};
+    config.fieldEvaluator = [&](const glm::dvec3& p) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return solver.fieldAt(p);
+    };
+    FieldLine traced = FieldLineGenerator::generate(seed, particles, config, true);
+
+    // Every evaluation went through the solver, and the line follows the direct one
+    assert(calls.load() == traced.fieldEvaluations);
+    assert(traced.points.size() > 10);
+    size_t compared = std::min(direct.points.size(), traced.points.size()) / 2;
+    for (size_t i = 0; i < compared; ++i) {
+        assert(glm::length(traced.points[i] - direct.points[i]) < 1e-3);
+        double exact = glm::length(ElectricField::totalField(traced.points[i], particles));
+        assert(std::abs(traced.fieldMagnitudes[i] - exact) <= 1e-3 * exact);
+    }
+
+    std::cout << "  ✓ Field evaluator hook test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FMM unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testExpansionOrder();
+        testArbitraryPoints();
+        testFieldEvaluatorHook();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Unit tests for the particle integrators (convergence order, energy, force reuse)
+ */
+
+using Method = ParticleSystem::IntegrationMethod;
+
+// Electron on a circular orbit around a fixed proton
+struct Orbit {
+    double radius = 1e-10;
+    double speed = std::sqrt(PhysicsConstants::k * PhysicsConstants::e * PhysicsConstants::e /
+                             (PhysicsConstants::m_e * radius));
+    double omega = speed / radius;
+    double period = 2.0 * M_PI / omega;
+
+    void build(ParticleSystem& system, Method method) const {
+        Particle nucleus = Particle::createProton(glm::dvec3(0.0));
+        nucleus.isFixed = true;
+        system.addParticle(nucleus);
+        Particle electron = Particle::createElectron(glm::dvec3(radius, 0.0, 0.0));
+        electron.velocity = glm::dvec3(0.0, speed, 0.0);
+        system.addParticle(electron);
+        system.setIntegrationMethod(method);
+        system.setCollisionPrevention(false);
+        system.setThreadCount(1);
+    }
+
+    double energy(const ParticleSystem& system) const {
+        const Particle& e = system.getParticles()[1];
+        return 0.5 * e.mass * glm::dot(e.velocity, e.velocity) +
+               PhysicsConstants::k * e.charge * PhysicsConstants::e / glm::length(e.position);
+    }
+};
+
+double positionError(Method method, int stepsPerOrbit) {
+    Orbit orbit;
+    ParticleSystem system;
+    orbit.build(system, method);
+    for (int i = 0; i < stepsPerOrbit; ++i) {
+        system.step(orbit.period / stepsPerOrbit);
+    }
+    return glm::length(system.getParticles()[1].position - glm::dvec3(orbit.radius, 0.0, 0.0)) / orbit.radius;
+}
+
+void testConvergenceOrder() {
+    std::cout << "Testing convergence order..." << std::endl;
+
+    // Halving dt divides the error by 2^order
+    double verlet = positionError(Method::VERLET, 128) / positionError(Method::VERLET, 256);
+    double yoshida = positionError(Method::YOSHIDA4, 128) / positionError(Method::YOSHIDA4, 256);
+    double rk4 = positionError(Method::RK4, 128) / positionError(Method::RK4, 256);
+    assert(verlet > 3.5 && verlet < 4.5);
+    assert(yoshida > 13.0 && yoshida < 20.0);
+    assert(rk4 > 13.0 && rk4 < 20.0);
+
+    std::cout << "  ✓ Convergence order test passed (error ratios " << verlet << ", " << yoshida
+              << ", " << rk4 << ")" << std::endl;
+}
+
+void testEnergyConservation() {
+    std::cout << "Testing energy conservation..." << std::endl;
+
+    // Coarse steps over many orbits: symplectic methods keep the energy error
+    // bounded, RK4 drifts steadily
+    auto run = [](Method method, double& maxError, double& finalError) {
+        Orbit orbit;
+        ParticleSystem system;
+        orbit.build(system, method);
+        double e0 = orbit.energy(system);
+        maxError = 0.0;
+        for (int i = 0; i < 200 * 24; ++i) {
+            system.step(orbit.period / 24);
+            maxError = std::max(maxError, std::abs(orbit.energy(system) / e0 - 1.0));
+        }
+        finalError = std::abs(orbit.energy(system) / e0 - 1.0);
+    };
+
+    double verletMax, verletFinal, yoshidaMax, yoshidaFinal, rk4Max, rk4Final;
+    run(Method::VERLET, verletMax, verletFinal);
+    run(Method::YOSHIDA4, yoshidaMax, yoshidaFinal);
+    run(Method::RK4, rk4Max, rk4Final);
+    assert(verletMax < 1e-2);
+    assert(yoshidaMax < verletMax);
+    assert(rk4Final > 10.0 * yoshidaMax);  // Secular drift exceeds the bounded oscillation
+
+    std::cout << "  ✓ Energy conservation test passed" << std::endl;
+}
+
+void testForceReuse() {
+    std::cout << "Testing force evaluation reuse..." << std::endl;
+
+    Orbit orbit;
+    const double dt = orbit.period / 100;
+
+    // Verlet: one evaluation per step after the first
+    ParticleSystem verlet;
+    orbit.build(verlet, Method::VERLET);
+    for (int i = 0; i < 10; ++i) {
+        verlet.step(dt);
+    }
+    assert(verlet.getForceEvaluationCount() == 11);
+
+    // Editing a particle invalidates the saved forces
+    verlet.getParticles()[1].position.x *= 1.01;
+    verlet.step(dt);
+    assert(verlet.getForceEvaluationCount() == 13);
+    verlet.setMagneticInteraction(true);
+    verlet.step(dt);
+    assert(verlet.getForceEvaluationCount() == 15);
+
+    ParticleSystem yoshida;
+    orbit.build(yoshida, Method::YOSHIDA4);
+    ParticleSystem rk4;
+    orbit.build(rk4, Method::RK4);
+    for (int i = 0; i < 10; ++i) {
+        yoshida.step(dt);
+        rk4.step(dt);
+    }
+    assert(yoshida.getForceEvaluationCount() == 31);
+    assert(rk4.getForceEvaluationCount() == 40);
+
+    std::cout << "  ✓ Force reuse test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running integrator unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testConvergenceOrder();
+        testEnergyConservation();
+        testForceReuse();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,203 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Unit tests for magnetic fields, the Lorentz force and the Boris pusher
+ */
+
+const double c = PhysicsConstants::c;
+
+// One proton in external fields only
+void buildSingle(ParticleSystem& system, const glm::dvec3& velocity, ParticleSystem::IntegrationMethod method) {
+    Particle p = Particle::createProton(glm::dvec3(0.0));
+    p.velocity = velocity;
+    system.addParticle(p);
+    system.setIntegrationMethod(method);
+    system.setCollisionPrevention(false);
+    system.setThreadCount(1);
+}
+
+void testBorisGyration() {
+    std::cout << "Testing Boris gyration..." << std::endl;
+
+    // Coarse step: ω dt = 0.5, about 12 steps per gyration
+    const double B = 1.0;
+    const double speed = 1e5;
+    const double omega = PhysicsConstants::e * B / PhysicsConstants::m_p;
+    const double dt = 0.5 / omega;
+    const double radius = speed / omega;
+
+    ParticleSystem boris;
+    buildSingle(boris, glm::dvec3(speed, 0.0, 0.0), ParticleSystem::IntegrationMethod::BORIS);
+    boris.getExternalField().setUniformMagnetic(glm::dvec3(0.0, 0.0, B));
+
+    double maxDistance = 0.0;
+    for (int i = 0; i < 2000; ++i) {
+        boris.step(dt);
+        const Particle& p = boris.getParticles()[0];
+        maxDistance = std::max(maxDistance, glm::length(p.position));
+        assert(std::abs(glm::length(p.velocity) - speed) < 1e-12 * speed);
+    }
+    // Bounded circular orbit (slightly larger than the exact radius at this step)
+    assert(maxDistance < 2.2 * radius);
+    assert(boris.getParticles()[0].position.z == 0.0);
+
+    // Velocity Verlet gains energy every step at the same dt
+    ParticleSystem verlet;
+    buildSingle(verlet, glm::dvec3(speed, 0.0, 0.0), ParticleSystem::IntegrationMethod::VERLET);
+    verlet.getExternalField().setUniformMagnetic(glm::dvec3(0.0, 0.0, B));
+    for (int i = 0; i < 20; ++i) {
+        verlet.step(dt);
+    }
+    assert(glm::length(verlet.getParticles()[0].velocity) > 2.0 * speed);
+
+    std::cout << "  ✓ Boris gyration test passed" << std::endl;
+}
+
+void testExBDrift() {
+    std::cout << "Testing E × B drift..." << std::endl;
+
+    // Guiding center drifts at E × B / B², independent of charge and mass
+    const glm::dvec3 E(0.0, 1e3, 0.0);
+    const glm::dvec3 B(0.0, 0.0, 1.0);
+    const glm::dvec3 drift = glm::cross(E, B) / glm::dot(B, B);
+    const double omega = PhysicsConstants::e / PhysicsConstants::m_p;
+    const double dt = 0.1 / omega;
+    const int steps = 3000;  // ~48 gyrations
+
+    ParticleSystem system;
+    buildSingle(system, glm::dvec3(0.0), ParticleSystem::IntegrationMethod::BORIS);
+    system.getExternalField().setUniformElectric(E);
+    system.getExternalField().setUniformMagnetic(B);
+    for (int i = 0; i < steps; ++i) {
+        system.step(dt);
+    }
+
+    glm::dvec3 meanVelocity = system.getParticles()[0].position / system.getSimulationTime();
+    assert(std::abs(meanVelocity.x - drift.x) < 0.01 * drift.x);
+    assert(std::abs(meanVelocity.y) < 0.01 * drift.x);
+
+    std::cout << "  ✓ E × B drift test passed" << std::endl;
+}
+
+void testMagneticKernel() {
+    std::cout << "Testing vectorized magnetic field..." << std::endl;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> pos(-1e-6, 1e-6);
+    std::uniform_real_distribution<double> vel(-1e6, 1e6);
+    std::vector<Particle> particles;
+    for (int i = 0; i < 200; ++i) {
+        Particle p = i % 3 == 0 ? Particle::createProton(glm::dvec3(pos(rng), pos(rng), pos(rng)))
+                                : Particle::createElectron(glm::dvec3(pos(rng), pos(rng), pos(rng)));
+        p.velocity = glm::dvec3(vel(rng), vel(rng), vel(rng));
+        particles.push_back(p);
+    }
+    ParticleStore store;
+    store.loadFrom(particles);
+
+    ParticleStore::AlignedVector<double> qvx(store.size()), qvy(store.size()), qvz(store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        qvx[i] = store.q[i] * store.vx[i];
+        qvy[i] = store.q[i] * store.vy[i];
+        qvz[i] = store.q[i] * store.vz[i];
+    }
+
+    for (size_t i = 0; i < store.size(); i += 7) {
+        glm::dvec3 exact = MagneticField::totalField(store.position(i), store);
+        glm::dvec3 fast = MagneticField::totalField(store.position(i), store.x.data(), store.y.data(),
+                                                    store.z.data(), qvx.data(), qvy.data(), qvz.data(),
+                                                    store.size());
+        assert(glm::length(fast - exact) <= 1e-9 * glm::length(exact));
+    }
+
+    std::cout << "  ✓ Vectorized magnetic field test passed" << std::endl;
+}
+
+void testMovingChargeInteraction() {
+    std::cout << "Testing magnetic force between moving charges..." << std::endl;
+
+    // Two protons moving side by side: magnetic attraction reduces the Coulomb
+    // repulsion by the factor (1 - v²/c²) (to first order in the fields)
+    const double d = 1e-6;
+    const double v = 0.05 * c;
+    auto repulsion = [&](bool magnetic) {
+        ParticleSystem system;
+        for (double y : {0.0, d}) {
+            Particle p = Particle::createProton(glm::dvec3(0.0, y, 0.0));
+            p.velocity = glm::dvec3(v, 0.0, 0.0);
+            system.addParticle(p);
+        }
+        system.setCollisionPrevention(false);
+        system.setIntegrationMethod(ParticleSystem::IntegrationMethod::EULER);  // Forces at the start state
+        system.setMagneticInteraction(magnetic);
+        system.step(1e-20);
+        const auto& particles = system.getParticles();
+        assert(std::abs(particles[0].acceleration.y + particles[1].acceleration.y) <
+               1e-12 * std::abs(particles[1].acceleration.y));
+        return particles[1].acceleration.y;
+    };
+
+    double coulomb = PhysicsConstants::k * PhysicsConstants::e * PhysicsConstants::e /
+                     (PhysicsConstants::m_p * d * d);
+    assert(std::abs(repulsion(false) - coulomb) < 1e-9 * coulomb);
+    double expected = coulomb * (1.0 - v * v / (c * c));
+    assert(std::abs(repulsion(true) - expected) < 1e-9 * coulomb);
+
+    std::cout << "  ✓ Moving charge interaction test passed" << std::endl;
+}
+
+void testFieldFunction() {
+    std::cout << "Testing user-defined external field..." << std::endl;
+
+    // Field gradient plus a uniform part; both contribute
+    ParticleSystem system;
+    Particle p = Particle::createElectron(glm::dvec3(2e-3, 0.0, 0.0));
+    p.velocity = glm::dvec3(0.0, 1e4, 0.0);
+    system.addParticle(p);
+    system.setCollisionPrevention(false);
+    system.setIntegrationMethod(ParticleSystem::IntegrationMethod::EULER);  // Forces at the start state
+    system.getExternalField().setUniformElectric(glm::dvec3(0.0, 0.0, 50.0));
+    system.getExternalField().setFunction([](const glm::dvec3& position, double, glm::dvec3& E, glm::dvec3& B) {
+        E = glm::dvec3(1e6 * position.x, 0.0, 0.0);
+        B = glm::dvec3(0.0, 0.0, 1e-3);
+    });
+    assert(system.getExternalField().isActive());
+    system.step(1e-15);
+
+    glm::dvec3 E(2e3, 0.0, 50.0);
+    glm::dvec3 B(0.0, 0.0, 1e-3);
+    glm::dvec3 expected = -PhysicsConstants::e * (E + glm::cross(p.velocity, B)) / PhysicsConstants::m_e;
+    glm::dvec3 acceleration = system.getParticles()[0].acceleration;
+    assert(glm::length(acceleration - expected) < 1e-12 * glm::length(expected));
+
+    system.getExternalField().setFunction(nullptr);
+    system.getExternalField().setUniformElectric(glm::dvec3(0.0));
+    assert(!system.getExternalField().isActive());
+
+    std::cout << "  ✓ User-defined external field test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Lorentz force unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testBorisGyration();
+        testExBDrift();
+        testMagneticKernel();
+        testMovingChargeInteraction();
+        testFieldFunction();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,142 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "engine/physics/NeighborGrid.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Unit tests for the neighbor grid (spatial hash pair and point queries)
+ */
+
+struct Points {
+    std::vector<double> x, y, z;
+
+    Points(size_t count, double extent, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> coordinate(-extent, extent);
+        for (size_t i = 0; i < count; ++i) {
+            x.push_back(coordinate(rng));
+            y.push_back(coordinate(rng));
+            z.push_back(coordinate(rng));
+        }
+    }
+
+    double distanceSquared(size_t i, size_t j) const {
+        double dx = x[i] - x[j];
+        double dy = y[i] - y[j];
+        double dz = z[i] - z[j];
+        return dx * dx + dy * dy + dz * dz;
+    }
+};
+
+void testPairsMatchBruteForce() {
+    std::cout << "Testing pair search..." << std::endl;
+
+    // Dense and sparse scenes, including cells much smaller than the spacing
+    for (double radius : {0.05, 0.2, 1e-3}) {
+        Points points(2000, 1.0, 7);
+        NeighborGrid grid;
+        grid.build(points.x.data(), points.y.data(), points.z.data(), points.x.size(), radius);
+
+        std::set<std::pair<size_t, size_t>> found;
+        grid.forEachPair(radius, [&](size_t i, size_t j, double d2) {
+            assert(i < j);
+            assert(std::abs(d2 - points.distanceSquared(i, j)) <= 1e-15);
+            bool inserted = found.insert({i, j}).second;
+            assert(inserted);  // Each pair once
+        });
+
+        size_t expected = 0;
+        for (size_t i = 0; i < points.x.size(); ++i) {
+            for (size_t j = i + 1; j < points.x.size(); ++j) {
+                if (points.distanceSquared(i, j) < radius * radius) {
+                    assert(found.count({i, j}) == 1);
+                    ++expected;
+                }
+            }
+        }
+        assert(found.size() == expected);
+    }
+
+    std::cout << "  ✓ Pair search test passed" << std::endl;
+}
+
+void testPointQueries() {
+    std::cout << "Testing point queries..." << std::endl;
+
+    Points points(1000, 1.0, 11);
+    NeighborGrid grid;
+    grid.build(points.x.data(), points.y.data(), points.z.data(), points.x.size(), 0.1);
+
+    // Radii below, at and far above the cell size
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coordinate(-1.2, 1.2);
+    for (double radius : {0.03, 0.1, 0.35, 5.0}) {
+        for (int q = 0; q < 20; ++q) {
+            glm::dvec3 point(coordinate(rng), coordinate(rng), coordinate(rng));
+            std::vector<size_t> expected;
+            for (size_t j = 0; j < points.x.size(); ++j) {
+                glm::dvec3 d = glm::dvec3(points.x[j], points.y[j], points.z[j]) - point;
+                if (glm::dot(d, d) < radius * radius) {
+                    expected.push_back(j);
+                }
+            }
+            assert(grid.neighbors(point, radius) == expected);
+        }
+    }
+
+    // Empty grid
+    NeighborGrid empty;
+    empty.build(nullptr, nullptr, nullptr, 0, 1.0);
+    assert(empty.neighbors(glm::dvec3(0.0), 10.0).empty());
+
+    std::cout << "  ✓ Point query test passed" << std::endl;
+}
+
+void testCollisionPrevention() {
+    std::cout << "Testing collision prevention..." << std::endl;
+
+    // Two neutral particles inside the minimum separation are pushed apart;
+    // a third one far away is untouched. The Boris pusher, which integrates
+    // the fields rather than the acceleration, must see the repulsion too.
+    for (auto method : {ParticleSystem::IntegrationMethod::VERLET, ParticleSystem::IntegrationMethod::BORIS}) {
+        ParticleSystem system;
+        system.setThreadCount(1);
+        system.setIntegrationMethod(method);
+        system.setMinSeparation(1e-9);
+        system.addParticle(Particle::createCustom(glm::dvec3(0.0), 0.0, 1e-27));
+        system.addParticle(Particle::createCustom(glm::dvec3(5e-10, 0.0, 0.0), 0.0, 1e-27));
+        system.addParticle(Particle::createCustom(glm::dvec3(1e-6, 0.0, 0.0), 0.0, 1e-27));
+        system.step(1e-15);
+
+        const auto& particles = system.getParticles();
+        assert(particles[0].velocity.x < 0.0);
+        assert(particles[1].velocity.x > 0.0);
+        assert(std::abs(particles[0].velocity.x + particles[1].velocity.x) <= 1e-12 * std::abs(particles[1].velocity.x));
+        assert(particles[2].velocity == glm::dvec3(0.0));
+    }
+
+    std::cout << "  ✓ Collision prevention test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running neighbor grid unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testPairsMatchBruteForce();
+        testPointQueries();
+        testCollisionPrevention();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
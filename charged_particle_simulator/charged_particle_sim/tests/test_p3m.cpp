@@ -0,0 +1,231 @@
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "engine/math/Fft.hpp"
+#include "engine/physics/P3MSolver.hpp"
+#include "engine/core/Constants.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+#include "PeriodicTestUtils.hpp"
+
+/**
+ * Unit tests for the FFT, periodic boxes and the P3M solver
+ */
+
+using Complex = std::complex<double>;
+
+std::vector<Complex> naiveDft(const std::vector<Complex>& values) {
+    const size_t n = values.size();
+    std::vector<Complex> result(n);
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t j = 0; j < n; ++j) {
+            result[k] += values[j] * std::polar(1.0, -2.0 * M_PI * static_cast<double>(j * k % n) / n);
+        }
+    }
+    return result;
+}
+
+void testFft() {
+    std::cout << "Testing FFT..." << std::endl;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    for (size_t n : {1, 2, 8, 64}) {
+        std::vector<Complex> data(n);
+        for (auto& v : data) {
+            v = Complex(value(rng), value(rng));
+        }
+        std::vector<Complex> expected = naiveDft(data);
+        std::vector<Complex> transformed = data;
+        Fft plan(n);
+        plan.transform(transformed.data(), false);
+        for (size_t k = 0; k < n; ++k) {
+            assert(std::abs(transformed[k] - expected[k]) < 1e-12);
+        }
+        plan.transform(transformed.data(), true);
+        for (size_t k = 0; k < n; ++k) {
+            assert(std::abs(transformed[k] / static_cast<double>(n) - data[k]) < 1e-13);
+        }
+    }
+    assert(Fft::nextPowerOfTwo(33) == 64 && Fft::nextPowerOfTwo(32) == 32);
+
+    // 3D: a single plane wave transforms to a single peak, with or without threads
+    const glm::ivec3 counts(16, 8, 32);
+    const glm::ivec3 wave(3, 5, 30);
+    std::vector<Complex> grid(static_cast<size_t>(counts.x) * counts.y * counts.z);
+    for (int z = 0; z < counts.z; ++z) {
+        for (int y = 0; y < counts.y; ++y) {
+            for (int x = 0; x < counts.x; ++x) {
+                double phase = 2.0 * M_PI * (double(wave.x * x) / counts.x + double(wave.y * y) / counts.y +
+                                             double(wave.z * z) / counts.z);
+                grid[(static_cast<size_t>(z) * counts.y + y) * counts.x + x] = std::polar(1.0, phase);
+            }
+        }
+    }
+    std::vector<Complex> serial = grid;
+    Fft::transform3d(serial.data(), counts, false);
+    ThreadPool pool(3);
+    std::vector<Complex> parallel = grid;
+    Fft::transform3d(parallel.data(), counts, false, &pool);
+    assert(serial == parallel);
+    const size_t peak = (static_cast<size_t>(wave.z) * counts.y + wave.y) * counts.x + wave.x;
+    for (size_t n = 0; n < serial.size(); ++n) {
+        double expected = n == peak ? static_cast<double>(serial.size()) : 0.0;
+        assert(std::abs(serial[n] - expected) < 1e-9);
+    }
+    Fft::transform3d(serial.data(), counts, true, &pool);
+    for (size_t n = 0; n < serial.size(); ++n) {
+        assert(std::abs(serial[n] / static_cast<double>(serial.size()) - grid[n]) < 1e-12);
+    }
+
+    std::cout << "  ✓ FFT test passed" << std::endl;
+}
+
+void testPeriodicBox() {
+    std::cout << "Testing periodic box..." << std::endl;
+
+    PeriodicBox box(glm::dvec3(-1.0, 0.0, 2.0), glm::dvec3(1.0, 4.0, 3.0));
+    assert(box.isValid() && box.volume() == 8.0 && box.shortestSide() == 1.0);
+    assert(!PeriodicBox(glm::dvec3(0.0), glm::dvec3(1.0, 0.0, 1.0)).isValid());
+
+    // Inside: unchanged; outside: shifted by whole box sizes
+    const glm::dvec3 inside(0.3, 1.7, 2.2);
+    assert(box.wrap(inside) == inside);
+    glm::dvec3 wrapped = box.wrap(glm::dvec3(1.5, -4.5, 5.25));
+    assert(glm::length(wrapped - glm::dvec3(-0.5, 3.5, 2.25)) < 1e-12);
+    assert(box.wrap(glm::dvec3(1.0, 4.0, 3.0)) == box.getLow());
+    glm::dvec3 image = box.minimumImage(glm::dvec3(1.5, -3.0, 0.75));
+    assert(glm::length(image - glm::dvec3(-0.5, 1.0, -0.25)) < 1e-12);
+
+    // Images: a particle near an edge reappears beyond both faces and across the edge
+    ParticleStore store;
+    store.resize(2);
+    store.setPosition(0, glm::dvec3(-0.95, 0.1, 2.5));
+    store.setPosition(1, glm::dvec3(0.0, 2.0, 2.95));
+    store.q[0] = 1.0;
+    store.q[1] = -1.0;
+    PeriodicBox::Images images;
+    box.buildImages(store, 0.2, images);
+    assert(images.primaryCount == 2);
+    assert(images.size() == 2 + 3 + 1);
+    for (size_t k = 2; k < images.size(); ++k) {
+        assert(images.q[k] == store.q[images.source[k]]);
+    }
+    assert(images.x[2] == -0.95 && images.y[2] == 0.1 + 4.0 && images.z[2] == 2.5);
+
+    std::cout << "  ✓ Periodic box test passed" << std::endl;
+}
+
+void testAgainstEwald() {
+    std::cout << "Testing P3M against the Ewald sum..." << std::endl;
+
+    const PeriodicBox box(glm::dvec3(-0.5, -0.5, -0.25), glm::dvec3(0.5, 0.5, 0.75));
+    ParticleStore store = makeNeutralBox(box, 60, 5);
+    const std::vector<glm::dvec3> reference = ewaldReference(store, box);
+
+    P3MSolver solver;
+    solver.setBox(box);
+    solver.computeFields(store);
+    assert(solver.getMeshSize() == 0 && solver.getMeshNodes() == P3MSolver::MIN_AUTO_MESH_SIZE);
+    assert(std::abs(std::erfc(solver.getSplitting() * solver.getCutoff()) - 1e-5) < 1e-5);
+    const double autoError = rmsRelativeError(solver.getFields(), reference);
+    assert(autoError < 2e-3);
+
+    // Results do not depend on the thread count
+    ThreadPool pool(3);
+    const std::vector<glm::dvec3> serial = solver.getFields();
+    solver.computeFields(store, &pool);
+    assert(solver.getFields() == serial);
+
+    solver.setMeshSize(32);
+    solver.computeFields(store, &pool);
+    const double tscError = rmsRelativeError(solver.getFields(), reference);
+    assert(tscError < 2e-3);
+
+    solver.setAssignment(P3MSolver::Assignment::CIC);
+    solver.computeFields(store, &pool);
+    const double cicError = rmsRelativeError(solver.getFields(), reference);
+    assert(cicError < 1e-2);
+
+    // Finer mesh, shorter cutoff: the mesh carries more of the sum
+    solver.setAssignment(P3MSolver::Assignment::TSC);
+    solver.setMeshSize(40);
+    assert(solver.getMeshSize() == 64);
+    solver.computeFields(store, &pool);
+    assert(solver.getMeshNodes() == 64 && solver.getCutoff() == P3MSolver::AUTO_CUTOFF_CELLS / 64.0);
+    const double fineError = rmsRelativeError(solver.getFields(), reference);
+    assert(fineError < 2e-3);
+
+    // Whole box shifts of the input change nothing
+    ParticleStore shifted = store;
+    for (size_t i = 0; i < shifted.size(); ++i) {
+        shifted.setPosition(i, shifted.position(i) + glm::dvec3(i % 3 == 0 ? 1.0 : -2.0, 0.0, 3.0));
+    }
+    const std::vector<glm::dvec3> fields = solver.getFields();
+    solver.computeFields(shifted, &pool);
+    assert(rmsRelativeError(solver.getFields(), fields) < 1e-9);
+
+    std::cout << "  ✓ Ewald comparison passed (rms relative error automatic mesh " << autoError
+              << ", TSC " << tscError
+              << ", CIC " << cicError << ", TSC 64³ " << fineError << ")" << std::endl;
+}
+
+void testParticleSystem() {
+    std::cout << "Testing periodic particle system..." << std::endl;
+
+    // A close pair in a large box: the periodic images barely matter
+    const double side = 1e-6;
+    ParticleSystem system;
+    system.setCollisionPrevention(false);
+    system.addParticle(Particle::createProton(glm::dvec3(-1e-8, 2e-9, 0.0)));
+    system.addParticle(Particle::createElectron(glm::dvec3(1e-8, 0.0, 1e-9)));
+    system.setForceMethod(ParticleSystem::ForceMethod::P3M);
+
+    // Without a box P3M runs as the direct sum
+    system.step(1e-18);
+    const glm::dvec3 direct = system.getParticles()[0].acceleration;
+    system.reset();
+
+    system.setPeriodicBox(glm::dvec3(-0.5 * side), glm::dvec3(0.5 * side));
+    assert(system.isPeriodic());
+    system.setMeshSize(64);
+    system.step(1e-18);
+    const glm::dvec3 periodic = system.getParticles()[0].acceleration;
+    assert(glm::length(periodic - direct) < 1e-2 * glm::length(direct));
+
+    // Particles leaving through a face come back through the opposite one
+    system.reset();
+    system.getParticles()[1].velocity = glm::dvec3(0.0, 0.0, 1e6);
+    for (int i = 0; i < 12; ++i) {
+        system.step(5e-14);
+    }
+    const glm::dvec3 position = system.getParticles()[1].position;
+    assert(position.z < 0.0 && position.z >= -0.5 * side);
+    assert(system.getPeriodicBox().wrap(position) == position);
+
+    system.clearPeriodicBox();
+    assert(!system.isPeriodic());
+
+    std::cout << "  ✓ Particle system test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running P3M unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testFft();
+        testPeriodicBox();
+        testAgainstEwald();
+        testParticleSystem();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,195 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "engine/physics/ParticleHistory.hpp"
+#include "engine/physics/ElectricField.hpp"
+
+/**
+ * Unit tests for the particle history ring buffer and retarded-time lookup
+ */
+
+bool approxEqual(const glm::dvec3& a, const glm::dvec3& b, double tolerance) {
+    return glm::length(a - b) <= tolerance * std::max(1.0, glm::length(b));
+}
+
+// Circular motion: x = cos(wt), y = sin(wt)
+glm::dvec3 circlePosition(double t) { return glm::dvec3(std::cos(t), std::sin(t), 0.0); }
+glm::dvec3 circleVelocity(double t) { return glm::dvec3(-std::sin(t), std::cos(t), 0.0); }
+
+void testRingBuffer() {
+    std::cout << "Testing ring buffer wrap-around..." << std::endl;
+
+    ParticleHistory history(8);
+    assert(history.empty());
+    assert(history.findInterval(1.0) == 0);
+
+    for (int i = 0; i < 20; ++i) {
+        history.record(i, glm::dvec3(i, 0.0, 0.0), glm::dvec3(0.0, i, 0.0));
+    }
+    assert(history.size() == 8);
+    assert(history.oldestTime() == 12.0);
+    assert(history.newestTime() == 19.0);
+    for (size_t i = 0; i < history.size(); ++i) {
+        assert(history.timestamp(i) == 12.0 + i);
+        assert(history[i].position.x == 12.0 + i);
+        assert(history.velocity(i).y == 12.0 + i);
+    }
+
+    history.clear();
+    assert(history.empty());
+    history.record(5.0, glm::dvec3(1.0), glm::dvec3(0.0));
+    assert(history.size() == 1 && history.oldestTime() == 5.0);
+
+    std::cout << "  ✓ Ring buffer test passed" << std::endl;
+}
+
+void testFindInterval() {
+    std::cout << "Testing interval search..." << std::endl;
+
+    // Uniform spacing (interpolation probe) after wrap-around
+    ParticleHistory uniform(100);
+    for (int i = 0; i < 250; ++i) {
+        uniform.record(i * 0.1, glm::dvec3(0.0), glm::dvec3(0.0));
+    }
+    for (int i = 150; i < 249; ++i) {
+        size_t index = uniform.findInterval(i * 0.1 + 0.05);
+        assert(uniform.timestamp(index) <= i * 0.1 + 0.05);
+        assert(uniform.timestamp(index + 1) > i * 0.1 + 0.05);
+    }
+    assert(uniform.findInterval(0.0) == uniform.size());   // Before the oldest sample
+    assert(uniform.findInterval(1e9) == uniform.size() - 1);
+
+    // Irregular spacing (binary search fallback), checked against a linear scan
+    std::mt19937 rng(3);
+    std::exponential_distribution<double> gap(1.0);
+    ParticleHistory irregular(500);
+    double t = 0.0;
+    for (int i = 0; i < 700; ++i) {
+        t += gap(rng) * (i % 50 == 0 ? 100.0 : 1.0);
+        irregular.record(t, glm::dvec3(0.0), glm::dvec3(0.0));
+    }
+    std::uniform_real_distribution<double> query(irregular.oldestTime(), irregular.newestTime());
+    for (int q = 0; q < 2000; ++q) {
+        double time = query(rng);
+        size_t expected = 0;
+        while (expected + 1 < irregular.size() && irregular.timestamp(expected + 1) <= time) {
+            ++expected;
+        }
+        assert(irregular.findInterval(time) == expected);
+    }
+
+    std::cout << "  ✓ Interval search test passed" << std::endl;
+}
+
+void testHermiteInterpolation() {
+    std::cout << "Testing Hermite interpolation..." << std::endl;
+
+    const double dt = 0.05;
+    ParticleHistory history(1000);
+    for (int i = 0; i <= 200; ++i) {
+        history.record(i * dt, circlePosition(i * dt), circleVelocity(i * dt));
+    }
+
+    // Exact at the samples
+    glm::dvec3 position;
+    glm::dvec3 velocity;
+    assert(history.sample(50 * dt, position, velocity));
+    assert(position == circlePosition(50 * dt));
+
+    // Between samples: O(dt^4) position error, far below linear interpolation's O(dt^2)
+    double maxHermite = 0.0;
+    double maxLinear = 0.0;
+    for (int i = 0; i < 200; ++i) {
+        double time = (i + 0.37) * dt;
+        assert(history.sample(time, position, velocity));
+        maxHermite = std::max(maxHermite, glm::length(position - circlePosition(time)));
+        glm::dvec3 linear = glm::mix(history.position(i), history.position(i + 1), 0.37);
+        maxLinear = std::max(maxLinear, glm::length(linear - circlePosition(time)));
+        assert(approxEqual(velocity, circleVelocity(time), 1e-3));
+    }
+    assert(maxHermite < 1e-6);
+    assert(maxHermite < maxLinear * 1e-2);
+
+    // Clamped outside the recorded range
+    assert(history.sample(-1.0, position, velocity));
+    assert(position == history.position(0));
+    assert(history.sample(100.0, position, velocity));
+    assert(position == history.position(history.size() - 1));
+
+    ParticleHistory empty;
+    position = glm::dvec3(7.0);
+    assert(!empty.sample(0.0, position, velocity));
+    assert(position == glm::dvec3(7.0));
+
+    std::cout << "  ✓ Hermite interpolation test passed (max error " << maxHermite << ")" << std::endl;
+}
+
+void testRetardedField() {
+    std::cout << "Testing retarded field lookup..." << std::endl;
+
+    // Charge moving along x at constant velocity; the retarded field is the
+    // Coulomb field of the interpolated position at t - r/c
+    const double c = PhysicsConstants::c;
+    const glm::dvec3 velocity(0.1 * c, 0.0, 0.0);
+    Particle source = Particle::createElectron(glm::dvec3(0.0));
+    const double dt = 1e-10;
+    for (int i = 0; i <= 100; ++i) {
+        source.position = velocity * (i * dt);
+        source.velocity = velocity;
+        source.recordHistory(i * dt);
+    }
+
+    double now = 100 * dt;
+    glm::dvec3 evalPoint(source.position.x, 0.3, 0.0);
+    double distance = glm::length(evalPoint - source.position);
+    glm::dvec3 retardedPosition = velocity * (now - distance / c);
+
+    glm::dvec3 expected = ElectricField::fromPointCharge(evalPoint, retardedPosition, source.charge);
+    glm::dvec3 field = ElectricField::retardedField(evalPoint, now, source);
+    assert(approxEqual(field, expected, 1e-9));
+
+    // Without history the current position is used
+    source.clearHistory();
+    glm::dvec3 instantaneous = ElectricField::fromPointCharge(evalPoint, source.position, source.charge);
+    assert(ElectricField::retardedField(evalPoint, now, source) == instantaneous);
+
+    std::cout << "  ✓ Retarded field test passed" << std::endl;
+}
+
+void testLazyAllocation() {
+    std::cout << "Testing lazy allocation..." << std::endl;
+
+    // Particles that never record history copy without touching the buffer
+    std::vector<Particle> particles(1000, Particle::createProton(glm::dvec3(0.0)));
+    std::vector<Particle> copy = particles;
+    assert(copy[999].history.empty());
+    assert(copy[999].history.capacity() == Particle::MAX_HISTORY);
+
+    copy[0].recordHistory(0.0);
+    assert(copy[0].history.size() == 1);
+    assert(particles[0].history.empty());
+
+    std::cout << "  ✓ Lazy allocation test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running particle history unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testRingBuffer();
+        testFindInterval();
+        testHermiteInterpolation();
+        testRetardedField();
+        testLazyAllocation();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,189 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <utility>
+#include "engine/physics/PotentialGrid.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "TestUtils.hpp"
+
+/**
+ * Unit tests for the potential grid and equipotential extraction
+ */
+
+/**
+ * Largest node error relative to the sum of |contributions| at that node
+ */
+double maxNodeError(const PotentialGrid& grid, const std::vector<Particle>& particles) {
+    std::vector<Particle> magnitudes = particles;
+    for (auto& p : magnitudes) {
+        p.charge = std::abs(p.charge);
+    }
+    const glm::ivec3& counts = grid.getCounts();
+    double worst = 0.0;
+    for (int z = 0; z < counts.z; z += 3) {
+        for (int y = 0; y < counts.y; y += 3) {
+            for (int x = 0; x < counts.x; x += 3) {
+                glm::dvec3 node = grid.nodePosition(x, y, z);
+                double exact = ElectricField::totalPotential(node, particles);
+                double scale = ElectricField::totalPotential(node, magnitudes);
+                worst = std::max(worst, std::abs(grid.nodePotential(x, y, z) - exact) / scale);
+            }
+        }
+    }
+    return worst;
+}
+
+void testMethods() {
+    std::cout << "Testing direct, tree and FMM evaluation..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(300, 1, 1.0, 1e-6);
+
+    PotentialGrid direct;
+    direct.setResolution(24);
+    const auto& stats = direct.update(particles);
+    assert(stats.fullEvaluation && stats.nodeCount == direct.getNodeCount());
+    assert(direct.getCounts() == glm::ivec3(25));
+    double directError = maxNodeError(direct, particles);
+    assert(directError < 1e-12);
+
+    // Blocked sums do not depend on the thread count
+    ThreadPool pool(3);
+    PotentialGrid parallel;
+    parallel.setResolution(24);
+    parallel.update(particles, &pool);
+    assert(parallel.getValues() == direct.getValues());
+
+    PotentialGrid tree;
+    tree.setResolution(24);
+    tree.setMethod(PotentialGrid::Method::BARNES_HUT);
+    tree.update(particles, &pool);
+    double treeError = maxNodeError(tree, particles);
+    assert(treeError < 1e-2);
+
+    PotentialGrid fmm;
+    fmm.setResolution(24);
+    fmm.setMethod(PotentialGrid::Method::FMM);
+    fmm.update(particles, &pool);
+    double fmmError = maxNodeError(fmm, particles);
+    assert(fmmError < 1e-3);
+
+    std::cout << "  ✓ Evaluation test passed (max relative error direct " << directError
+              << ", tree " << treeError << ", FMM " << fmmError << ")" << std::endl;
+}
+
+void testIncrementalUpdate() {
+    std::cout << "Testing incremental updates..." << std::endl;
+
+    std::vector<Particle> particles = makeRandomCloud(200, 2, 1.0, 1e-6);
+    PotentialGrid grid;
+    grid.setResolution(20);
+    grid.update(particles);
+
+    // Nothing changed: nothing to do
+    const auto& unchanged = grid.update(particles);
+    assert(!unchanged.fullEvaluation && unchanged.changedParticles == 0);
+
+    // Two moved, one changed charge: only their contributions are replaced
+    particles[3].position += glm::dvec3(0.2, -0.1, 0.05);
+    particles[150].position.z -= 0.3;
+    particles[77].charge *= -2.0;
+    const glm::dvec3 origin = grid.getOrigin();
+    const auto& incremental = grid.update(particles);
+    assert(!incremental.fullEvaluation && incremental.changedParticles == 3);
+    assert(grid.getOrigin() == origin);
+
+    PotentialGrid fresh;
+    fresh.setBounds(grid.getOrigin(), grid.getOrigin() + grid.getCellSize() * glm::dvec3(grid.getCounts() - 1));
+    fresh.setResolution(20);
+    fresh.update(particles);
+    assert(fresh.getCounts() == grid.getCounts());
+    double worst = 0.0;
+    for (size_t n = 0; n < grid.getValues().size(); ++n) {
+        worst = std::max(worst, std::abs(grid.getValues()[n] - fresh.getValues()[n]) /
+                                (std::abs(fresh.getValues()[n]) + 1.0));
+    }
+    assert(worst < 1e-9);
+
+    // Many changes: a full evaluation is cheaper
+    for (size_t i = 0; i < particles.size(); i += 2) {
+        particles[i].position.x += 0.01;
+    }
+    assert(grid.update(particles).fullEvaluation);
+
+    // Periodic full refresh
+    int fullUpdates = 0;
+    for (int step = 0; step <= PotentialGrid::REFRESH_INTERVAL; ++step) {
+        particles[0].position.y += 1e-3;
+        fullUpdates += grid.update(particles).fullEvaluation ? 1 : 0;
+    }
+    assert(fullUpdates == 1);
+
+    std::cout << "  ✓ Incremental update test passed (max deviation " << worst << ")" << std::endl;
+}
+
+void testEquipotentialSphere() {
+    std::cout << "Testing equipotential extraction..." << std::endl;
+
+    // A single charge has no extent: nothing is sampled without fixed bounds
+    const glm::dvec3 center(0.013, -0.021, 0.007);
+    std::vector<Particle> particles = {Particle::createCustom(center, 1e-6, 1.0)};
+    PotentialGrid grid;
+    grid.update(particles);
+    IsosurfaceMesh mesh;
+    grid.extractEquipotential(1e4, mesh);
+    assert(grid.getNodeCount() == 0 && mesh.empty());
+
+    // Sphere of radius 0.5 around it
+    grid.setBounds(glm::dvec3(-1.0), glm::dvec3(1.0));
+    grid.setResolution(32);
+    grid.update(particles);
+    const double radius = 0.5;
+    grid.extractEquipotential(PhysicsConstants::k * 1e-6 / radius, mesh);
+    assert(mesh.triangleCount() > 500);
+    assert(mesh.vertices.size() == mesh.normals.size());
+
+    for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+        const glm::dvec3 p = mesh.vertices[v] - center;
+        assert(std::abs(glm::length(p) - radius) < 0.02 * radius);
+        // Potential rises toward the positive charge
+        assert(glm::dot(mesh.normals[v], glm::normalize(p)) < -0.99);
+    }
+
+    // Closed and consistently wound: every directed edge appears once and its
+    // reverse once; triangles face along the vertex normals
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        const uint32_t* tri = &mesh.indices[t];
+        for (int e = 0; e < 3; ++e) {
+            ++edges[{tri[e], tri[(e + 1) % 3]}];
+        }
+        glm::dvec3 n = glm::cross(mesh.vertices[tri[1]] - mesh.vertices[tri[0]],
+                                  mesh.vertices[tri[2]] - mesh.vertices[tri[0]]);
+        assert(glm::dot(n, mesh.normals[tri[0]]) > 0.0);
+    }
+    for (const auto& [edge, count] : edges) {
+        assert(count == 1);
+        assert(edges.count({edge.second, edge.first}) == 1);
+    }
+
+    std::cout << "  ✓ Equipotential test passed (" << mesh.triangleCount() << " triangles)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running potential grid unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testMethods();
+        testIncrementalUpdate();
+        testEquipotentialSphere();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
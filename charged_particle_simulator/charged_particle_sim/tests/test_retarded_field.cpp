@@ -0,0 +1,250 @@
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "engine/physics/RetardedFieldSolver.hpp"
+#include "engine/physics/ElectricField.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Unit tests for the retarded (Liénard–Wiechert) field solver
+ */
+
+const double c = PhysicsConstants::c;
+
+double relativeError(const glm::dvec3& value, const glm::dvec3& expected) {
+    return glm::length(value - expected) / glm::length(expected);
+}
+
+// Store with one moving source (index 0) and one observer at rest (index 1)
+ParticleStore makePair(const glm::dvec3& sourcePos, const glm::dvec3& sourceVel, const glm::dvec3& observer) {
+    std::vector<Particle> particles;
+    Particle source = Particle::createElectron(sourcePos);
+    source.velocity = sourceVel;
+    particles.push_back(source);
+    particles.push_back(Particle::createProton(observer));
+    ParticleStore store;
+    store.loadFrom(particles);
+    return store;
+}
+
+// Record `frames` frames of a trajectory, ending at time `now`
+void recordTrajectory(
+    RetardedFieldSolver& solver,
+    const std::function<glm::dvec3(double)>& position,
+    const std::function<glm::dvec3(double)>& velocity,
+    const glm::dvec3& observer,
+    double now,
+    double dt,
+    int frames
+) {
+    for (int f = frames - 1; f >= 0; --f) {
+        double t = now - f * dt;
+        ParticleStore store = makePair(position(t), velocity(t), observer);
+        solver.record(t, store);
+    }
+}
+
+void testStaticLimit() {
+    std::cout << "Testing static limit..." << std::endl;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(-1e-6, 1e-6);
+    std::vector<Particle> particles;
+    for (int i = 0; i < 50; ++i) {
+        glm::dvec3 pos(dist(rng), dist(rng), dist(rng));
+        particles.push_back(i % 2 == 0 ? Particle::createProton(pos) : Particle::createElectron(pos));
+    }
+    ParticleStore store;
+    store.loadFrom(particles);
+
+    // Charges at rest: Coulomb field and no magnetic field
+    RetardedFieldSolver solver;
+    ThreadPool pool(1);
+    solver.record(0.0, store);
+    solver.record(1e-12, store);
+    solver.computeFields(store, 1e-12, pool);
+
+    for (size_t i = 0; i < particles.size(); ++i) {
+        glm::dvec3 coulomb = ElectricField::totalField(particles[i].position, store);
+        assert(relativeError(solver.getElectricFields()[i], coulomb) < 1e-12);
+        assert(glm::length(solver.getMagneticFields()[i]) * c < 1e-12 * glm::length(coulomb));
+    }
+
+    std::cout << "  ✓ Static limit test passed" << std::endl;
+}
+
+void testUniformMotion() {
+    std::cout << "Testing uniformly moving charge..." << std::endl;
+
+    // Field of a uniformly moving charge points from its present position:
+    // E = kq (1 - β²) R / (R³ (1 - β² sin²θ)^(3/2))
+    const glm::dvec3 velocity(0.5 * c, 0.0, 0.0);
+    const glm::dvec3 observer(0.1, 0.3, 0.0);
+    const double now = 5e-9;
+    const double dt = 1e-10;  // Light travel time ~10 frames
+    auto position = [&](double t) { return velocity * t; };
+    auto constantVelocity = [&](double) { return velocity; };
+
+    RetardedFieldSolver solver;
+    recordTrajectory(solver, position, constantVelocity, observer, now, dt, 40);
+    ThreadPool pool(1);
+    ParticleStore store = makePair(position(now), velocity, observer);
+    solver.computeFields(store, now, pool);
+
+    glm::dvec3 R = observer - position(now);
+    double r = glm::length(R);
+    double beta2 = 0.25;
+    double sinTheta = glm::length(glm::cross(R / r, glm::dvec3(1.0, 0.0, 0.0)));
+    double q = -PhysicsConstants::e;
+    glm::dvec3 expected = PhysicsConstants::k * q * (1.0 - beta2) * R /
+                          (r * r * r * std::pow(1.0 - beta2 * sinTheta * sinTheta, 1.5));
+    glm::dvec3 expectedB = glm::cross(velocity, expected) / (c * c);
+
+    assert(relativeError(solver.getElectricFields()[1], expected) < 1e-9);
+    assert(relativeError(solver.getMagneticFields()[1], expectedB) < 1e-9);
+    assert(solver.getMeanIterations() <= 5.0);
+
+    std::cout << "  ✓ Uniform motion test passed (" << solver.getMeanIterations()
+              << " iterations/pair)" << std::endl;
+}
+
+void testAcceleratedCharge() {
+    std::cout << "Testing radiation field of an accelerated charge..." << std::endl;
+
+    // Constant acceleration: x = a t² / 2 is reproduced exactly by the Hermite cubic
+    const glm::dvec3 acceleration(2e16, 5e15, 0.0);
+    const glm::dvec3 observer(0.05, 0.2, -0.1);
+    const double now = 2e-9;
+    const double dt = 5e-11;
+    auto position = [&](double t) { return 0.5 * acceleration * t * t; };
+    auto velocity = [&](double t) { return acceleration * t; };
+
+    RetardedFieldSolver solver;
+    recordTrajectory(solver, position, velocity, observer, now, dt, 41);
+    ThreadPool pool(1);
+    ParticleStore store = makePair(position(now), velocity(now), observer);
+    solver.computeFields(store, now, pool);
+
+    // Reference: retarded time by bisection, exact state
+    double lo = 0.0;
+    double hi = now;
+    for (int i = 0; i < 200; ++i) {
+        double mid = 0.5 * (lo + hi);
+        double g = (now - mid) - glm::length(observer - position(mid)) / c;
+        (g > 0.0 ? lo : hi) = mid;
+    }
+    double tr = 0.5 * (lo + hi);
+    glm::dvec3 expectedE;
+    glm::dvec3 expectedB;
+    RetardedFieldSolver::lienardWiechert(observer, position(tr), velocity(tr), acceleration,
+                                         -PhysicsConstants::e, expectedE, expectedB);
+
+    // The radiation term matters here: dropping it changes the field noticeably
+    glm::dvec3 noRadiation;
+    glm::dvec3 unusedB;
+    RetardedFieldSolver::lienardWiechert(observer, position(tr), velocity(tr), glm::dvec3(0.0),
+                                         -PhysicsConstants::e, noRadiation, unusedB);
+    assert(relativeError(noRadiation, expectedE) > 1e-3);
+
+    assert(relativeError(solver.getElectricFields()[1], expectedE) < 1e-8);
+    assert(relativeError(solver.getMagneticFields()[1], expectedB) < 1e-8);
+
+    std::cout << "  ✓ Accelerated charge test passed" << std::endl;
+}
+
+void testThreadCountIndependence() {
+    std::cout << "Testing thread count independence..." << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> pos(-1e-3, 1e-3);
+    std::uniform_real_distribution<double> vel(-1e6, 1e6);
+    std::vector<Particle> particles;
+    for (int i = 0; i < 300; ++i) {
+        Particle p = Particle::createElectron(glm::dvec3(pos(rng), pos(rng), pos(rng)));
+        p.velocity = glm::dvec3(vel(rng), vel(rng), vel(rng));
+        particles.push_back(p);
+    }
+
+    auto run = [&](size_t threads) {
+        RetardedFieldSolver solver;
+        ThreadPool pool(threads);
+        std::vector<Particle> state = particles;
+        ParticleStore store;
+        for (int f = 0; f < 5; ++f) {
+            for (auto& p : state) {
+                p.position += p.velocity * 1e-12;
+            }
+            store.loadFrom(state);
+            solver.record(f * 1e-12, store);
+        }
+        solver.computeFields(store, 4e-12, pool);
+        return solver.getElectricFields();
+    };
+
+    std::vector<glm::dvec3> single = run(1);
+    std::vector<glm::dvec3> multi = run(4);
+    for (size_t i = 0; i < single.size(); ++i) {
+        assert(single[i] == multi[i]);
+    }
+
+    std::cout << "  ✓ Thread count independence test passed" << std::endl;
+}
+
+void testParticleSystemMode() {
+    std::cout << "Testing retarded force method..." << std::endl;
+
+    // Slow particles: retarded dynamics stay close to electrostatics
+    auto build = [](ParticleSystem& system, ParticleSystem::ForceMethod method) {
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<double> dist(-1e-6, 1e-6);
+        for (int i = 0; i < 40; ++i) {
+            glm::dvec3 p(dist(rng), dist(rng), dist(rng));
+            system.addParticle(i % 2 == 0 ? Particle::createProton(p) : Particle::createElectron(p));
+        }
+        system.setForceMethod(method);
+        system.setCollisionPrevention(false);
+        system.setThreadCount(2);
+    };
+
+    ParticleSystem direct;
+    ParticleSystem retarded;
+    build(direct, ParticleSystem::ForceMethod::DIRECT);
+    build(retarded, ParticleSystem::ForceMethod::RETARDED);
+    for (int i = 0; i < 20; ++i) {
+        direct.step(1e-13);
+        retarded.step(1e-13);
+    }
+
+    double maxDifference = 0.0;
+    for (size_t i = 0; i < direct.getParticleCount(); ++i) {
+        maxDifference = std::max(maxDifference, relativeError(
+            retarded.getParticles()[i].acceleration, direct.getParticles()[i].acceleration));
+    }
+    assert(maxDifference > 0.0);   // Retardation is actually applied
+    assert(maxDifference < 1e-3);
+
+    std::cout << "  ✓ Retarded force method test passed (max difference " << maxDifference << ")" << std::endl;
+}
+
+int main() {
+    std::cout << "Running retarded field unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testStaticLimit();
+        testUniformMotion();
+        testAcceleratedCharge();
+        testThreadCountIndependence();
+        testParticleSystemMode();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,158 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include "engine/scene/SceneLoader.hpp"
+
+/**
+ * Unit tests for the text scene format
+ */
+
+void testParticles() {
+    std::cout << "Testing particle directives..." << std::endl;
+
+    std::istringstream scene(
+        "# Dipole with an anchor\n"
+        "electron -1 0 0\n"
+        "proton 1 0 0  0 5 0   # moving proton\n"
+        "\n"
+        "particle 0 1 0 0 0 0 1e-6 2.0\n"
+        "fixed 0 -1 0 -2e-6\n"
+    );
+
+    ParticleSystem system;
+    std::string error;
+    assert(SceneLoader::load(scene, system, error));
+
+    const auto& particles = system.getParticles();
+    assert(particles.size() == 4);
+    assert(particles[0].charge < 0.0 && particles[0].position.x == -1.0);
+    assert(particles[1].charge > 0.0 && particles[1].velocity.y == 5.0);
+    assert(particles[2].charge == 1e-6 && particles[2].mass == 2.0);
+    assert(particles[3].isFixed && particles[3].charge == -2e-6);
+
+    std::cout << "  ✓ Particle directives test passed" << std::endl;
+}
+
+void testCloudAndSettings() {
+    std::cout << "Testing cloud and settings..." << std::endl;
+
+    std::istringstream scene(
+        "cloud 100 0.5 1e-9 1e-3 7\n"
+        "force_method fmm\n"
+        "expansion_order 6\n"
+        "collision_prevention off\n"
+        "integrator boris\n"
+        "electric_field 0 1e3 0\n"
+        "magnetic_field 0 0 0.5\n"
+        "magnetic_interaction on\n"
+        "time_step block\n"
+        "time_step_accuracy 0.05\n"
+        "max_time_step_level 6\n"
+    );
+
+    ParticleSystem system;
+    std::string error;
+    assert(SceneLoader::load(scene, system, error));
+    assert(system.getParticleCount() == 100);
+    assert(system.getForceMethod() == ParticleSystem::ForceMethod::FMM);
+    assert(system.getExpansionOrder() == 6);
+    assert(system.getIntegrationMethod() == ParticleSystem::IntegrationMethod::BORIS);
+    assert(system.getExternalField().getUniformElectric() == glm::dvec3(0.0, 1e3, 0.0));
+    assert(system.getExternalField().getUniformMagnetic() == glm::dvec3(0.0, 0.0, 0.5));
+    assert(system.getMagneticInteraction());
+    assert(system.getTimeStepMode() == ParticleSystem::TimeStepMode::BLOCK);
+    assert(system.getTimeStepAccuracy() == 0.05);
+    assert(system.getMaxTimeStepLevel() == 6);
+
+    double netCharge = 0.0;
+    for (const auto& p : system.getParticles()) {
+        assert(glm::length(p.position) <= 0.5);
+        netCharge += p.charge;
+    }
+    assert(std::abs(netCharge) < 1e-20);
+
+    // Same seed, same cloud
+    std::istringstream again("cloud 100 0.5 1e-9 1e-3 7\n");
+    ParticleSystem other;
+    assert(SceneLoader::load(again, other, error));
+    assert(other.getParticles()[42].position == system.getParticles()[42].position);
+
+    std::istringstream periodic(
+        "force_method p3m\n"
+        "periodic_box -1 -1 -1 1 1 2\n"
+        "mesh_size 24\n"
+        "short_range_cutoff 0.3\n"
+    );
+    ParticleSystem box;
+    assert(SceneLoader::load(periodic, box, error));
+    assert(box.getForceMethod() == ParticleSystem::ForceMethod::P3M);
+    assert(box.isPeriodic());
+    assert(box.getPeriodicBox().getLow() == glm::dvec3(-1.0));
+    assert(box.getPeriodicBox().getSize() == glm::dvec3(2.0, 2.0, 3.0));
+    assert(box.getMeshSize() == 32);  // Next power of two
+    assert(box.getShortRangeCutoff() == 0.3);
+
+    std::istringstream ewald("force_method ewald\nperiodic_box 0 0 0 1 1 1\newald_accuracy 1e-8\n");
+    ParticleSystem crystal;
+    assert(SceneLoader::load(ewald, crystal, error));
+    assert(crystal.getForceMethod() == ParticleSystem::ForceMethod::EWALD);
+    assert(crystal.getEwaldAccuracy() == 1e-8);
+
+    std::cout << "  ✓ Cloud and settings test passed" << std::endl;
+}
+
+void testErrors() {
+    std::cout << "Testing malformed scenes..." << std::endl;
+
+    const char* bad[] = {
+        "electron 1 2\n",
+        "proton 1 2 3 4\n",
+        "particle 0 0 0 0 0 0 1e-6 -1\n",
+        "electron 0 0 0\nwarp 9\n",
+        "force_method magic\n",
+        "cloud 1.5 1 1 1\n",
+        "electron 0 x 0\n",
+        "periodic_box 0 0 0 1 0 1\n",
+        "ewald_accuracy 0.5\n"
+    };
+
+    for (const char* text : bad) {
+        std::istringstream scene(text);
+        ParticleSystem system;
+        std::string error;
+        assert(!SceneLoader::load(scene, system, error));
+        assert(!error.empty());
+        // Nothing is applied from a malformed scene
+        assert(system.getParticleCount() == 0);
+    }
+
+    // Errors name the offending line
+    std::istringstream scene("electron 0 0 0\nwarp 9\n");
+    ParticleSystem system;
+    std::string error;
+    SceneLoader::load(scene, system, error, "test.scene");
+    assert(error.rfind("test.scene:2:", 0) == 0);
+
+    assert(!SceneLoader::loadFile("/nonexistent/scene.txt", system, error));
+
+    std::cout << "  ✓ Malformed scene test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running scene loader unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testParticles();
+        testCloudAndSettings();
+        testErrors();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
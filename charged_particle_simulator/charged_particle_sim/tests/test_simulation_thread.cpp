@@ -0,0 +1,203 @@
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include "engine/scene/SimulationThread.hpp"
+
+/**
+ * Unit tests for the triple buffer and the fixed-step simulation thread
+ */
+
+void testTripleBuffer() {
+    std::cout << "Testing triple buffer..." << std::endl;
+
+    TripleBuffer<int> buffer;
+    assert(!buffer.acquire());
+
+    buffer.back() = 1;
+    buffer.publish();
+    assert(buffer.acquire());
+    assert(buffer.front() == 1);
+    assert(!buffer.acquire());
+    assert(buffer.front() == 1);
+
+    // Only the newest of several publishes is seen
+    buffer.back() = 2;
+    buffer.publish();
+    buffer.back() = 3;
+    buffer.publish();
+    assert(buffer.front() == 1);
+    assert(buffer.acquire());
+    assert(buffer.front() == 3);
+
+    std::cout << "  ✓ Triple buffer test passed" << std::endl;
+}
+
+void testTripleBufferConcurrent() {
+    std::cout << "Testing concurrent triple buffer..." << std::endl;
+
+    // The reader must only ever see whole, increasingly recent values
+    struct Value {
+        long a = 0;
+        long b = 0;
+        std::vector<long> data;
+    };
+    TripleBuffer<Value> buffer;
+    constexpr long COUNT = 200000;
+
+    std::thread writer([&buffer] {
+        for (long i = 1; i <= COUNT; ++i) {
+            Value& v = buffer.back();
+            v.a = i;
+            v.data.assign(8, i);
+            v.b = -i;
+            buffer.publish();
+        }
+    });
+
+    long last = 0;
+    while (last < COUNT) {
+        if (buffer.acquire()) {
+            const Value& v = buffer.front();
+            assert(v.a > last);
+            assert(v.b == -v.a);
+            for (long x : v.data) {
+                assert(x == v.a);
+            }
+            last = v.a;
+        }
+    }
+    writer.join();
+
+    std::cout << "  ✓ Concurrent triple buffer test passed" << std::endl;
+}
+
+void buildSystem(ParticleSystem& system) {
+    system.setThreadCount(1);
+    for (int i = 0; i < 8; ++i) {
+        Particle p = i % 2 == 0 ? Particle::createProton(glm::dvec3(i * 1e-9, 0.0, 0.0))
+                                : Particle::createElectron(glm::dvec3(i * 1e-9, 1e-9, 0.0));
+        system.addParticle(p);
+    }
+}
+
+void testPublishedStates() {
+    std::cout << "Testing published states..." << std::endl;
+
+    const double dt = 1e-16;
+    ParticleSystem system;
+    buildSystem(system);
+    SimulationThread simulation(system);
+    simulation.setTimeStep(dt);
+    simulation.setSubstepsPerFrame(5);
+    simulation.setFrameInterval(0.0);
+    simulation.start();
+
+    // The initial state is available at once
+    const SimulationThread::State* state = &simulation.acquireState();
+    assert(state->particles.size() == 8);
+
+    // Every state is a whole frame: a multiple of the substeps, consistent time
+    uint64_t lastFrame = 0;
+    while (lastFrame < 20) {
+        state = &simulation.acquireState();
+        assert(state->frame >= lastFrame);
+        assert(state->stepCount == state->frame * 5);
+        assert(std::abs(state->simulationTime - state->stepCount * dt) <= 1e-9 * state->simulationTime);
+        assert(state->particles.size() == 8);
+        assert(state->particles[0].history.size() == 0);
+        lastFrame = state->frame;
+        std::this_thread::yield();
+    }
+
+    simulation.stop();
+    assert(simulation.getStats().frames * 5 == system.getStepCount());
+
+    // Stepping on the thread is the same computation as stepping directly
+    ParticleSystem reference;
+    buildSystem(reference);
+    for (size_t i = 0; i < system.getStepCount(); ++i) {
+        reference.step(dt);
+    }
+    for (size_t i = 0; i < system.getParticleCount(); ++i) {
+        assert(system.getParticles()[i].position == reference.getParticles()[i].position);
+    }
+
+    std::cout << "  ✓ Published states test passed" << std::endl;
+}
+
+void testPauseAndCommands() {
+    std::cout << "Testing pause and commands..." << std::endl;
+
+    ParticleSystem system;
+    buildSystem(system);
+    SimulationThread simulation(system);
+    simulation.setTimeStep(1e-16);
+    simulation.setFrameInterval(0.0);
+    simulation.setPaused(true);
+    simulation.start();
+
+    // Commands run while paused and publish their result without stepping
+    simulation.post([](ParticleSystem& s) { s.addParticle(Particle::createProton(glm::dvec3(0.0, 0.0, 1e-9))); });
+    const SimulationThread::State* state = &simulation.acquireState();
+    auto start = std::chrono::steady_clock::now();
+    while (state->particles.size() != 9) {
+        assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+        std::this_thread::yield();
+        state = &simulation.acquireState();
+    }
+    assert(state->stepCount == 0);
+
+    simulation.setPaused(false);
+    while (state->stepCount == 0) {
+        assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+        std::this_thread::yield();
+        state = &simulation.acquireState();
+    }
+    simulation.stop();
+    assert(system.getParticleCount() == 9);
+
+    std::cout << "  ✓ Pause and commands test passed" << std::endl;
+}
+
+void testFixedRate() {
+    std::cout << "Testing fixed frame rate..." << std::endl;
+
+    // Frames follow wall-clock time, not how fast the loop could run
+    ParticleSystem system;
+    buildSystem(system);
+    SimulationThread simulation(system);
+    simulation.setTimeStep(1e-16);
+    simulation.setSubstepsPerFrame(2);
+    simulation.setFrameInterval(0.01);
+    simulation.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    simulation.stop();
+
+    uint64_t frames = simulation.getStats().frames;
+    assert(frames >= 5 && frames <= 30);
+    assert(system.getStepCount() == frames * 2);
+
+    std::cout << "  ✓ Fixed frame rate test passed (" << frames << " frames in 0.2 s)" << std::endl;
+}
+
+int main() {
+    std::cout << "Running simulation thread unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testTripleBuffer();
+        testTripleBufferConcurrent();
+        testPublishedStates();
+        testPauseAndCommands();
+        testFixedRate();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
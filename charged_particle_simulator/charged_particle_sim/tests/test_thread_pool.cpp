@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "engine/core/ThreadPool.hpp"
+#include "engine/physics/FieldLineGenerator.hpp"
+#include "engine/scene/ParticleSystem.hpp"
+
+/**
+ * Unit tests for the thread pool, multithreaded ParticleSystem stepping
+ * and parallel field line tracing
+ */
+
+void testEveryIndexOnce() {
+    std::cout << "Testing parallelFor covers every index once..." << std::endl;
+    
+    ThreadPool pool(4);
+    assert(pool.getThreadCount() == 4);
+    
+    std::vector<int> visits(1001, 0);
+    for (int repeat = 0; repeat < 50; ++repeat) {
+        pool.parallelFor(0, visits.size(), [&](size_t begin, size_t end, size_t worker) {
+            assert(worker < 4);
+            for (size_t i = begin; i < end; ++i) {
+                ++visits[i];
+            }
+        });
+    }
+    for (int v : visits) {
+        assert(v == 50);
+    }
+    
+    std::cout << "  ✓ Index coverage test passed" << std::endl;
+}
+
+void testWorkStealingCoversEveryIndex() {
+    std::cout << "Testing work-stealing loop covers every index once..." << std::endl;
+    
+    ThreadPool pool(4);
+    std::vector<int> visits(997, 0);
+    for (size_t grain : {1, 3, 64}) {
+        std::fill(visits.begin(), visits.end(), 0);
+        pool.parallelForDynamic(0, visits.size(), [&](size_t begin, size_t end, size_t) {
+            assert(end - begin <= grain);
+            for (size_t i = begin; i < end; ++i) {
+                // Very uneven cost, as with field lines of different lengths
+                volatile double sink = 0.0;
+                for (size_t k = 0; k < (i % 97 == 0 ? 20000 : 10); ++k) {
+                    sink = sink + 1.0;
+                }
+                ++visits[i];
+            }
+        }, grain);
+        for (int v : visits) {
+            assert(v == 1);
+        }
+    }
+    
+    std::cout << "  ✓ Work-stealing coverage test passed" << std::endl;
+}
+
+void testExceptionPropagates() {
+    std::cout << "Testing exceptions propagate to caller..." << std::endl;
+    
+    ThreadPool pool(3);
+    bool caught = false;
+    try {
+        pool.parallelFor(0, 300, [](size_t begin, size_t end, size_t) {
+            if (begin <= 250 && 250 < end) {
+                throw std::runtime_error("boom");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    assert(caught);
+    
+    // Pool stays usable after an exception
+    size_t total = 0;
+    pool.parallelFor(0, 10, [&](size_t begin, size_t end, size_t) {
+        if (begin == 0) {
+            total = end;
+        }
+    }, 100);
+    assert(total == 10);
+    
+    std::cout << "  ✓ Exception test passed" << std::endl;
+}
+
+std::vector<Particle> runSystem(size_t threadCount, ParticleSystem::ForceMethod method) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> pos(-1e-6, 1e-6);
+    
+    ParticleSystem system;
+    system.setThreadCount(threadCount);
+    system.setForceMethod(method);
+    for (int i = 0; i < 300; ++i) {
+        glm::dvec3 p(pos(rng), pos(rng), pos(rng));
+        system.addParticle(i % 2 == 0 ? Particle::createProton(p) : Particle::createElectron(p));
+    }
+    for (int s = 0; s < 5; ++s) {
+        system.step(1e-15);
+    }
+    assert(system.getThreadCount() == threadCount);
+    return system.getParticles();
+}
+
+void testDeterministicAcrossThreadCounts() {
+    std::cout << "Testing results are identical for any thread count..." << std::endl;
+    
+    for (auto method : {ParticleSystem::ForceMethod::DIRECT, ParticleSystem::ForceMethod::BARNES_HUT}) {
+        std::vector<Particle> reference = runSystem(1, method);
+        for (size_t threads : {2, 3, 8}) {
+            std::vector<Particle> result = runSystem(threads, method);
+            for (size_t i = 0; i < reference.size(); ++i) {
+                // Bitwise equality, not tolerance
+                assert(result[i].position == reference[i].position);
+                assert(result[i].velocity == reference[i].velocity);
+            }
+        }
+    }
+    
+    std::cout << "  ✓ Determinism test passed" << std::endl;
+}
+
+void testParallelFieldLinesMatchSerial() {
+    std::cout << "Testing parallel field lines match serial trace..." << std::endl;
+    
+    std::vector<Particle> particles = {
+        Particle::createProton(glm::dvec3(-1e-9, 0.0, 0.0)),
+        Particle::createElectron(glm::dvec3(1e-9, 0.0, 0.0)),
+        Particle::createProton(glm::dvec3(0.0, 2e-9, 0.0))
+    };
+    FieldLineConfig config;
+    config.stepSize = 1e-11;
+    config.maxDistance = 1e-7;
+    config.maxStepsPerLine = 300;
+    
+    std::vector<FieldLine> serial = FieldLineGenerator::generateAll(particles, config);
+    ThreadPool pool(4);
+    std::vector<FieldLine> parallel = FieldLineGenerator::generateAll(particles, config, &pool);
+    
+    assert(!serial.empty());
+    assert(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        assert(parallel[i].points == serial[i].points);
+        assert(parallel[i].fieldMagnitudes == serial[i].fieldMagnitudes);
+        assert(parallel[i].isComplete == serial[i].isComplete);
+    }
+    
+    std::cout << "  ✓ Parallel field line test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running thread pool unit tests..." << std::endl;
+    std::cout << std::endl;
+    
+    try {
+        testEveryIndexOnce();
+        testWorkStealingCoversEveryIndex();
+        testExceptionPropagates();
+        testDeterministicAcrossThreadCounts();
+        testParallelFieldLinesMatchSerial();
+        
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
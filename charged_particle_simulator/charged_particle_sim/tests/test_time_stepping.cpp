@@ -0,0 +1,194 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include "engine/io/Checkpoint.hpp"
+
+/**
+ * Unit tests for adaptive and block time stepping
+ */
+
+using Mode = ParticleSystem::TimeStepMode;
+
+// Two protons in a near head-on collision among distant, slowly moving bystanders
+void buildEncounter(ParticleSystem& system) {
+    system.setCollisionPrevention(false);
+    system.setThreadCount(1);
+
+    Particle a = Particle::createProton(glm::dvec3(-1e-6, 2e-9, 0.0));
+    a.velocity = glm::dvec3(1e4, 0.0, 0.0);
+    Particle b = Particle::createProton(glm::dvec3(1e-6, -2e-9, 0.0));
+    b.velocity = glm::dvec3(-1e4, 0.0, 0.0);
+    system.addParticle(a);
+    system.addParticle(b);
+    for (int i = 0; i < 20; ++i) {
+        system.addParticle(Particle::createProton(glm::dvec3(1e-4 * (i % 5 - 2), 1e-4 * (i / 5 + 1), 3e-5)));
+    }
+}
+
+double energy(const ParticleSystem& system) {
+    const auto& particles = system.getParticles();
+    double total = 0.0;
+    for (size_t i = 0; i < particles.size(); ++i) {
+        total += 0.5 * particles[i].mass * glm::dot(particles[i].velocity, particles[i].velocity);
+        for (size_t j = i + 1; j < particles.size(); ++j) {
+            total += PhysicsConstants::k * particles[i].charge * particles[j].charge /
+                     glm::length(particles[i].position - particles[j].position);
+        }
+    }
+    return total;
+}
+
+// Encounter (closest approach ~1.4 nm, ~1e-13 s) is at step 100
+constexpr double BASE_DT = 1e-12;
+constexpr int STEPS = 200;
+
+void testEncounterAccuracy() {
+    std::cout << "Testing close encounter accuracy..." << std::endl;
+
+    // Reference: fixed steps as short as the finest adaptive level
+    ParticleSystem reference;
+    buildEncounter(reference);
+    const int substeps = 1 << reference.getMaxTimeStepLevel();
+    for (int i = 0; i < STEPS * substeps; ++i) {
+        reference.step(BASE_DT / substeps);
+    }
+    const glm::dvec3 expected = reference.getParticles()[0].position;
+
+    ParticleSystem coarse;
+    buildEncounter(coarse);
+    const double coarseEnergy = energy(coarse);
+    for (int i = 0; i < STEPS; ++i) {
+        coarse.step(BASE_DT);
+    }
+    double coarseError = std::abs(energy(coarse) / coarseEnergy - 1.0);
+    assert(coarseError > 1e-2);
+
+    for (Mode mode : {Mode::GLOBAL, Mode::BLOCK}) {
+        ParticleSystem system;
+        buildEncounter(system);
+        system.setTimeStepMode(mode);
+        const double initialEnergy = energy(system);
+        for (int i = 0; i < STEPS; ++i) {
+            system.step(BASE_DT);
+        }
+        assert(std::abs(energy(system) / initialEnergy - 1.0) < 1e-5);
+        assert(glm::length(system.getParticles()[0].position - expected) < 1e-3 * glm::length(expected));
+
+        // Far fewer force evaluations than resolving everything at the finest level
+        assert(system.getParticleForceEvaluationCount() * 100 < reference.getParticleForceEvaluationCount());
+    }
+
+    std::cout << "  ✓ Close encounter accuracy test passed (fixed-step energy error " << coarseError
+              << ")" << std::endl;
+}
+
+void testBlockLevels() {
+    std::cout << "Testing block levels..." << std::endl;
+
+    ParticleSystem global;
+    buildEncounter(global);
+    global.setTimeStepMode(Mode::GLOBAL);
+    ParticleSystem block;
+    buildEncounter(block);
+    block.setTimeStepMode(Mode::BLOCK);
+
+    // Near closest approach only the colliding pair substeps
+    for (int i = 0; i < 100; ++i) {
+        global.step(BASE_DT);
+        block.step(BASE_DT);
+    }
+    const auto& levels = block.getTimeStepLevels();
+    assert(levels.size() == block.getParticleCount());
+    assert(levels[0] >= 3 && levels[1] >= 3);
+    for (size_t i = 2; i < levels.size(); ++i) {
+        assert(levels[i] <= 1);
+    }
+
+    for (int i = 100; i < STEPS; ++i) {
+        global.step(BASE_DT);
+        block.step(BASE_DT);
+    }
+    assert(block.getParticleForceEvaluationCount() * 3 < global.getParticleForceEvaluationCount());
+
+    std::cout << "  ✓ Block levels test passed (" << block.getParticleForceEvaluationCount() << " vs "
+              << global.getParticleForceEvaluationCount() << " particle force evaluations)" << std::endl;
+}
+
+void testQuietSystemKeepsBaseStep() {
+    std::cout << "Testing quiet system..." << std::endl;
+
+    // Widely separated particles settle on the base step after the first step
+    ParticleSystem system;
+    system.setCollisionPrevention(false);
+    system.setThreadCount(1);
+    system.setTimeStepMode(Mode::BLOCK);
+    system.addParticle(Particle::createProton(glm::dvec3(-1e-3, 0.0, 0.0)));
+    system.addParticle(Particle::createProton(glm::dvec3(1e-3, 0.0, 0.0)));
+    for (int i = 0; i < 5; ++i) {
+        system.step(BASE_DT);
+    }
+    size_t evaluations = system.getParticleForceEvaluationCount();
+    for (int i = 0; i < 10; ++i) {
+        system.step(BASE_DT);
+    }
+    assert(system.getTimeStepLevels()[0] == 0 && system.getTimeStepLevels()[1] == 0);
+    assert(system.getParticleForceEvaluationCount() - evaluations == 20);
+
+    std::cout << "  ✓ Quiet system test passed" << std::endl;
+}
+
+void testBlockRestart() {
+    std::cout << "Testing block step restart..." << std::endl;
+
+    const std::string path = "test_time_stepping.cpschk";
+    ParticleSystem original;
+    buildEncounter(original);
+    original.setTimeStepMode(Mode::BLOCK);
+    original.setTimeStepAccuracy(0.03);
+    for (int i = 0; i < 95; ++i) {
+        original.step(BASE_DT);
+    }
+
+    std::string error;
+    assert(Checkpoint::save(path, original, error));
+    for (int i = 0; i < 10; ++i) {
+        original.step(BASE_DT);
+    }
+
+    ParticleSystem restored;
+    assert(Checkpoint::load(path, restored, error));
+    assert(restored.getTimeStepMode() == Mode::BLOCK);
+    assert(restored.getTimeStepAccuracy() == 0.03);
+    for (int i = 0; i < 10; ++i) {
+        restored.step(BASE_DT);
+    }
+    for (size_t i = 0; i < original.getParticleCount(); ++i) {
+        assert(original.getParticles()[i].position == restored.getParticles()[i].position);
+        assert(original.getParticles()[i].velocity == restored.getParticles()[i].velocity);
+    }
+    assert(original.getTimeStepLevels() == restored.getTimeStepLevels());
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Block step restart test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running time stepping unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testEncounterAccuracy();
+        testBlockLevels();
+        testQuietSystemKeepsBaseStep();
+        testBlockRestart();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,240 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "engine/io/TrajectoryReader.hpp"
+#include "engine/io/TrajectoryWriter.hpp"
+
+/**
+ * Unit tests for the binary trajectory writer and memory-mapped reader
+ */
+
+std::vector<Particle> makeParticles(size_t count) {
+    std::vector<Particle> particles;
+    for (size_t i = 0; i < count; ++i) {
+        double q = (i % 2 == 0) ? 1e-9 : -2e-9;
+        particles.push_back(Particle::createCustom(glm::dvec3(0.0), q, 1.0 + i));
+    }
+    return particles;
+}
+
+// Deterministic, exactly representable state for frame f
+void setFrameState(std::vector<Particle>& particles, size_t frame) {
+    for (size_t i = 0; i < particles.size(); ++i) {
+        particles[i].position = glm::dvec3(frame + 0.25 * i, -0.5 * i, 1.0 / 3.0 + frame);
+        particles[i].velocity = glm::dvec3(i, frame, -1.0);
+    }
+}
+
+std::string tempPath(const char* name) {
+    return std::string("test_trajectory_") + name + ".cpstraj";
+}
+
+void testRoundTrip() {
+    std::cout << "Testing float64 round trip..." << std::endl;
+
+    const std::string path = tempPath("f64");
+    std::vector<Particle> particles = makeParticles(7);
+
+    TrajectoryWriter::Options options;
+    options.blockWhenFull = true;
+    options.bufferFrames = 4;
+    TrajectoryWriter writer;
+    assert(writer.open(path, particles, 1e-3, options));
+    for (size_t f = 0; f < 50; ++f) {
+        setFrameState(particles, f);
+        assert(writer.writeFrame(particles, f * 10, f * 10 * 1e-3));
+    }
+    assert(writer.close());
+    assert(writer.getStats().framesWritten == 50);
+    assert(writer.getStats().framesDropped == 0);
+
+    TrajectoryReader reader;
+    std::string error;
+    assert(reader.open(path, error));
+    assert(reader.getParticleCount() == 7);
+    assert(reader.getFrameCount() == 50);
+    assert(reader.getTimeStep() == 1e-3);
+    assert(!reader.isFloat32() && reader.hasVelocities() && reader.hasIndex());
+    assert(reader.getCharges()[1] == -2e-9);
+    assert(reader.getMasses()[6] == 7.0);
+
+    // Bitwise-identical state from any frame, in any order
+    for (size_t f : {49u, 0u, 17u}) {
+        setFrameState(particles, f);
+        assert(reader.getFrameStep(f) == f * 10);
+        for (size_t i = 0; i < particles.size(); ++i) {
+            assert(reader.getPosition(f, i) == particles[i].position);
+            assert(reader.getVelocity(f, i) == particles[i].velocity);
+        }
+        const double* raw = static_cast<const double*>(reader.getPositionData(f));
+        assert(raw[3 * 2 + 1] == particles[2].position.y);
+    }
+
+    // Lookup through the index
+    assert(reader.findFrameByStep(170) == 17);
+    assert(reader.findFrameByStep(171) == 18);
+    assert(reader.findFrameByStep(100000) == 50);
+    assert(reader.findFrameByTime(0.2) == 20);
+
+    reader.close();
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Round trip test passed" << std::endl;
+}
+
+void testFloat32WithoutVelocities() {
+    std::cout << "Testing float32 frames..." << std::endl;
+
+    const std::string path = tempPath("f32");
+    std::vector<Particle> particles = makeParticles(5);
+
+    TrajectoryWriter::Options options;
+    options.precision = TrajectoryWriter::Precision::FLOAT32;
+    options.velocities = false;
+    options.frameIndex = false;
+    options.blockWhenFull = true;
+    TrajectoryWriter writer;
+    assert(writer.open(path, particles, 0.5, options));
+    for (size_t f = 0; f < 10; ++f) {
+        setFrameState(particles, f);
+        assert(writer.writeFrame(particles, f, f * 0.5));
+    }
+    assert(writer.close());
+
+    TrajectoryReader reader;
+    std::string error;
+    assert(reader.open(path, error));
+    assert(reader.isFloat32() && !reader.hasVelocities() && !reader.hasIndex());
+    assert(reader.getFrameCount() == 10);
+
+    setFrameState(particles, 3);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        glm::dvec3 expected = glm::dvec3(glm::vec3(particles[i].position));
+        assert(reader.getPosition(3, i) == expected);
+    }
+    assert(reader.getVelocityData(3) == nullptr);
+
+    // Binary search over the frame headers when there is no index
+    assert(reader.findFrameByStep(4) == 4);
+    assert(reader.findFrameByTime(2.25) == 5);
+
+    reader.close();
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Float32 test passed" << std::endl;
+}
+
+void testDropWhenFull() {
+    std::cout << "Testing bounded buffering..." << std::endl;
+
+    const std::string path = tempPath("drop");
+    std::vector<Particle> particles = makeParticles(20000);
+
+    // A burst far larger than the buffer pool: frames are dropped, never queued unbounded
+    TrajectoryWriter::Options options;
+    options.bufferFrames = 2;
+    TrajectoryWriter writer;
+    assert(writer.open(path, particles, 1.0, options));
+    size_t accepted = 0;
+    for (size_t f = 0; f < 200; ++f) {
+        accepted += writer.writeFrame(particles, f, static_cast<double>(f)) ? 1 : 0;
+    }
+    assert(writer.close());
+
+    TrajectoryWriter::Stats stats = writer.getStats();
+    assert(stats.framesQueued == accepted);
+    assert(stats.framesWritten == accepted);
+    assert(stats.framesQueued + stats.framesDropped == 200);
+
+    // Frames that made it are in order
+    TrajectoryReader reader;
+    std::string error;
+    assert(reader.open(path, error));
+    assert(reader.getFrameCount() == accepted);
+    for (size_t f = 1; f < reader.getFrameCount(); ++f) {
+        assert(reader.getFrameStep(f) > reader.getFrameStep(f - 1));
+    }
+    reader.close();
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Bounded buffering test passed (" << stats.framesDropped << " dropped)" << std::endl;
+}
+
+void testUnfinishedFile() {
+    std::cout << "Testing unfinished and invalid files..." << std::endl;
+
+    const std::string path = tempPath("partial");
+    std::vector<Particle> particles = makeParticles(3);
+
+    TrajectoryWriter::Options options;
+    options.blockWhenFull = true;
+    TrajectoryWriter writer;
+    assert(writer.open(path, particles, 1.0, options));
+    for (size_t f = 0; f < 6; ++f) {
+        setFrameState(particles, f);
+        writer.writeFrame(particles, f, static_cast<double>(f));
+    }
+    assert(writer.close());
+
+    // Simulate a crash: header frame count 0, last frame cut in half, no index
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    TrajectoryFormat::TrajectoryHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    size_t cut = header.frameDataOffset + 5 * header.frameStride + header.frameStride / 2;
+    header.frameCount = 0;
+    header.indexOffset = 0;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(cut));
+    }
+
+    TrajectoryReader reader;
+    std::string error;
+    assert(reader.open(path, error));
+    assert(reader.getFrameCount() == 5);
+    assert(!reader.hasIndex());
+    setFrameState(particles, 4);
+    assert(reader.getPosition(4, 2) == particles[2].position);
+    reader.close();
+
+    // Not a trajectory
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "definitely not a trajectory file, but long enough to hold a header......";
+    }
+    assert(!reader.open(path, error));
+    assert(!error.empty());
+    assert(!reader.open("missing_trajectory.cpstraj", error));
+
+    std::remove(path.c_str());
+
+    std::cout << "  ✓ Unfinished file test passed" << std::endl;
+}
+
+int main() {
+    std::cout << "Running trajectory unit tests..." << std::endl;
+    std::cout << std::endl;
+
+    try {
+        testRoundTrip();
+        testFloat32WithoutVelocities();
+        testDropWhenFull();
+        testUnfinishedFile();
+
+        std::cout << std::endl;
+        std::cout << "All tests passed!" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}